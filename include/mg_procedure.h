@@ -1171,6 +1171,66 @@ enum mgp_error mgp_duration_sub(struct mgp_duration *first, struct mgp_duration
 /// Result is NULL if the end of the iteration has been reached.
 /// Return MGP_ERROR_UNABLE_TO_ALLOCATE if unable to allocate a mgp_vertex.
 enum mgp_error mgp_vertices_iterator_next(struct mgp_vertices_iterator *it, struct mgp_vertex **result);
+
+/// A read-only snapshot of a part of the graph in the compressed sparse row
+/// (CSR) format, meant for analytics algorithms which traverse the graph many
+/// times.
+///
+/// Projected vertices get dense indices from 0 to the number of vertices. The
+/// outbound neighbors of the vertex with index `i` are the indices stored in
+/// `neighbors[offsets[i]]` up to `neighbors[offsets[i + 1]]` (exclusive).
+/// If the projection has weights, `weights` is parallel to `neighbors`.
+/// Since the projection is a snapshot, it doesn't reflect changes made to the
+/// graph after it was built.
+struct mgp_graph_projection;
+
+/// Build a projection of the graph.
+///
+/// Only vertices with the given `label` are projected, or all vertices if
+/// `label` is NULL. Only edges of the given `edge_type` whose both endpoints
+/// are projected are included, or edges of all types if `edge_type` is NULL.
+/// If `weight_property` is not NULL, the projection gets a weight for each
+/// edge from that property. Edges whose property isn't a number get the weight
+/// 1.0.
+/// Resulting projection must be freed with mgp_graph_projection_destroy.
+/// Return MGP_ERROR_UNABLE_TO_ALLOCATE if unable to allocate the projection.
+enum mgp_error mgp_graph_project(struct mgp_graph *graph, const char *label, const char *edge_type,
+                                 const char *weight_property, struct mgp_memory *memory,
+                                 struct mgp_graph_projection **result);
+
+/// Free the memory used by a mgp_graph_projection.
+void mgp_graph_projection_destroy(struct mgp_graph_projection *projection);
+
+/// Get the number of projected vertices.
+/// Current implementation always returns without errors.
+enum mgp_error mgp_graph_projection_vertices_count(struct mgp_graph_projection *projection, size_t *result);
+
+/// Get the number of projected edges.
+/// Current implementation always returns without errors.
+enum mgp_error mgp_graph_projection_edges_count(struct mgp_graph_projection *projection, size_t *result);
+
+/// Get the ID of the projected vertex with the given index, which can be used
+/// with mgp_graph_get_vertex_by_id.
+/// Return MGP_ERROR_OUT_OF_RANGE if `index` is not smaller than the number of vertices.
+enum mgp_error mgp_graph_projection_vertex_id(struct mgp_graph_projection *projection, size_t index,
+                                              struct mgp_vertex_id *result);
+
+/// Get the array of offsets into the neighbors, its size is the number of
+/// vertices increased by one.
+/// The array is valid until the projection is freed.
+/// Current implementation always returns without errors.
+enum mgp_error mgp_graph_projection_offsets(struct mgp_graph_projection *projection, const size_t **result);
+
+/// Get the array of neighbor indices, its size is the number of edges.
+/// The array is valid until the projection is freed.
+/// Current implementation always returns without errors.
+enum mgp_error mgp_graph_projection_neighbors(struct mgp_graph_projection *projection, const size_t **result);
+
+/// Get the array of edge weights, its size is the number of edges. Result is
+/// NULL if the projection was built without a weight property.
+/// The array is valid until the projection is freed.
+/// Current implementation always returns without errors.
+enum mgp_error mgp_graph_projection_weights(struct mgp_graph_projection *projection, const double **result);
 ///@}
 
 /// @name Type System
@@ -1321,6 +1381,68 @@ enum mgp_error mgp_module_add_read_procedure(struct mgp_module *module, const ch
 enum mgp_error mgp_module_add_write_procedure(struct mgp_module *module, const char *name, mgp_proc_cb cb,
                                               struct mgp_proc **result);
 
+/// Initializer of a batched procedure call, invoked once per call of the
+/// procedure before its first batch is requested.
+///
+/// The returned pointer is the state of the call. It is passed to every
+/// invocation of the batch callback and to the cleanup of the call, which are
+/// responsible for freeing it. Passed in arguments and the graph stay valid
+/// until the cleanup is invoked, as does the memory allocated through the
+/// passed in mgp_memory.
+typedef void *(*mgp_batch_proc_initializer)(struct mgp_list *, struct mgp_graph *, struct mgp_memory *);
+
+/// Entry-point for producing the next batch of records of a batched procedure
+/// call, invoked with the state returned by the initializer.
+///
+/// A batch without any records signals that the call produced all of its
+/// records. Errors are reported through mgp_result_set_error_msg, in which
+/// case the call is cleaned up and no further batches are requested.
+typedef void (*mgp_batch_proc_cb)(void *, struct mgp_graph *, struct mgp_result *, struct mgp_memory *);
+
+/// Cleanup of a batched procedure call, invoked once with the state returned by
+/// the initializer. The cleanup is invoked after the last batch or when the
+/// query stops requesting further batches. The query may already be finished
+/// at that point, so the cleanup must not use the graph.
+typedef void (*mgp_batch_proc_cleanup)(void *);
+
+/// Register a read-only batched procedure to a module.
+///
+/// Instead of producing all of its records in a single invocation, a batched
+/// procedure produces them in batches. For each call of the procedure,
+/// `initializer` is invoked first, after which `cb` is invoked repeatedly to
+/// produce the next batch of records. The records of a batch are passed on
+/// before the next batch is requested, so the memory used for the records stays
+/// bounded by the batch size and the first records are available before the
+/// procedure produces all of them. Finally, `cleanup` is invoked.
+///
+/// The batches of a single call may be requested from different threads, but
+/// never concurrently.
+///
+/// The `name` must be a valid identifier, following the same rules as the
+/// procedure`name` in mgp_module_add_read_procedure.
+///
+/// Return MGP_ERROR_UNABLE_TO_ALLOCATE if unable to allocate memory for mgp_proc.
+/// Return MGP_ERROR_INVALID_ARGUMENT if `name` is not a valid procedure name or any of the callbacks is NULL.
+/// RETURN MGP_ERROR_LOGIC_ERROR if a procedure with the same name was already registered.
+enum mgp_error mgp_module_add_batch_read_procedure(struct mgp_module *module, const char *name,
+                                                   mgp_batch_proc_initializer initializer, mgp_batch_proc_cb cb,
+                                                   mgp_batch_proc_cleanup cleanup, struct mgp_proc **result);
+
+/// Register a writeable batched procedure to a module.
+///
+/// The procedure is invoked in the same way as the procedures registered
+/// through mgp_module_add_batch_read_procedure.
+///
+/// The `name` must be a valid identifier, following the same rules as the
+/// procedure`name` in mgp_module_add_read_procedure.
+///
+/// Return MGP_ERROR_UNABLE_TO_ALLOCATE if unable to allocate memory for mgp_proc.
+/// Return MGP_ERROR_INVALID_ARGUMENT if `name` is not a valid procedure name or any of the callbacks is NULL.
+/// RETURN MGP_ERROR_LOGIC_ERROR if a procedure with the same name was already registered.
+enum mgp_error mgp_module_add_batch_write_procedure(struct mgp_module *module, const char *name,
+                                                    mgp_batch_proc_initializer initializer, mgp_batch_proc_cb cb,
+                                                    mgp_batch_proc_cleanup cleanup, struct mgp_proc **result);
+
 /// Add a required argument to a procedure.
 ///
 /// The order of adding arguments will correspond to the order the procedure
@@ -1384,6 +1506,19 @@ enum mgp_error mgp_proc_add_result(struct mgp_proc *proc, const char *name, stru
 /// Return MGP_ERROR_INVALID_ARGUMENT if `name` is not a valid result name.
 /// RETURN MGP_ERROR_LOGIC_ERROR if a result field with the same name was already added.
 enum mgp_error mgp_proc_add_deprecated_result(struct mgp_proc *proc, const char *name, struct mgp_type *type);
+
+/// Mark a read procedure as safe to be called concurrently.
+///
+/// When a procedure is called once for each of many rows, as in
+/// `MATCH (n) CALL module.procedure(n) YIELD *`, the calls of a parallel safe
+/// procedure are run on multiple threads. Each call gets its own mgp_memory and
+/// mgp_result, and the results are still produced in the order of the rows.
+/// The procedure mustn't modify any state shared between its calls without
+/// synchronizing the access to it.
+///
+/// Return MGP_ERROR_LOGIC_ERROR if the procedure is a write or a batched
+/// procedure.
+enum mgp_error mgp_proc_set_parallel_safe(struct mgp_proc *proc);
 ///@}
 
 /// @name Execution
@@ -211,13 +211,10 @@ class Properties:
         """
         if not self._vertex_or_edge.is_valid():
             raise InvalidContextError()
-        properties_it = self._vertex_or_edge.iter_properties()
-        prop = properties_it.get()
-        while prop is not None:
-            yield Property(*prop)
-            if not self._vertex_or_edge.is_valid():
-                raise InvalidContextError()
-            prop = properties_it.next()
+        # All properties are read in a single pass and converted at once.
+        properties = self._vertex_or_edge.get_properties()
+        for name, value in properties.items():
+            yield Property(name, value)
 
     def keys(self) -> typing.Iterable[str]:
         """
@@ -262,7 +259,7 @@ class Properties:
         if not self._vertex_or_edge.is_valid():
             raise InvalidContextError()
         if self._len is None:
-            self._len = sum(1 for item in self.items())
+            self._len = len(self._vertex_or_edge.get_properties())
         return self._len
 
     def __iter__(self) -> typing.Iterable[str]:
@@ -789,6 +786,31 @@ class Vertices:
         return self._len
 
 
+class GraphProjection:
+    """
+    Compressed sparse row (CSR) projection of a graph.
+
+    Vertices are numbered from 0 in the ascending order of their IDs. The
+    outgoing neighbors of the vertex at index `i` are
+    `neighbors[offsets[i]:offsets[i + 1]]` and the weights of the matching
+    edges are at the same positions in `weights`. All arrays are read-only
+    memoryviews which are valid after the procedure finishes.
+    """
+    __slots__ = ('vertex_ids', 'offsets', 'neighbors', 'weights')
+
+    def __init__(self, vertex_ids: memoryview, offsets: memoryview,
+                 neighbors: memoryview,
+                 weights: typing.Optional[memoryview]):
+        self.vertex_ids = vertex_ids
+        self.offsets = offsets
+        self.neighbors = neighbors
+        self.weights = weights
+
+    def __len__(self) -> int:
+        """Get the number of projected vertices."""
+        return len(self.vertex_ids)
+
+
 class Graph:
     """State of the graph database in current ProcCtx."""
     __slots__ = ('_graph',)
@@ -840,6 +862,29 @@ class Graph:
             raise InvalidContextError()
         return Vertices(self._graph)
 
+    def project(self, label: typing.Optional[str] = None,
+                edge_type: typing.Optional[str] = None,
+                weight_property: typing.Optional[str] = None
+                ) -> GraphProjection:
+        """
+        Build a GraphProjection of vertices with `label` and of edges with
+        `edge_type` between them. If `label` or `edge_type` is None, all
+        vertices or edges are projected. If `weight_property` is given, edge
+        weights are read from it; edges without a numeric value get weight 1.
+
+        Raise InvalidContextError if context is invalid.
+        Raise UnableToAllocateError if unable to allocate the projection.
+        """
+        if not self.is_valid():
+            raise InvalidContextError()
+        vertex_ids, offsets, neighbors, weights = self._graph.project(
+            label, edge_type, weight_property)
+        return GraphProjection(
+            memoryview(vertex_ids).cast('q'),
+            memoryview(offsets).cast('N'),
+            memoryview(neighbors).cast('N'),
+            memoryview(weights).cast('d') if weights is not None else None)
+
     def is_mutable(self) -> bool:
         """
         Return True if `self` represents a mutable graph, thus it can be
@@ -1113,16 +1158,21 @@ def raise_if_does_not_meet_requirements(func: typing.Callable[..., Record]):
     if sys.version_info >= (3, 6):
         if inspect.isasyncgenfunction(func):
             raise TypeError("Callable must not be 'async def' function")
-    if inspect.isgeneratorfunction(func):
-        raise NotImplementedError("Generator functions are not supported")
 
 
 def _register_proc(func: typing.Callable[..., Record],
                    is_write: bool):
     raise_if_does_not_meet_requirements(func)
-    register_func = (
-        _mgp.Module.add_write_procedure if is_write
-        else _mgp.Module.add_read_procedure)
+    # Records of generator functions are consumed in batches while they are
+    # being yielded, instead of collecting all of them first.
+    if inspect.isgeneratorfunction(func):
+        register_func = (
+            _mgp.Module.add_batch_write_procedure if is_write
+            else _mgp.Module.add_batch_read_procedure)
+    else:
+        register_func = (
+            _mgp.Module.add_write_procedure if is_write
+            else _mgp.Module.add_read_procedure)
     sig = inspect.signature(func)
     params = tuple(sig.parameters.values())
     if params and params[0].annotation is ProcCtx:
@@ -1172,8 +1222,9 @@ def read_proc(func: typing.Callable[..., Record]):
     `Record(field_name=type, ...)` and the procedure must produce either a
     complete Record or None. To mark a field as deprecated, use
     `Record(field_name=Deprecated(type), ...)`. Multiple records can be
-    produced by returning an iterable of them. Registering generator functions
-    is currently not supported.
+    produced by returning an iterable of them. A generator function may also
+    be registered, in which case the yielded records are passed on in batches
+    while the generator is running, without keeping all of them in memory.
 
     Example usage.
 
@@ -1215,8 +1266,9 @@ def write_proc(func: typing.Callable[..., Record]):
     `Record(field_name=type, ...)` and the procedure must produce either a
     complete Record or None. To mark a field as deprecated, use
     `Record(field_name=Deprecated(type), ...)`. Multiple records can be
-    produced by returning an iterable of them. Registering generator functions
-    is currently not supported.
+    produced by returning an iterable of them. A generator function may also
+    be registered, in which case the yielded records are passed on in batches
+    while the generator is running, without keeping all of them in memory.
 
     Example usage.
 
@@ -1366,6 +1418,8 @@ class TransCtx:
 
 def transformation(func: typing.Callable[..., Record]):
     raise_if_does_not_meet_requirements(func)
+    if inspect.isgeneratorfunction(func):
+        raise NotImplementedError("Generator functions are not supported")
     sig = inspect.signature(func)
     params = tuple(sig.parameters.values())
     if not params or not params[0].annotation is Messages:
@@ -0,0 +1,789 @@
+// Native implementations of common graph algorithms.
+//
+// The algorithms run on a compressed sparse row projection of the graph
+// (see mgp_graph_project) and are parallelized over all available cores.
+// Each procedure takes two optional arguments, `label` and `edge_type`, which
+// restrict the algorithm to the vertices with the given label and to the
+// edges of the given type between them. Results are streamed in batches, one
+// record per projected vertex.
+//
+// Example usage:
+//   CALL graph_algorithms.pagerank() YIELD node, rank;
+//   CALL graph_algorithms.weakly_connected_components('Person', 'KNOWS')
+//   YIELD node, component_id;
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "mg_procedure.h"
+
+namespace {
+
+constexpr size_t kBatchSize = 1000;
+// Number of vertices a worker claims at once in Workers::ParallelFor.
+constexpr size_t kParallelChunkSize = 1024;
+
+class AlgorithmError final : public std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+void CheckError(mgp_error error, const char *message) {
+  if (error != MGP_ERROR_NO_ERROR) throw AlgorithmError(message);
+}
+
+size_t ThreadCount() { return std::max(1U, std::thread::hardware_concurrency()); }
+
+// Threads that run the parallel loops of a single procedure call. They are
+// started once per call and wait for the next loop in between, so that the
+// iterations of an algorithm don't start new threads.
+class Workers final {
+ public:
+  Workers() : thread_count_(ThreadCount()) {
+    threads_.reserve(thread_count_ - 1);
+    for (size_t thread_index = 1; thread_index < thread_count_; ++thread_index) {
+      threads_.emplace_back([this, thread_index] { Work(thread_index); });
+    }
+  }
+
+  Workers(const Workers &) = delete;
+  Workers(Workers &&) = delete;
+  Workers &operator=(const Workers &) = delete;
+  Workers &operator=(Workers &&) = delete;
+
+  ~Workers() {
+    {
+      std::lock_guard guard(mutex_);
+      stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &thread : threads_) thread.join();
+  }
+
+  // Number of threads, including the calling one. Thread indices passed to the
+  // loops are smaller than it.
+  size_t Count() const { return thread_count_; }
+
+  // Calls `func(thread_index, i)` for every `i` in [0, count). Work is handed
+  // out in chunks, so that threads which get cheap vertices take over more of
+  // them. The calling thread is one of the workers.
+  template <class TFunc>
+  void ParallelFor(size_t count, TFunc &&func) {
+    const auto loop_threads = std::min(thread_count_, (count + kParallelChunkSize - 1) / kParallelChunkSize);
+    if (loop_threads <= 1) {
+      for (size_t i = 0; i < count; ++i) func(0, i);
+      return;
+    }
+    std::atomic<size_t> next_chunk{0};
+    std::vector<std::exception_ptr> exceptions(loop_threads);
+    const std::function<void(size_t)> loop = [&](size_t thread_index) {
+      try {
+        while (true) {
+          const auto begin = next_chunk.fetch_add(kParallelChunkSize, std::memory_order_relaxed);
+          if (begin >= count) return;
+          const auto end = std::min(count, begin + kParallelChunkSize);
+          for (size_t i = begin; i < end; ++i) func(thread_index, i);
+        }
+      } catch (...) {
+        exceptions[thread_index] = std::current_exception();
+      }
+    };
+    {
+      std::lock_guard guard(mutex_);
+      loop_ = &loop;
+      loop_threads_ = loop_threads;
+      running_ = loop_threads - 1;
+      ++generation_;
+    }
+    start_cv_.notify_all();
+    loop(0);
+    {
+      std::unique_lock guard(mutex_);
+      done_cv_.wait(guard, [this] { return running_ == 0; });
+      loop_ = nullptr;
+    }
+    for (const auto &exception : exceptions) {
+      if (exception) std::rethrow_exception(exception);
+    }
+  }
+
+ private:
+  void Work(size_t thread_index) {
+    uint64_t seen_generation = 0;
+    std::unique_lock guard(mutex_);
+    while (true) {
+      start_cv_.wait(guard, [&] { return stop_ || generation_ != seen_generation; });
+      if (stop_) return;
+      seen_generation = generation_;
+      // Small loops don't use all of the threads. A thread that takes part in
+      // a loop can't miss it, because the next loop starts only after all of
+      // them finished.
+      if (thread_index >= loop_threads_) continue;
+      const auto *loop = loop_;
+      guard.unlock();
+      (*loop)(thread_index);
+      guard.lock();
+      if (--running_ == 0) done_cv_.notify_one();
+    }
+  }
+
+  size_t thread_count_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  bool stop_{false};
+  uint64_t generation_{0};
+  const std::function<void(size_t)> *loop_{nullptr};
+  size_t loop_threads_{0};
+  size_t running_{0};
+};
+
+// Adjacency of the projected graph in both directions. Vertices are identified
+// by their indices in the projection.
+struct Graph {
+  size_t vertices_count{0};
+  const size_t *out_offsets{nullptr};
+  const size_t *out_neighbors{nullptr};
+  std::vector<size_t> in_offsets;
+  std::vector<size_t> in_neighbors;
+
+  size_t OutDegree(size_t v) const { return out_offsets[v + 1] - out_offsets[v]; }
+
+  template <class TFunc>
+  void ForEachOut(size_t v, TFunc &&func) const {
+    for (auto i = out_offsets[v]; i < out_offsets[v + 1]; ++i) func(out_neighbors[i]);
+  }
+
+  template <class TFunc>
+  void ForEachIn(size_t v, TFunc &&func) const {
+    for (auto i = in_offsets[v]; i < in_offsets[v + 1]; ++i) func(in_neighbors[i]);
+  }
+};
+
+Graph MakeGraph(mgp_graph_projection *projection) {
+  Graph graph;
+  CheckError(mgp_graph_projection_vertices_count(projection, &graph.vertices_count), "Unable to read the projection.");
+  CheckError(mgp_graph_projection_offsets(projection, &graph.out_offsets), "Unable to read the projection.");
+  CheckError(mgp_graph_projection_neighbors(projection, &graph.out_neighbors), "Unable to read the projection.");
+
+  const auto n = graph.vertices_count;
+  graph.in_offsets.assign(n + 1, 0);
+  for (size_t i = 0; i < graph.out_offsets[n]; ++i) ++graph.in_offsets[graph.out_neighbors[i] + 1];
+  std::partial_sum(graph.in_offsets.begin(), graph.in_offsets.end(), graph.in_offsets.begin());
+  graph.in_neighbors.resize(graph.out_offsets[n]);
+  std::vector<size_t> positions(graph.in_offsets.begin(), graph.in_offsets.end() - 1);
+  for (size_t v = 0; v < n; ++v) {
+    graph.ForEachOut(v, [&](size_t to) { graph.in_neighbors[positions[to]++] = v; });
+  }
+  return graph;
+}
+
+/// PageRank
+
+std::vector<double> PageRank(const Graph &graph, Workers &workers, mgp_graph *memgraph_graph, double damping_factor,
+                             int64_t max_iterations, double tolerance) {
+  const auto n = graph.vertices_count;
+  if (n == 0) return {};
+  const auto thread_count = workers.Count();
+  std::vector<double> rank(n, 1.0 / static_cast<double>(n));
+  std::vector<double> next_rank(n);
+  std::vector<double> contribution(n);
+  std::vector<double> dangling_sums(thread_count);
+  std::vector<double> errors(thread_count);
+  for (int64_t iteration = 0; iteration < max_iterations; ++iteration) {
+    if (mgp_must_abort(memgraph_graph)) throw AlgorithmError("The procedure was aborted.");
+    std::fill(dangling_sums.begin(), dangling_sums.end(), 0.0);
+    workers.ParallelFor(n, [&](size_t thread_index, size_t v) {
+      const auto degree = graph.OutDegree(v);
+      if (degree == 0) {
+        dangling_sums[thread_index] += rank[v];
+        contribution[v] = 0.0;
+      } else {
+        contribution[v] = rank[v] / static_cast<double>(degree);
+      }
+    });
+    const auto dangling_sum = std::accumulate(dangling_sums.begin(), dangling_sums.end(), 0.0);
+    const auto base = (1.0 - damping_factor + damping_factor * dangling_sum) / static_cast<double>(n);
+    std::fill(errors.begin(), errors.end(), 0.0);
+    workers.ParallelFor(n, [&](size_t thread_index, size_t v) {
+      double sum = 0.0;
+      graph.ForEachIn(v, [&](size_t from) { sum += contribution[from]; });
+      next_rank[v] = base + damping_factor * sum;
+      errors[thread_index] += std::abs(next_rank[v] - rank[v]);
+    });
+    rank.swap(next_rank);
+    if (std::accumulate(errors.begin(), errors.end(), 0.0) < static_cast<double>(n) * tolerance) break;
+  }
+  return rank;
+}
+
+/// Weakly connected components
+
+// Find and Union of a concurrent disjoint set, where a root is always linked
+// under a root with a smaller index.
+size_t Find(std::vector<std::atomic<size_t>> &parent, size_t v) {
+  while (true) {
+    auto p = parent[v].load(std::memory_order_relaxed);
+    if (p == v) return v;
+    const auto grandparent = parent[p].load(std::memory_order_relaxed);
+    if (grandparent != p) parent[v].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+    v = grandparent;
+  }
+}
+
+void Union(std::vector<std::atomic<size_t>> &parent, size_t u, size_t v) {
+  while (true) {
+    u = Find(parent, u);
+    v = Find(parent, v);
+    if (u == v) return;
+    if (u < v) std::swap(u, v);
+    auto expected = u;
+    if (parent[u].compare_exchange_strong(expected, v, std::memory_order_relaxed)) return;
+  }
+}
+
+// Each vertex gets the index of the smallest vertex in its component.
+std::vector<int64_t> WeaklyConnectedComponents(const Graph &graph, Workers &workers) {
+  const auto n = graph.vertices_count;
+  std::vector<std::atomic<size_t>> parent(n);
+  workers.ParallelFor(n, [&](size_t, size_t v) { parent[v].store(v, std::memory_order_relaxed); });
+  workers.ParallelFor(n, [&](size_t, size_t v) { graph.ForEachOut(v, [&](size_t to) { Union(parent, v, to); }); });
+  std::vector<int64_t> components(n);
+  workers.ParallelFor(n, [&](size_t, size_t v) { components[v] = static_cast<int64_t>(Find(parent, v)); });
+  return components;
+}
+
+/// Strongly connected components
+
+// Iterative Tarjan's algorithm. It is inherently sequential, but it runs in
+// linear time. Each vertex gets the index of the smallest vertex in its
+// component.
+std::vector<int64_t> StronglyConnectedComponents(const Graph &graph, Workers &) {
+  constexpr auto kUnvisited = std::numeric_limits<size_t>::max();
+  const auto n = graph.vertices_count;
+  std::vector<size_t> index(n, kUnvisited);
+  std::vector<size_t> low_link(n);
+  std::vector<bool> on_stack(n, false);
+  std::vector<size_t> stack;
+  std::vector<int64_t> components(n);
+  // Pairs of a vertex and the position of the next out edge to visit.
+  std::vector<std::pair<size_t, size_t>> call_stack;
+  size_t next_index = 0;
+  for (size_t root = 0; root < n; ++root) {
+    if (index[root] != kUnvisited) continue;
+    call_stack.emplace_back(root, graph.out_offsets[root]);
+    index[root] = low_link[root] = next_index++;
+    stack.push_back(root);
+    on_stack[root] = true;
+    while (!call_stack.empty()) {
+      auto &[v, edge] = call_stack.back();
+      if (edge < graph.out_offsets[v + 1]) {
+        const auto to = graph.out_neighbors[edge++];
+        if (index[to] == kUnvisited) {
+          index[to] = low_link[to] = next_index++;
+          stack.push_back(to);
+          on_stack[to] = true;
+          call_stack.emplace_back(to, graph.out_offsets[to]);
+        } else if (on_stack[to]) {
+          low_link[v] = std::min(low_link[v], index[to]);
+        }
+        continue;
+      }
+      const auto finished = v;
+      call_stack.pop_back();
+      if (!call_stack.empty()) {
+        auto &parent = call_stack.back().first;
+        low_link[parent] = std::min(low_link[parent], low_link[finished]);
+      }
+      if (low_link[finished] != index[finished]) continue;
+      const auto component_begin = std::find(stack.rbegin(), stack.rend(), finished).base() - 1;
+      const auto smallest = *std::min_element(component_begin, stack.end());
+      for (auto it = component_begin; it != stack.end(); ++it) {
+        on_stack[*it] = false;
+        components[*it] = static_cast<int64_t>(smallest);
+      }
+      stack.erase(component_begin, stack.end());
+    }
+  }
+  return components;
+}
+
+/// Label propagation
+
+// Synchronous label propagation over the undirected graph. A vertex takes the
+// most frequent label among itself and its neighbors, preferring the smallest
+// label on ties. Each vertex gets the index of the vertex whose label it ended
+// up with.
+std::vector<int64_t> LabelPropagation(const Graph &graph, Workers &workers, mgp_graph *memgraph_graph,
+                                      int64_t max_iterations) {
+  const auto n = graph.vertices_count;
+  std::vector<int64_t> labels(n);
+  std::iota(labels.begin(), labels.end(), 0);
+  std::vector<int64_t> next_labels(n);
+  std::vector<std::vector<int64_t>> neighbor_labels(workers.Count());
+  for (int64_t iteration = 0; iteration < max_iterations; ++iteration) {
+    if (mgp_must_abort(memgraph_graph)) throw AlgorithmError("The procedure was aborted.");
+    std::atomic<bool> changed{false};
+    workers.ParallelFor(n, [&](size_t thread_index, size_t v) {
+      auto &candidates = neighbor_labels[thread_index];
+      candidates.clear();
+      candidates.push_back(labels[v]);
+      graph.ForEachOut(v, [&](size_t to) { candidates.push_back(labels[to]); });
+      graph.ForEachIn(v, [&](size_t from) { candidates.push_back(labels[from]); });
+      std::sort(candidates.begin(), candidates.end());
+      auto best_label = candidates.front();
+      size_t best_count = 0;
+      for (auto it = candidates.begin(); it != candidates.end();) {
+        const auto run_end = std::upper_bound(it, candidates.end(), *it);
+        const auto count = static_cast<size_t>(run_end - it);
+        if (count > best_count) {
+          best_label = *it;
+          best_count = count;
+        }
+        it = run_end;
+      }
+      next_labels[v] = best_label;
+      if (best_label != labels[v]) changed.store(true, std::memory_order_relaxed);
+    });
+    labels.swap(next_labels);
+    if (!changed.load()) break;
+  }
+  return labels;
+}
+
+/// Betweenness centrality
+
+// Brandes' algorithm on the unweighted directed graph, parallelized over the
+// source vertices. If `samples` is positive, only that many randomly chosen
+// source vertices are used and the result is extrapolated from them.
+std::vector<double> BetweennessCentrality(const Graph &graph, Workers &workers, mgp_graph *memgraph_graph,
+                                          int64_t samples, bool normalized, int64_t seed) {
+  const auto n = graph.vertices_count;
+  std::vector<size_t> sources(n);
+  std::iota(sources.begin(), sources.end(), 0);
+  if (samples > 0 && static_cast<size_t>(samples) < n) {
+    std::mt19937_64 generator(static_cast<uint64_t>(seed));
+    for (size_t i = 0; i < static_cast<size_t>(samples); ++i) {
+      std::uniform_int_distribution<size_t> distribution(i, n - 1);
+      std::swap(sources[i], sources[distribution(generator)]);
+    }
+    sources.resize(static_cast<size_t>(samples));
+  }
+
+  struct ThreadState {
+    std::vector<double> centrality;
+    std::vector<double> dependency;
+    std::vector<double> paths;
+    std::vector<int64_t> distance;
+    std::vector<size_t> order;
+  };
+  std::vector<ThreadState> states(workers.Count());
+  std::atomic<bool> aborted{false};
+  workers.ParallelFor(sources.size(), [&](size_t thread_index, size_t source_index) {
+    if (aborted.load(std::memory_order_relaxed)) return;
+    auto &state = states[thread_index];
+    if (state.centrality.empty()) {
+      state.centrality.assign(n, 0.0);
+      state.dependency.assign(n, 0.0);
+      state.paths.assign(n, 0.0);
+      state.distance.assign(n, -1);
+    }
+    const auto source = sources[source_index];
+    // BFS which records the visiting order; `order` doubles as the queue.
+    state.order.clear();
+    state.order.push_back(source);
+    state.paths[source] = 1.0;
+    state.distance[source] = 0;
+    for (size_t head = 0; head < state.order.size(); ++head) {
+      const auto v = state.order[head];
+      graph.ForEachOut(v, [&](size_t to) {
+        if (state.distance[to] < 0) {
+          state.distance[to] = state.distance[v] + 1;
+          state.order.push_back(to);
+        }
+        if (state.distance[to] == state.distance[v] + 1) state.paths[to] += state.paths[v];
+      });
+    }
+    for (auto it = state.order.rbegin(); it != state.order.rend(); ++it) {
+      const auto v = *it;
+      graph.ForEachOut(v, [&](size_t to) {
+        if (state.distance[to] == state.distance[v] + 1) {
+          state.dependency[v] += state.paths[v] / state.paths[to] * (1.0 + state.dependency[to]);
+        }
+      });
+      if (v != source) state.centrality[v] += state.dependency[v];
+    }
+    for (const auto v : state.order) {
+      state.dependency[v] = 0.0;
+      state.paths[v] = 0.0;
+      state.distance[v] = -1;
+    }
+    if (thread_index == 0 && mgp_must_abort(memgraph_graph)) aborted.store(true, std::memory_order_relaxed);
+  });
+  if (aborted.load()) throw AlgorithmError("The procedure was aborted.");
+
+  std::vector<double> centrality(n, 0.0);
+  workers.ParallelFor(n, [&](size_t, size_t v) {
+    for (const auto &state : states) {
+      if (!state.centrality.empty()) centrality[v] += state.centrality[v];
+    }
+  });
+  double scale = 1.0;
+  if (normalized) {
+    scale = n > 2 ? 1.0 / (static_cast<double>(n - 1) * static_cast<double>(n - 2)) : 1.0;
+  }
+  if (!sources.empty() && sources.size() < n) {
+    scale *= static_cast<double>(n) / static_cast<double>(sources.size());
+  }
+  for (auto &value : centrality) value *= scale;
+  return centrality;
+}
+
+/// Triangle counting
+
+// Counts the triangles each vertex belongs to in the undirected simple graph,
+// ignoring edge directions, self-loops and parallel edges. Every triangle is
+// found once, from its vertex with the lowest (degree, index) order.
+std::vector<int64_t> TriangleCount(const Graph &graph, Workers &workers) {
+  const auto n = graph.vertices_count;
+  std::vector<std::vector<size_t>> neighbors(n);
+  workers.ParallelFor(n, [&](size_t, size_t v) {
+    auto &adjacent = neighbors[v];
+    adjacent.reserve(graph.OutDegree(v) + graph.in_offsets[v + 1] - graph.in_offsets[v]);
+    graph.ForEachOut(v, [&](size_t to) { adjacent.push_back(to); });
+    graph.ForEachIn(v, [&](size_t from) { adjacent.push_back(from); });
+    std::sort(adjacent.begin(), adjacent.end());
+    adjacent.erase(std::unique(adjacent.begin(), adjacent.end()), adjacent.end());
+    adjacent.erase(std::remove(adjacent.begin(), adjacent.end(), v), adjacent.end());
+  });
+  auto precedes = [&](size_t u, size_t v) {
+    const auto u_degree = neighbors[u].size();
+    const auto v_degree = neighbors[v].size();
+    return u_degree < v_degree || (u_degree == v_degree && u < v);
+  };
+  // Keep only the neighbors which come later in the order, they stay sorted by
+  // index.
+  std::vector<std::vector<size_t>> forward(n);
+  workers.ParallelFor(n, [&](size_t, size_t v) {
+    for (const auto to : neighbors[v]) {
+      if (precedes(v, to)) forward[v].push_back(to);
+    }
+  });
+  std::vector<std::atomic<int64_t>> triangles(n);
+  workers.ParallelFor(n, [&](size_t, size_t v) { triangles[v].store(0, std::memory_order_relaxed); });
+  workers.ParallelFor(n, [&](size_t, size_t u) {
+    for (const auto v : forward[u]) {
+      auto u_it = forward[u].begin();
+      auto v_it = forward[v].begin();
+      while (u_it != forward[u].end() && v_it != forward[v].end()) {
+        if (*u_it < *v_it) {
+          ++u_it;
+        } else if (*v_it < *u_it) {
+          ++v_it;
+        } else {
+          triangles[u].fetch_add(1, std::memory_order_relaxed);
+          triangles[v].fetch_add(1, std::memory_order_relaxed);
+          triangles[*u_it].fetch_add(1, std::memory_order_relaxed);
+          ++u_it;
+          ++v_it;
+        }
+      }
+    }
+  });
+  std::vector<int64_t> result(n);
+  for (size_t v = 0; v < n; ++v) result[v] = triangles[v].load(std::memory_order_relaxed);
+  return result;
+}
+
+/// Procedure plumbing
+
+// State of a single procedure call. The algorithm runs in the initializer and
+// the batch callback streams its results.
+struct AlgorithmCall {
+  mgp_graph_projection *projection{nullptr};
+  const char *result_field{nullptr};
+  // Values of integer results which are vertex indices are reported as the IDs
+  // of those vertices.
+  bool values_are_vertices{false};
+  std::variant<std::vector<int64_t>, std::vector<double>> values;
+  size_t next{0};
+  std::string error;
+
+  ~AlgorithmCall() {
+    if (projection) mgp_graph_projection_destroy(projection);
+  }
+};
+
+mgp_value *GetArg(mgp_list *args, size_t index) {
+  mgp_value *value{nullptr};
+  CheckError(mgp_list_at(args, index, &value), "Unable to read the procedure arguments.");
+  return value;
+}
+
+const char *GetNullableString(mgp_list *args, size_t index) {
+  auto *value = GetArg(args, index);
+  int is_null{0};
+  CheckError(mgp_value_is_null(value, &is_null), "Unable to read the procedure arguments.");
+  if (is_null) return nullptr;
+  const char *result{nullptr};
+  CheckError(mgp_value_get_string(value, &result), "Unable to read the procedure arguments.");
+  return result;
+}
+
+int64_t GetInt(mgp_list *args, size_t index) {
+  int64_t result{0};
+  CheckError(mgp_value_get_int(GetArg(args, index), &result), "Unable to read the procedure arguments.");
+  return result;
+}
+
+double GetNumber(mgp_list *args, size_t index) {
+  auto *value = GetArg(args, index);
+  int is_int{0};
+  CheckError(mgp_value_is_int(value, &is_int), "Unable to read the procedure arguments.");
+  if (is_int) return static_cast<double>(GetInt(args, index));
+  double result{0.0};
+  CheckError(mgp_value_get_double(value, &result), "Unable to read the procedure arguments.");
+  return result;
+}
+
+bool GetBool(mgp_list *args, size_t index) {
+  int result{0};
+  CheckError(mgp_value_get_bool(GetArg(args, index), &result), "Unable to read the procedure arguments.");
+  return result != 0;
+}
+
+// Projects the graph using the `label` and `edge_type` arguments, which are
+// always the first two, and runs `algorithm` on it with the worker threads of
+// this call.
+template <class TAlgorithm>
+void *RunAlgorithm(mgp_list *args, mgp_graph *graph, mgp_memory *memory, const char *result_field,
+                   bool values_are_vertices, TAlgorithm &&algorithm) {
+  AlgorithmCall *call{nullptr};
+  try {
+    call = new AlgorithmCall();
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+  call->result_field = result_field;
+  call->values_are_vertices = values_are_vertices;
+  try {
+    CheckError(mgp_graph_project(graph, GetNullableString(args, 0), GetNullableString(args, 1), nullptr, memory,
+                                 &call->projection),
+               "Unable to project the graph.");
+    Workers workers;
+    call->values = algorithm(MakeGraph(call->projection), workers);
+  } catch (const AlgorithmError &e) {
+    call->error = e.what();
+  } catch (const std::bad_alloc &) {
+    call->error = "Not enough memory to run the algorithm.";
+  } catch (const std::exception &e) {
+    call->error = e.what();
+  }
+  return call;
+}
+
+void InsertVertexId(mgp_graph_projection *projection, size_t index, mgp_memory *memory, mgp_result_record *record,
+                    const char *field) {
+  mgp_vertex_id id{};
+  CheckError(mgp_graph_projection_vertex_id(projection, index, &id), "Unable to read the projection.");
+  mgp_value *value{nullptr};
+  CheckError(mgp_value_make_int(id.as_int, memory, &value), "Unable to allocate a result value.");
+  const auto error = mgp_result_record_insert(record, field, value);
+  mgp_value_destroy(value);
+  CheckError(error, "Unable to insert a result value.");
+}
+
+void InsertResult(AlgorithmCall &call, size_t index, mgp_graph *graph, mgp_result *result, mgp_memory *memory) {
+  mgp_vertex_id id{};
+  CheckError(mgp_graph_projection_vertex_id(call.projection, index, &id), "Unable to read the projection.");
+  mgp_vertex *vertex{nullptr};
+  CheckError(mgp_graph_get_vertex_by_id(graph, id, memory, &vertex), "Unable to retrieve a vertex.");
+  // The vertex was deleted by the query meanwhile.
+  if (!vertex) return;
+  mgp_value *vertex_value{nullptr};
+  if (mgp_value_make_vertex(vertex, &vertex_value) != MGP_ERROR_NO_ERROR) {
+    mgp_vertex_destroy(vertex);
+    throw AlgorithmError("Unable to allocate a result value.");
+  }
+  mgp_result_record *record{nullptr};
+  auto error = mgp_result_new_record(result, &record);
+  if (error == MGP_ERROR_NO_ERROR) error = mgp_result_record_insert(record, "node", vertex_value);
+  mgp_value_destroy(vertex_value);
+  CheckError(error, "Unable to insert a result record.");
+
+  if (const auto *ints = std::get_if<std::vector<int64_t>>(&call.values)) {
+    if (call.values_are_vertices) {
+      InsertVertexId(call.projection, static_cast<size_t>((*ints)[index]), memory, record, call.result_field);
+      return;
+    }
+    mgp_value *value{nullptr};
+    CheckError(mgp_value_make_int((*ints)[index], memory, &value), "Unable to allocate a result value.");
+    error = mgp_result_record_insert(record, call.result_field, value);
+    mgp_value_destroy(value);
+  } else {
+    mgp_value *value{nullptr};
+    CheckError(mgp_value_make_double(std::get<std::vector<double>>(call.values)[index], memory, &value),
+               "Unable to allocate a result value.");
+    error = mgp_result_record_insert(record, call.result_field, value);
+    mgp_value_destroy(value);
+  }
+  CheckError(error, "Unable to insert a result value.");
+}
+
+void StreamResults(void *state, mgp_graph *graph, mgp_result *result, mgp_memory *memory) {
+  auto *call = static_cast<AlgorithmCall *>(state);
+  if (!call) {
+    static_cast<void>(mgp_result_set_error_msg(result, "Not enough memory to run the algorithm."));
+    return;
+  }
+  if (!call->error.empty()) {
+    static_cast<void>(mgp_result_set_error_msg(result, call->error.c_str()));
+    return;
+  }
+  const auto count = std::visit([](const auto &values) { return values.size(); }, call->values);
+  const auto end = std::min(count, call->next + kBatchSize);
+  try {
+    for (; call->next < end; ++call->next) InsertResult(*call, call->next, graph, result, memory);
+  } catch (const std::exception &e) {
+    static_cast<void>(mgp_result_set_error_msg(result, e.what()));
+  }
+}
+
+void CleanupCall(void *state) { delete static_cast<AlgorithmCall *>(state); }
+
+/// Procedures
+
+void *PageRankCall(mgp_list *args, mgp_graph *graph, mgp_memory *memory) {
+  return RunAlgorithm(args, graph, memory, "rank", false, [&](const Graph &projected, Workers &workers) {
+    return PageRank(projected, workers, graph, GetNumber(args, 2), GetInt(args, 3), GetNumber(args, 4));
+  });
+}
+
+void *WeaklyConnectedComponentsCall(mgp_list *args, mgp_graph *graph, mgp_memory *memory) {
+  return RunAlgorithm(args, graph, memory, "component_id", true, WeaklyConnectedComponents);
+}
+
+void *StronglyConnectedComponentsCall(mgp_list *args, mgp_graph *graph, mgp_memory *memory) {
+  return RunAlgorithm(args, graph, memory, "component_id", true, StronglyConnectedComponents);
+}
+
+void *LabelPropagationCall(mgp_list *args, mgp_graph *graph, mgp_memory *memory) {
+  return RunAlgorithm(args, graph, memory, "community_id", true,
+                      [&](const Graph &projected, Workers &workers) {
+                        return LabelPropagation(projected, workers, graph, GetInt(args, 2));
+                      });
+}
+
+void *BetweennessCentralityCall(mgp_list *args, mgp_graph *graph, mgp_memory *memory) {
+  return RunAlgorithm(args, graph, memory, "betweenness", false, [&](const Graph &projected, Workers &workers) {
+    return BetweennessCentrality(projected, workers, graph, GetInt(args, 2), GetBool(args, 3), GetInt(args, 4));
+  });
+}
+
+void *TriangleCountCall(mgp_list *args, mgp_graph *graph, mgp_memory *memory) {
+  return RunAlgorithm(args, graph, memory, "triangles", false, TriangleCount);
+}
+
+mgp_type *GetType(mgp_error (*type_getter)(mgp_type **)) {
+  mgp_type *type{nullptr};
+  CheckError(type_getter(&type), "Unable to get a type.");
+  return type;
+}
+
+template <class TMakeValue>
+void AddOptArg(mgp_proc *proc, const char *name, mgp_type *type, mgp_memory *memory, TMakeValue &&make_value) {
+  mgp_value *default_value{nullptr};
+  CheckError(make_value(memory, &default_value), "Unable to allocate a default value.");
+  const auto error = mgp_proc_add_opt_arg(proc, name, type, default_value);
+  mgp_value_destroy(default_value);
+  CheckError(error, "Unable to add an argument.");
+}
+
+// Registers a procedure with the common `label` and `edge_type` arguments and
+// the `node` result.
+mgp_proc *AddProcedure(mgp_module *module, const char *name, mgp_batch_proc_initializer initializer,
+                       mgp_memory *memory) {
+  mgp_proc *proc{nullptr};
+  CheckError(mgp_module_add_batch_read_procedure(module, name, initializer, StreamResults, CleanupCall, &proc),
+             "Unable to add a procedure.");
+  mgp_type *nullable_string{nullptr};
+  CheckError(mgp_type_nullable(GetType(mgp_type_string), &nullable_string), "Unable to get a type.");
+  AddOptArg(proc, "label", nullable_string, memory, mgp_value_make_null);
+  AddOptArg(proc, "edge_type", nullable_string, memory, mgp_value_make_null);
+  CheckError(mgp_proc_add_result(proc, "node", GetType(mgp_type_node)), "Unable to add a result.");
+  return proc;
+}
+
+void AddResult(mgp_proc *proc, const char *name, mgp_error (*type_getter)(mgp_type **)) {
+  CheckError(mgp_proc_add_result(proc, name, GetType(type_getter)), "Unable to add a result.");
+}
+
+auto MakeInt(int64_t value) {
+  return [value](mgp_memory *memory, mgp_value **result) { return mgp_value_make_int(value, memory, result); };
+}
+
+auto MakeDouble(double value) {
+  return [value](mgp_memory *memory, mgp_value **result) { return mgp_value_make_double(value, memory, result); };
+}
+
+auto MakeBool(bool value) {
+  return [value](mgp_memory *memory, mgp_value **result) { return mgp_value_make_bool(value, memory, result); };
+}
+
+}  // namespace
+
+extern "C" int mgp_init_module(struct mgp_module *module, struct mgp_memory *memory) {
+  try {
+    {
+      auto *proc = AddProcedure(module, "pagerank", PageRankCall, memory);
+      AddOptArg(proc, "damping_factor", GetType(mgp_type_number), memory, MakeDouble(0.85));
+      AddOptArg(proc, "max_iterations", GetType(mgp_type_int), memory, MakeInt(100));
+      AddOptArg(proc, "tolerance", GetType(mgp_type_number), memory, MakeDouble(1e-6));
+      AddResult(proc, "rank", mgp_type_float);
+    }
+    {
+      auto *proc = AddProcedure(module, "weakly_connected_components", WeaklyConnectedComponentsCall, memory);
+      AddResult(proc, "component_id", mgp_type_int);
+    }
+    {
+      auto *proc = AddProcedure(module, "strongly_connected_components", StronglyConnectedComponentsCall, memory);
+      AddResult(proc, "component_id", mgp_type_int);
+    }
+    {
+      auto *proc = AddProcedure(module, "label_propagation", LabelPropagationCall, memory);
+      AddOptArg(proc, "max_iterations", GetType(mgp_type_int), memory, MakeInt(10));
+      AddResult(proc, "community_id", mgp_type_int);
+    }
+    {
+      auto *proc = AddProcedure(module, "betweenness_centrality", BetweennessCentralityCall, memory);
+      AddOptArg(proc, "samples", GetType(mgp_type_int), memory, MakeInt(0));
+      AddOptArg(proc, "normalized", GetType(mgp_type_bool), memory, MakeBool(true));
+      AddOptArg(proc, "seed", GetType(mgp_type_int), memory, MakeInt(0));
+      AddResult(proc, "betweenness", mgp_type_float);
+    }
+    {
+      auto *proc = AddProcedure(module, "triangle_count", TriangleCountCall, memory);
+      AddResult(proc, "triangles", mgp_type_int);
+    }
+  } catch (const std::exception &) {
+    return 1;
+  }
+  return 0;
+}
+
+extern "C" int mgp_shutdown_module() { return 0; }
@@ -19,6 +19,7 @@
 #include <fmt/format.h>
 
 #include "communication/bolt/v1/constants.hpp"
+#include "communication/buffer.hpp"
 
 namespace communication::bolt {
 
@@ -47,11 +48,13 @@ enum class ChunkState : uint8_t {
  * the data can then be read. While getting a chunk the buffer checks the
  * chunk for validity and then copies only data from the chunk. The headers
  * aren't copied so that the decoder can read only the raw encoded data.
+ * The chunk data is kept in a pooled `Buffer` that is released once all of it
+ * is read, so an idle buffer doesn't hold any memory.
  */
 template <typename TBuffer>
 class ChunkedDecoderBuffer {
  public:
-  ChunkedDecoderBuffer(TBuffer &buffer) : buffer_(buffer) { data_.reserve(kChunkMaxDataSize); }
+  ChunkedDecoderBuffer(TBuffer &buffer) : buffer_(buffer) {}
 
   /**
    * Reads data from the internal buffer.
@@ -63,11 +66,11 @@ class ChunkedDecoderBuffer {
    */
   bool Read(uint8_t *data, size_t len) {
     if (len > Size()) return false;
-    memcpy(data, &data_[pos_], len);
+    memcpy(data, data_.read_end()->data() + pos_, len);
     pos_ += len;
     if (Size() == 0) {
       pos_ = 0;
-      data_.clear();
+      data_.read_end()->Clear();
     }
     return true;
   }
@@ -84,7 +87,7 @@ class ChunkedDecoderBuffer {
    */
   bool Peek(uint8_t *data, size_t len, size_t offset = 0) {
     if (len + offset > Size()) return false;
-    memcpy(data, &data_[pos_ + offset], len);
+    memcpy(data, data_.read_end()->data() + pos_ + offset, len);
     return true;
   }
 
@@ -118,7 +121,11 @@ class ChunkedDecoderBuffer {
       return ChunkState::Partial;
     }
 
-    std::copy(data + 2, data + chunk_size + 2, std::back_inserter(data_));
+    auto *write_end = data_.write_end();
+    write_end->Resize(data_.read_end()->size() + chunk_size);
+    auto chunk = write_end->Allocate();
+    memcpy(chunk.data, data + 2, chunk_size);
+    write_end->Written(chunk_size);
     buffer_.Shift(chunk_size + 2);
 
     return ChunkState::Whole;
@@ -129,11 +136,11 @@ class ChunkedDecoderBuffer {
    *
    * @returns size of available data
    */
-  size_t Size() { return data_.size() - pos_; }
+  size_t Size() { return data_.read_end()->size() - pos_; }
 
  private:
   TBuffer &buffer_;
-  std::vector<uint8_t> data_;
+  Buffer data_;
   size_t pos_{0};
 };
 }  // namespace communication::bolt
@@ -50,7 +50,19 @@ class Decoder {
       return false;
     }
 
-    Marker marker = (Marker)value;
+    return ReadValue((Marker)value, data);
+  }
+
+  /**
+   * Reads a Value whose marker was already read from the buffer.
+   *
+   * @param marker the marker of the Value
+   * @param data pointer to a Value where the read data should be stored
+   * @returns true if data has been written to the data pointer,
+   *          false otherwise
+   */
+  bool ReadValue(const Marker marker, Value *data) {
+    const uint8_t value = utils::UnderlyingCast(marker);
 
     switch (marker) {
       case Marker::Null:
@@ -305,34 +317,18 @@ class Decoder {
   }
 
   bool ReadString(const Marker &marker, Value *data) {
-    const int kMaxStackBuffer = 8192;
-    uint8_t buffer[kMaxStackBuffer];
     auto size = ReadTypeSize(marker, MarkerString);
     if (size == -1) {
       return false;
     }
-    // Here we use a temporary buffer on the stack to prevent temporary
-    // allocations. Most of strings that are decoded are small so it makes no
-    // sense to allocate a temporary buffer every time we decode a string. This
-    // way we allocate a temporary buffer only when the string is large. This
-    // wouldn't be necessary if we had full C++17 support. In C++17 we could
-    // preallocate the `buffer[size]` in the destination string `*data =
-    // Value(std::string('\0', size))` and just call
-    // `buffer_.Read(data->ValueString().data())`.
-    if (size < kMaxStackBuffer) {
-      if (!buffer_.Read(buffer, size)) {
-        SPDLOG_WARN("[ReadString] Missing data!");
-        return false;
-      }
-      *data = Value(std::string(reinterpret_cast<char *>(buffer), size));
-    } else {
-      std::unique_ptr<uint8_t[]> ret(new uint8_t[size]);
-      if (!buffer_.Read(ret.get(), size)) {
-        SPDLOG_WARN("[ReadString] Missing data!");
-        return false;
-      }
-      *data = Value(std::string(reinterpret_cast<char *>(ret.get()), size));
+    // The string is read directly into its final storage so that large
+    // strings aren't copied through a temporary buffer.
+    std::string ret(size, '\0');
+    if (!buffer_.Read(reinterpret_cast<uint8_t *>(ret.data()), size)) {
+      SPDLOG_WARN("[ReadString] Missing data!");
+      return false;
     }
+    *data = Value(std::move(ret));
     return true;
   }
 
@@ -344,7 +340,18 @@ class Decoder {
     *data = Value(std::vector<Value>(size));
     auto &ret = data->ValueList();
     for (int64_t i = 0; i < size; ++i) {
-      if (!ReadValue(&ret[i])) {
+      // Numeric elements are decoded without going through the generic
+      // marker dispatch because large parameter lists are mostly numeric.
+      uint8_t value;
+      if (!buffer_.Read(&value, 1)) {
+        return false;
+      }
+      const auto element_marker = static_cast<Marker>(value);
+      if (element_marker == Marker::Float64) {
+        if (!ReadDouble(element_marker, &ret[i])) return false;
+      } else if (value >= 240 || value <= 127) {
+        ret[i] = Value(static_cast<int64_t>(value >= 240 ? value - 256 : value));
+      } else if (!ReadValue(element_marker, &ret[i])) {
         return false;
       }
     }
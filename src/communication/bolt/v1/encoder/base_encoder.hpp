@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <type_traits>
 
 #include "communication/bolt/v1/codes.hpp"
@@ -54,21 +56,8 @@ class BaseEncoder {
   }
 
   void WriteInt(const int64_t &value) {
-    if (value >= -16L && value < 128L) {
-      WriteRAW(static_cast<uint8_t>(value));
-    } else if (value >= -128L && value < -16L) {
-      WriteRAW(utils::UnderlyingCast(Marker::Int8));
-      WriteRAW(static_cast<uint8_t>(value));
-    } else if (value >= -32768L && value < 32768L) {
-      WriteRAW(utils::UnderlyingCast(Marker::Int16));
-      WritePrimitiveValue(static_cast<int16_t>(value));
-    } else if (value >= -2147483648L && value < 2147483648L) {
-      WriteRAW(utils::UnderlyingCast(Marker::Int32));
-      WritePrimitiveValue(static_cast<int32_t>(value));
-    } else {
-      WriteRAW(utils::UnderlyingCast(Marker::Int64));
-      WritePrimitiveValue(value);
-    }
+    uint8_t data[kMaxIntSize];
+    WriteRAW(data, EncodeInt(value, data));
   }
 
   void WriteDouble(const double &value) {
@@ -104,6 +93,16 @@ class BaseEncoder {
 
   void WriteList(const std::vector<Value> &value) {
     WriteTypeSize(value.size(), MarkerList);
+    if (value.size() >= kBulkListMinSize) {
+      // Homogeneous numeric lists are encoded in batches so that the buffer is
+      // written to once per batch instead of once per element.
+      const auto type = value.front().type();
+      if ((type == Value::Type::Int || type == Value::Type::Double) &&
+          std::all_of(value.begin(), value.end(), [type](const auto &x) { return x.type() == type; })) {
+        WriteNumericListBody(value, type);
+        return;
+      }
+    }
     for (auto &x : value) WriteValue(x);
   }
 
@@ -266,11 +265,74 @@ class BaseEncoder {
   Buffer &buffer_;
 
  private:
+  // Maximum size of an encoded integer (marker and 8 bytes).
+  static constexpr size_t kMaxIntSize = 9;
+  // Lists shorter than this are encoded element by element.
+  static constexpr size_t kBulkListMinSize = 16;
+  // Size of the stack buffer that batches of list elements are encoded into.
+  static constexpr size_t kBulkBatchSize = 4096;
+
   template <class T>
   void WritePrimitiveValue(T value) {
     value = utils::HostToBigEndian(value);
     WriteRAW(reinterpret_cast<const uint8_t *>(&value), sizeof(value));
   }
+
+  template <class T>
+  static size_t EncodePrimitiveValue(T value, uint8_t *data) {
+    value = utils::HostToBigEndian(value);
+    std::memcpy(data, &value, sizeof(value));
+    return sizeof(value);
+  }
+
+  // Encodes the integer into `data`, which must have at least `kMaxIntSize`
+  // bytes. Returns the number of bytes used.
+  static size_t EncodeInt(const int64_t value, uint8_t *data) {
+    if (value >= -16L && value < 128L) {
+      data[0] = static_cast<uint8_t>(value);
+      return 1;
+    } else if (value >= -128L && value < -16L) {
+      data[0] = utils::UnderlyingCast(Marker::Int8);
+      data[1] = static_cast<uint8_t>(value);
+      return 2;
+    } else if (value >= -32768L && value < 32768L) {
+      data[0] = utils::UnderlyingCast(Marker::Int16);
+      return 1 + EncodePrimitiveValue(static_cast<int16_t>(value), data + 1);
+    } else if (value >= -2147483648L && value < 2147483648L) {
+      data[0] = utils::UnderlyingCast(Marker::Int32);
+      return 1 + EncodePrimitiveValue(static_cast<int32_t>(value), data + 1);
+    } else {
+      data[0] = utils::UnderlyingCast(Marker::Int64);
+      return 1 + EncodePrimitiveValue(value, data + 1);
+    }
+  }
+
+  // Writes the elements of a list in which all values are of the given
+  // numeric type.
+  //
+  // The encoded size isn't calculated up front to reserve the output once.
+  // The session's ChunkedEncoderBuffer holds a single chunk and sends it as
+  // soon as it's full, so there is nothing to reserve, and encoding the whole
+  // list into one buffer would keep the message in memory. The size of the
+  // integers is known only after a pass over the values, so the batch on the
+  // stack bounds the memory and the number of writes instead.
+  void WriteNumericListBody(const std::vector<Value> &value, const Value::Type type) {
+    uint8_t batch[kBulkBatchSize];
+    size_t size = 0;
+    for (const auto &x : value) {
+      if (size + kMaxIntSize > kBulkBatchSize) {
+        WriteRAW(batch, size);
+        size = 0;
+      }
+      if (type == Value::Type::Int) {
+        size += EncodeInt(x.ValueInt(), batch + size);
+      } else {
+        batch[size] = utils::UnderlyingCast(Marker::Float64);
+        size += 1 + EncodePrimitiveValue(utils::MemcpyCast<uint64_t>(x.ValueDouble()), batch + size + 1);
+      }
+    }
+    if (size > 0) WriteRAW(batch, size);
+  }
 };
 
 }  // namespace communication::bolt
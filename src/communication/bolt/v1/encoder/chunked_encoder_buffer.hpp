@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "communication/bolt/v1/constants.hpp"
+#include "communication/buffer.hpp"
 
 namespace communication::bolt {
 
@@ -41,14 +42,24 @@ namespace communication::bolt {
  * unnecessarily buffered in memory.
  *
  * The current implementation stores only a single chunk into memory and sends
- * it immediately to the output stream when new data arrives.
+ * it immediately to the output stream when new data arrives. The chunk storage
+ * is leased from a `BufferPool` only while the chunk holds data, so an idle
+ * buffer doesn't hold any memory.
  *
  * @tparam TOutputStream the output stream that should be used
  */
 template <class TOutputStream>
 class ChunkedEncoderBuffer {
  public:
-  ChunkedEncoderBuffer(TOutputStream &output_stream) : output_stream_(output_stream) {}
+  ChunkedEncoderBuffer(TOutputStream &output_stream, BufferPool *pool = GlobalBufferPool())
+      : output_stream_(output_stream), pool_(pool) {}
+
+  ~ChunkedEncoderBuffer() { Clear(); }
+
+  ChunkedEncoderBuffer(const ChunkedEncoderBuffer &) = delete;
+  ChunkedEncoderBuffer(ChunkedEncoderBuffer &&) = delete;
+  ChunkedEncoderBuffer &operator=(const ChunkedEncoderBuffer &) = delete;
+  ChunkedEncoderBuffer &operator=(ChunkedEncoderBuffer &&) = delete;
 
   /**
    * Writes n values into the buffer. If n is bigger than whole chunk size
@@ -65,8 +76,10 @@ class ChunkedEncoderBuffer {
       // the internal storage is a fixed length array.
       size_t size = n < kChunkMaxDataSize - have_ ? n : kChunkMaxDataSize - have_;
 
+      if (!chunk_) chunk_ = pool_->Acquire(kChunkWholeSize);
+
       // Copy `size` values to the chunk array.
-      std::memcpy(chunk_.data() + kChunkHeaderSize + have_, values + written, size);
+      std::memcpy(chunk_ + kChunkHeaderSize + have_, values + written, size);
 
       // Update positions. The position pointer and incoming size have to be
       // updated because all incoming values have to be processed.
@@ -90,12 +103,18 @@ class ChunkedEncoderBuffer {
    *                  waiting to be sent (in order to optimize network packets)
    */
   bool Flush(bool have_more = false) {
+    if (!chunk_) {
+      // Nothing was written, only the header of an empty chunk is sent.
+      const uint8_t header[kChunkHeaderSize]{0, 0};
+      return output_stream_.Write(header, kChunkHeaderSize, have_more);
+    }
+
     // Write the size of the chunk.
     chunk_[0] = have_ >> 8;
     chunk_[1] = have_ & 0xFF;
 
     // Write the data to the stream.
-    auto ret = output_stream_.Write(chunk_.data(), kChunkHeaderSize + have_, have_more);
+    auto ret = output_stream_.Write(chunk_, kChunkHeaderSize + have_, have_more);
 
     // Cleanup.
     Clear();
@@ -103,8 +122,13 @@ class ChunkedEncoderBuffer {
     return ret;
   }
 
-  /** Clears the internal buffers. */
-  void Clear() { have_ = 0; }
+  /** Clears the internal buffers and returns the chunk storage to the pool. */
+  void Clear() {
+    have_ = 0;
+    if (!chunk_) return;
+    pool_->Release(chunk_, BufferPool::BlockSize(kChunkWholeSize));
+    chunk_ = nullptr;
+  }
 
   /**
    * Returns a boolean indicating whether there is data in the buffer.
@@ -117,8 +141,10 @@ class ChunkedEncoderBuffer {
   // The output stream used.
   TOutputStream &output_stream_;
 
-  // Buffer for a single chunk.
-  std::array<uint8_t, kChunkWholeSize> chunk_;
+  BufferPool *pool_;
+
+  // Buffer for a single chunk, leased from `pool_` while it holds data.
+  uint8_t *chunk_{nullptr};
 
   // Amount of data in chunk array.
   size_t have_{0};
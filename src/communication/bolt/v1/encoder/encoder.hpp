@@ -58,6 +58,26 @@ class Encoder : private BaseEncoder<Buffer> {
     return buffer_.Flush(true);
   }
 
+  /**
+   * Sends a Record message whose fields are written by `write_fields`. The
+   * function receives the underlying `BaseEncoder` and must write exactly
+   * `size` values. It is used to encode values without converting them to
+   * `Value` first.
+   *
+   * @param size the number of fields in the record
+   * @param write_fields function that writes the fields
+   */
+  template <typename TWriteFields>
+  bool MessageRecord(const size_t size, TWriteFields &&write_fields) {
+    WriteRAW(utils::UnderlyingCast(Marker::TinyStruct1));
+    WriteRAW(utils::UnderlyingCast(Signature::Record));
+    BaseEncoder<Buffer>::WriteTypeSize(size, MarkerList);
+    write_fields(static_cast<BaseEncoder<Buffer> &>(*this));
+    // The same flushing rules as in the above `MessageRecord` apply.
+    if (!buffer_.Flush(true)) return false;
+    return buffer_.Flush(true);
+  }
+
   /**
    * Sends a Success message.
    *
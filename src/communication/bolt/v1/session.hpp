@@ -105,10 +105,7 @@ class Session {
    */
   void Execute() {
     if (UNLIKELY(!handshake_done_)) {
-      // Resize the input buffer to ensure that a whole chunk can fit into it.
-      // This can be done only once because the buffer holds its size.
-      input_stream_.Resize(kChunkWholeSize);
-
+      // The input buffer grows on demand, so a whole chunk always fits into it.
       // Receive the handshake.
       if (input_stream_.size() < kHandshakeSize) {
         spdlog::trace("Received partial handshake of size {}", input_stream_.size());
@@ -11,11 +11,84 @@
 
 #include "communication/buffer.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <mutex>
+
 #include "utils/logging.hpp"
 
 namespace communication {
 
-Buffer::Buffer() : data_(kBufferInitialSize, 0), read_end_(this), write_end_(this) {}
+namespace {
+// Size class of a block, without the headroom.
+size_t ClassSize(size_t block_size) { return block_size - BufferPool::kBlockHeadroom; }
+
+size_t SizeClassIndex(size_t block_size) {
+  return std::countr_zero(ClassSize(block_size)) - std::countr_zero(BufferPool::kMinBlockSize);
+}
+}  // namespace
+
+BufferPool::~BufferPool() {
+  for (auto &size_class : classes_) {
+    for (auto *block : size_class.free_blocks) delete[] block;
+  }
+}
+
+size_t BufferPool::BlockSize(size_t size) {
+  const auto class_size = size > kBlockHeadroom ? std::bit_ceil(size - kBlockHeadroom) : 0;
+  return std::max(class_size, kMinBlockSize) + kBlockHeadroom;
+}
+
+uint8_t *BufferPool::Acquire(size_t size) {
+  const auto block_size = BlockSize(size);
+  leased_bytes_.fetch_add(block_size, std::memory_order_relaxed);
+  if (ClassSize(block_size) > kMaxPooledBlockSize) return new uint8_t[block_size];
+  auto &size_class = classes_[SizeClassIndex(block_size)];
+  {
+    std::lock_guard guard(size_class.lock);
+    if (!size_class.free_blocks.empty()) {
+      auto *block = size_class.free_blocks.back();
+      size_class.free_blocks.pop_back();
+      return block;
+    }
+  }
+  return new uint8_t[block_size];
+}
+
+void BufferPool::Release(uint8_t *block, size_t size) {
+  DMG_ASSERT(size == BlockSize(size), "Released a block that wasn't leased from the pool!");
+  leased_bytes_.fetch_sub(size, std::memory_order_relaxed);
+  if (ClassSize(size) <= kMaxPooledBlockSize) {
+    auto &size_class = classes_[SizeClassIndex(size)];
+    std::lock_guard guard(size_class.lock);
+    if ((size_class.free_blocks.size() + 1) * size <= kMaxFreeBytesPerClass) {
+      size_class.free_blocks.push_back(block);
+      return;
+    }
+  }
+  delete[] block;
+}
+
+size_t BufferPool::FreeBytes() {
+  size_t free_bytes = 0;
+  for (size_t i = 0; i < kNumClasses; ++i) {
+    std::lock_guard guard(classes_[i].lock);
+    free_bytes += classes_[i].free_blocks.size() * ((kMinBlockSize << i) + kBlockHeadroom);
+  }
+  return free_bytes;
+}
+
+size_t BufferPool::LeasedBytes() const { return leased_bytes_.load(std::memory_order_relaxed); }
+
+BufferPool *GlobalBufferPool() {
+  static BufferPool pool;
+  return &pool;
+}
+
+Buffer::Buffer(BufferPool *pool) : pool_(pool), read_end_(this), write_end_(this) {}
+
+Buffer::~Buffer() { Clear(); }
 
 Buffer::ReadEnd::ReadEnd(Buffer *buffer) : buffer_(buffer) {}
 
@@ -39,11 +112,13 @@ void Buffer::WriteEnd::Resize(size_t len) { buffer_->Resize(len); }
 
 void Buffer::WriteEnd::Clear() { buffer_->Clear(); }
 
+void Buffer::WriteEnd::Release() { buffer_->Release(); }
+
 Buffer::ReadEnd *Buffer::read_end() { return &read_end_; }
 
 Buffer::WriteEnd *Buffer::write_end() { return &write_end_; }
 
-uint8_t *Buffer::data() { return data_.data(); }
+uint8_t *Buffer::data() { return data_; }
 
 size_t Buffer::size() const { return have_; }
 
@@ -51,30 +126,48 @@ void Buffer::Shift(size_t len) {
   DMG_ASSERT(len <= have_, "Tried to shift more data than the buffer has!");
   if (len == have_) {
     have_ = 0;
+    Release();
   } else {
-    memmove(data_.data(), data_.data() + len, have_ - len);
+    memmove(data_, data_ + len, have_ - len);
     have_ -= len;
   }
 }
 
 io::network::StreamBuffer Buffer::Allocate() {
-  DMG_ASSERT(data_.size() > have_,
+  DMG_ASSERT(capacity_ >= have_,
              "The buffer thinks that there is more data "
              "in the buffer than there is underlying "
              "storage space!");
-  return {data_.data() + have_, data_.size() - have_};
+  if (capacity_ == have_) Resize(capacity_ + 1);
+  return {data_ + have_, capacity_ - have_};
 }
 
 void Buffer::Written(size_t len) {
   have_ += len;
-  DMG_ASSERT(have_ <= data_.size(), "Written more than storage has space!");
+  DMG_ASSERT(have_ <= capacity_, "Written more than storage has space!");
 }
 
 void Buffer::Resize(size_t len) {
-  if (len <= data_.size()) return;
-  data_.resize(len, 0);
+  if (len <= capacity_) return;
+  auto *data = pool_->Acquire(len);
+  if (data_) {
+    memcpy(data, data_, have_);
+    pool_->Release(data_, capacity_);
+  }
+  data_ = data;
+  capacity_ = BufferPool::BlockSize(len);
 }
 
-void Buffer::Clear() { have_ = 0; }
+void Buffer::Clear() {
+  have_ = 0;
+  Release();
+}
+
+void Buffer::Release() {
+  if (have_ > 0 || !data_) return;
+  pool_->Release(data_, capacity_);
+  data_ = nullptr;
+  capacity_ = 0;
+}
 
 }  // namespace communication
@@ -11,12 +11,93 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 #include "io/network/stream_buffer.hpp"
+#include "utils/spin_lock.hpp"
 
 namespace communication {
 
+/**
+ * @brief BufferPool
+ *
+ * Shared pool of memory blocks that are leased by `Buffer` objects and the
+ * Bolt chunk buffers while they hold data. Blocks are grouped into power of two
+ * size classes starting at `kMinBlockSize`. Each block has `kBlockHeadroom`
+ * bytes on top of its class, so data of a power of two size with a small
+ * framing header, like a full Bolt chunk, doesn't take a block twice as large.
+ * Blocks larger than `kMaxPooledBlockSize` are overflow blocks that are
+ * allocated and freed directly. Each size class keeps at most
+ * `kMaxFreeBytesPerClass` bytes of free blocks, the rest is freed.
+ *
+ * This class is thread safe.
+ */
+class BufferPool final {
+ public:
+  static constexpr size_t kMinBlockSize = 65536;
+  static constexpr size_t kMaxPooledBlockSize = 1024 * 1024;
+  static constexpr size_t kBlockHeadroom = 64;
+  static constexpr size_t kMaxFreeBytesPerClass = 16 * 1024 * 1024;
+
+  BufferPool() = default;
+  ~BufferPool();
+
+  BufferPool(const BufferPool &) = delete;
+  BufferPool(BufferPool &&) = delete;
+  BufferPool &operator=(const BufferPool &) = delete;
+  BufferPool &operator=(BufferPool &&) = delete;
+
+  /**
+   * Returns the size of the block that is leased for a request of `size`
+   * bytes.
+   */
+  static size_t BlockSize(size_t size);
+
+  /**
+   * Leases a block that has at least `size` bytes. The returned block has
+   * exactly `BlockSize(size)` bytes.
+   */
+  uint8_t *Acquire(size_t size);
+
+  /**
+   * Returns the block that was leased with `Acquire`. The `size` must be the
+   * size of the block.
+   */
+  void Release(uint8_t *block, size_t size);
+
+  /**
+   * Returns the number of free bytes that are held by the pool.
+   */
+  size_t FreeBytes();
+
+  /**
+   * Returns the number of bytes in blocks that are currently leased, including
+   * overflow blocks.
+   */
+  size_t LeasedBytes() const;
+
+ private:
+  static constexpr size_t kNumClasses = 5;
+  static_assert(kMinBlockSize << (kNumClasses - 1) == kMaxPooledBlockSize);
+
+  struct SizeClass {
+    utils::SpinLock lock;
+    std::vector<uint8_t *> free_blocks;
+  };
+
+  std::array<SizeClass, kNumClasses> classes_;
+  std::atomic<size_t> leased_bytes_{0};
+};
+
+/**
+ * Returns the pool that is shared by all buffers that weren't given a pool.
+ */
+BufferPool *GlobalBufferPool();
+
 /**
  * @brief Buffer
  *
@@ -24,20 +105,20 @@ namespace communication {
  *
  * Allocating, writing and written stores data in the buffer. The stored
  * data can then be read using the pointer returned with the data function.
- * This implementation stores data in a variable sized array (a vector).
- * The internal array can only grow in size.
+ * The storage is leased from a `BufferPool` only while the buffer holds data.
+ * Once all of the data is shifted out (or cleared) the storage is returned to
+ * the pool, so idle buffers don't hold any memory. The storage grows on demand
+ * when it is full, large messages end up in overflow blocks that aren't kept
+ * by the pool.
  *
  * This buffer is NOT thread safe. It is intended to be used in the network
  * stack where all execution when it is being done is being done on a single
  * thread.
  */
 class Buffer final {
- private:
-  // Initial capacity of the internal buffer.
-  const size_t kBufferInitialSize = 65536;
-
  public:
-  Buffer();
+  explicit Buffer(BufferPool *pool = GlobalBufferPool());
+  ~Buffer();
 
   Buffer(const Buffer &) = delete;
   Buffer(Buffer &&) = delete;
@@ -92,6 +173,8 @@ class Buffer final {
 
     void Clear();
 
+    void Release();
+
    private:
     Buffer *buffer_;
   };
@@ -133,7 +216,8 @@ class Buffer final {
    * Allocates a new StreamBuffer from the internal buffer.
    * This function returns a pointer to the first currently free memory
    * location in the internal buffer. Also, it returns the size of the
-   * available memory.
+   * available memory. The storage is leased if the buffer doesn't have any,
+   * and grown if it is full.
    */
   io::network::StreamBuffer Allocate();
 
@@ -154,19 +238,28 @@ class Buffer final {
    * It is used to notify the buffer of the incoming message size.
    * If the requested size is larger than the buffer size then the buffer is
    * resized, if the requested size is smaller than the buffer size then
-   * nothing is done.
+   * nothing is done. The size holds only until the buffer is emptied.
    *
    * @param len the desired size of the buffer
    */
   void Resize(size_t len);
 
   /**
-   * This method clears the buffer. It doesn't release the underlying storage
-   * space.
+   * This method clears the buffer and returns the underlying storage space to
+   * the pool.
    */
   void Clear();
 
-  std::vector<uint8_t> data_;
+  /**
+   * This method returns the underlying storage space to the pool if the buffer
+   * doesn't hold any data. It should be called when the buffer was allocated
+   * but nothing was written to it, e.g. when a non-blocking read would block.
+   */
+  void Release();
+
+  BufferPool *pool_;
+  uint8_t *data_{nullptr};
+  size_t capacity_{0};
   size_t have_{0};
   ReadEnd read_end_;
   WriteEnd write_end_;
@@ -209,6 +209,18 @@ bool Client::Write(const std::string &str, bool have_more) {
   return Write(reinterpret_cast<const uint8_t *>(str.data()), str.size(), have_more);
 }
 
+bool Client::Write(const iovec *iov, size_t iovcnt, bool have_more) {
+  if (!ssl_) return socket_.Write(iov, iovcnt, have_more);
+  // OpenSSL doesn't support gather writes so the buffers are written one by
+  // one.
+  for (size_t i = 0; i < iovcnt; ++i) {
+    if (!Write(static_cast<const uint8_t *>(iov[i].iov_base), iov[i].iov_len, have_more || i + 1 < iovcnt)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 const io::network::Endpoint &Client::endpoint() { return socket_.endpoint(); }
 
 void Client::ReleaseSslObjects() {
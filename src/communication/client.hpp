@@ -110,6 +110,12 @@ class Client final {
    */
   bool Write(const std::string &str, bool have_more = false);
 
+  /**
+   * This function writes the data from all of the buffers to the socket in
+   * order. Without SSL the buffers are written with a single gather write.
+   */
+  bool Write(const iovec *iov, size_t iovcnt, bool have_more = false);
+
   const io::network::Endpoint &endpoint();
 
  private:
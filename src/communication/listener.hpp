@@ -12,10 +12,12 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
 
 #include <gflags/gflags.h>
@@ -23,13 +25,35 @@
 #include "communication/session.hpp"
 #include "io/network/epoll.hpp"
 #include "io/network/socket.hpp"
+#include "utils/io_uring.hpp"
 #include "utils/logging.hpp"
 #include "utils/signals.hpp"
 #include "utils/spin_lock.hpp"
 #include "utils/thread.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace communication {
 
+/**
+ * Configuration of the pool that executes sessions when the network I/O is
+ * decoupled from the session execution.
+ */
+struct ExecutionPoolConfig {
+  // Number of threads that execute sessions.
+  size_t workers_count;
+  // Number of execution threads that only run sessions which aren't
+  // considered long running. They keep short requests responsive while all
+  // other threads are busy.
+  size_t reserved_workers_count;
+  // A session whose last execution took longer than this is considered long
+  // running and its next execution is scheduled with a lower priority.
+  std::chrono::milliseconds long_execution_threshold;
+  // The I/O threads take many epoll events at once and read all of their
+  // sockets with a single io_uring submission. Sessions that use SSL are
+  // still read one by one.
+  bool use_io_uring{false};
+};
+
 /**
  * This class listens to events on an epoll object and processes them.
  * When a new connection is added a `TSession` object is created to handle the
@@ -38,6 +62,11 @@ namespace communication {
  * closed. Also, this class has a background thread that periodically, every
  * second, checks all sessions for expiration and shuts them down if they have
  * expired.
+ *
+ * When an `ExecutionPoolConfig` is supplied the worker threads only read data
+ * from the sockets. Sessions that received data are then executed on a
+ * separate pool which prefers sessions that aren't long running, so a few
+ * heavy requests can't delay the short requests of all other clients.
  */
 template <class TSession, class TSessionData>
 class Listener final {
@@ -47,25 +76,30 @@ class Listener final {
   // make sense to take more than one event because the processing of an event
   // can take a long time.
   static const int kMaxEvents = 1;
+  // Threads that only read the data can take many events at once, they don't
+  // process them. Used only with io_uring, where all of them are read with a
+  // single submission.
+  static const int kMaxReadEvents = 64;
 
   using SessionHandler = Session<TSession, TSessionData>;
 
  public:
   Listener(TSessionData *data, ServerContext *context, int inactivity_timeout_sec, const std::string &service_name,
-           size_t workers_count)
+           size_t workers_count, std::optional<ExecutionPoolConfig> execution_pool_config = std::nullopt)
       : data_(data),
         alive_(false),
         context_(context),
         inactivity_timeout_sec_(inactivity_timeout_sec),
         service_name_(service_name),
-        workers_count_(workers_count) {}
+        workers_count_(workers_count),
+        execution_pool_config_(execution_pool_config) {}
 
   ~Listener() {
     bool worker_alive = false;
     for (auto &thread : worker_threads_) {
       if (thread.joinable()) worker_alive = true;
     }
-    MG_ASSERT(!alive_ && !worker_alive && !timeout_thread_.joinable(),
+    MG_ASSERT(!alive_ && !worker_alive && !timeout_thread_.joinable() && !execution_pool_,
               "You should call Shutdown and AwaitShutdown on "
               "communication::Listener!");
   }
@@ -109,11 +143,28 @@ class Listener final {
     spdlog::info("Starting {} {} workers", workers_count_, service_name_);
 
     std::string service_name(service_name_);
+    if (execution_pool_config_) {
+      spdlog::info("Starting {} {} execution workers, {} of them reserved for short requests",
+                   execution_pool_config_->workers_count, service_name_, execution_pool_config_->reserved_workers_count);
+      execution_pool_.emplace(execution_pool_config_->workers_count, execution_pool_config_->reserved_workers_count,
+                              service_name);
+    }
     for (size_t i = 0; i < workers_count_; ++i) {
       worker_threads_.emplace_back([this, service_name, i]() {
         utils::ThreadSetName(fmt::format("{} worker {}", service_name, i + 1));
+        std::unique_ptr<utils::IoUring> ring;
+        if (execution_pool_config_ && execution_pool_config_->use_io_uring) {
+          ring = utils::IoUring::Create(kMaxReadEvents, nullptr, 0);
+          if (!ring && i == 0) {
+            spdlog::warn("io_uring isn't supported by the kernel, {} sockets will be read one by one.", service_name);
+          }
+        }
         while (alive_) {
-          WaitAndProcessEvents();
+          if (ring) {
+            WaitAndReadEvents(ring.get());
+          } else {
+            WaitAndProcessEvents();
+          }
         }
       });
     }
@@ -156,6 +207,12 @@ class Listener final {
     for (auto &worker_thread : worker_threads_) {
       if (worker_thread.joinable()) worker_thread.join();
     }
+    // The execution pool is stopped after the workers so that no new sessions
+    // can be scheduled on it.
+    if (execution_pool_) {
+      execution_pool_->Shutdown();
+      execution_pool_.reset();
+    }
     // Here we free all active connections to close them and notify the other
     // end that we won't process them because we stopped all worker threads.
     std::lock_guard<utils::SpinLock> guard(lock_);
@@ -194,9 +251,15 @@ class Listener final {
     // and calling a function on that session after that would cause a
     // segfault.
     if (event.events & EPOLLIN) {
-      // Read and process all incoming data.
-      while (ExecuteSession(session))
-        ;
+      if (execution_pool_) {
+        // Read the incoming data and leave the processing to the execution
+        // pool.
+        ReadSession(session);
+      } else {
+        // Read and process all incoming data.
+        while (ExecuteSession(session))
+          ;
+      }
     } else if (event.events & EPOLLRDHUP) {
       // The client closed the connection.
       spdlog::info("{} client {} closed the connection.", service_name_, session.socket().endpoint());
@@ -213,14 +276,131 @@ class Listener final {
     }
   }
 
+  /**
+   * Takes all waiting epoll events and reads the sockets of the sessions that
+   * received data with a single io_uring submission. The sessions are then
+   * scheduled on the execution pool, the same as in `ReadSession`.
+   */
+  void WaitAndReadEvents(utils::IoUring *ring) {
+    io::network::Epoll::Event events[kMaxReadEvents];
+    int n = epoll_.Wait(events, kMaxReadEvents, 200);
+    if (n <= 0) return;
+
+    // Indexed by the user data of the receive operations.
+    std::array<SessionHandler *, kMaxReadEvents> receiving;
+    unsigned receiving_count = 0;
+    for (int i = 0; i < n; ++i) {
+      auto &event = events[i];
+      // The same rules apply as in `WaitAndProcessEvents`.
+      SessionHandler &session = *reinterpret_cast<SessionHandler *>(event.data.ptr);
+      if (event.events & EPOLLIN) {
+        if (session.UsesSsl()) {
+          // OpenSSL reads from the socket itself.
+          ReadSession(session);
+          continue;
+        }
+        auto buf = session.AllocateInput();
+        ring->PrepareRecv(session.socket().fd(), buf.data, buf.len, receiving_count);
+        receiving[receiving_count++] = &session;
+      } else if (event.events & EPOLLRDHUP) {
+        spdlog::info("{} client {} closed the connection.", service_name_, session.socket().endpoint());
+        CloseSession(session);
+      } else {
+        spdlog::error("Error occured in {} session associated with {}", service_name_, session.socket().endpoint());
+        CloseSession(session);
+      }
+    }
+    if (receiving_count == 0) return;
+
+    ring->Submit(receiving_count);
+    for (unsigned completed = 0; completed < receiving_count;) {
+      auto completion = ring->PopCompletion();
+      if (!completion) {
+        ring->Submit(1);
+        continue;
+      }
+      ++completed;
+      SessionHandler &session = *receiving[completion->user_data];
+      auto status = SessionHandler::ReadStatus::RETRY;
+      if (!HandleSessionErrors(session, [&] { status = session.Received(completion->result); })) continue;
+      ScheduleSession(session, status);
+    }
+  }
+
   bool ExecuteSession(SessionHandler &session) {
+    bool done = false;
+    if (!HandleSessionErrors(session, [&] { done = session.Execute(); })) return false;
+    if (done) {
+      // Session execution done, rearm epoll to send events for this
+      // socket.
+      RearmSession(session);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Reads the data waiting on the session's socket and schedules the session
+   * on the execution pool. The session's socket isn't rearmed in epoll until
+   * the execution is done so the session is never used by two threads at the
+   * same time.
+   */
+  void ReadSession(SessionHandler &session) {
+    auto status = SessionHandler::ReadStatus::RETRY;
+    if (!HandleSessionErrors(session, [&] {
+          do {
+            status = session.Read();
+          } while (status == SessionHandler::ReadStatus::RETRY);
+        })) {
+      return;
+    }
+    ScheduleSession(session, status);
+  }
+
+  /**
+   * Schedules the session on the execution pool if the last read returned
+   * data, otherwise it waits for the next epoll event.
+   */
+  void ScheduleSession(SessionHandler &session, typename SessionHandler::ReadStatus status) {
+    if (status == SessionHandler::ReadStatus::WOULD_BLOCK) {
+      RearmSession(session);
+      return;
+    }
+    const auto priority = session.LastExecutionDuration() > execution_pool_config_->long_execution_threshold
+                              ? utils::PriorityThreadPool::Priority::LOW
+                              : utils::PriorityThreadPool::Priority::HIGH;
+    // A low priority session can wait in the queue for longer than the
+    // inactivity timeout, the timeout thread mustn't close it meanwhile.
+    session.MarkActive();
+    execution_pool_->AddTask([this, &session] { ExecuteSessionInput(session); }, priority);
+  }
+
+  void ExecuteSessionInput(SessionHandler &session) {
+    if (!HandleSessionErrors(session, [&] { session.ExecuteInput(); })) return;
+    if (session.HasPendingInput()) {
+      // OpenSSL already consumed the data from the socket so epoll won't
+      // notify us about it, we have to read it here.
+      ReadSession(session);
+      return;
+    }
+    // Rearming epoll also raises an event if more data arrived in the
+    // meantime.
+    RearmSession(session);
+  }
+
+  void RearmSession(SessionHandler &session) {
+    epoll_.Modify(session.socket().fd(), EPOLLIN | EPOLLET | EPOLLRDHUP | EPOLLONESHOT, &session);
+  }
+
+  /**
+   * Calls `func` and closes the session if `func` throws. Returns `false` if
+   * the session was closed.
+   */
+  template <class TFunc>
+  bool HandleSessionErrors(SessionHandler &session, const TFunc &func) {
     try {
-      if (session.Execute()) {
-        // Session execution done, rearm epoll to send events for this
-        // socket.
-        epoll_.Modify(session.socket().fd(), EPOLLIN | EPOLLET | EPOLLRDHUP | EPOLLONESHOT, &session);
-        return false;
-      }
+      func();
+      return true;
     } catch (const SessionClosedException &e) {
       spdlog::info("{} client {} closed the connection.", service_name_, session.socket().endpoint());
       CloseSession(session);
@@ -235,7 +415,6 @@ class Listener final {
       CloseSession(session);
       return false;
     }
-    return true;
   }
 
   void CloseSession(SessionHandler &session) {
@@ -272,5 +451,8 @@ class Listener final {
   const int inactivity_timeout_sec_;
   const std::string service_name_;
   const size_t workers_count_;
+
+  const std::optional<ExecutionPoolConfig> execution_pool_config_;
+  std::optional<utils::PriorityThreadPool> execution_pool_;
 };
 }  // namespace communication
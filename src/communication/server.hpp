@@ -40,6 +40,10 @@ namespace communication {
  * Current Server achitecture:
  * incoming connection -> server -> listener -> session
  *
+ * If an `ExecutionPoolConfig` is given, the listener's `workers_count`
+ * threads only handle the network I/O and the sessions are executed on a
+ * separate execution pool.
+ *
  * NOTE: If you use this server you **must** create `communication::SSLInit`
  * from the `main` function before using the server!
  *
@@ -60,10 +64,11 @@ class Server final {
    */
   Server(const io::network::Endpoint &endpoint, TSessionData *session_data, ServerContext *context,
          int inactivity_timeout_sec, const std::string &service_name,
-         size_t workers_count = std::thread::hardware_concurrency())
+         size_t workers_count = std::thread::hardware_concurrency(),
+         std::optional<ExecutionPoolConfig> execution_pool_config = std::nullopt)
       : alive_(false),
         endpoint_(endpoint),
-        listener_(session_data, context, inactivity_timeout_sec, service_name, workers_count),
+        listener_(session_data, context, inactivity_timeout_sec, service_name, workers_count, execution_pool_config),
         service_name_(service_name) {}
 
   ~Server() {
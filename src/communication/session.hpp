@@ -47,7 +47,9 @@ using InputStream = Buffer::ReadEnd;
  */
 class OutputStream final {
  public:
-  OutputStream(std::function<bool(const uint8_t *, size_t, bool)> write_function) : write_function_(write_function) {}
+  OutputStream(std::function<bool(const uint8_t *, size_t, bool)> write_function,
+               std::function<void()> close_function = nullptr)
+      : write_function_(write_function), close_function_(close_function) {}
 
   OutputStream(const OutputStream &) = delete;
   OutputStream(OutputStream &&) = delete;
@@ -60,8 +62,15 @@ class OutputStream final {
     return Write(reinterpret_cast<const uint8_t *>(str.data()), str.size(), have_more);
   }
 
+  /// Shuts the connection down, so that the network stack closes the session.
+  /// Can be called from any thread.
+  void Close() {
+    if (close_function_) close_function_();
+  }
+
  private:
   std::function<bool(const uint8_t *, size_t, bool)> write_function_;
+  std::function<void()> close_function_;
 };
 
 /**
@@ -74,7 +83,8 @@ class Session final {
  public:
   Session(io::network::Socket &&socket, TSessionData *data, ServerContext *context, int inactivity_timeout_sec)
       : socket_(std::move(socket)),
-        output_stream_([this](const uint8_t *data, size_t len, bool have_more) { return Write(data, len, have_more); }),
+        output_stream_([this](const uint8_t *data, size_t len, bool have_more) { return Write(data, len, have_more); },
+                       [this] { socket_.Shutdown(); }),
         session_(data, socket_.endpoint(), input_buffer_.read_end(), &output_stream_),
         inactivity_timeout_sec_(inactivity_timeout_sec) {
     // Set socket options.
@@ -134,6 +144,18 @@ class Session final {
     }
   }
 
+  /**
+   * Result of a single read from the session's socket.
+   */
+  enum class ReadStatus {
+    // New data was appended to the input buffer.
+    DATA,
+    // There is no more data to read, wait for the next epoll event.
+    WOULD_BLOCK,
+    // Nothing was read but the read should be attempted again.
+    RETRY,
+  };
+
   /**
    * This function is called from the communication stack when an event occurs
    * indicating that there is data waiting to be read. This function calls the
@@ -148,8 +170,32 @@ class Session final {
     RefreshLastEventTime(true);
     utils::OnScopeExit on_exit([this] { RefreshLastEventTime(false); });
 
+    switch (Read()) {
+      case ReadStatus::WOULD_BLOCK:
+        return true;
+      case ReadStatus::RETRY:
+        return false;
+      case ReadStatus::DATA:
+        break;
+    }
+
+    // Execute the session.
+    session_.Execute();
+
+    return false;
+  }
+
+  /**
+   * Reads the data that is waiting on the socket into the input buffer without
+   * executing the supplied `TSession`. Used together with `ExecuteInput` when
+   * the network I/O and the session execution are done on different threads.
+   */
+  ReadStatus Read() {
     // Allocate the buffer to fill the data.
     auto buf = input_buffer_.write_end()->Allocate();
+    // If nothing was read into an empty buffer, its storage goes back to the
+    // pool so that idle sessions don't hold any.
+    utils::OnScopeExit release_buffer([this] { input_buffer_.write_end()->Release(); });
 
     if (ssl_) {
       // We clear errors here to prevent errors piling up in the internal
@@ -164,17 +210,15 @@ class Session final {
       if (len < 0) {
         auto err = SSL_get_error(ssl_, len);
         if (err == SSL_ERROR_WANT_READ) {
-          // OpenSSL want's to read more data from the socket. We return `true`
-          // to stop execution of the session to wait for more data to be
-          // received.
-          return true;
+          // OpenSSL want's to read more data from the socket. We stop
+          // execution of the session to wait for more data to be received.
+          return ReadStatus::WOULD_BLOCK;
         } else if (err == SSL_ERROR_WANT_WRITE) {
           // The OpenSSL library wants to perfrom some kind of handshake so we
           // wait for the socket to become ready for a write and call the read
-          // again. We return `false` so that the listener calls this function
           // again.
           socket_.WaitForReadyWrite();
-          return false;
+          return ReadStatus::RETRY;
         } else if (err == SSL_ERROR_SYSCALL) {
           // OpenSSL returns this error when you open a connection to the server
           // but you don't send any data. We do this often when we check whether
@@ -200,7 +244,6 @@ class Session final {
       } else if (len == 0) {
         // The client closed the connection.
         throw SessionClosedException("Session was closed by the client.");
-        return false;
       } else {
         // Notify the input buffer that it has new data.
         input_buffer_.write_end()->Written(len);
@@ -210,33 +253,69 @@ class Session final {
       // Note, the `true` parameter for non-blocking here is redundant because
       // the socket already is non-blocking.
       auto len = socket_.Read(buf.data, buf.len, true);
-
-      // Check for read errors.
-      if (len == -1) {
-        // This means read would block or read was interrupted by signal, we
-        // return `true` to indicate that all data is processad and to stop
-        // reading of data.
-        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
-          return true;
-        }
-        // Some other error occurred, throw an exception to start session
-        // cleanup.
-        throw utils::BasicException("Couldn't read data from the socket!");
-      } else if (len == 0) {
-        // The client has closed the connection.
-        throw SessionClosedException("Session was closed by client.");
-      } else {
-        // Notify the input buffer that it has new data.
-        input_buffer_.write_end()->Written(len);
-      }
+      return HandleReceived(len, len == -1 ? errno : 0);
     }
 
-    // Execute the session.
-    session_.Execute();
+    return ReadStatus::DATA;
+  }
 
-    return false;
+  /**
+   * Returns the free space of the input buffer, for a read that the caller
+   * does itself (e.g. through io_uring). The result of the read must be passed
+   * to `Received`. Can't be used for sessions that use SSL.
+   */
+  io::network::StreamBuffer AllocateInput() {
+    DMG_ASSERT(!ssl_, "SSL sessions must be read with Read!");
+    return input_buffer_.write_end()->Allocate();
+  }
+
+  /**
+   * Handles the result of a read into the buffer returned by `AllocateInput`.
+   * The `result` is the return value of `recv`, with the error negated.
+   */
+  ReadStatus Received(ssize_t result) {
+    utils::OnScopeExit release_buffer([this] { input_buffer_.write_end()->Release(); });
+    return result < 0 ? HandleReceived(-1, static_cast<int>(-result)) : HandleReceived(result, 0);
   }
 
+  /**
+   * Returns true if the session's data is encrypted with SSL.
+   */
+  bool UsesSsl() const { return ssl_ != nullptr; }
+
+  /**
+   * Executes the supplied `TSession` on the data that was previously read
+   * with `Read`. The duration of the execution is remembered so that the
+   * network stack can schedule long running sessions with a lower priority.
+   */
+  void ExecuteInput() {
+    RefreshLastEventTime(true);
+    const auto start = std::chrono::steady_clock::now();
+    utils::OnScopeExit on_exit([this, start] {
+      last_execution_duration_ = std::chrono::steady_clock::now() - start;
+      RefreshLastEventTime(false);
+    });
+
+    session_.Execute();
+  }
+
+  /**
+   * Marks the session as active so that it doesn't time out while the data
+   * read with `Read` waits for `ExecuteInput`.
+   */
+  void MarkActive() { RefreshLastEventTime(true); }
+
+  /**
+   * Returns the duration of the last `ExecuteInput` call.
+   */
+  std::chrono::steady_clock::duration LastExecutionDuration() const { return last_execution_duration_; }
+
+  /**
+   * Returns true if OpenSSL already holds decrypted data that wasn't read into
+   * the input buffer. No epoll event will be raised for that data.
+   */
+  bool HasPendingInput() const { return ssl_ && SSL_pending(ssl_) > 0; }
+
   /**
    * Returns true if session has timed out. Session times out if there was no
    * activity in inactivity_timeout_sec seconds. This function must be thread
@@ -255,6 +334,27 @@ class Session final {
   io::network::Socket &socket() { return socket_; }
 
  private:
+  // Handles the result of a read from the socket without SSL.
+  ReadStatus HandleReceived(ssize_t len, int error) {
+    // Check for read errors.
+    if (len == -1) {
+      // This means read would block or read was interrupted by signal, we
+      // indicate that all data is processed to stop reading of data.
+      if (error == EAGAIN || error == EWOULDBLOCK || error == EINTR) {
+        return ReadStatus::WOULD_BLOCK;
+      }
+      // Some other error occurred, throw an exception to start session
+      // cleanup.
+      throw utils::BasicException("Couldn't read data from the socket!");
+    } else if (len == 0) {
+      // The client has closed the connection.
+      throw SessionClosedException("Session was closed by client.");
+    }
+    // Notify the input buffer that it has new data.
+    input_buffer_.write_end()->Written(len);
+    return ReadStatus::DATA;
+  }
+
   void RefreshLastEventTime(bool active) {
     std::unique_lock<utils::SpinLock> guard(lock_);
     execution_active_ = active;
@@ -321,6 +421,7 @@ class Session final {
   std::chrono::time_point<std::chrono::steady_clock> last_event_time_{std::chrono::steady_clock::now()};
   bool execution_active_{false};
   utils::SpinLock lock_;
+  std::chrono::steady_clock::duration last_execution_duration_{0};
   const int inactivity_timeout_sec_;
 
   // SSL objects.
@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 
+#include "communication/bolt/v1/encoder/base_encoder.hpp"
 #include "storage/v2/edge_accessor.hpp"
 #include "storage/v2/storage.hpp"
 #include "storage/v2/vertex_accessor.hpp"
@@ -183,6 +184,64 @@ storage::Result<communication::bolt::Path> ToBoltPath(const query::Path &path, c
   return communication::bolt::Path(vertices, edges);
 }
 
+storage::Result<BoltField> ToBoltField(const query::TypedValue &value, const storage::Storage &db,
+                                       storage::View view) {
+  switch (value.type()) {
+    case query::TypedValue::Type::Vertex: {
+      const auto &vertex = value.ValueVertex();
+      auto maybe_labels = vertex.impl_.Labels(view);
+      if (maybe_labels.HasError()) return maybe_labels.GetError();
+      auto maybe_properties = vertex.impl_.Properties(view);
+      if (maybe_properties.HasError()) return maybe_properties.GetError();
+      return BoltField(BoltVertexData{vertex.Gid(), std::move(*maybe_labels), std::move(*maybe_properties)});
+    }
+    case query::TypedValue::Type::Edge: {
+      const auto &edge = value.ValueEdge();
+      auto maybe_properties = edge.impl_.Properties(view);
+      if (maybe_properties.HasError()) return maybe_properties.GetError();
+      return BoltField(BoltEdgeData{edge.Gid(), edge.impl_.FromVertex().Gid(), edge.impl_.ToVertex().Gid(),
+                                    edge.EdgeType(), std::move(*maybe_properties)});
+    }
+    default: {
+      auto maybe_value = ToBoltValue(value, db, view);
+      if (maybe_value.HasError()) return maybe_value.GetError();
+      return BoltField(std::move(*maybe_value));
+    }
+  }
+}
+
+namespace {
+// Output buffer of `communication::bolt::BaseEncoder` that appends to a string.
+struct StringEncoderBuffer {
+  void Write(const uint8_t *data, size_t len) { output->append(reinterpret_cast<const char *>(data), len); }
+
+  std::string *output;
+};
+}  // namespace
+
+template <typename TName>
+const std::string &BoltNameCache::Get(uint64_t id, const TName &name) {
+  auto it = encoded_.find(id);
+  if (it != encoded_.end()) return it->second;
+  std::string encoded;
+  StringEncoderBuffer buffer{&encoded};
+  communication::bolt::BaseEncoder<StringEncoderBuffer> encoder(buffer);
+  encoder.WriteString(name());
+  return encoded_.emplace(id, std::move(encoded)).first->second;
+}
+
+const std::string &BoltNameCache::Label(storage::LabelId label) {
+  return Get(label.AsUint(), [&]() -> const std::string & { return db_->LabelToName(label); });
+}
+
+const std::string &BoltNameCache::Property(storage::PropertyId property) {
+  return Get(property.AsUint(), [&]() -> const std::string & { return db_->PropertyToName(property); });
+}
+
+const std::string &BoltNameCache::EdgeType(storage::EdgeTypeId edge_type) {
+  return Get(edge_type.AsUint(), [&]() -> const std::string & { return db_->EdgeTypeToName(edge_type); });
+}
+
 storage::PropertyValue ToPropertyValue(const Value &value) {
   switch (value.type()) {
     case Value::Type::Null:
@@ -12,11 +12,21 @@
 /// @file Conversion functions between Value and other memgraph types.
 #pragma once
 
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "communication/bolt/v1/codes.hpp"
 #include "communication/bolt/v1/value.hpp"
 #include "query/typed_value.hpp"
+#include "storage/v2/id_types.hpp"
 #include "storage/v2/property_value.hpp"
 #include "storage/v2/result.hpp"
 #include "storage/v2/view.hpp"
+#include "utils/cast.hpp"
+#include "utils/temporal.hpp"
 
 namespace storage {
 class EdgeAccessor;
@@ -59,6 +69,164 @@ storage::Result<communication::bolt::Path> ToBoltPath(const query::Path &path, c
 storage::Result<communication::bolt::Value> ToBoltValue(const query::TypedValue &value, const storage::Storage &db,
                                                         storage::View view);
 
+/// Vertex data read from storage that is encoded directly into PackStream by
+/// `EncodeBoltField`.
+struct BoltVertexData {
+  storage::Gid gid;
+  std::vector<storage::LabelId> labels;
+  std::map<storage::PropertyId, storage::PropertyValue> properties;
+};
+
+/// Edge data read from storage that is encoded directly into PackStream by
+/// `EncodeBoltField`.
+struct BoltEdgeData {
+  storage::Gid gid;
+  storage::Gid from;
+  storage::Gid to;
+  storage::EdgeTypeId type;
+  std::map<storage::PropertyId, storage::PropertyValue> properties;
+};
+
+/// A result field prepared for `EncodeBoltField`. Vertices and edges keep the
+/// data read from storage, all other values are converted to
+/// communication::bolt::Value.
+using BoltField = std::variant<communication::bolt::Value, BoltVertexData, BoltEdgeData>;
+
+/// @param query::TypedValue for converting to BoltField.
+/// @param storage::Storage for ToBoltValue.
+/// @param storage::View for deciding which vertex and edge attributes are
+///        visible.
+///
+/// All storage errors are returned here so that the encoding can't fail
+/// halfway through a message.
+///
+/// @throw std::bad_alloc
+storage::Result<BoltField> ToBoltField(const query::TypedValue &value, const storage::Storage &db,
+                                       storage::View view);
+
+/// Caches PackStream encodings of label, edge type and property names. Names
+/// never change for a given id so the cache can be kept for a whole session.
+/// A name is looked up in the storage only on a cache miss. The cache isn't
+/// thread safe.
+class BoltNameCache final {
+ public:
+  explicit BoltNameCache(const storage::Storage *db) : db_(db) {}
+
+  const std::string &Label(storage::LabelId label);
+  const std::string &Property(storage::PropertyId property);
+  const std::string &EdgeType(storage::EdgeTypeId edge_type);
+
+ private:
+  // Returns the cached encoding of the name with the given id, `name` is
+  // called to get the name only if it isn't cached yet.
+  template <typename TName>
+  const std::string &Get(uint64_t id, const TName &name);
+
+  const storage::Storage *db_;
+  // Labels, edge types and properties share the same id space.
+  std::unordered_map<uint64_t, std::string> encoded_;
+};
+
+/// Writes the property value into the given `communication::bolt::BaseEncoder`
+/// without converting it to communication::bolt::Value.
+template <typename TEncoder>
+void EncodeBoltPropertyValue(TEncoder &encoder, const storage::PropertyValue &value) {
+  switch (value.type()) {
+    case storage::PropertyValue::Type::Null:
+      encoder.WriteNull();
+      break;
+    case storage::PropertyValue::Type::Bool:
+      encoder.WriteBool(value.ValueBool());
+      break;
+    case storage::PropertyValue::Type::Int:
+      encoder.WriteInt(value.ValueInt());
+      break;
+    case storage::PropertyValue::Type::Double:
+      encoder.WriteDouble(value.ValueDouble());
+      break;
+    case storage::PropertyValue::Type::String:
+      encoder.WriteString(value.ValueString());
+      break;
+    case storage::PropertyValue::Type::List: {
+      const auto &values = value.ValueList();
+      encoder.WriteTypeSize(values.size(), communication::bolt::MarkerList);
+      for (const auto &v : values) EncodeBoltPropertyValue(encoder, v);
+      break;
+    }
+    case storage::PropertyValue::Type::Map: {
+      const auto &map = value.ValueMap();
+      encoder.WriteTypeSize(map.size(), communication::bolt::MarkerMap);
+      for (const auto &kv : map) {
+        encoder.WriteString(kv.first);
+        EncodeBoltPropertyValue(encoder, kv.second);
+      }
+      break;
+    }
+    case storage::PropertyValue::Type::TemporalData: {
+      const auto &temporal = value.ValueTemporalData();
+      switch (temporal.type) {
+        case storage::TemporalType::Date:
+          encoder.WriteDate(utils::Date(temporal.microseconds));
+          break;
+        case storage::TemporalType::LocalTime:
+          encoder.WriteLocalTime(utils::LocalTime(temporal.microseconds));
+          break;
+        case storage::TemporalType::LocalDateTime:
+          encoder.WriteLocalDateTime(utils::LocalDateTime(temporal.microseconds));
+          break;
+        case storage::TemporalType::Duration:
+          encoder.WriteDuration(utils::Duration(temporal.microseconds));
+          break;
+      }
+      break;
+    }
+  }
+}
+
+/// Writes the field into the given `communication::bolt::BaseEncoder`. The
+/// output decodes to the same value as the output of `WriteValue` for the
+/// field converted with ToBoltValue, but vertex and edge properties are encoded
+/// straight from the storage values and names are taken from the `names`
+/// cache. The properties are written in the order of their ids instead of
+/// their names, PackStream maps are unordered.
+template <typename TEncoder>
+void EncodeBoltField(TEncoder &encoder, const BoltField &field, BoltNameCache *names) {
+  using communication::bolt::Marker;
+  using communication::bolt::Signature;
+
+  const auto write_properties = [&](const std::map<storage::PropertyId, storage::PropertyValue> &properties) {
+    encoder.WriteTypeSize(properties.size(), communication::bolt::MarkerMap);
+    for (const auto &[property, value] : properties) {
+      const auto &name = names->Property(property);
+      encoder.WriteRAW(name.data(), name.size());
+      EncodeBoltPropertyValue(encoder, value);
+    }
+  };
+
+  if (const auto *vertex = std::get_if<BoltVertexData>(&field)) {
+    encoder.WriteRAW(utils::UnderlyingCast(Marker::TinyStruct) + 3);
+    encoder.WriteRAW(utils::UnderlyingCast(Signature::Node));
+    encoder.WriteInt(communication::bolt::Id::FromUint(vertex->gid.AsUint()).AsInt());
+    encoder.WriteTypeSize(vertex->labels.size(), communication::bolt::MarkerList);
+    for (const auto &label : vertex->labels) {
+      const auto &name = names->Label(label);
+      encoder.WriteRAW(name.data(), name.size());
+    }
+    write_properties(vertex->properties);
+  } else if (const auto *edge = std::get_if<BoltEdgeData>(&field)) {
+    encoder.WriteRAW(utils::UnderlyingCast(Marker::TinyStruct) + 5);
+    encoder.WriteRAW(utils::UnderlyingCast(Signature::Relationship));
+    encoder.WriteInt(communication::bolt::Id::FromUint(edge->gid.AsUint()).AsInt());
+    encoder.WriteInt(communication::bolt::Id::FromUint(edge->from.AsUint()).AsInt());
+    encoder.WriteInt(communication::bolt::Id::FromUint(edge->to.AsUint()).AsInt());
+    const auto &type = names->EdgeType(edge->type);
+    encoder.WriteRAW(type.data(), type.size());
+    write_properties(edge->properties);
+  } else {
+    encoder.WriteValue(std::get<communication::bolt::Value>(field));
+  }
+}
+
 query::TypedValue ToTypedValue(const communication::bolt::Value &value);
 
 communication::bolt::Value ToBoltValue(const storage::PropertyValue &value);
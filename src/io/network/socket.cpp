@@ -11,10 +11,13 @@
 
 #include "io/network/socket.hpp"
 
+#include <algorithm>
+#include <climits>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <vector>
 
 #include <arpa/inet.h>
 #include <errno.h>
@@ -240,6 +243,43 @@ bool Socket::Write(const std::string &s, bool have_more) {
   return Write(reinterpret_cast<const uint8_t *>(s.data()), s.size(), have_more);
 }
 
+bool Socket::Write(const iovec *iov, size_t iovcnt, bool have_more) {
+  // The buffers are copied because a partial write has to adjust them.
+  std::vector<iovec> buffers(iov, iov + iovcnt);
+  size_t first = 0;
+  int flags = MSG_NOSIGNAL | (have_more ? MSG_MORE : 0);
+  while (first < buffers.size()) {
+    msghdr message{};
+    message.msg_iov = buffers.data() + first;
+    message.msg_iovlen = std::min(buffers.size() - first, static_cast<size_t>(IOV_MAX));
+    auto written = sendmsg(socket_, &message, flags);
+    if (written == -1) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        // Terminal error, return failure.
+        return false;
+      }
+      // Non-fatal error, retry after the socket is ready.
+      if (!WaitForReadyWrite()) return false;
+    } else if (written == 0) {
+      // The client closed the connection.
+      return false;
+    } else {
+      // Skip the buffers that were written completely and adjust the one that
+      // was written partially.
+      auto left = static_cast<size_t>(written);
+      while (first < buffers.size() && left >= buffers[first].iov_len) {
+        left -= buffers[first].iov_len;
+        ++first;
+      }
+      if (left > 0) {
+        buffers[first].iov_base = static_cast<uint8_t *>(buffers[first].iov_base) + left;
+        buffers[first].iov_len -= left;
+      }
+    }
+  }
+  return true;
+}
+
 ssize_t Socket::Read(void *buffer, size_t len, bool nonblock) {
   return recv(socket_, buffer, len, nonblock ? MSG_DONTWAIT : 0);
 }
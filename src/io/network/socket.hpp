@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <sys/uio.h>
+
 #include <functional>
 #include <iostream>
 #include <optional>
@@ -151,6 +153,19 @@ class Socket {
   bool Write(const uint8_t *data, size_t len, bool have_more = false);
   bool Write(const std::string &s, bool have_more = false);
 
+  /**
+   * Write the data from all of the buffers to the socket in order, using a
+   * single system call when possible. This function guarantees that all data
+   * will be written.
+   *
+   * @param iov buffers that should be written
+   * @param iovcnt number of buffers
+   * @param have_more set to true if you plan to send more data
+   *
+   * @return write success status
+   */
+  bool Write(const iovec *iov, size_t iovcnt, bool have_more = false);
+
   /**
    * Read data from the socket.
    * This function is a direct wrapper for the read function.
@@ -133,6 +133,23 @@ DEFINE_VALIDATED_int32(bolt_num_workers, std::max(std::thread::hardware_concurre
                        "Number of workers used by the Bolt server. By default, this will be the "
                        "number of processing units available on the machine.",
                        FLAG_IN_RANGE(1, INT32_MAX));
+DEFINE_VALIDATED_int32(bolt_num_io_workers, 0,
+                       "Number of threads that handle the Bolt network I/O. If set, queries are executed on a "
+                       "separate pool of --bolt-num-workers threads. If 0, each worker reads the requests and "
+                       "executes the queries itself.",
+                       FLAG_IN_RANGE(0, INT32_MAX));
+DEFINE_VALIDATED_int32(bolt_num_reserved_workers, 1,
+                       "Number of Bolt execution workers that only run sessions which aren't long running. Used only "
+                       "when --bolt-num-io-workers is set.",
+                       FLAG_IN_RANGE(0, INT32_MAX));
+DEFINE_VALIDATED_int32(bolt_long_execution_threshold_ms, 100,
+                       "Time in milliseconds after which a Bolt session is considered long running. Its next request "
+                       "is executed with a lower priority. Used only when --bolt-num-io-workers is set.",
+                       FLAG_IN_RANGE(1, INT32_MAX));
+DEFINE_bool(bolt_io_uring, false,
+            "Controls whether the Bolt I/O workers read the sockets using io_uring, many of them with a single "
+            "submission. Used only when --bolt-num-io-workers is set. Sockets are read one by one if the kernel "
+            "doesn't support it.");
 DEFINE_VALIDATED_int32(bolt_session_inactivity_timeout, 1800,
                        "Time in seconds after which inactive Bolt sessions will be "
                        "closed.",
@@ -163,6 +180,10 @@ DEFINE_VALIDATED_uint64(storage_gc_cycle_sec, 30, "Storage garbage collector int
 // `mg_import_csv`. If you change it, make sure to change it there as well.
 DEFINE_bool(storage_properties_on_edges, false, "Controls whether edges have properties.");
 DEFINE_bool(storage_recover_on_startup, false, "Controls whether the storage recovers persisted data on startup.");
+DEFINE_VALIDATED_uint64(storage_recovery_thread_count, storage::Config::Durability().recovery_thread_count,
+                        "Number of threads used to apply the WAL deltas during recovery. The deltas are applied "
+                        "sequentially when it's set to 1.",
+                        FLAG_IN_RANGE(1, 1024));
 DEFINE_VALIDATED_uint64(storage_snapshot_interval_sec, 0,
                         "Storage snapshot creation interval (in seconds). Set "
                         "to 0 to disable periodic snapshot creation.",
@@ -179,6 +200,13 @@ DEFINE_VALIDATED_uint64(storage_wal_file_flush_every_n_tx, storage::Config::Dura
                         "WAL file. Set to 1 for fully synchronous operation.",
                         FLAG_IN_RANGE(1, 1000000));
 DEFINE_bool(storage_snapshot_on_exit, false, "Controls whether the storage creates another snapshot on exit.");
+DEFINE_VALIDATED_uint64(storage_compression_block_size_kib,
+                        storage::Config::Durability::Compression().block_size_kibibytes,
+                        "Uncompressed size of each independently compressed block of the snapshot and WAL files.",
+                        FLAG_IN_RANGE(1, 64 * 1024));
+DEFINE_bool(storage_io_uring, false,
+            "Controls whether the snapshot and WAL files are written using io_uring. Blocking writes are used if the "
+            "kernel doesn't support it.");
 
 DEFINE_bool(telemetry_enabled, false,
             "Set to true to enable telemetry. We collect information about the "
@@ -223,8 +251,37 @@ constexpr std::array isolation_level_mappings{
 const std::string isolation_level_help_string =
     fmt::format("Default isolation level used for the transactions. Allowed values: {}",
                 GetAllowedEnumValuesString(isolation_level_mappings));
+
+constexpr std::array storage_compression_mappings{
+    std::pair{"NONE"sv, storage::Config::Durability::Compression::Type::NONE},
+    std::pair{"ZLIB"sv, storage::Config::Durability::Compression::Type::ZLIB}};
+
+const std::string storage_compression_help_string =
+    fmt::format("Compression used for the snapshot and WAL files. Allowed values: {}",
+                GetAllowedEnumValuesString(storage_compression_mappings));
 }  // namespace
 
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_string(storage_compression, "NONE", storage_compression_help_string.c_str(), {
+  if (const auto result = IsValidEnumValueString(value, storage_compression_mappings); result.HasError()) {
+    const auto error = result.GetError();
+    switch (error) {
+      case ValidationError::EmptyValue: {
+        std::cout << "Storage compression cannot be empty." << std::endl;
+        break;
+      }
+      case ValidationError::InvalidValue: {
+        std::cout << "Invalid value for storage compression. Allowed values: "
+                  << GetAllowedEnumValuesString(storage_compression_mappings) << std::endl;
+        break;
+      }
+    }
+    return false;
+  }
+
+  return true;
+});
+
 // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
 DEFINE_VALIDATED_string(isolation_level, "SNAPSHOT_ISOLATION", isolation_level_help_string.c_str(), {
   if (const auto result = IsValidEnumValueString(value, isolation_level_mappings); result.HasError()) {
@@ -253,6 +310,13 @@ storage::IsolationLevel ParseIsolationLevel() {
   return *isolation_level;
 }
 
+storage::Config::Durability::Compression::Type ParseStorageCompression() {
+  const auto compression = StringToEnum<storage::Config::Durability::Compression::Type>(FLAGS_storage_compression,
+                                                                                        storage_compression_mappings);
+  MG_ASSERT(compression, "Invalid storage compression");
+  return *compression;
+}
+
 int64_t GetMemoryLimit() {
   if (FLAGS_memory_limit == 0) {
     auto maybe_total_memory = utils::sysinfo::TotalMemory();
@@ -297,6 +361,13 @@ DEFINE_VALIDATED_string(query_modules_directory, "",
                           return true;
                         });
 
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_uint64(query_modules_python_interpreters, 0,
+              "Number of Python worker interpreters, each with its own GIL, which run Python query procedures and "
+              "transformations in parallel. With 0, they run in the main interpreter one at a time. Requires "
+              "Python 3.12 or newer; worker interpreters don't support temporal values and import only extension "
+              "modules with per-interpreter GIL support.");
+
 // Logging flags
 DEFINE_bool(also_log_to_stderr, false, "Log messages go to stderr in addition to logfiles");
 DEFINE_string(log_file, "", "Path to where the log should be stored.");
@@ -835,7 +906,7 @@ class BoltSession final : public communication::bolt::Session<communication::Inp
 
   std::map<std::string, communication::bolt::Value> Pull(TEncoder *encoder, std::optional<int> n,
                                                          std::optional<int> qid) override {
-    TypedValueResultStream stream(encoder, db_);
+    TypedValueResultStream stream(encoder, db_, &names_);
     return PullResults(stream, n, qid);
   }
 
@@ -893,13 +964,14 @@ class BoltSession final : public communication::bolt::Session<communication::Inp
   /// before forwarding the calls to original TEncoder.
   class TypedValueResultStream {
    public:
-    TypedValueResultStream(TEncoder *encoder, const storage::Storage *db) : encoder_(encoder), db_(db) {}
+    TypedValueResultStream(TEncoder *encoder, const storage::Storage *db, glue::BoltNameCache *names)
+        : encoder_(encoder), db_(db), names_(names) {}
 
     void Result(const std::vector<query::TypedValue> &values) {
-      std::vector<communication::bolt::Value> decoded_values;
-      decoded_values.reserve(values.size());
+      std::vector<glue::BoltField> fields;
+      fields.reserve(values.size());
       for (const auto &v : values) {
-        auto maybe_value = glue::ToBoltValue(v, *db_, storage::View::NEW);
+        auto maybe_value = glue::ToBoltField(v, *db_, storage::View::NEW);
         if (maybe_value.HasError()) {
           switch (maybe_value.GetError()) {
             case storage::Error::DELETED_OBJECT:
@@ -912,19 +984,25 @@ class BoltSession final : public communication::bolt::Session<communication::Inp
               throw communication::bolt::ClientError("Unexpected storage error when streaming results.");
           }
         }
-        decoded_values.emplace_back(std::move(*maybe_value));
+        fields.emplace_back(std::move(*maybe_value));
       }
-      encoder_->MessageRecord(decoded_values);
+      // Vertices and edges are encoded straight from the storage values.
+      encoder_->MessageRecord(fields.size(), [&](auto &encoder) {
+        for (const auto &field : fields) glue::EncodeBoltField(encoder, field, names_);
+      });
     }
 
    private:
     TEncoder *encoder_;
     // NOTE: Needed only for ToBoltValue conversions
     const storage::Storage *db_;
+    glue::BoltNameCache *names_;
   };
 
   // NOTE: Needed only for ToBoltValue conversions
   const storage::Storage *db_;
+  // Encoded names of labels, edge types and properties of returned objects.
+  glue::BoltNameCache names_{db_};
   query::Interpreter interpreter_;
   utils::Synchronized<auth::Auth, utils::WritePrioritizedRWLock> *auth_;
   std::optional<auth::User> user_;
@@ -1010,6 +1088,10 @@ int main(int argc, char **argv) {
     spdlog::error(
         utils::MessageWithLink("Unable to load support for embedded Python: {}.", e.what(), "https://memgr.ph/python"));
   }
+  if (FLAGS_query_modules_python_interpreters > 0 &&
+      !query::procedure::StartPyWorkerInterpreters(FLAGS_query_modules_python_interpreters)) {
+    spdlog::warn("Python query procedures will run in the main Python interpreter.");
+  }
 
   // Initialize the communication library.
   communication::SSLInit sslInit;
@@ -1096,10 +1178,14 @@ int main(int argc, char **argv) {
       .items = {.properties_on_edges = FLAGS_storage_properties_on_edges},
       .durability = {.storage_directory = FLAGS_data_directory,
                      .recover_on_startup = FLAGS_storage_recover_on_startup,
+                     .recovery_thread_count = FLAGS_storage_recovery_thread_count,
                      .snapshot_retention_count = FLAGS_storage_snapshot_retention_count,
                      .wal_file_size_kibibytes = FLAGS_storage_wal_file_size_kib,
                      .wal_file_flush_every_n_tx = FLAGS_storage_wal_file_flush_every_n_tx,
-                     .snapshot_on_exit = FLAGS_storage_snapshot_on_exit},
+                     .snapshot_on_exit = FLAGS_storage_snapshot_on_exit,
+                     .compression = {.type = ParseStorageCompression(),
+                                     .block_size_kibibytes = FLAGS_storage_compression_block_size_kib},
+                     .use_io_uring = FLAGS_storage_io_uring},
       .transaction = {.isolation_level = ParseIsolationLevel()}};
   if (FLAGS_storage_snapshot_interval_sec == 0) {
     if (FLAGS_storage_wal_enabled) {
@@ -1161,8 +1247,19 @@ int main(int argc, char **argv) {
     spdlog::warn(utils::MessageWithLink("Using non-secure Bolt connection (without SSL).", "https://memgr.ph/ssl"));
   }
 
+  std::optional<communication::ExecutionPoolConfig> execution_pool_config;
+  if (FLAGS_bolt_num_io_workers > 0) {
+    // At least one execution worker has to be able to run long running
+    // sessions.
+    const size_t reserved_workers_count =
+        std::min<size_t>(FLAGS_bolt_num_reserved_workers, static_cast<size_t>(FLAGS_bolt_num_workers) - 1);
+    execution_pool_config.emplace(communication::ExecutionPoolConfig{
+        static_cast<size_t>(FLAGS_bolt_num_workers), reserved_workers_count,
+        std::chrono::milliseconds(FLAGS_bolt_long_execution_threshold_ms), FLAGS_bolt_io_uring});
+  }
   ServerT server({FLAGS_bolt_address, static_cast<uint16_t>(FLAGS_bolt_port)}, &session_data, &context,
-                 FLAGS_bolt_session_inactivity_timeout, service_name, FLAGS_bolt_num_workers);
+                 FLAGS_bolt_session_inactivity_timeout, service_name,
+                 execution_pool_config ? FLAGS_bolt_num_io_workers : FLAGS_bolt_num_workers, execution_pool_config);
 
   // Setup telemetry
   std::optional<telemetry::Telemetry> telemetry;
@@ -1199,6 +1296,7 @@ int main(int argc, char **argv) {
   MG_ASSERT(server.Start(), "Couldn't start the Bolt server!");
   server.AwaitShutdown();
   query::procedure::gModuleRegistry.UnloadAllModules();
+  query::procedure::StopPyWorkerInterpreters();
 
   Py_END_ALLOW_THREADS;
   // Shutdown Python
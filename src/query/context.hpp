@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <optional>
 #include <type_traits>
 
 #include "query/common.hpp"
@@ -70,6 +71,8 @@ struct ExecutionContext {
   plan::ProfilingStats *stats_root{nullptr};
   TriggerContextCollector *trigger_context_collector{nullptr};
   utils::AsyncTimer timer;
+  // The QUERY MEMORY LIMIT of the query, if it was set.
+  std::optional<size_t> memory_limit;
 };
 
 static_assert(std::is_move_assignable_v<ExecutionContext>, "ExecutionContext must be move assignable!");
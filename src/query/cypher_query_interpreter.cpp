@@ -11,14 +11,82 @@
 
 #include "query/cypher_query_interpreter.hpp"
 
+#include <cmath>
+#include <mutex>
+
+#include "utils/fnv.hpp"
+
 // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
 DEFINE_HIDDEN_bool(query_cost_planner, true, "Use the cost-estimating query planner.");
 // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
-DEFINE_VALIDATED_int32(query_plan_cache_ttl, 60, "Time to live for cached query plans, in seconds.",
-                       FLAG_IN_RANGE(0, std::numeric_limits<int32_t>::max()));
+DEFINE_VALIDATED_double(query_plan_cache_max_drift, 2.0,
+                        "Factor by which the vertex count or the estimated cost of a cached query plan may change "
+                        "before the query is planned again.",
+                        FLAG_IN_RANGE(1.0, std::numeric_limits<double>::max()));
 
 namespace query {
-CachedPlan::CachedPlan(std::unique_ptr<LogicalPlan> plan) : plan_(std::move(plan)) {}
+namespace {
+// Returns by how many times the current estimate differs from the planned one.
+// Estimates are clamped to 1 so that empty results don't divide by zero.
+double DriftFactor(double planned, double current) {
+  planned = std::max(planned, 1.0);
+  current = std::max(current, 1.0);
+  return std::max(planned, current) / std::min(planned, current);
+}
+
+uint64_t ParametersHash(const Parameters &parameters) {
+  uint64_t hash = parameters.size();
+  for (const auto &[position, value] : parameters) {
+    hash = utils::HashCombine<uint64_t, int>{}(hash, position);
+    hash = utils::HashCombine<uint64_t, size_t>{}(hash, TypedValue::Hash{}(TypedValue(value)));
+  }
+  return hash;
+}
+
+// Plans made for parameters which don't fit the query's first plan are told
+// apart by the magnitude of their estimated cost.
+int64_t CostClass(double cost) { return static_cast<int64_t>(std::log2(std::max(cost, 1.0))); }
+}  // namespace
+
+CachedPlan::CachedPlan(std::unique_ptr<LogicalPlan> plan, int64_t vertex_count)
+    : plan_(std::move(plan)), vertex_count_(vertex_count) {}
+
+bool CachedPlan::IsStale(DbAccessor *db_accessor) const {
+  return DriftFactor(vertex_count_, db_accessor->VerticesCount()) > FLAGS_query_plan_cache_max_drift;
+}
+
+bool CachedPlan::IsStale(const Parameters &parameters, DbAccessor *db_accessor) const {
+  if (IsStale(db_accessor)) return true;
+  // Without parameters the estimated cost can change only with the data size
+  // which is covered above.
+  return parameters.size() != 0 && !FitsCost(EstimateCost(parameters, db_accessor));
+}
+
+Parameters CachedPlan::BindParameters(const Parameters &parameters, DbAccessor *db_accessor) const {
+  return plan::BindFoldedConstants(plan_->GetFoldedConstants(), parameters, db_accessor);
+}
+
+double CachedPlan::EstimateCost(const Parameters &parameters, DbAccessor *db_accessor) const {
+  const auto hash = ParametersHash(parameters);
+  {
+    std::lock_guard guard(estimated_costs_lock_);
+    if (auto it = estimated_costs_.find(hash); it != estimated_costs_.end()) return it->second;
+  }
+  // Re-estimating the cost of the existing plan is a lot cheaper than planning
+  // the query again and it captures the selectivity of the new parameter
+  // values used in index lookups.
+  auto vertex_counts = plan::MakeVertexCountCache(db_accessor);
+  const auto cost = plan::EstimatePlanCost(&vertex_counts, BindParameters(parameters, db_accessor),
+                                           const_cast<plan::LogicalOperator &>(plan_->GetRoot()));
+  std::lock_guard guard(estimated_costs_lock_);
+  if (estimated_costs_.size() == kMaxEstimatedCosts) estimated_costs_.clear();
+  estimated_costs_.emplace(hash, cost);
+  return cost;
+}
+
+bool CachedPlan::FitsCost(const double cost) const {
+  return DriftFactor(plan_->GetCost(), cost) <= FLAGS_query_plan_cache_max_drift;
+}
 
 ParsedQuery ParseQuery(const std::string &query_string, const std::map<std::string, storage::PropertyValue> &params,
                        utils::SkipList<QueryCacheEntry> *cache, utils::SpinLock *antlr_lock,
@@ -122,35 +190,48 @@ ParsedQuery ParseQuery(const std::string &query_string, const std::map<std::stri
 std::unique_ptr<LogicalPlan> MakeLogicalPlan(AstStorage ast_storage, CypherQuery *query, const Parameters &parameters,
                                              DbAccessor *db_accessor,
                                              const std::vector<Identifier *> &predefined_identifiers) {
+  auto bound_parameters = parameters;
+  auto folded_constants = plan::FoldConstants(query, &ast_storage, &bound_parameters, db_accessor);
   auto vertex_counts = plan::MakeVertexCountCache(db_accessor);
   auto symbol_table = MakeSymbolTable(query, predefined_identifiers);
   auto planning_context = plan::MakePlanningContext(&ast_storage, &symbol_table, query, &vertex_counts);
-  auto [root, cost] = plan::MakeLogicalPlan(&planning_context, parameters, FLAGS_query_cost_planner);
+  auto [root, cost] = plan::MakeLogicalPlan(&planning_context, bound_parameters, FLAGS_query_cost_planner);
   return std::make_unique<SingleNodeLogicalPlan>(std::move(root), cost, std::move(ast_storage),
-                                                 std::move(symbol_table));
+                                                 std::move(symbol_table), std::move(folded_constants));
 }
 
 std::shared_ptr<CachedPlan> CypherQueryToPlan(uint64_t hash, AstStorage ast_storage, CypherQuery *query,
                                               const Parameters &parameters, utils::SkipList<PlanCacheEntry> *plan_cache,
                                               DbAccessor *db_accessor,
                                               const std::vector<Identifier *> &predefined_identifiers) {
+  PlanCacheKey key{hash, std::nullopt};
   std::optional<utils::SkipList<PlanCacheEntry>::Accessor> plan_cache_access;
   if (plan_cache) {
     plan_cache_access.emplace(plan_cache->access());
-    auto it = plan_cache_access->find(hash);
+    auto it = plan_cache_access->find(key);
     if (it != plan_cache_access->end()) {
-      if (it->second->IsExpired()) {
-        plan_cache_access->remove(hash);
-      } else {
+      if (it->second->IsStale(db_accessor)) {
+        plan_cache_access->remove(key);
+      } else if (parameters.size() == 0) {
         return it->second;
+      } else if (const auto cost = it->second->EstimateCost(parameters, db_accessor); it->second->FitsCost(cost)) {
+        return it->second;
+      } else {
+        key.cost_class = CostClass(cost);
+        auto cost_class_it = plan_cache_access->find(key);
+        if (cost_class_it != plan_cache_access->end()) {
+          if (!cost_class_it->second->IsStale(parameters, db_accessor)) return cost_class_it->second;
+          plan_cache_access->remove(key);
+        }
       }
     }
   }
 
   auto plan = std::make_shared<CachedPlan>(
-      MakeLogicalPlan(std::move(ast_storage), query, parameters, db_accessor, predefined_identifiers));
+      MakeLogicalPlan(std::move(ast_storage), query, parameters, db_accessor, predefined_identifiers),
+      db_accessor->VerticesCount());
   if (plan_cache_access) {
-    plan_cache_access->insert({hash, plan});
+    plan_cache_access->insert({key, plan});
   }
   return plan;
 }
@@ -11,6 +11,10 @@
 
 #pragma once
 
+#include <compare>
+#include <optional>
+#include <unordered_map>
+
 //////////////////////////////////////////////////////
 // THIS INCLUDE SHOULD ALWAYS COME BEFORE THE
 // "cypher_main_visitor.hpp"
@@ -23,21 +27,24 @@
 #include "query/plan/planner.hpp"
 //////////////////////////////////////////////////////
 #include "query/config.hpp"
+#include "query/plan/constant_folding.hpp"
 #include "query/frontend/ast/cypher_main_visitor.hpp"
 #include "query/frontend/opencypher/parser.hpp"
 #include "query/frontend/semantic/required_privileges.hpp"
 #include "query/frontend/semantic/symbol_generator.hpp"
 #include "query/frontend/stripped.hpp"
 #include "utils/flag_validation.hpp"
-#include "utils/timer.hpp"
+#include "utils/spin_lock.hpp"
 
 // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
 DECLARE_bool(query_cost_planner);
 // NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
-DECLARE_int32(query_plan_cache_ttl);
+DECLARE_double(query_plan_cache_max_drift);
 
 namespace query {
 
+class DbAccessor;
+
 // TODO: Maybe this should move to query/plan/planner.
 /// Interface for accessing the root operator of a logical plan.
 class LogicalPlan {
@@ -55,25 +62,55 @@ class LogicalPlan {
   virtual double GetCost() const = 0;
   virtual const SymbolTable &GetSymbolTable() const = 0;
   virtual const AstStorage &GetAstStorage() const = 0;
+  virtual const std::vector<plan::FoldedConstant> &GetFoldedConstants() const = 0;
 };
 
 class CachedPlan {
  public:
-  explicit CachedPlan(std::unique_ptr<LogicalPlan> plan);
+  /// @param vertex_count number of vertices in the database at the time the
+  /// plan was made, used for detecting data-size drift.
+  explicit CachedPlan(std::unique_ptr<LogicalPlan> plan, int64_t vertex_count = 0);
 
   const auto &plan() const { return plan_->GetRoot(); }
   double cost() const { return plan_->GetCost(); }
   const auto &symbol_table() const { return plan_->GetSymbolTable(); }
   const auto &ast_storage() const { return plan_->GetAstStorage(); }
 
-  bool IsExpired() const {
-    // NOLINTNEXTLINE (modernize-use-nullptr)
-    return cache_timer_.Elapsed() > std::chrono::seconds(FLAGS_query_plan_cache_ttl);
-  };
+  /// Returns true if the plan should be regenerated for any parameters, i.e.
+  /// if the number of vertices changed by more than
+  /// `query_plan_cache_max_drift` times since planning. Plans don't expire
+  /// otherwise, index and constraint changes clear the whole cache.
+  bool IsStale(DbAccessor *db_accessor) const;
+
+  /// Returns true if the plan should be regenerated before executing it with
+  /// the given parameters. Besides the cases covered by `IsStale` above, that
+  /// happens when the plan was made for parameter values of very different
+  /// selectivity (see `FitsCost`).
+  bool IsStale(const Parameters &parameters, DbAccessor *db_accessor) const;
+
+  /// Returns the parameters the plan is executed with, i.e. `parameters` with
+  /// the values of the constants folded in the plan (see `plan::FoldConstants`).
+  Parameters BindParameters(const Parameters &parameters, DbAccessor *db_accessor) const;
+
+  /// Estimates the cost of the plan under the given parameters. The estimates
+  /// are cached by the parameter values, so a plan which is executed with the
+  /// same values again isn't estimated again.
+  double EstimateCost(const Parameters &parameters, DbAccessor *db_accessor) const;
+
+  /// Returns true if the estimated `cost` differs from the cost the plan was
+  /// chosen with by at most `query_plan_cache_max_drift` times.
+  bool FitsCost(double cost) const;
 
  private:
+  // Limits the number of cached cost estimates, the cache is cleared when it
+  // gets full.
+  static constexpr size_t kMaxEstimatedCosts = 128;
+
   std::unique_ptr<LogicalPlan> plan_;
-  utils::Timer cache_timer_;
+  int64_t vertex_count_;
+  mutable utils::SpinLock estimated_costs_lock_;
+  // Estimated costs by the hash of the parameter values.
+  mutable std::unordered_map<uint64_t, double> estimated_costs_;
 };
 
 struct CachedQuery {
@@ -94,13 +131,24 @@ struct QueryCacheEntry {
   CachedQuery second;
 };
 
+/// Key of a cached plan. Parameters which don't fit the plan of a query get
+/// plans of their own, one per cost class (see `CypherQueryToPlan`).
+struct PlanCacheKey {
+  auto operator<=>(const PlanCacheKey &) const = default;
+
+  uint64_t query_hash;
+  // Magnitude of the estimated cost the plan was made for, empty for the
+  // plan which is tried first.
+  std::optional<int64_t> cost_class;
+};
+
 struct PlanCacheEntry {
   bool operator==(const PlanCacheEntry &other) const { return first == other.first; }
   bool operator<(const PlanCacheEntry &other) const { return first < other.first; }
-  bool operator==(const uint64_t &other) const { return first == other; }
-  bool operator<(const uint64_t &other) const { return first < other; }
+  bool operator==(const PlanCacheKey &other) const { return first == other; }
+  bool operator<(const PlanCacheKey &other) const { return first < other; }
 
-  uint64_t first;
+  PlanCacheKey first;
   // TODO: Maybe store the query string here and use it as a key with the hash
   // so that we eliminate the risk of hash collisions.
   std::shared_ptr<CachedPlan> second;
@@ -127,19 +175,25 @@ ParsedQuery ParseQuery(const std::string &query_string, const std::map<std::stri
 class SingleNodeLogicalPlan final : public LogicalPlan {
  public:
   SingleNodeLogicalPlan(std::unique_ptr<plan::LogicalOperator> root, double cost, AstStorage storage,
-                        const SymbolTable &symbol_table)
-      : root_(std::move(root)), cost_(cost), storage_(std::move(storage)), symbol_table_(symbol_table) {}
+                        const SymbolTable &symbol_table, std::vector<plan::FoldedConstant> folded_constants = {})
+      : root_(std::move(root)),
+        cost_(cost),
+        storage_(std::move(storage)),
+        symbol_table_(symbol_table),
+        folded_constants_(std::move(folded_constants)) {}
 
   const plan::LogicalOperator &GetRoot() const override { return *root_; }
   double GetCost() const override { return cost_; }
   const SymbolTable &GetSymbolTable() const override { return symbol_table_; }
   const AstStorage &GetAstStorage() const override { return storage_; }
+  const std::vector<plan::FoldedConstant> &GetFoldedConstants() const override { return folded_constants_; }
 
  private:
   std::unique_ptr<plan::LogicalOperator> root_;
   double cost_;
   AstStorage storage_;
   SymbolTable symbol_table_;
+  std::vector<plan::FoldedConstant> folded_constants_;
 };
 
 std::unique_ptr<LogicalPlan> MakeLogicalPlan(AstStorage ast_storage, CypherQuery *query, const Parameters &parameters,
@@ -148,7 +202,11 @@ std::unique_ptr<LogicalPlan> MakeLogicalPlan(AstStorage ast_storage, CypherQuery
 
 /**
  * Return the parsed *Cypher* query's AST cached logical plan, or create and
- * cache a fresh one if it doesn't yet exist.
+ * cache a fresh one if it doesn't yet exist or the cached one is stale for the
+ * given parameters (see `CachedPlan::IsStale`). Parameters which don't fit the
+ * cached plan get a plan of their own, cached by the magnitude of their cost,
+ * so that parameters of different selectivity don't keep replacing each
+ * other's plans.
  * @param predefined_identifiers optional identifiers you want to inject into a query.
  * If an identifier is not defined in a scope, we check the predefined identifiers.
  * If an identifier is contained there, we inject it at that place and remove it,
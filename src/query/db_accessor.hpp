@@ -230,6 +230,10 @@ class DbAccessor final {
 
   VerticesIterable Vertices(storage::View view) { return VerticesIterable(accessor_->Vertices(view)); }
 
+  VerticesIterable Vertices(storage::View view, storage::Gid from, std::optional<storage::Gid> to) {
+    return VerticesIterable(accessor_->Vertices(from, to, view));
+  }
+
   VerticesIterable Vertices(storage::View view, storage::LabelId label) {
     return VerticesIterable(accessor_->Vertices(label, view));
   }
@@ -353,6 +357,8 @@ class DbAccessor final {
     return accessor_->ApproximateVertexCount(label, property, lower, upper);
   }
 
+  storage::Gid VertexGidUpperBound() const { return accessor_->VertexGidUpperBound(); }
+
   storage::IndicesInfo ListAllIndices() const { return accessor_->ListAllIndices(); }
 
   storage::ConstraintsInfo ListAllConstraints() const { return accessor_->ListAllConstraints(); }
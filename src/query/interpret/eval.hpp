@@ -80,12 +80,6 @@ class ExpressionEvaluator : public ExpressionVisitor<TypedValue> {
   BINARY_OPERATOR_VISITOR(MultiplicationOperator, *, *);
   BINARY_OPERATOR_VISITOR(DivisionOperator, /, /);
   BINARY_OPERATOR_VISITOR(ModOperator, %, %);
-  BINARY_OPERATOR_VISITOR(NotEqualOperator, !=, <>);
-  BINARY_OPERATOR_VISITOR(EqualOperator, ==, =);
-  BINARY_OPERATOR_VISITOR(LessOperator, <, <);
-  BINARY_OPERATOR_VISITOR(GreaterOperator, >, >);
-  BINARY_OPERATOR_VISITOR(LessEqualOperator, <=, <=);
-  BINARY_OPERATOR_VISITOR(GreaterEqualOperator, >=, >=);
 
   UNARY_OPERATOR_VISITOR(NotOperator, !, NOT);
   UNARY_OPERATOR_VISITOR(UnaryPlusOperator, +, +);
@@ -94,6 +88,36 @@ class ExpressionEvaluator : public ExpressionVisitor<TypedValue> {
 #undef BINARY_OPERATOR_VISITOR
 #undef UNARY_OPERATOR_VISITOR
 
+// Comparisons dominate the evaluation of filters, so numeric and boolean
+// operands are compared directly instead of going through the generic
+// TypedValue operators. Operands which are identifiers are read from the frame
+// without copying them. `FAST_CMP` must match the definition of `CPP_OP` in
+// typed_value.hpp, so that the results stay the same (e.g. for NaN).
+#define COMPARISON_OPERATOR_VISITOR(OP_NODE, CPP_OP, CYPHER_OP, FAST_CMP, COMPARES_BOOL)                       \
+  TypedValue Visit(OP_NODE &op) override {                                                                     \
+    TypedValue evaluated1(ctx_->memory);                                                                       \
+    TypedValue evaluated2(ctx_->memory);                                                                       \
+    const auto &val1 = EvaluateInPlace(op.expression1_, &evaluated1);                                          \
+    const auto &val2 = EvaluateInPlace(op.expression2_, &evaluated2);                                          \
+    if (auto result = CompareFast<COMPARES_BOOL>(val1, val2, [](const auto &a, const auto &b) { FAST_CMP; })) { \
+      return TypedValue(*result, ctx_->memory);                                                                \
+    }                                                                                                          \
+    try {                                                                                                      \
+      return val1 CPP_OP val2;                                                                                 \
+    } catch (const TypedValueException &) {                                                                    \
+      throw QueryRuntimeException("Invalid types: {} and {} for '{}'.", val1.type(), val2.type(), #CYPHER_OP); \
+    }                                                                                                          \
+  }
+
+  COMPARISON_OPERATOR_VISITOR(NotEqualOperator, !=, <>, return !(a == b), true);
+  COMPARISON_OPERATOR_VISITOR(EqualOperator, ==, =, return a == b, true);
+  COMPARISON_OPERATOR_VISITOR(LessOperator, <, <, return a < b, false);
+  COMPARISON_OPERATOR_VISITOR(GreaterOperator, >, >, return !(a < b || a == b), false);
+  COMPARISON_OPERATOR_VISITOR(LessEqualOperator, <=, <=, return a < b || a == b, false);
+  COMPARISON_OPERATOR_VISITOR(GreaterEqualOperator, >=, >=, return !(a < b), false);
+
+#undef COMPARISON_OPERATOR_VISITOR
+
   TypedValue Visit(AndOperator &op) override {
     auto value1 = op.expression1_->Accept(*this);
     if (value1.IsBool() && !value1.ValueBool()) {
@@ -258,7 +282,8 @@ class ExpressionEvaluator : public ExpressionVisitor<TypedValue> {
   }
 
   TypedValue Visit(PropertyLookup &property_lookup) override {
-    auto expression_result = property_lookup.expression_->Accept(*this);
+    TypedValue evaluated(ctx_->memory);
+    const auto &expression_result = EvaluateInPlace(property_lookup.expression_, &evaluated);
     auto maybe_date = [this](const auto &date, const auto &prop_name) -> std::optional<TypedValue> {
       if (prop_name == "year") {
         return TypedValue(date.year, ctx_->memory);
@@ -321,9 +346,16 @@ class ExpressionEvaluator : public ExpressionVisitor<TypedValue> {
       case TypedValue::Type::Edge:
         return TypedValue(GetProperty(expression_result.ValueEdge(), property_lookup.property_), ctx_->memory);
       case TypedValue::Type::Map: {
+        if (&expression_result != &evaluated) {
+          // The map is stored in the frame, so the element must be copied.
+          const auto &map = expression_result.ValueMap();
+          auto found = map.find(property_lookup.property_.name.c_str());
+          if (found == map.end()) return TypedValue(ctx_->memory);
+          return TypedValue(found->second, ctx_->memory);
+        }
         // NOTE: Take non-const reference to map, so that we can move out the
         // looked-up element as the result.
-        auto &map = expression_result.ValueMap();
+        auto &map = evaluated.ValueMap();
         auto found = map.find(property_lookup.property_.name.c_str());
         if (found == map.end()) return TypedValue(ctx_->memory);
         // NOTE: Explicit move is needed, so that we return the move constructed
@@ -688,6 +720,43 @@ class ExpressionEvaluator : public ExpressionVisitor<TypedValue> {
   }
 
  private:
+  // Evaluates the expression into `storage` and returns a reference to it,
+  // unless the expression is an identifier. Identifiers are returned directly
+  // from the frame, which avoids copying strings, lists and maps.
+  const TypedValue &EvaluateInPlace(Expression *expression, TypedValue *storage) {
+    if (auto *ident = utils::Downcast<Identifier>(expression)) {
+      return frame_->at(symbol_table_->at(*ident));
+    }
+    *storage = expression->Accept(*this);
+    return *storage;
+  }
+
+  // Returns the result of `cmp` if both values are numeric, or both are
+  // booleans and `TComparesBool` is set. Otherwise, returns nullopt and the
+  // comparison needs to be done by the generic TypedValue operator.
+  template <bool TComparesBool, class TCmp>
+  static std::optional<bool> CompareFast(const TypedValue &a, const TypedValue &b, const TCmp &cmp) {
+    using Type = TypedValue::Type;
+    const auto type_a = a.type();
+    const auto type_b = b.type();
+    if (type_a == Type::Int && type_b == Type::Int) {
+      return cmp(a.ValueInt(), b.ValueInt());
+    }
+    const auto is_numeric = [](const auto type) { return type == Type::Int || type == Type::Double; };
+    if (is_numeric(type_a) && is_numeric(type_b)) {
+      const auto to_double = [](const TypedValue &value) {
+        return value.type() == Type::Int ? static_cast<double>(value.ValueInt()) : value.ValueDouble();
+      };
+      return cmp(to_double(a), to_double(b));
+    }
+    if constexpr (TComparesBool) {
+      if (type_a == Type::Bool && type_b == Type::Bool) {
+        return cmp(a.ValueBool(), b.ValueBool());
+      }
+    }
+    return std::nullopt;
+  }
+
   template <class TRecordAccessor>
   storage::PropertyValue GetProperty(const TRecordAccessor &record_accessor, PropertyIx prop) {
     auto maybe_prop = record_accessor.GetProperty(view_, ctx_->properties[prop.ix]);
@@ -712,7 +781,7 @@ class ExpressionEvaluator : public ExpressionVisitor<TypedValue> {
           throw QueryRuntimeException("Unexpected error when getting a property.");
       }
     }
-    return *maybe_prop;
+    return std::move(*maybe_prop);
   }
 
   template <class TRecordAccessor>
@@ -739,7 +808,7 @@ class ExpressionEvaluator : public ExpressionVisitor<TypedValue> {
           throw QueryRuntimeException("Unexpected error when getting a property.");
       }
     }
-    return *maybe_prop;
+    return std::move(*maybe_prop);
   }
 
   storage::LabelId GetLabel(LabelIx label) { return ctx_->labels[label.ix]; }
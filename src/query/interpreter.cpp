@@ -748,7 +748,14 @@ struct PullPlan {
                                                         std::map<std::string, TypedValue> *summary);
 
  private:
+  // Cursors free and allocate values for each row, e.g. in ORDER BY or
+  // DISTINCT, so they and the frame use a pool over the execution memory
+  // which reuses freed blocks instead of taking new ones from it.
+  static constexpr size_t kCursorMemoryMaxBlocksPerChunk = 128;
+  static constexpr size_t kCursorMemoryMaxBlockSize = 1024;
+
   std::shared_ptr<CachedPlan> plan_ = nullptr;
+  utils::PoolResource cursor_memory_;
   plan::UniqueCursorPtr cursor_ = nullptr;
   Frame frame_;
   ExecutionContext ctx_;
@@ -772,13 +779,14 @@ PullPlan::PullPlan(const std::shared_ptr<CachedPlan> plan, const Parameters &par
                    DbAccessor *dba, InterpreterContext *interpreter_context, utils::MemoryResource *execution_memory,
                    TriggerContextCollector *trigger_context_collector, const std::optional<size_t> memory_limit)
     : plan_(plan),
-      cursor_(plan->plan().MakeCursor(execution_memory)),
-      frame_(plan->symbol_table().max_position(), execution_memory),
+      cursor_memory_(kCursorMemoryMaxBlocksPerChunk, kCursorMemoryMaxBlockSize, execution_memory),
+      cursor_(plan->plan().MakeCursor(&cursor_memory_)),
+      frame_(plan->symbol_table().max_position(), &cursor_memory_),
       memory_limit_(memory_limit) {
   ctx_.db_accessor = dba;
   ctx_.symbol_table = plan->symbol_table();
   ctx_.evaluation_context.timestamp = QueryTimestamp();
-  ctx_.evaluation_context.parameters = parameters;
+  ctx_.evaluation_context.parameters = plan->BindParameters(parameters, dba);
   ctx_.evaluation_context.properties = NamesToProperties(plan->ast_storage().properties_, dba);
   ctx_.evaluation_context.labels = NamesToLabels(plan->ast_storage().labels_, dba);
   if (interpreter_context->config.execution_timeout_sec > 0) {
@@ -787,6 +795,7 @@ PullPlan::PullPlan(const std::shared_ptr<CachedPlan> plan, const Parameters &par
   ctx_.is_shutting_down = &interpreter_context->is_shutting_down;
   ctx_.is_profile_query = is_profile_query;
   ctx_.trigger_context_collector = trigger_context_collector;
+  ctx_.memory_limit = memory_limit;
 }
 
 std::optional<plan::ProfilingStatsWithTotalTime> PullPlan::Pull(AnyStream *stream, std::optional<int> n,
@@ -1137,6 +1146,17 @@ PreparedQuery PrepareDumpQuery(ParsedQuery parsed_query, std::map<std::string, T
                        RWType::R};
 }
 
+namespace {
+// Cached plans are only valid for the indices and constraints that existed
+// when they were made.
+void InvalidatePlanCache(InterpreterContext *interpreter_context) {
+  auto access = interpreter_context->plan_cache.access();
+  for (auto &kv : access) {
+    access.remove(kv.first);
+  }
+}
+}  // namespace
+
 PreparedQuery PrepareIndexQuery(ParsedQuery parsed_query, bool in_explicit_transaction,
                                 std::map<std::string, TypedValue> *summary, InterpreterContext *interpreter_context,
                                 utils::MemoryResource *execution_memory) {
@@ -1147,14 +1167,6 @@ PreparedQuery PrepareIndexQuery(ParsedQuery parsed_query, bool in_explicit_trans
   auto *index_query = utils::Downcast<IndexQuery>(parsed_query.query);
   std::function<void()> handler;
 
-  // Creating an index influences computed plan costs.
-  auto invalidate_plan_cache = [plan_cache = &interpreter_context->plan_cache] {
-    auto access = plan_cache->access();
-    for (auto &kv : access) {
-      access.remove(kv.first);
-    }
-  };
-
   auto label = interpreter_context->db->NameToLabel(index_query->label_.name);
   std::vector<storage::PropertyId> properties;
   properties.reserve(index_query->properties_.size());
@@ -1168,8 +1180,7 @@ PreparedQuery PrepareIndexQuery(ParsedQuery parsed_query, bool in_explicit_trans
 
   switch (index_query->action_) {
     case IndexQuery::Action::CREATE: {
-      handler = [interpreter_context, label, properties = std::move(properties),
-                 invalidate_plan_cache = std::move(invalidate_plan_cache)] {
+      handler = [interpreter_context, label, properties = std::move(properties)] {
         if (properties.empty()) {
           interpreter_context->db->CreateIndex(label);
           EventCounter::IncrementCounter(EventCounter::LabelIndexCreated);
@@ -1178,20 +1189,20 @@ PreparedQuery PrepareIndexQuery(ParsedQuery parsed_query, bool in_explicit_trans
           interpreter_context->db->CreateIndex(label, properties[0]);
           EventCounter::IncrementCounter(EventCounter::LabelPropertyIndexCreated);
         }
-        invalidate_plan_cache();
+        // Creating or dropping an index influences computed plan costs.
+        InvalidatePlanCache(interpreter_context);
       };
       break;
     }
     case IndexQuery::Action::DROP: {
-      handler = [interpreter_context, label, properties = std::move(properties),
-                 invalidate_plan_cache = std::move(invalidate_plan_cache)] {
+      handler = [interpreter_context, label, properties = std::move(properties)] {
         if (properties.empty()) {
           interpreter_context->db->DropIndex(label);
         } else {
           MG_ASSERT(properties.size() == 1U);
           interpreter_context->db->DropIndex(label, properties[0]);
         }
-        invalidate_plan_cache();
+        InvalidatePlanCache(interpreter_context);
       };
       break;
     }
@@ -1778,8 +1789,9 @@ PreparedQuery PrepareConstraintQuery(ParsedQuery parsed_query, bool in_explicit_
 
   return PreparedQuery{{},
                        std::move(parsed_query.required_privileges),
-                       [handler = std::move(handler)](AnyStream *stream, std::optional<int> n) {
+                       [handler = std::move(handler), interpreter_context](AnyStream *stream, std::optional<int> n) {
                          handler();
+                         InvalidatePlanCache(interpreter_context);
                          return QueryHandlerResult::COMMIT;
                        },
                        RWType::NONE};
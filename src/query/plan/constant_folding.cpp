@@ -0,0 +1,278 @@
+// Copyright 2021 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "query/plan/constant_folding.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "query/db_accessor.hpp"
+#include "query/frontend/semantic/symbol_table.hpp"
+#include "query/interpret/awesome_memgraph_functions.hpp"
+#include "query/interpret/eval.hpp"
+#include "query/interpret/frame.hpp"
+#include "utils/exceptions.hpp"
+
+namespace query::plan {
+
+namespace {
+
+// -1 is the position of parameter lookups which weren't made from a token.
+constexpr int32_t kFirstFoldedPosition = -2;
+
+// Returns true if the result of the function depends only on its arguments.
+// RANGE is left out because it makes lists of any size from small arguments,
+// and the temporal functions return the current time without arguments.
+bool IsPure(const Function &function) {
+  static const std::unordered_set<std::string_view> kPureFunctions{
+      // Scalar and list functions
+      "HEAD", "LAST", "SIZE", "TAIL", "TOBOOLEAN", "TOFLOAT", "TOINTEGER", "VALUETYPE",
+      // Mathematical functions
+      "ABS", "CEIL", "FLOOR", "ROUND", "SIGN", "E", "EXP", "LOG", "LOG10", "SQRT", "ACOS", "ASIN", "ATAN", "ATAN2",
+      "COS", "PI", "SIN", "TAN",
+      // String functions
+      kContains, kEndsWith, kStartsWith, "LEFT", "LTRIM", "REPLACE", "REVERSE", "RIGHT", "RTRIM", "SPLIT",
+      "SUBSTRING", "TOLOWER", "TOSTRING", "TOUPPER", "TRIM"};
+  static const std::unordered_set<std::string_view> kTemporalFunctions{"DATE", "LOCALTIME", "LOCALDATETIME",
+                                                                       "DURATION"};
+  if (kPureFunctions.contains(function.function_name_)) return true;
+  return kTemporalFunctions.contains(function.function_name_) && !function.arguments_.empty();
+}
+
+class ConstantFolder final : public HierarchicalTreeVisitor {
+ public:
+  ConstantFolder(AstStorage *storage, Parameters parameters, DbAccessor *dba)
+      : storage_(storage), evaluator_(&frame_, symbol_table_, context_, dba, storage::View::OLD) {
+    context_.parameters = std::move(parameters);
+  }
+
+  using HierarchicalTreeVisitor::PostVisit;
+  using HierarchicalTreeVisitor::PreVisit;
+  using HierarchicalTreeVisitor::Visit;
+
+  bool Visit(Identifier &) override { return true; }
+
+  bool Visit(PrimitiveLiteral &literal) override {
+    constants_.insert(&literal);
+    return true;
+  }
+
+  bool Visit(ParameterLookup &lookup) override {
+    constants_.insert(&lookup);
+    return true;
+  }
+
+  bool PostVisit(OrOperator &op) override { return PostVisitOperator(op, true, op.expression1_, op.expression2_); }
+  bool PostVisit(XorOperator &op) override { return PostVisitOperator(op, true, op.expression1_, op.expression2_); }
+  bool PostVisit(AndOperator &op) override { return PostVisitOperator(op, true, op.expression1_, op.expression2_); }
+  bool PostVisit(AdditionOperator &op) override {
+    return PostVisitOperator(op, true, op.expression1_, op.expression2_);
+  }
+  bool PostVisit(SubtractionOperator &op) override {
+    return PostVisitOperator(op, true, op.expression1_, op.expression2_);
+  }
+  bool PostVisit(MultiplicationOperator &op) override {
+    return PostVisitOperator(op, true, op.expression1_, op.expression2_);
+  }
+  bool PostVisit(DivisionOperator &op) override {
+    return PostVisitOperator(op, true, op.expression1_, op.expression2_);
+  }
+  bool PostVisit(ModOperator &op) override { return PostVisitOperator(op, true, op.expression1_, op.expression2_); }
+  bool PostVisit(NotEqualOperator &op) override {
+    return PostVisitOperator(op, true, op.expression1_, op.expression2_);
+  }
+  bool PostVisit(EqualOperator &op) override { return PostVisitOperator(op, true, op.expression1_, op.expression2_); }
+  bool PostVisit(LessOperator &op) override { return PostVisitOperator(op, true, op.expression1_, op.expression2_); }
+  bool PostVisit(GreaterOperator &op) override {
+    return PostVisitOperator(op, true, op.expression1_, op.expression2_);
+  }
+  bool PostVisit(LessEqualOperator &op) override {
+    return PostVisitOperator(op, true, op.expression1_, op.expression2_);
+  }
+  bool PostVisit(GreaterEqualOperator &op) override {
+    return PostVisitOperator(op, true, op.expression1_, op.expression2_);
+  }
+  bool PostVisit(InListOperator &op) override {
+    return PostVisitOperator(op, true, op.expression1_, op.expression2_);
+  }
+  bool PostVisit(SubscriptOperator &op) override {
+    return PostVisitOperator(op, true, op.expression1_, op.expression2_);
+  }
+  bool PostVisit(ListSlicingOperator &op) override {
+    return PostVisitOperator(op, true, op.list_, op.lower_bound_, op.upper_bound_);
+  }
+  bool PostVisit(IfOperator &op) override {
+    return PostVisitOperator(op, true, op.condition_, op.then_expression_, op.else_expression_);
+  }
+  bool PostVisit(NotOperator &op) override { return PostVisitOperator(op, true, op.expression_); }
+  bool PostVisit(UnaryPlusOperator &op) override { return PostVisitOperator(op, true, op.expression_); }
+  bool PostVisit(UnaryMinusOperator &op) override { return PostVisitOperator(op, true, op.expression_); }
+  bool PostVisit(IsNullOperator &op) override { return PostVisitOperator(op, true, op.expression_); }
+  bool PostVisit(RegexMatch &op) override { return PostVisitOperator(op, true, op.string_expr_, op.regex_); }
+  bool PostVisit(ListLiteral &literal) override { return PostVisitOperator(literal, true, literal.elements_); }
+  bool PostVisit(MapLiteral &literal) override { return PostVisitOperator(literal, true, literal.elements_); }
+  bool PostVisit(Coalesce &coalesce) override { return PostVisitOperator(coalesce, true, coalesce.expressions_); }
+  bool PostVisit(Function &function) override {
+    return PostVisitOperator(function, IsPure(function), function.arguments_);
+  }
+
+  // The following are never constant, but their operands may be.
+  bool PostVisit(Aggregation &aggregation) override {
+    Fold(aggregation.expression1_);
+    Fold(aggregation.expression2_);
+    return true;
+  }
+  bool PostVisit(PropertyLookup &lookup) override {
+    Fold(lookup.expression_);
+    return true;
+  }
+  bool PostVisit(LabelsTest &test) override {
+    Fold(test.expression_);
+    return true;
+  }
+  bool PostVisit(Reduce &reduce) override {
+    Fold(reduce.initializer_);
+    Fold(reduce.list_);
+    Fold(reduce.expression_);
+    return true;
+  }
+  bool PostVisit(Extract &extract) override {
+    Fold(extract.list_);
+    Fold(extract.expression_);
+    return true;
+  }
+  bool PostVisit(All &all) override {
+    Fold(all.list_expression_);
+    return true;
+  }
+  bool PostVisit(Single &single) override {
+    Fold(single.list_expression_);
+    return true;
+  }
+  bool PostVisit(Any &any) override {
+    Fold(any.list_expression_);
+    return true;
+  }
+  bool PostVisit(None &none) override {
+    Fold(none.list_expression_);
+    return true;
+  }
+
+  // Roots of the expressions evaluated for each row.
+  bool PostVisit(Where &where) override {
+    Fold(where.expression_);
+    return true;
+  }
+  bool PostVisit(NamedExpression &named_expression) override {
+    Fold(named_expression.expression_);
+    return true;
+  }
+
+  std::vector<FoldedConstant> TakeFolded(Parameters *parameters) {
+    *parameters = std::move(context_.parameters);
+    return std::move(folded_);
+  }
+
+ private:
+  bool IsConstant(const Expression *expression) const { return !expression || constants_.contains(expression); }
+
+  bool IsConstant(const std::vector<Expression *> &expressions) const {
+    return std::all_of(expressions.begin(), expressions.end(), [this](const auto *e) { return IsConstant(e); });
+  }
+
+  bool IsConstant(const std::unordered_map<PropertyIx, Expression *> &expressions) const {
+    return std::all_of(expressions.begin(), expressions.end(),
+                       [this](const auto &property) { return IsConstant(property.second); });
+  }
+
+  // Marks `expression` as constant if it's pure and all of its operands are
+  // constant. Otherwise it's evaluated for each row, so its constant operands
+  // are folded.
+  template <class... TOperands>
+  bool PostVisitOperator(Expression &expression, bool is_pure, TOperands &...operands) {
+    if (is_pure && (IsConstant(operands) && ...)) {
+      constants_.insert(&expression);
+    } else {
+      (Fold(operands), ...);
+    }
+    return true;
+  }
+
+  void Fold(std::vector<Expression *> &expressions) {
+    for (auto &expression : expressions) Fold(expression);
+  }
+
+  void Fold(std::unordered_map<PropertyIx, Expression *> &expressions) {
+    for (auto &property : expressions) Fold(property.second);
+  }
+
+  void Fold(Expression *&expression) {
+    if (!expression || !IsConstant(expression)) return;
+    // Literals and parameters are as cheap as a folded constant.
+    if (utils::Downcast<PrimitiveLiteral>(expression) || utils::Downcast<ParameterLookup>(expression)) return;
+    // The planner looks into list literals, e.g. to look up the values of an
+    // IN filter in an index, so only their elements are folded.
+    if (auto *list = utils::Downcast<ListLiteral>(expression)) {
+      Fold(list->elements_);
+      return;
+    }
+    std::optional<storage::PropertyValue> value;
+    try {
+      value.emplace(storage::PropertyValue(expression->Accept(evaluator_)));
+    } catch (const utils::BasicException &) {
+      return;
+    }
+    context_.parameters.Add(next_position_, *value);
+    folded_.push_back({next_position_, expression});
+    expression = storage_->Create<ParameterLookup>(next_position_);
+    --next_position_;
+  }
+
+  AstStorage *storage_;
+  SymbolTable symbol_table_;
+  Frame frame_{0};
+  EvaluationContext context_;
+  ExpressionEvaluator evaluator_;
+  std::unordered_set<const Expression *> constants_;
+  std::vector<FoldedConstant> folded_;
+  int32_t next_position_{kFirstFoldedPosition};
+};
+
+}  // namespace
+
+std::vector<FoldedConstant> FoldConstants(CypherQuery *query, AstStorage *storage, Parameters *parameters,
+                                          DbAccessor *dba) {
+  ConstantFolder folder(storage, std::move(*parameters), dba);
+  query->single_query_->Accept(folder);
+  for (auto *cypher_union : query->cypher_unions_) {
+    cypher_union->Accept(folder);
+  }
+  return folder.TakeFolded(parameters);
+}
+
+Parameters BindFoldedConstants(const std::vector<FoldedConstant> &constants, Parameters parameters, DbAccessor *dba) {
+  if (constants.empty()) return parameters;
+  SymbolTable symbol_table;
+  Frame frame(0);
+  EvaluationContext context;
+  context.parameters = std::move(parameters);
+  ExpressionEvaluator evaluator(&frame, symbol_table, context, dba, storage::View::OLD);
+  for (const auto &[token_position, expression] : constants) {
+    auto value = storage::PropertyValue(expression->Accept(evaluator));
+    context.parameters.Add(token_position, value);
+  }
+  return std::move(context.parameters);
+}
+
+}  // namespace query::plan
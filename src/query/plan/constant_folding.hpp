@@ -0,0 +1,60 @@
+// Copyright 2021 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+/// @file
+/// This file provides the folding of constant subexpressions of a query, which
+/// is done before planning. The public entrypoints are `FoldConstants` and
+/// `BindFoldedConstants`.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "query/frontend/ast/ast.hpp"
+#include "query/parameters.hpp"
+
+namespace query {
+
+class DbAccessor;
+
+namespace plan {
+
+/// Subexpression of a query which has the same value for every row, because
+/// it consists only of literals, parameters and pure operators and functions.
+struct FoldedConstant {
+  /// Token position of the `ParameterLookup` which replaced the expression in
+  /// the query. These positions are negative, so they don't clash with the
+  /// positions of literals and parameters.
+  int32_t token_position;
+  Expression *expression;
+};
+
+/// Replaces the constant subexpressions of `query` with parameter lookups, so
+/// they are evaluated once per execution instead of once per row.
+///
+/// Literals are stripped into parameters and a cached plan is executed with
+/// different values for them, so the folded expressions are kept and
+/// `BindFoldedConstants` evaluates them for each execution. Their values for
+/// `parameters` are added to it, so that the query can be planned with them.
+/// Expressions which can't be evaluated for `parameters` aren't folded and
+/// keep failing only for the rows which reach them.
+std::vector<FoldedConstant> FoldConstants(CypherQuery *query, AstStorage *storage, Parameters *parameters,
+                                          DbAccessor *dba);
+
+/// Returns `parameters` with the values of the folded `constants` added.
+///
+/// @throw utils::BasicException if a constant can't be evaluated for the given
+/// parameters, as its evaluation for a row would.
+Parameters BindFoldedConstants(const std::vector<FoldedConstant> &constants, Parameters parameters, DbAccessor *dba);
+
+}  // namespace plan
+}  // namespace query
@@ -12,7 +12,10 @@
 #include "query/plan/operator.hpp"
 
 #include <algorithm>
+#include <array>
+#include <condition_variable>
 #include <limits>
+#include <mutex>
 #include <queue>
 #include <random>
 #include <string>
@@ -32,7 +35,9 @@
 #include "query/frontend/semantic/symbol_table.hpp"
 #include "query/interpret/eval.hpp"
 #include "query/path.hpp"
+#include "query/plan/read_write_type_checker.hpp"
 #include "query/plan/scoped_profile.hpp"
+#include "query/plan/spill.hpp"
 #include "query/procedure/cypher_types.hpp"
 #include "query/procedure/mg_procedure_impl.hpp"
 #include "query/procedure/module.hpp"
@@ -49,6 +54,7 @@
 #include "utils/pmr/vector.hpp"
 #include "utils/readable_size.hpp"
 #include "utils/string.hpp"
+#include "utils/thread_pool.hpp"
 
 // macro for the default implementation of LogicalOperator::Accept
 // that accepts the visitor and visits it's input_ operator
@@ -109,6 +115,36 @@ namespace query::plan {
 
 namespace {
 
+// Replaces the evaluation memory of the context while it exists. It's meant for
+// values which are needed only while a single input row is processed, so that
+// operators which evaluate expressions on many rows during one Pull don't keep
+// growing the evaluation memory. The first buffer is on the stack and memory
+// beyond it is returned to the original evaluation memory on destruction.
+class RowEvaluationMemory final {
+ public:
+  explicit RowEvaluationMemory(EvaluationContext *context)
+      : context_(context),
+        upstream_(context->memory),
+        memory_(buffer_.data(), buffer_.size(), upstream_) {
+    context_->memory = &memory_;
+  }
+
+  ~RowEvaluationMemory() { context_->memory = upstream_; }
+
+  RowEvaluationMemory(const RowEvaluationMemory &) = delete;
+  RowEvaluationMemory &operator=(const RowEvaluationMemory &) = delete;
+  RowEvaluationMemory(RowEvaluationMemory &&) = delete;
+  RowEvaluationMemory &operator=(RowEvaluationMemory &&) = delete;
+
+ private:
+  static constexpr size_t kBufferSize = 4096;
+
+  EvaluationContext *context_;
+  utils::MemoryResource *upstream_;
+  std::array<char, kBufferSize> buffer_;
+  utils::MonotonicBufferResource memory_;
+};
+
 // Custom equality function for a vector of typed values.
 // Used in unordered_maps in Aggregate and Distinct operators.
 struct TypedValueVectorEqual {
@@ -1026,7 +1062,10 @@ class ExpandVariableCursor : public Cursor {
       // Skip expanding out of filtered expansion.
       frame[self_.filter_lambda_.inner_edge_symbol] = current_edge.first;
       frame[self_.filter_lambda_.inner_node_symbol] = current_vertex;
-      if (self_.filter_lambda_.expression && !EvaluateFilter(evaluator, self_.filter_lambda_.expression)) continue;
+      if (self_.filter_lambda_.expression) {
+        RowEvaluationMemory row_memory(&context.evaluation_context);
+        if (!EvaluateFilter(evaluator, self_.filter_lambda_.expression)) continue;
+      }
 
       // we are doing depth-first search, so place the current
       // edge's expansions onto the stack, if we should continue to expand
@@ -1121,12 +1160,13 @@ class STShortestPathCursor : public query::plan::Cursor {
   }
 
   bool ShouldExpand(const VertexAccessor &vertex, const EdgeAccessor &edge, Frame *frame,
-                    ExpressionEvaluator *evaluator) {
+                    ExpressionEvaluator *evaluator, EvaluationContext *evaluation_context) {
     if (!self_.filter_lambda_.expression) return true;
 
     frame->at(self_.filter_lambda_.inner_node_symbol) = vertex;
     frame->at(self_.filter_lambda_.inner_edge_symbol) = edge;
 
+    RowEvaluationMemory row_memory(evaluation_context);
     TypedValue result = self_.filter_lambda_.expression->Accept(*evaluator);
     if (result.IsNull()) return false;
     if (result.IsBool()) return result.ValueBool();
@@ -1135,7 +1175,7 @@ class STShortestPathCursor : public query::plan::Cursor {
   }
 
   bool FindPath(const DbAccessor &dba, const VertexAccessor &source, const VertexAccessor &sink, int64_t lower_bound,
-                int64_t upper_bound, Frame *frame, ExpressionEvaluator *evaluator, const ExecutionContext &context) {
+                int64_t upper_bound, Frame *frame, ExpressionEvaluator *evaluator, ExecutionContext &context) {
     using utils::Contains;
 
     if (source == sink) return false;
@@ -1178,7 +1218,8 @@ class STShortestPathCursor : public query::plan::Cursor {
         if (self_.common_.direction != EdgeAtom::Direction::IN) {
           auto out_edges = UnwrapEdgesResult(vertex.OutEdges(storage::View::OLD, self_.common_.edge_types));
           for (const auto &edge : out_edges) {
-            if (ShouldExpand(edge.To(), edge, frame, evaluator) && !Contains(in_edge, edge.To())) {
+            if (ShouldExpand(edge.To(), edge, frame, evaluator, &context.evaluation_context) &&
+                !Contains(in_edge, edge.To())) {
               in_edge.emplace(edge.To(), edge);
               if (Contains(out_edge, edge.To())) {
                 if (current_length >= lower_bound) {
@@ -1195,7 +1236,8 @@ class STShortestPathCursor : public query::plan::Cursor {
         if (self_.common_.direction != EdgeAtom::Direction::OUT) {
           auto in_edges = UnwrapEdgesResult(vertex.InEdges(storage::View::OLD, self_.common_.edge_types));
           for (const auto &edge : in_edges) {
-            if (ShouldExpand(edge.From(), edge, frame, evaluator) && !Contains(in_edge, edge.From())) {
+            if (ShouldExpand(edge.From(), edge, frame, evaluator, &context.evaluation_context) &&
+                !Contains(in_edge, edge.From())) {
               in_edge.emplace(edge.From(), edge);
               if (Contains(out_edge, edge.From())) {
                 if (current_length >= lower_bound) {
@@ -1226,7 +1268,8 @@ class STShortestPathCursor : public query::plan::Cursor {
         if (self_.common_.direction != EdgeAtom::Direction::OUT) {
           auto out_edges = UnwrapEdgesResult(vertex.OutEdges(storage::View::OLD, self_.common_.edge_types));
           for (const auto &edge : out_edges) {
-            if (ShouldExpand(vertex, edge, frame, evaluator) && !Contains(out_edge, edge.To())) {
+            if (ShouldExpand(vertex, edge, frame, evaluator, &context.evaluation_context) &&
+                !Contains(out_edge, edge.To())) {
               out_edge.emplace(edge.To(), edge);
               if (Contains(in_edge, edge.To())) {
                 if (current_length >= lower_bound) {
@@ -1243,7 +1286,8 @@ class STShortestPathCursor : public query::plan::Cursor {
         if (self_.common_.direction != EdgeAtom::Direction::IN) {
           auto in_edges = UnwrapEdgesResult(vertex.InEdges(storage::View::OLD, self_.common_.edge_types));
           for (const auto &edge : in_edges) {
-            if (ShouldExpand(vertex, edge, frame, evaluator) && !Contains(out_edge, edge.From())) {
+            if (ShouldExpand(vertex, edge, frame, evaluator, &context.evaluation_context) &&
+                !Contains(out_edge, edge.From())) {
               out_edge.emplace(edge.From(), edge);
               if (Contains(in_edge, edge.From())) {
                 if (current_length >= lower_bound) {
@@ -1289,7 +1333,7 @@ class SingleSourceShortestPathCursor : public query::plan::Cursor {
 
     // for the given (edge, vertex) pair checks if they satisfy the
     // "where" condition. if so, places them in the to_visit_ structure.
-    auto expand_pair = [this, &evaluator, &frame](EdgeAccessor edge, VertexAccessor vertex) {
+    auto expand_pair = [this, &evaluator, &frame, &context](EdgeAccessor edge, VertexAccessor vertex) {
       // if we already processed the given vertex it doesn't get expanded
       if (processed_.find(vertex) != processed_.end()) return;
 
@@ -1297,6 +1341,7 @@ class SingleSourceShortestPathCursor : public query::plan::Cursor {
       frame[self_.filter_lambda_.inner_node_symbol] = vertex;
 
       if (self_.filter_lambda_.expression) {
+        RowEvaluationMemory row_memory(&context.evaluation_context);
         TypedValue result = self_.filter_lambda_.expression->Accept(evaluator);
         switch (result.type()) {
           case TypedValue::Type::Null:
@@ -1444,13 +1489,14 @@ class ExpandWeightedShortestPathCursor : public query::plan::Cursor {
     // For the given (edge, vertex, weight, depth) tuple checks if they
     // satisfy the "where" condition. if so, places them in the priority
     // queue.
-    auto expand_pair = [this, &evaluator, &frame, &create_state](const EdgeAccessor &edge, const VertexAccessor &vertex,
-                                                                 double weight, int64_t depth) {
+    auto expand_pair = [this, &evaluator, &frame, &context, &create_state](
+                           const EdgeAccessor &edge, const VertexAccessor &vertex, double weight, int64_t depth) {
       auto *memory = evaluator.GetMemoryResource();
       if (self_.filter_lambda_.expression) {
         frame[self_.filter_lambda_.inner_edge_symbol] = edge;
         frame[self_.filter_lambda_.inner_node_symbol] = vertex;
 
+        RowEvaluationMemory row_memory(&context.evaluation_context);
         if (!EvaluateFilter(evaluator, self_.filter_lambda_.expression)) return;
       }
 
@@ -1778,6 +1824,7 @@ bool Filter::FilterCursor::Pull(Frame &frame, ExecutionContext &context) {
   ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                 storage::View::OLD);
   while (input_cursor_->Pull(frame, context)) {
+    RowEvaluationMemory row_memory(&context.evaluation_context);
     if (EvaluateFilter(evaluator, self_.expression_)) return true;
   }
   return false;
@@ -1818,6 +1865,9 @@ bool Produce::ProduceCursor::Pull(Frame &frame, ExecutionContext &context) {
     // Produce should always yield the latest results.
     ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                   storage::View::NEW);
+    // The results are copied into the frame, so intermediate values may be
+    // freed right away.
+    RowEvaluationMemory row_memory(&context.evaluation_context);
     for (auto named_expr : self_.named_expressions_) named_expr->Accept(evaluator);
 
     return true;
@@ -2561,10 +2611,25 @@ TypedValue DefaultAggregationOpValue(const Aggregate::Element &element, utils::M
 }
 }  // namespace
 
+// Unlike OrderBy, Aggregate doesn't spill to disk. It holds one entry per
+// group rather than per input row, and spilling the groups would need the
+// input to be partitioned by the group keys and each partition aggregated on
+// its own.
 class AggregateCursor : public Cursor {
  public:
   AggregateCursor(const Aggregate &self, utils::MemoryResource *mem)
-      : self_(self), input_cursor_(self_.input_->MakeCursor(mem)), aggregation_(mem) {}
+      : self_(self),
+        input_cursor_(self_.input_->MakeCursor(mem)),
+        aggregation_(mem),
+        group_by_buffer_(mem),
+        batch_groups_(mem),
+        batch_values_(self_.aggregations_.size(), mem),
+        batch_keys_(self_.aggregations_.size(), mem),
+        batch_selection_(mem),
+        batch_ints_(mem),
+        batch_doubles_(mem) {
+    group_by_buffer_.reserve(self_.group_by_.size());
+  }
 
   bool Pull(Frame &frame, ExecutionContext &context) override {
     SCOPED_PROFILE_OP("Aggregate");
@@ -2606,12 +2671,19 @@ class AggregateCursor : public Cursor {
 
   void Reset() override {
     input_cursor_->Reset();
+    ClearBatch();
     aggregation_.clear();
     aggregation_it_ = aggregation_.begin();
     pulled_all_input_ = false;
   }
 
  private:
+  // Input rows are aggregated in batches of up to `kBatchSize` rows. The
+  // aggregation inputs of a batch are evaluated into columns which are then
+  // folded into their groups one aggregation at a time, so the aggregation
+  // op is dispatched once per batch and not once per row.
+  static constexpr size_t kBatchSize = 1024;
+
   // Data structure for a single aggregation cache.
   // Does NOT include the group-by values since those are a key in the
   // aggregation map. The vectors in an AggregationValue contain one element for
@@ -2649,6 +2721,23 @@ class AggregateCursor : public Cursor {
   // this LogicalOp pulls all from the input on it's first pull
   // this switch tracks if this has been performed
   bool pulled_all_input_{false};
+  // Reused buffer for the group-by values of an input row. Only the rows
+  // which start a new group copy them into the aggregation memory.
+  utils::pmr::vector<TypedValue> group_by_buffer_;
+  // Group of each row in the current batch.
+  utils::pmr::vector<AggregationValue *> batch_groups_;
+  // Input values of each aggregation for the rows in the current batch,
+  // COUNT(*) has no inputs.
+  utils::pmr::vector<utils::pmr::vector<TypedValue>> batch_values_;
+  // Keys of each COLLECT_MAP aggregation for the rows in the current batch.
+  utils::pmr::vector<utils::pmr::vector<TypedValue>> batch_keys_;
+  // Rows of the current batch whose input value of the aggregation which is
+  // being updated isn't Null.
+  utils::pmr::vector<uint32_t> batch_selection_;
+  // Typed copy of the selected input values when all of them are integers or
+  // all of them are doubles, indexed like `batch_selection_`.
+  utils::pmr::vector<int64_t> batch_ints_;
+  utils::pmr::vector<double> batch_doubles_;
 
   /**
    * Pulls from the input operator until exhausted and aggregates the
@@ -2663,8 +2752,10 @@ class AggregateCursor : public Cursor {
     ExpressionEvaluator evaluator(frame, context->symbol_table, context->evaluation_context, context->db_accessor,
                                   storage::View::NEW);
     while (input_cursor_->Pull(*frame, *context)) {
-      ProcessOne(*frame, &evaluator);
+      ProcessOne(*frame, &evaluator, &context->evaluation_context);
+      if (batch_groups_.size() == kBatchSize) UpdateBatch();
     }
+    UpdateBatch();
 
     // calculate AVG aggregations (so far they have only been summed)
     for (size_t pos = 0; pos < self_.aggregations_.size(); ++pos) {
@@ -2681,18 +2772,38 @@ class AggregateCursor : public Cursor {
   }
 
   /**
-   * Performs a single accumulation.
+   * Finds the group of a single input row and adds the row's aggregation
+   * inputs to the batch.
    */
-  void ProcessOne(const Frame &frame, ExpressionEvaluator *evaluator) {
-    auto *mem = aggregation_.get_allocator().GetMemoryResource();
-    utils::pmr::vector<TypedValue> group_by(mem);
-    group_by.reserve(self_.group_by_.size());
+  void ProcessOne(const Frame &frame, ExpressionEvaluator *evaluator, EvaluationContext *evaluation_context) {
+    // The evaluated values are copied into the cursor memory, so intermediate
+    // values may be freed right away.
+    RowEvaluationMemory row_memory(evaluation_context);
+    group_by_buffer_.clear();
     for (Expression *expression : self_.group_by_) {
-      group_by.emplace_back(expression->Accept(*evaluator));
+      group_by_buffer_.emplace_back(expression->Accept(*evaluator));
+    }
+    auto found = aggregation_.find(group_by_buffer_);
+    if (found == aggregation_.end()) {
+      auto *mem = aggregation_.get_allocator().GetMemoryResource();
+      found = aggregation_.try_emplace(utils::pmr::vector<TypedValue>(group_by_buffer_, mem), mem).first;
     }
-    auto &agg_value = aggregation_.try_emplace(std::move(group_by), mem).first->second;
+    auto &agg_value = found->second;
     EnsureInitialized(frame, &agg_value);
-    Update(evaluator, &agg_value);
+    batch_groups_.push_back(&agg_value);
+
+    for (size_t pos = 0; pos < self_.aggregations_.size(); ++pos) {
+      const auto &agg_elem = self_.aggregations_[pos];
+      if (!agg_elem.value) continue;
+      const auto &input_value = batch_values_[pos].emplace_back(agg_elem.value->Accept(*evaluator));
+      if (!agg_elem.key) continue;
+      // Keys of Null values aren't needed because Null values are skipped.
+      if (input_value.IsNull()) {
+        batch_keys_[pos].emplace_back();
+      } else {
+        batch_keys_[pos].emplace_back(agg_elem.key->Accept(*evaluator));
+      }
+    }
   }
 
   /** Ensures the new AggregationValue has been initialized. This means
@@ -2711,110 +2822,195 @@ class AggregateCursor : public Cursor {
     for (const Symbol &remember_sym : self_.remember_) agg_value->remember_.push_back(frame[remember_sym]);
   }
 
-  /** Updates the given AggregationValue with new data. Assumes that
-   * the AggregationValue has been initialized */
-  void Update(ExpressionEvaluator *evaluator, AggregateCursor::AggregationValue *agg_value) {
-    DMG_ASSERT(self_.aggregations_.size() == agg_value->values_.size(),
-               "Expected as much AggregationValue.values_ as there are "
-               "aggregations.");
-    DMG_ASSERT(self_.aggregations_.size() == agg_value->counts_.size(),
-               "Expected as much AggregationValue.counts_ as there are "
-               "aggregations.");
-
-    // we iterate over counts, values and aggregation info at the same time
-    auto count_it = agg_value->counts_.begin();
-    auto value_it = agg_value->values_.begin();
-    auto agg_elem_it = self_.aggregations_.begin();
-    for (; count_it < agg_value->counts_.end(); count_it++, value_it++, agg_elem_it++) {
+  /** Updates the groups with the rows of the current batch and clears the
+   * batch. Assumes that the groups have been initialized. */
+  void UpdateBatch() {
+    for (size_t pos = 0; pos < self_.aggregations_.size(); ++pos) {
+      const auto &agg_elem = self_.aggregations_[pos];
       // COUNT(*) is the only case where input expression is optional
       // handle it here
-      auto input_expr_ptr = agg_elem_it->value;
-      if (!input_expr_ptr) {
-        *count_it += 1;
-        *value_it = *count_it;
-        continue;
-      }
-
-      TypedValue input_value = input_expr_ptr->Accept(*evaluator);
-
-      // Aggregations skip Null input values.
-      if (input_value.IsNull()) continue;
-      const auto &agg_op = agg_elem_it->op;
-      *count_it += 1;
-      if (*count_it == 1) {
-        // first value, nothing to aggregate. check type, set and continue.
-        switch (agg_op) {
-          case Aggregation::Op::MIN:
-          case Aggregation::Op::MAX:
-            *value_it = input_value;
-            EnsureOkForMinMax(input_value);
-            break;
-          case Aggregation::Op::SUM:
-          case Aggregation::Op::AVG:
-            *value_it = input_value;
-            EnsureOkForAvgSum(input_value);
-            break;
-          case Aggregation::Op::COUNT:
-            *value_it = 1;
-            break;
-          case Aggregation::Op::COLLECT_LIST:
-            value_it->ValueList().push_back(input_value);
-            break;
-          case Aggregation::Op::COLLECT_MAP:
-            auto key = agg_elem_it->key->Accept(*evaluator);
-            if (key.type() != TypedValue::Type::String) throw QueryRuntimeException("Map key must be a string.");
-            value_it->ValueMap().emplace(key.ValueString(), input_value);
-            break;
+      if (!agg_elem.value) {
+        for (auto *agg_value : batch_groups_) {
+          auto &count = agg_value->counts_[pos];
+          agg_value->values_[pos] = ++count;
         }
         continue;
       }
-
-      // aggregation of existing values
-      switch (agg_op) {
+      switch (agg_elem.op) {
         case Aggregation::Op::COUNT:
-          *value_it = *count_it;
+          UpdateColumn<Aggregation::Op::COUNT>(pos);
           break;
-        case Aggregation::Op::MIN: {
-          EnsureOkForMinMax(input_value);
-          try {
-            TypedValue comparison_result = input_value < *value_it;
-            // since we skip nulls we either have a valid comparison, or
-            // an exception was just thrown above
-            // safe to assume a bool TypedValue
-            if (comparison_result.ValueBool()) *value_it = input_value;
-          } catch (const TypedValueException &) {
-            throw QueryRuntimeException("Unable to get MIN of '{}' and '{}'.", input_value.type(), value_it->type());
-          }
+        case Aggregation::Op::MIN:
+          UpdateColumn<Aggregation::Op::MIN>(pos);
           break;
-        }
-        case Aggregation::Op::MAX: {
-          //  all comments as for Op::Min
-          EnsureOkForMinMax(input_value);
-          try {
-            TypedValue comparison_result = input_value > *value_it;
-            if (comparison_result.ValueBool()) *value_it = input_value;
-          } catch (const TypedValueException &) {
-            throw QueryRuntimeException("Unable to get MAX of '{}' and '{}'.", input_value.type(), value_it->type());
-          }
+        case Aggregation::Op::MAX:
+          UpdateColumn<Aggregation::Op::MAX>(pos);
           break;
-        }
-        case Aggregation::Op::AVG:
-        // for averaging we sum first and divide by count once all
-        // the input has been processed
         case Aggregation::Op::SUM:
-          EnsureOkForAvgSum(input_value);
-          *value_it = *value_it + input_value;
+          UpdateColumn<Aggregation::Op::SUM>(pos);
+          break;
+        case Aggregation::Op::AVG:
+          UpdateColumn<Aggregation::Op::AVG>(pos);
           break;
         case Aggregation::Op::COLLECT_LIST:
-          value_it->ValueList().push_back(input_value);
+          UpdateColumn<Aggregation::Op::COLLECT_LIST>(pos);
           break;
         case Aggregation::Op::COLLECT_MAP:
-          auto key = agg_elem_it->key->Accept(*evaluator);
-          if (key.type() != TypedValue::Type::String) throw QueryRuntimeException("Map key must be a string.");
-          value_it->ValueMap().emplace(key.ValueString(), input_value);
+          UpdateColumn<Aggregation::Op::COLLECT_MAP>(pos);
           break;
-      }  // end switch over Aggregation::Op enum
-    }    // end loop over all aggregations
+      }
+    }
+    ClearBatch();
+  }
+
+  /** Folds the input values of the aggregation at `pos` into the groups of
+   * their rows. */
+  template <Aggregation::Op TOp>
+  void UpdateColumn(const size_t pos) {
+    const auto column_type = SelectColumn(batch_values_[pos]);
+    if constexpr (TOp == Aggregation::Op::MIN || TOp == Aggregation::Op::MAX || TOp == Aggregation::Op::SUM ||
+                  TOp == Aggregation::Op::AVG) {
+      if (column_type == TypedValue::Type::Int) {
+        UpdateTypedColumn<TOp>(pos, batch_ints_);
+        return;
+      }
+      if (column_type == TypedValue::Type::Double) {
+        UpdateTypedColumn<TOp>(pos, batch_doubles_);
+        return;
+      }
+    }
+    auto &input_values = batch_values_[pos];
+    for (const auto row : batch_selection_) {
+      auto &input_value = input_values[row];
+      auto *agg_value = batch_groups_[row];
+      auto &count = agg_value->counts_[pos];
+      auto &value = agg_value->values_[pos];
+      count += 1;
+      if constexpr (TOp == Aggregation::Op::COUNT) {
+        value = count;
+      } else if constexpr (TOp == Aggregation::Op::MIN || TOp == Aggregation::Op::MAX) {
+        EnsureOkForMinMax(input_value);
+        // first value, nothing to aggregate
+        if (count == 1) {
+          value = std::move(input_value);
+          continue;
+        }
+        constexpr auto op_name = TOp == Aggregation::Op::MIN ? "MIN" : "MAX";
+        try {
+          TypedValue comparison_result = TOp == Aggregation::Op::MIN ? input_value < value : input_value > value;
+          // since we skip nulls we either have a valid comparison, or
+          // an exception was just thrown above
+          // safe to assume a bool TypedValue
+          if (comparison_result.ValueBool()) value = std::move(input_value);
+        } catch (const TypedValueException &) {
+          throw QueryRuntimeException("Unable to get {} of '{}' and '{}'.", op_name, input_value.type(), value.type());
+        }
+      } else if constexpr (TOp == Aggregation::Op::SUM || TOp == Aggregation::Op::AVG) {
+        // for averaging we sum first and divide by count once all
+        // the input has been processed
+        EnsureOkForAvgSum(input_value);
+        if (count == 1) {
+          value = std::move(input_value);
+        } else {
+          value = value + input_value;
+        }
+      } else if constexpr (TOp == Aggregation::Op::COLLECT_LIST) {
+        value.ValueList().push_back(std::move(input_value));
+      } else {
+        static_assert(TOp == Aggregation::Op::COLLECT_MAP);
+        const auto &key = batch_keys_[pos][row];
+        if (key.type() != TypedValue::Type::String) throw QueryRuntimeException("Map key must be a string.");
+        value.ValueMap().emplace(key.ValueString(), std::move(input_value));
+      }
+    }
+  }
+
+  /**
+   * Fills `batch_selection_` with the rows whose value in `input_values`
+   * isn't Null. When all of the selected values are integers or all of them
+   * are doubles, they are also copied into `batch_ints_` or `batch_doubles_`
+   * and that type is returned. Otherwise Null is returned.
+   */
+  TypedValue::Type SelectColumn(const utils::pmr::vector<TypedValue> &input_values) {
+    batch_selection_.clear();
+    auto column_type = TypedValue::Type::Null;
+    bool mixed = false;
+    for (uint32_t row = 0; row < input_values.size(); ++row) {
+      const auto type = input_values[row].type();
+      if (type == TypedValue::Type::Null) continue;
+      batch_selection_.push_back(row);
+      if (column_type == TypedValue::Type::Null) column_type = type;
+      mixed |= type != column_type;
+    }
+    if (mixed) return TypedValue::Type::Null;
+    if (column_type == TypedValue::Type::Int) {
+      batch_ints_.clear();
+      for (const auto row : batch_selection_) batch_ints_.push_back(input_values[row].ValueInt());
+    } else if (column_type == TypedValue::Type::Double) {
+      batch_doubles_.clear();
+      for (const auto row : batch_selection_) batch_doubles_.push_back(input_values[row].ValueDouble());
+    } else {
+      return TypedValue::Type::Null;
+    }
+    return column_type;
+  }
+
+  /**
+   * Folds a numeric column of selected input values into the groups of their
+   * rows. Groups which already hold a value of the same type are updated in
+   * place, the rest go through the TypedValue operators.
+   */
+  template <Aggregation::Op TOp, class TNumber>
+  void UpdateTypedColumn(const size_t pos, const utils::pmr::vector<TNumber> &column) {
+    constexpr auto kType = std::is_same_v<TNumber, int64_t> ? TypedValue::Type::Int : TypedValue::Type::Double;
+    for (size_t i = 0; i < column.size(); ++i) {
+      const auto input = column[i];
+      auto *agg_value = batch_groups_[batch_selection_[i]];
+      auto &count = agg_value->counts_[pos];
+      auto &value = agg_value->values_[pos];
+      count += 1;
+      if (count == 1) {
+        value = input;
+        continue;
+      }
+      if (value.type() != kType) {
+        TypedValue input_value(input, value.GetMemoryResource());
+        if constexpr (TOp == Aggregation::Op::SUM || TOp == Aggregation::Op::AVG) {
+          value = value + input_value;
+        } else {
+          constexpr auto op_name = TOp == Aggregation::Op::MIN ? "MIN" : "MAX";
+          try {
+            TypedValue comparison_result = TOp == Aggregation::Op::MIN ? input_value < value : input_value > value;
+            if (comparison_result.ValueBool()) value = std::move(input_value);
+          } catch (const TypedValueException &) {
+            throw QueryRuntimeException("Unable to get {} of '{}' and '{}'.", op_name, input_value.type(),
+                                        value.type());
+          }
+        }
+        continue;
+      }
+      auto &current = [&value]() -> TNumber & {
+        if constexpr (std::is_same_v<TNumber, int64_t>) {
+          return value.ValueInt();
+        } else {
+          return value.ValueDouble();
+        }
+      }();
+      if constexpr (TOp == Aggregation::Op::SUM || TOp == Aggregation::Op::AVG) {
+        current += input;
+      } else if constexpr (TOp == Aggregation::Op::MIN) {
+        current = std::min(current, input);
+      } else {
+        static_assert(TOp == Aggregation::Op::MAX);
+        current = std::max(current, input);
+      }
+    }
+  }
+
+  void ClearBatch() {
+    batch_groups_.clear();
+    for (auto &input_values : batch_values_) input_values.clear();
+    for (auto &keys : batch_keys_) keys.clear();
   }
 
   /** Checks if the given TypedValue is legal in MIN and MAX. If not
@@ -2961,8 +3157,8 @@ void Limit::LimitCursor::Reset() {
 }
 
 OrderBy::OrderBy(const std::shared_ptr<LogicalOperator> &input, const std::vector<SortItem> &order_by,
-                 const std::vector<Symbol> &output_symbols)
-    : input_(input), output_symbols_(output_symbols) {
+                 const std::vector<Symbol> &output_symbols, Expression *skip, Expression *limit)
+    : input_(input), output_symbols_(output_symbols), skip_(skip), limit_(limit) {
   // split the order_by vector into two vectors of orderings and expressions
   std::vector<Ordering> ordering;
   ordering.reserve(order_by.size());
@@ -2986,7 +3182,7 @@ std::vector<Symbol> OrderBy::ModifiedSymbols(const SymbolTable &table) const { r
 class OrderByCursor : public Cursor {
  public:
   OrderByCursor(const OrderBy &self, utils::MemoryResource *mem)
-      : self_(self), input_cursor_(self_.input_->MakeCursor(mem)), cache_(mem) {}
+      : self_(self), input_cursor_(self_.input_->MakeCursor(mem)), runs_(mem), heads_(mem), merge_heap_(mem) {}
 
   bool Pull(Frame &frame, ExecutionContext &context) override {
     SCOPED_PROFILE_OP("OrderBy");
@@ -2994,13 +3190,30 @@ class OrderByCursor : public Cursor {
     if (!did_pull_all_) {
       ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                     storage::View::OLD);
-      auto *mem = cache_.get_allocator().GetMemoryResource();
+      const auto top_k = EvaluateTopK(&evaluator);
+      // Elements of the top-K heap are constantly replaced, so they are
+      // allocated from a pool which reuses the freed memory.
+      auto *mem = top_k ? &pool_memory_ : cache_.get_allocator().GetMemoryResource();
+      uint64_t pulled = 0;
       while (input_cursor_->Pull(frame, context)) {
         // collect the order_by elements
         utils::pmr::vector<TypedValue> order_by(mem);
         order_by.reserve(self_.order_by_.size());
-        for (auto expression_ptr : self_.order_by_) {
-          order_by.emplace_back(expression_ptr->Accept(evaluator));
+        {
+          // The keys are copied into `mem`, so intermediate values may be
+          // freed right away.
+          RowEvaluationMemory row_memory(&context.evaluation_context);
+          for (auto expression_ptr : self_.order_by_) {
+            order_by.emplace_back(expression_ptr->Accept(evaluator));
+          }
+        }
+
+        if (top_k && cache_.size() == *top_k) {
+          // The heap is full, the row is kept only if it precedes the last
+          // row of the heap, which is on its top.
+          if (cache_.empty() || !self_.compare_(order_by, cache_.front().order_by)) continue;
+          std::pop_heap(cache_.begin(), cache_.end(), ElementCompare());
+          cache_.pop_back();
         }
 
         // collect the output elements
@@ -3009,16 +3222,33 @@ class OrderByCursor : public Cursor {
         for (const Symbol &output_sym : self_.output_symbols_) output.emplace_back(frame[output_sym]);
 
         cache_.push_back(Element{std::move(order_by), std::move(output)});
+
+        if (top_k) {
+          std::push_heap(cache_.begin(), cache_.end(), ElementCompare());
+        } else if (++pulled % kSpillCheckInterval == 0 &&
+                   ShouldSpill(context, cache_memory_counter_.GetAllocatedBytes())) {
+          SpillCache();
+          CascadeRuns(context.db_accessor);
+        }
       }
 
-      std::sort(cache_.begin(), cache_.end(), [this](const auto &pair1, const auto &pair2) {
-        return self_.compare_(pair1.order_by, pair2.order_by);
-      });
+      if (top_k) {
+        std::sort_heap(cache_.begin(), cache_.end(), ElementCompare());
+      } else if (runs_.empty()) {
+        SortCache();
+      } else {
+        // Some of the input is on disk, so the sorted runs are merged.
+        if (!cache_.empty()) SpillCache();
+        while (runs_.size() > kSpillMaxMergedRuns) MergeRuns(context.db_accessor, runs_.size() - kSpillMaxMergedRuns);
+        StartMerge(context.db_accessor);
+      }
 
       did_pull_all_ = true;
       cache_it_ = cache_.begin();
     }
 
+    if (!runs_.empty()) return PullMerged(frame, context);
+
     if (cache_it_ == cache_.end()) return false;
 
     if (MustAbort(context)) throw HintedAbortError();
@@ -3038,24 +3268,194 @@ class OrderByCursor : public Cursor {
   void Reset() override {
     input_cursor_->Reset();
     did_pull_all_ = false;
-    cache_.clear();
+    ClearCache();
     cache_it_ = cache_.begin();
+    merge_heap_.clear();
+    heads_.clear();
+    runs_.clear();
+    pool_memory_.Release();
   }
 
  private:
+  // How many input rows are accumulated between two checks whether the cache
+  // should be spilled to disk.
+  static constexpr uint64_t kSpillCheckInterval = 4096;
+  static constexpr size_t kCacheMemoryInitialSize = 8192;
+
   struct Element {
     utils::pmr::vector<TypedValue> order_by;
     utils::pmr::vector<TypedValue> remember;
   };
 
+  // A sorted part of the input which was written to disk, see `SpillCache`.
+  // Runs spilled from the cache are on level 0, and merging runs of level L
+  // gives a run of level L + 1.
+  struct Run {
+    std::unique_ptr<SpillFile> file;
+    uint64_t remaining;
+    uint64_t level;
+  };
+
+  auto ElementCompare() const {
+    return [this](const Element &element1, const Element &element2) {
+      return self_.compare_(element1.order_by, element2.order_by);
+    };
+  }
+
+  void SortCache() { std::sort(cache_.begin(), cache_.end(), ElementCompare()); }
+
+  // Returns how many of the first sorted rows pass through the Skip and Limit
+  // which follow this operator. If the number isn't known, the whole input is
+  // sorted and Skip and Limit report the invalid values.
+  std::optional<uint64_t> EvaluateTopK(ExpressionEvaluator *evaluator) const {
+    if (!self_.limit_) return std::nullopt;
+    auto evaluate = [evaluator](Expression *expression) -> std::optional<uint64_t> {
+      const auto value = expression->Accept(*evaluator);
+      if (value.type() != TypedValue::Type::Int || value.ValueInt() < 0) return std::nullopt;
+      return value.ValueInt();
+    };
+    const auto limit = evaluate(self_.limit_);
+    const auto skip = self_.skip_ ? evaluate(self_.skip_) : std::optional<uint64_t>(0);
+    if (!limit || !skip || *limit > std::numeric_limits<uint64_t>::max() - *skip) return std::nullopt;
+    return *skip + *limit;
+  }
+
+  void ClearCache() {
+    utils::pmr::vector<Element>(&cache_memory_).swap(cache_);
+    cache_memory_.Release();
+  }
+
+  // Sorts the cached elements, writes them to a new run on disk and frees the
+  // memory they occupied.
+  void SpillCache() {
+    SortCache();
+    auto &run = runs_.emplace_back(Run{std::make_unique<SpillFile>(), 0, 0});
+    for (const auto &element : cache_) WriteElement(&run, element);
+    ClearCache();
+  }
+
+  static void WriteElement(Run *run, const Element &element) {
+    for (const auto &value : element.order_by) run->file->Write(value);
+    for (const auto &value : element.remember) run->file->Write(value);
+    ++run->remaining;
+  }
+
+  // Opens the runs starting with `first_run_ix` for reading and puts each of
+  // them on the merge heap. The earlier runs get empty heads.
+  void StartMerge(DbAccessor *dba, size_t first_run_ix = 0) {
+    for (size_t run_ix = 0; run_ix < runs_.size(); ++run_ix) {
+      heads_.push_back(
+          Element{utils::pmr::vector<TypedValue>(&pool_memory_), utils::pmr::vector<TypedValue>(&pool_memory_)});
+      if (run_ix < first_run_ix) continue;
+      runs_[run_ix].file->FinishWriting();
+      if (ReadHead(run_ix, dba)) PushHeap(run_ix);
+    }
+  }
+
+  // Merges the runs starting with `first_run_ix` into a single run, which
+  // replaces them at the end of `runs_`.
+  void MergeRuns(DbAccessor *dba, size_t first_run_ix) {
+    StartMerge(dba, first_run_ix);
+    uint64_t level = 0;
+    for (size_t run_ix = first_run_ix; run_ix < runs_.size(); ++run_ix) level = std::max(level, runs_[run_ix].level);
+    Run merged{std::make_unique<SpillFile>(), 0, level + 1};
+    while (!merge_heap_.empty()) {
+      const auto run_ix = PopHeap();
+      WriteElement(&merged, heads_[run_ix]);
+      if (ReadHead(run_ix, dba)) PushHeap(run_ix);
+    }
+    heads_.clear();
+    runs_.erase(runs_.begin() + static_cast<std::ptrdiff_t>(first_run_ix), runs_.end());
+    pool_memory_.Release();
+    runs_.push_back(std::move(merged));
+  }
+
+  // Keeps the number of runs logarithmic in the size of the input. Levels of
+  // the runs don't increase towards the end of `runs_`, and once the last
+  // `kSpillMaxMergedRuns` runs are on the same level, they are merged into one
+  // run of the next level, which may cascade further. Each row is thus
+  // rewritten once per level instead of on every merge.
+  void CascadeRuns(DbAccessor *dba) {
+    while (runs_.size() >= kSpillMaxMergedRuns) {
+      const auto first_run_ix = runs_.size() - kSpillMaxMergedRuns;
+      if (runs_[first_run_ix].level != runs_.back().level) return;
+      MergeRuns(dba, first_run_ix);
+    }
+  }
+
+  // Replaces the head of the given run with its next element. Returns false
+  // if the run is exhausted.
+  bool ReadHead(size_t run_ix, DbAccessor *dba) {
+    auto &run = runs_[run_ix];
+    auto &head = heads_[run_ix];
+    head.order_by.clear();
+    head.remember.clear();
+    if (run.remaining == 0) return false;
+    --run.remaining;
+    for (size_t i = 0; i < self_.order_by_.size(); ++i) {
+      head.order_by.emplace_back(run.file->Read(dba, &pool_memory_));
+    }
+    for (size_t i = 0; i < self_.output_symbols_.size(); ++i) {
+      head.remember.emplace_back(run.file->Read(dba, &pool_memory_));
+    }
+    return true;
+  }
+
+  // `merge_heap_` keeps the run with the smallest head on top.
+  bool MergeHeapCompare(size_t run_ix1, size_t run_ix2) const {
+    return self_.compare_(heads_[run_ix2].order_by, heads_[run_ix1].order_by);
+  }
+
+  void PushHeap(size_t run_ix) {
+    merge_heap_.push_back(run_ix);
+    std::push_heap(merge_heap_.begin(), merge_heap_.end(),
+                   [this](size_t run_ix1, size_t run_ix2) { return MergeHeapCompare(run_ix1, run_ix2); });
+  }
+
+  // Removes the run with the smallest head from the merge heap.
+  size_t PopHeap() {
+    std::pop_heap(merge_heap_.begin(), merge_heap_.end(),
+                  [this](size_t run_ix1, size_t run_ix2) { return MergeHeapCompare(run_ix1, run_ix2); });
+    const auto run_ix = merge_heap_.back();
+    merge_heap_.pop_back();
+    return run_ix;
+  }
+
+  bool PullMerged(Frame &frame, ExecutionContext &context) {
+    if (merge_heap_.empty()) return false;
+
+    if (MustAbort(context)) throw HintedAbortError();
+
+    const auto run_ix = PopHeap();
+    auto output_sym_it = self_.output_symbols_.begin();
+    for (const TypedValue &output : heads_[run_ix].remember) frame[*output_sym_it++] = output;
+
+    if (ReadHead(run_ix, context.db_accessor)) PushHeap(run_ix);
+    return true;
+  }
+
   const OrderBy &self_;
   const UniqueCursorPtr input_cursor_;
   bool did_pull_all_{false};
+  // Counts the memory of the cache_, which is compared with the memory limit
+  // of the query.
+  utils::LimitedMemoryResource cache_memory_counter_{utils::NewDeleteResource(), std::numeric_limits<size_t>::max()};
+  // Memory of the cache_, owned by the cursor so that it can be released
+  // after the cache_ is spilled to disk.
+  utils::MonotonicBufferResource cache_memory_{kCacheMemoryInitialSize, &cache_memory_counter_};
+  // Memory of the elements which are often replaced: the elements of the
+  // top-K heap and the heads of the merged runs.
+  utils::PoolResource pool_memory_{128, 1024};
   // a cache of elements pulled from the input
   // the cache is filled and sorted (only on first elem) on first Pull
-  utils::pmr::vector<Element> cache_;
+  utils::pmr::vector<Element> cache_{&cache_memory_};
   // iterator over the cache_, maintains state between Pulls
   decltype(cache_.begin()) cache_it_ = cache_.begin();
+  // Sorted runs spilled to disk and the current head of each of them. If
+  // there are any runs, they are merged instead of iterating the cache_.
+  utils::pmr::vector<Run> runs_;
+  utils::pmr::vector<Element> heads_;
+  utils::pmr::vector<size_t> merge_heap_;
 };
 
 UniqueCursorPtr OrderBy::MakeCursor(utils::MemoryResource *mem) const {
@@ -3291,6 +3691,9 @@ UniqueCursorPtr Unwind::MakeCursor(utils::MemoryResource *mem) const {
   return MakeUniqueCursorPtr<UnwindCursor>(mem, *this, mem);
 }
 
+// Distinct doesn't spill to disk. It streams each row as soon as it's first
+// seen, so the rows seen so far must be looked up in memory; spilling them
+// would mean reading the whole input before producing any row.
 class DistinctCursor : public Cursor {
  public:
   DistinctCursor(const Distinct &self, utils::MemoryResource *mem)
@@ -3643,14 +4046,14 @@ std::unordered_map<std::string, int64_t> CallProcedure::GetAndResetCounters() {
 
 namespace {
 
-void CallCustomProcedure(const std::string_view &fully_qualified_procedure_name, const mgp_proc &proc,
-                         const std::vector<Expression *> &args, mgp_graph &graph, ExpressionEvaluator *evaluator,
-                         utils::MemoryResource *memory, std::optional<size_t> memory_limit, mgp_result *result) {
+// Build and type check procedure arguments.
+void EvaluateProcedureArgs(const std::string_view &fully_qualified_procedure_name, const mgp_proc &proc,
+                           const std::vector<Expression *> &args, mgp_graph &graph, ExpressionEvaluator *evaluator,
+                           mgp_list *proc_args_ptr) {
   static_assert(std::uses_allocator_v<mgp_value, utils::Allocator<mgp_value>>,
                 "Expected mgp_value to use custom allocator and makes STL "
                 "containers aware of that");
-  // Build and type check procedure arguments.
-  mgp_list proc_args(memory);
+  auto &proc_args = *proc_args_ptr;
   proc_args.elems.reserve(args.size());
   if (args.size() < proc.args.size() ||
       // Rely on `||` short circuit so we can avoid potential overflow of
@@ -3691,6 +4094,13 @@ void CallCustomProcedure(const std::string_view &fully_qualified_procedure_name,
   for (size_t i = passed_in_opt_args; i < proc.opt_args.size(); ++i) {
     proc_args.elems.emplace_back(std::get<2>(proc.opt_args[i]), &graph);
   }
+}
+
+void CallCustomProcedure(const std::string_view &fully_qualified_procedure_name, const mgp_proc &proc,
+                         const std::vector<Expression *> &args, mgp_graph &graph, ExpressionEvaluator *evaluator,
+                         utils::MemoryResource *memory, std::optional<size_t> memory_limit, mgp_result *result) {
+  mgp_list proc_args(memory);
+  EvaluateProcedureArgs(fully_qualified_procedure_name, proc, args, graph, evaluator, &proc_args);
   if (memory_limit) {
     SPDLOG_INFO("Running '{}' with memory limit of {}", fully_qualified_procedure_name,
                 utils::GetReadableSize(*memory_limit));
@@ -3713,24 +4123,113 @@ void CallCustomProcedure(const std::string_view &fully_qualified_procedure_name,
   }
 }
 
+size_t ProcedureThreadPoolSize() { return std::max(std::thread::hardware_concurrency(), 1U); }
+
+// Threads on which parallel-safe procedures are called, shared by all queries.
+utils::ThreadPool &ProcedureThreadPool() {
+  static utils::ThreadPool pool(ProcedureThreadPoolSize());
+  return pool;
+}
+
 }  // namespace
 
 class CallProcedureCursor : public Cursor {
+  // A call of a batched procedure whose batches are still being produced.
+  struct BatchedCall {
+    BatchedCall(const mgp_proc *proc, uint64_t unload_count, mgp_graph graph, utils::MemoryResource *memory,
+                std::optional<size_t> memory_limit)
+        : proc(proc), unload_count(unload_count), graph(graph), proc_memory{memory}, args(memory) {
+      if (memory_limit) {
+        limited_memory.emplace(memory, *memory_limit);
+        proc_memory.impl = &*limited_memory;
+      }
+    }
+
+    const mgp_proc *proc;
+    // `ModulePtr::UnloadCount` when the call started.
+    uint64_t unload_count;
+    void *state{nullptr};
+    mgp_graph graph;
+    std::optional<utils::LimitedMemoryResource> limited_memory;
+    mgp_memory proc_memory;
+    mgp_list args;
+  };
+
+  static constexpr size_t kParallelCallInitialMemory = 4 * 1024;
+  // Bounds the number of input rows pulled ahead of the produced results.
+  static constexpr size_t kParallelCallsPerThread = 4;
+
+  // A call of a parallel-safe procedure for a single input row. Each call has
+  // its own memory and graph, as the calls run concurrently.
+  struct ParallelCall {
+    utils::MonotonicBufferResource memory{kParallelCallInitialMemory, utils::NewDeleteResource()};
+    std::optional<utils::LimitedMemoryResource> limited_memory;
+    mgp_memory proc_memory{&memory};
+    mgp_list args{&memory};
+    mgp_result result{nullptr, &memory};
+    // The call's own accessor over the storage accessor of the query. The
+    // graph is only read with `View::OLD`, which doesn't modify the storage
+    // accessor, so the calls can use it concurrently. The execution context
+    // is reached only to check whether the query must abort.
+    std::optional<DbAccessor> dba;
+    mgp_graph graph{nullptr, storage::View::OLD, nullptr};
+    // Values of the input symbols for this call's row.
+    std::vector<TypedValue> input_values;
+    std::exception_ptr exception;
+  };
+
   const CallProcedure *self_;
   UniqueCursorPtr input_cursor_;
-  mgp_result result_;
+  // Results are released after they are produced, so that procedures which
+  // yield many rows in batches don't accumulate all of them in memory.
+  utils::PoolResource result_memory_{128, 4 * 1024};
+  mgp_result result_{nullptr, &result_memory_};
+  // Either result_ or the result of the current parallel call.
+  mgp_result *current_result_{&result_};
   decltype(result_.rows.end()) result_row_it_{result_.rows.end()};
   size_t result_signature_size_{0};
+  // Memory which a batched procedure call uses across its invocations.
+  utils::PoolResource batched_call_memory_{128, 4 * 1024};
+  std::unique_ptr<BatchedCall> batched_call_;
+  // Finished calls of a parallel-safe procedure whose results are yet to be
+  // produced, in the order of their input rows.
+  std::vector<std::unique_ptr<ParallelCall>> parallel_calls_;
+  size_t parallel_call_index_{0};
+  std::vector<Symbol> input_symbols_;
+  bool input_exhausted_{false};
+  // Input rows are pulled ahead only if that can't change what the calls
+  // observe, i.e. if the input doesn't write.
+  bool input_is_read_only_{false};
+  // The result of the last procedure lookup, valid while the module registry
+  // snapshot has the same generation.
+  uint64_t cached_generation_{0};
+  const procedure::Module *cached_module_{nullptr};
+  const mgp_proc *cached_proc_{nullptr};
 
  public:
   CallProcedureCursor(const CallProcedure *self, utils::MemoryResource *mem)
-      : self_(self),
-        input_cursor_(self_->input_->MakeCursor(mem)),
-        // result_ needs to live throughout multiple Pull evaluations, until all
-        // rows are produced. Therefore, we use the memory dedicated for the
-        // whole execution.
-        result_(nullptr, mem) {
+      : self_(self), input_cursor_(self_->input_->MakeCursor(mem)) {
     MG_ASSERT(self_->result_fields_.size() == self_->result_symbols_.size(), "Incorrectly constructed CallProcedure");
+    ReadWriteTypeChecker input_type_checker;
+    input_type_checker.InferRWType(*self_->input_);
+    input_is_read_only_ = input_type_checker.type == ReadWriteTypeChecker::RWType::NONE ||
+                          input_type_checker.type == ReadWriteTypeChecker::RWType::R;
+  }
+
+  CallProcedureCursor(const CallProcedureCursor &) = delete;
+  CallProcedureCursor &operator=(const CallProcedureCursor &) = delete;
+  CallProcedureCursor(CallProcedureCursor &&) = delete;
+  CallProcedureCursor &operator=(CallProcedureCursor &&) = delete;
+
+  ~CallProcedureCursor() override {
+    // The cursor can outlive the execution context if the query was abandoned
+    // before `Shutdown`, so the cleanup must not reach the context through the
+    // graph.
+    if (batched_call_) {
+      batched_call_->graph.impl = nullptr;
+      batched_call_->graph.ctx = nullptr;
+    }
+    FinishBatchedCall();
   }
 
   bool Pull(Frame &frame, ExecutionContext &context) override {
@@ -3743,41 +4242,48 @@ class CallProcedureCursor : public Cursor {
     // empty result set vs procedures which return `void`. We currently don't
     // have procedures registering what they return.
     // This `while` loop will skip over empty results.
-    while (result_row_it_ == result_.rows.end()) {
-      if (!input_cursor_->Pull(frame, context)) return false;
-      result_.signature = nullptr;
-      result_.rows.clear();
-      result_.error_msg.reset();
-      // It might be a good idea to resolve the procedure name once, at the
-      // start. Unfortunately, this could deadlock if we tried to invoke a
-      // procedure from a module (read lock) and reload a module (write lock)
-      // inside the same execution thread. Also, our RWLock is setup so that
-      // it's not possible for a single thread to request multiple read locks.
-      // Builtin module registration in query/procedure/module.cpp depends on
-      // this locking scheme.
-      const auto &maybe_found = procedure::FindProcedure(procedure::gModuleRegistry, self_->procedure_name_,
-                                                         context.evaluation_context.memory);
+    while (result_row_it_ == current_result_->rows.end()) {
+      if (batched_call_) {
+        // An empty batch ends the call and we continue with the next input.
+        if (!PullBatch(context)) FinishBatchedCall();
+        continue;
+      }
+      if (NextParallelCall(frame)) continue;
+      if (input_exhausted_) return false;
+      if (!input_cursor_->Pull(frame, context)) {
+        input_exhausted_ = true;
+        return false;
+      }
+      ClearResult();
+      // The module is held only while the procedure is called, because
+      // reloading a module waits until nobody else holds it.
+      auto maybe_found = FindProcedure(context.evaluation_context.memory);
       if (!maybe_found) {
         throw QueryRuntimeException("There is no procedure named '{}'.", self_->procedure_name_);
       }
       const auto &[module, proc] = *maybe_found;
-      if (proc->is_write_procedure != self_->is_write_) {
-        auto get_proc_type_str = [](bool is_write) { return is_write ? "write" : "read"; };
-        throw QueryRuntimeException("The procedure named '{}' was a {} procedure, but changed to be a {} procedure.",
-                                    self_->procedure_name_, get_proc_type_str(self_->is_write_),
-                                    get_proc_type_str(proc->is_write_procedure));
+      CheckProcedureType(*proc);
+      if (proc->is_parallel_safe && input_is_read_only_) {
+        // The module is released, as more input is pulled before the calls.
+        maybe_found.reset();
+        RunParallelCalls(frame, context);
+        continue;
       }
       const auto graph_view = proc->is_write_procedure ? storage::View::NEW : storage::View::OLD;
       ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
                                     graph_view);
+      auto memory_limit = EvaluateMemoryLimit(&evaluator, self_->memory_limit_, self_->memory_scale_);
+
+      if (proc->IsBatched()) {
+        StartBatchedCall(proc, module.UnloadCount(), mgp_graph{context.db_accessor, graph_view, &context}, &evaluator,
+                         memory_limit);
+        continue;
+      }
 
       result_.signature = &proc->results;
       // Use evaluation memory, as invoking a procedure is akin to a simple
       // evaluation of an expression.
-      // TODO: This will probably need to be changed when we add support for
-      // generator like procedures which yield a new result on each invocation.
       auto *memory = context.evaluation_context.memory;
-      auto memory_limit = EvaluateMemoryLimit(&evaluator, self_->memory_limit_, self_->memory_scale_);
       mgp_graph graph{context.db_accessor, graph_view, &context};
       CallCustomProcedure(self_->procedure_name_, *proc, self_->arguments_, graph, &evaluator, memory, memory_limit,
                           &result_);
@@ -3819,12 +4325,240 @@ class CallProcedureCursor : public Cursor {
   }
 
   void Reset() override {
+    FinishBatchedCall();
+    ClearResult();
+    input_exhausted_ = false;
+    input_cursor_->Reset();
+  }
+
+  void Shutdown() override {
+    FinishBatchedCall();
+    ClearResult();
+  }
+
+ private:
+  void ClearResult() {
+    result_.signature = nullptr;
     result_.rows.clear();
     result_.error_msg.reset();
-    input_cursor_->Reset();
+    parallel_calls_.clear();
+    parallel_call_index_ = 0;
+    current_result_ = &result_;
+    result_row_it_ = result_.rows.end();
   }
 
-  void Shutdown() override {}
+  // Resolves the procedure name, reusing the previous result until a module
+  // is (re)loaded.
+  std::optional<std::pair<procedure::ModulePtr, const mgp_proc *>> FindProcedure(utils::MemoryResource *memory) {
+    if (cached_proc_) {
+      auto snapshot = procedure::gModuleRegistry.GetSnapshot();
+      if (snapshot->generation == cached_generation_) {
+        return std::make_pair(procedure::ModulePtr(cached_module_, std::move(snapshot)), cached_proc_);
+      }
+    }
+    auto maybe_found = procedure::FindProcedure(procedure::gModuleRegistry, self_->procedure_name_, memory);
+    if (maybe_found) {
+      cached_generation_ = maybe_found->first.Generation();
+      cached_module_ = &*maybe_found->first;
+      cached_proc_ = maybe_found->second;
+    } else {
+      cached_proc_ = nullptr;
+    }
+    return maybe_found;
+  }
+
+  void CheckProcedureType(const mgp_proc &proc) const {
+    if (proc.is_write_procedure != self_->is_write_) {
+      auto get_proc_type_str = [](bool is_write) { return is_write ? "write" : "read"; };
+      throw QueryRuntimeException("The procedure named '{}' was a {} procedure, but changed to be a {} procedure.",
+                                  self_->procedure_name_, get_proc_type_str(self_->is_write_),
+                                  get_proc_type_str(proc.is_write_procedure));
+    }
+  }
+
+  void RestoreInput(Frame &frame, const ParallelCall &call) const {
+    for (size_t i = 0; i < input_symbols_.size(); ++i) {
+      frame[input_symbols_[i]] = call.input_values[i];
+    }
+  }
+
+  // Starts producing the results of the next finished parallel call. Returns
+  // false if there are no more calls.
+  bool NextParallelCall(Frame &frame) {
+    if (parallel_call_index_ == parallel_calls_.size()) return false;
+    auto &call = *parallel_calls_[parallel_call_index_++];
+    RestoreInput(frame, call);
+    current_result_ = &call.result;
+    result_row_it_ = call.result.rows.begin();
+    return true;
+  }
+
+  // Calls a parallel-safe procedure for the current input row and the rows
+  // pulled after it, up to a bound. The calls are spread over
+  // `ProcedureThreadPool` and their results are produced in the order of the
+  // input rows. Arguments are still evaluated on this thread, as evaluation
+  // isn't thread-safe.
+  void RunParallelCalls(Frame &frame, ExecutionContext &context) {
+    input_symbols_ = self_->input_->ModifiedSymbols(context.symbol_table);
+    auto save_input = [&] {
+      auto &call = parallel_calls_.emplace_back(std::make_unique<ParallelCall>());
+      call->input_values.reserve(input_symbols_.size());
+      for (const auto &symbol : input_symbols_) call->input_values.emplace_back(frame[symbol], &call->memory);
+    };
+    save_input();
+    const size_t max_calls = ProcedureThreadPoolSize() * kParallelCallsPerThread;
+    while (parallel_calls_.size() < max_calls) {
+      if (MustAbort(context)) throw HintedAbortError();
+      if (!input_cursor_->Pull(frame, context)) {
+        input_exhausted_ = true;
+        break;
+      }
+      save_input();
+    }
+
+    const auto maybe_found = FindProcedure(context.evaluation_context.memory);
+    if (!maybe_found) {
+      throw QueryRuntimeException("There is no procedure named '{}'.", self_->procedure_name_);
+    }
+    const auto &[module, proc] = *maybe_found;
+    CheckProcedureType(*proc);
+    if (proc->IsBatched()) {
+      throw QueryRuntimeException("The procedure named '{}' was changed to produce its results in batches.",
+                                  self_->procedure_name_);
+    }
+    bool logged_memory_limit = false;
+    for (auto &call : parallel_calls_) {
+      call->dba.emplace(*context.db_accessor);
+      call->graph = mgp_graph{&*call->dba, storage::View::OLD, &context};
+      RestoreInput(frame, *call);
+      ExpressionEvaluator evaluator(&frame, context.symbol_table, context.evaluation_context, context.db_accessor,
+                                    storage::View::OLD);
+      if (auto memory_limit = EvaluateMemoryLimit(&evaluator, self_->memory_limit_, self_->memory_scale_)) {
+        if (!std::exchange(logged_memory_limit, true)) {
+          SPDLOG_INFO("Running '{}' with memory limit of {}", self_->procedure_name_,
+                      utils::GetReadableSize(*memory_limit));
+        }
+        call->limited_memory.emplace(&call->memory, *memory_limit);
+        call->proc_memory.impl = &*call->limited_memory;
+      }
+      EvaluateProcedureArgs(self_->procedure_name_, *proc, self_->arguments_, call->graph, &evaluator, &call->args);
+      call->result.signature = &proc->results;
+    }
+
+    auto run_call = [&](ParallelCall &call) noexcept {
+      try {
+        proc->cb(&call.args, &call.graph, &call.result, &call.proc_memory);
+      } catch (...) {
+        call.exception = std::current_exception();
+      }
+    };
+    // The procedure may have been reloaded as not parallel-safe meanwhile.
+    if (proc->is_parallel_safe && parallel_calls_.size() > 1) {
+      std::mutex mutex;
+      std::condition_variable finished_cv;
+      size_t unfinished_calls = parallel_calls_.size() - 1;
+      for (size_t i = 1; i < parallel_calls_.size(); ++i) {
+        ProcedureThreadPool().AddTask([&, call = parallel_calls_[i].get()] {
+          run_call(*call);
+          std::lock_guard guard(mutex);
+          --unfinished_calls;
+          // Notify under the lock, as the waiting thread destroys the
+          // condition variable as soon as it sees that all calls finished.
+          finished_cv.notify_one();
+        });
+      }
+      run_call(*parallel_calls_.front());
+      std::unique_lock guard(mutex);
+      finished_cv.wait(guard, [&] { return unfinished_calls == 0; });
+    } else {
+      for (auto &call : parallel_calls_) run_call(*call);
+    }
+
+    // Reset the signatures to nullptr, because we will no longer hold a lock
+    // on the `module` when the results are produced.
+    result_signature_size_ = proc->results.size();
+    for (auto &call : parallel_calls_) {
+      call->result.signature = nullptr;
+      if (call->limited_memory) {
+        const size_t leaked_bytes = call->limited_memory->GetAllocatedBytes();
+        if (leaked_bytes > 0U) {
+          spdlog::warn("Query procedure '{}' leaked {} *tracked* bytes", self_->procedure_name_, leaked_bytes);
+        }
+      }
+    }
+    for (auto &call : parallel_calls_) {
+      if (call->exception) std::rethrow_exception(call->exception);
+      if (call->result.error_msg) {
+        throw QueryRuntimeException("{}: {}", self_->procedure_name_, *call->result.error_msg);
+      }
+    }
+  }
+
+  // Must be called while holding the module of `proc`.
+  void StartBatchedCall(const mgp_proc *proc, uint64_t unload_count, mgp_graph graph, ExpressionEvaluator *evaluator,
+                        std::optional<size_t> memory_limit) {
+    if (memory_limit) {
+      SPDLOG_INFO("Running '{}' with memory limit of {}", self_->procedure_name_,
+                  utils::GetReadableSize(*memory_limit));
+    }
+    auto call = std::make_unique<BatchedCall>(proc, unload_count, graph, &batched_call_memory_, memory_limit);
+    EvaluateProcedureArgs(self_->procedure_name_, *proc, self_->arguments_, call->graph, evaluator, &call->args);
+    call->state = proc->batch_initializer(&call->args, &call->graph, &call->proc_memory);
+    batched_call_ = std::move(call);
+  }
+
+  // The module isn't locked between the batches of a call, so that modules
+  // can be (re)loaded meanwhile, even from the same query. Returns nullptr if
+  // the module of the batched call was unloaded since the call started.
+  procedure::ModulePtr LockBatchedCallModule() {
+    auto maybe_found = FindProcedure(utils::NewDeleteResource());
+    if (!maybe_found || maybe_found->first.UnloadCount() != batched_call_->unload_count) return nullptr;
+    MG_ASSERT(maybe_found->second == batched_call_->proc);
+    return std::move(maybe_found->first);
+  }
+
+  // Produces the next batch of the batched call into result_. Returns false if
+  // the batch is empty.
+  bool PullBatch(ExecutionContext &context) {
+    ClearResult();
+    {
+      const auto module = LockBatchedCallModule();
+      if (!module) {
+        // The cleanup can't be invoked, as it was unloaded together with the
+        // module.
+        batched_call_.reset();
+        throw QueryRuntimeException("Procedure '{}' was unloaded while producing its results.",
+                                    self_->procedure_name_);
+      }
+      auto &call = *batched_call_;
+      call.graph.impl = context.db_accessor;
+      call.graph.ctx = &context;
+      result_.signature = &call.proc->results;
+      call.proc->batch_cb(call.state, &call.graph, &result_, &call.proc_memory);
+      result_signature_size_ = result_.signature->size();
+      result_.signature = nullptr;
+    }
+    if (result_.error_msg) {
+      FinishBatchedCall();
+      throw QueryRuntimeException("{}: {}", self_->procedure_name_, *result_.error_msg);
+    }
+    result_row_it_ = result_.rows.begin();
+    return !result_.rows.empty();
+  }
+
+  void FinishBatchedCall() noexcept {
+    if (!batched_call_) return;
+    if (const auto module = LockBatchedCallModule()) {
+      batched_call_->proc->batch_cleanup(batched_call_->state);
+    }
+    if (batched_call_->limited_memory) {
+      const size_t leaked_bytes = batched_call_->limited_memory->GetAllocatedBytes();
+      if (leaked_bytes > 0U) {
+        spdlog::warn("Query procedure '{}' leaked {} *tracked* bytes", self_->procedure_name_, leaked_bytes);
+      }
+    }
+    batched_call_.reset();
+  }
 };
 
 UniqueCursorPtr CallProcedure::MakeCursor(utils::MemoryResource *mem) const {
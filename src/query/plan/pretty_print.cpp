@@ -754,6 +754,10 @@ bool PlanToJsonVisitor::PreVisit(OrderBy &op) {
     self["order_by"].push_back(json);
   }
   self["output_symbols"] = ToJson(op.output_symbols_);
+  if (op.limit_) {
+    if (op.skip_) self["skip"] = ToJson(op.skip_);
+    self["limit"] = ToJson(op.limit_);
+  }
 
   op.input_->Accept(*this);
   self["input"] = PopOutput();
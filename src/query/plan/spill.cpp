@@ -0,0 +1,220 @@
+// Copyright 2021 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "query/plan/spill.hpp"
+
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "query/exceptions.hpp"
+#include "query/path.hpp"
+#include "utils/file.hpp"
+#include "utils/flag_validation.hpp"
+#include "utils/memory_tracker.hpp"
+
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_VALIDATED_double(query_spill_memory_ratio, 0.8,
+                        "Ratio of the memory limit after which operators that accumulate their input (e.g. ORDER BY) "
+                        "start spilling it to disk. Set to 0 to disable spilling.",
+                        FLAG_IN_RANGE(0.0, 1.0));
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DEFINE_string(query_spill_directory, "",
+              "Directory for temporary files of spilling query operators. If empty, a 'memgraph' directory inside "
+              "the system temporary directory is used.");
+
+namespace query::plan {
+
+namespace {
+
+constexpr std::string_view kSpillMagic{"MGsp"};
+constexpr uint64_t kSpillVersion{2};
+
+// Every spilled value is preceded by one of these tags.
+enum class SpillTag : uint64_t {
+  PROPERTY_VALUE = 0,
+  LIST = 1,
+  MAP = 2,
+  VERTEX = 3,
+  EDGE = 4,
+  PATH = 5,
+};
+
+std::filesystem::path MakeSpillFilePath() {
+  static std::atomic<uint64_t> counter{0};
+  const std::filesystem::path directory = FLAGS_query_spill_directory.empty()
+                                              ? std::filesystem::temp_directory_path() / "memgraph"
+                                              : std::filesystem::path(FLAGS_query_spill_directory);
+  if (!utils::EnsureDir(directory)) {
+    throw QueryRuntimeException("Couldn't create the directory {} for spilling query data.", directory.string());
+  }
+  return directory / fmt::format("spill_{}_{}", getpid(), counter.fetch_add(1, std::memory_order_relaxed));
+}
+
+}  // namespace
+
+bool ShouldSpill(const ExecutionContext &context, const size_t accumulated_bytes) {
+  if (FLAGS_query_spill_memory_ratio <= 0.0 || accumulated_bytes < kSpillMinRunBytes) return false;
+  if (context.memory_limit && static_cast<double>(accumulated_bytes) >
+                                  FLAGS_query_spill_memory_ratio * static_cast<double>(*context.memory_limit)) {
+    return true;
+  }
+  const auto hard_limit = utils::total_memory_tracker.HardLimit();
+  if (hard_limit <= 0) return false;
+  return static_cast<double>(utils::total_memory_tracker.Amount()) >
+         FLAGS_query_spill_memory_ratio * static_cast<double>(hard_limit);
+}
+
+SpillFile::SpillFile() : path_(MakeSpillFilePath()) { encoder_.Initialize(path_, kSpillMagic, kSpillVersion); }
+
+SpillFile::~SpillFile() {
+  encoder_.Close();
+  utils::DeleteFile(path_);
+}
+
+void SpillFile::Write(const TypedValue &value) {
+  auto write_vertex = [this](const VertexAccessor &vertex) { encoder_.WriteUint(vertex.Gid().AsUint()); };
+  // Edges are looked up among the edges of the same type between their nodes
+  // when they are read.
+  auto write_edge = [&](const EdgeAccessor &edge) {
+    write_vertex(edge.From());
+    write_vertex(edge.To());
+    encoder_.WriteUint(edge.EdgeType().AsUint());
+    encoder_.WriteUint(edge.Gid().AsUint());
+  };
+
+  switch (value.type()) {
+    case TypedValue::Type::List: {
+      const auto &list = value.ValueList();
+      encoder_.WriteUint(static_cast<uint64_t>(SpillTag::LIST));
+      encoder_.WriteUint(list.size());
+      for (const auto &element : list) Write(element);
+      break;
+    }
+    case TypedValue::Type::Map: {
+      const auto &map = value.ValueMap();
+      encoder_.WriteUint(static_cast<uint64_t>(SpillTag::MAP));
+      encoder_.WriteUint(map.size());
+      for (const auto &[key, element] : map) {
+        encoder_.WriteString(key);
+        Write(element);
+      }
+      break;
+    }
+    case TypedValue::Type::Vertex:
+      encoder_.WriteUint(static_cast<uint64_t>(SpillTag::VERTEX));
+      write_vertex(value.ValueVertex());
+      break;
+    case TypedValue::Type::Edge:
+      encoder_.WriteUint(static_cast<uint64_t>(SpillTag::EDGE));
+      write_edge(value.ValueEdge());
+      break;
+    case TypedValue::Type::Path: {
+      const auto &path = value.ValuePath();
+      encoder_.WriteUint(static_cast<uint64_t>(SpillTag::PATH));
+      encoder_.WriteUint(path.edges().size());
+      write_vertex(path.vertices()[0]);
+      for (size_t i = 0; i < path.edges().size(); ++i) {
+        write_edge(path.edges()[i]);
+        write_vertex(path.vertices()[i + 1]);
+      }
+      break;
+    }
+    default:
+      encoder_.WriteUint(static_cast<uint64_t>(SpillTag::PROPERTY_VALUE));
+      encoder_.WritePropertyValue(storage::PropertyValue(value));
+      break;
+  }
+}
+
+void SpillFile::FinishWriting() {
+  encoder_.Close();
+  if (!decoder_.Initialize(path_, std::string(kSpillMagic))) {
+    throw QueryRuntimeException("Couldn't open the spilled query data in {}.", path_.string());
+  }
+}
+
+TypedValue SpillFile::Read(DbAccessor *dba, utils::MemoryResource *memory) {
+  auto read_uint = [this] {
+    auto value = decoder_.ReadUint();
+    if (!value) throw QueryRuntimeException("Couldn't read the spilled query data.");
+    return *value;
+  };
+  // Nodes and edges deleted earlier in the query are visible only in the OLD
+  // view.
+  constexpr std::array kViews{storage::View::NEW, storage::View::OLD};
+  auto read_vertex = [&] {
+    const auto gid = storage::Gid::FromUint(read_uint());
+    for (const auto view : kViews) {
+      if (auto vertex = dba->FindVertex(gid, view)) return *vertex;
+    }
+    throw QueryRuntimeException("Couldn't restore a spilled node, it no longer exists.");
+  };
+  auto read_edge = [&] {
+    auto from = read_vertex();
+    auto to = read_vertex();
+    const std::vector edge_types{storage::EdgeTypeId::FromUint(read_uint())};
+    const auto gid = storage::Gid::FromUint(read_uint());
+    for (const auto view : kViews) {
+      auto maybe_edges = from.OutEdges(view, edge_types, to);
+      if (!maybe_edges.HasValue()) continue;
+      for (const auto &edge : *maybe_edges) {
+        if (edge.Gid() == gid) return edge;
+      }
+    }
+    throw QueryRuntimeException("Couldn't restore a spilled relationship, it no longer exists.");
+  };
+
+  switch (static_cast<SpillTag>(read_uint())) {
+    case SpillTag::PROPERTY_VALUE: {
+      auto value = decoder_.ReadPropertyValue();
+      if (!value) throw QueryRuntimeException("Couldn't read the spilled query data.");
+      return TypedValue(std::move(*value), memory);
+    }
+    case SpillTag::LIST: {
+      const auto size = read_uint();
+      TypedValue::TVector list(memory);
+      list.reserve(size);
+      for (uint64_t i = 0; i < size; ++i) list.emplace_back(Read(dba, memory));
+      return TypedValue(std::move(list), memory);
+    }
+    case SpillTag::MAP: {
+      const auto size = read_uint();
+      TypedValue::TMap map(memory);
+      for (uint64_t i = 0; i < size; ++i) {
+        auto key = decoder_.ReadString();
+        if (!key) throw QueryRuntimeException("Couldn't read the spilled query data.");
+        map.emplace(*key, Read(dba, memory));
+      }
+      return TypedValue(std::move(map), memory);
+    }
+    case SpillTag::VERTEX:
+      return TypedValue(read_vertex(), memory);
+    case SpillTag::EDGE:
+      return TypedValue(read_edge(), memory);
+    case SpillTag::PATH: {
+      const auto size = read_uint();
+      Path path(read_vertex(), memory);
+      for (uint64_t i = 0; i < size; ++i) {
+        path.Expand(read_edge());
+        path.Expand(read_vertex());
+      }
+      return TypedValue(std::move(path), memory);
+    }
+  }
+  throw QueryRuntimeException("Couldn't read the spilled query data.");
+}
+
+}  // namespace query::plan
@@ -0,0 +1,87 @@
+// Copyright 2021 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+/// @file
+#pragma once
+
+#include <filesystem>
+
+#include <gflags/gflags.h>
+
+#include "query/context.hpp"
+#include "query/db_accessor.hpp"
+#include "query/typed_value.hpp"
+#include "storage/v2/durability/serialization.hpp"
+#include "utils/memory.hpp"
+
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DECLARE_double(query_spill_memory_ratio);
+// NOLINTNEXTLINE (cppcoreguidelines-avoid-non-const-global-variables)
+DECLARE_string(query_spill_directory);
+
+namespace query::plan {
+
+/// Minimum amount of accumulated memory which is spilled at once. Smaller runs
+/// would free little memory, while each of them costs a file.
+constexpr size_t kSpillMinRunBytes = 1024UL * 1024UL;
+
+/// Maximum number of spilled runs which are read at once, as each of them holds
+/// its own file buffers. Runs are merged in levels: once this many runs of the
+/// same level exist, they are merged into a single run of the next level, so
+/// each spilled row is rewritten a logarithmic number of times.
+constexpr size_t kSpillMaxMergedRuns = 16;
+
+/// Returns true if an operator which accumulates its input in memory should
+/// move what it has accumulated so far to disk. `accumulated_bytes` is the
+/// memory the operator currently holds.
+///
+/// Spilling is triggered once the memory tracked by
+/// `utils::total_memory_tracker` exceeds `--query-spill-memory-ratio` of the
+/// memory limit, or once `accumulated_bytes` exceed the same ratio of the
+/// QUERY MEMORY LIMIT. Less than `kSpillMinRunBytes` is never spilled.
+bool ShouldSpill(const ExecutionContext &context, size_t accumulated_bytes);
+
+/// A temporary file into which operators spill `TypedValue`s that don't fit in
+/// memory. Values are first written sequentially, then `FinishWriting` is
+/// called and the values are read back in the same order. The file is removed
+/// when the object is destroyed.
+///
+/// Nodes and edges are stored by their IDs and are looked up again when read,
+/// so the file may only be read within the transaction which wrote it. Those
+/// deleted earlier in the query are restored as they were before the current
+/// command.
+class SpillFile final {
+ public:
+  SpillFile();
+  ~SpillFile();
+
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+  SpillFile(SpillFile &&) = delete;
+  SpillFile &operator=(SpillFile &&) = delete;
+
+  void Write(const TypedValue &value);
+
+  /// Flushes all written values and opens the file for reading.
+  void FinishWriting();
+
+  /// Reads the next value using the given memory.
+  /// @throw QueryRuntimeException if the value can't be read or a spilled node
+  /// or edge no longer exists.
+  TypedValue Read(DbAccessor *dba, utils::MemoryResource *memory);
+
+ private:
+  std::filesystem::path path_;
+  storage::durability::Encoder encoder_;
+  storage::durability::Decoder decoder_;
+};
+
+}  // namespace query::plan
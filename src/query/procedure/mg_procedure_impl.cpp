@@ -19,8 +19,10 @@
 #include <optional>
 #include <regex>
 #include <stdexcept>
+#include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "mg_procedure.h"
 #include "module.hpp"
@@ -35,6 +37,7 @@
 #include "utils/memory.hpp"
 #include "utils/string.hpp"
 #include "utils/temporal.hpp"
+#include "utils/thread_pool.hpp"
 
 // This file contains implementation of top level C API functions, but this is
 // all actually part of query::procedure. So use that namespace for simplicity.
@@ -2222,6 +2225,169 @@ mgp_error mgp_vertices_iterator_next(mgp_vertices_iterator *it, mgp_vertex **res
       result);
 }
 
+namespace {
+double GetProjectedEdgeWeight(const query::EdgeAccessor &edge, storage::PropertyId weight_property,
+                              storage::View view) {
+  const auto maybe_weight = edge.GetProperty(view, weight_property);
+  if (maybe_weight.HasError()) return 1.0;
+  if (maybe_weight->IsInt()) return static_cast<double>(maybe_weight->ValueInt());
+  if (maybe_weight->IsDouble()) return maybe_weight->ValueDouble();
+  return 1.0;
+}
+
+// Minimum number of vertices per worker of a graph projection, smaller graphs
+// are projected by fewer workers.
+constexpr int64_t kProjectionVerticesPerThread = 10000;
+
+// Pool shared by all graph projections. The thread that projects the graph is
+// one of the workers, so the pool is one thread short.
+utils::ThreadPool &ProjectionThreadPool() {
+  static utils::ThreadPool pool(std::max(1U, std::thread::hardware_concurrency()) - 1);
+  return pool;
+}
+
+mgp_graph_projection *ProjectGraph(mgp_graph *graph, const char *label, const char *edge_type,
+                                   const char *weight_property, mgp_memory *memory) {
+  auto *dba = graph->impl;
+  const auto view = graph->view;
+  const uint64_t thread_count = std::clamp<int64_t>(dba->VerticesCount() / kProjectionVerticesPerThread, 1,
+                                                    std::max(1U, std::thread::hardware_concurrency()));
+  std::optional<storage::LabelId> label_id;
+  if (label) label_id = dba->NameToLabel(label);
+
+  // The vertices are sorted by their gids, so that the index of a vertex can
+  // be found with a binary search over the gids.
+  utils::pmr::vector<query::VertexAccessor> vertices(memory->impl);
+  if (label_id && dba->LabelIndexExists(*label_id)) {
+    for (auto vertex : dba->Vertices(view, *label_id)) vertices.push_back(vertex);
+    std::sort(vertices.begin(), vertices.end(),
+              [](const auto &vertex1, const auto &vertex2) { return vertex1.Gid().AsInt() < vertex2.Gid().AsInt(); });
+  } else {
+    // Every worker scans a range of gids. The vertices are iterated in gid
+    // order, so concatenating the ranges keeps them sorted. The workers can't
+    // allocate from `memory`, as it isn't thread-safe.
+    std::vector<std::vector<query::VertexAccessor>> range_vertices(thread_count);
+    const auto range_size = dba->VertexGidUpperBound().AsUint() / thread_count;
+    utils::RunOnThreads(&ProjectionThreadPool(), thread_count, [&](uint64_t worker) {
+      std::optional<storage::Gid> to;
+      if (worker + 1 < thread_count) to = storage::Gid::FromUint(range_size * (worker + 1));
+      for (auto vertex : dba->Vertices(view, storage::Gid::FromUint(range_size * worker), to)) {
+        if (label_id) {
+          const auto has_label = vertex.HasLabel(view, *label_id);
+          if (!has_label.HasValue() || !*has_label) continue;
+        }
+        range_vertices[worker].push_back(vertex);
+      }
+    });
+    for (const auto &range : range_vertices) vertices.insert(vertices.end(), range.begin(), range.end());
+  }
+
+  auto projection = NewMgpObject<mgp_graph_projection>(memory);
+  auto &vertex_ids = projection->vertex_ids;
+  vertex_ids.reserve(vertices.size());
+  for (const auto &vertex : vertices) vertex_ids.push_back(vertex.Gid().AsInt());
+
+  std::vector<storage::EdgeTypeId> edge_types;
+  if (edge_type) edge_types.push_back(dba->NameToEdgeType(edge_type));
+  std::optional<storage::PropertyId> weight_property_id;
+  if (weight_property) {
+    weight_property_id = dba->NameToProperty(weight_property);
+    projection->has_weights = true;
+  }
+
+  // Every worker builds the adjacency of a contiguous range of the vertices,
+  // `ends` holds the end of the neighbors of each of its vertices.
+  struct RangeEdges {
+    std::vector<size_t> ends;
+    std::vector<size_t> neighbors;
+    std::vector<double> weights;
+  };
+  std::vector<RangeEdges> range_edges(thread_count);
+  utils::RunOnThreads(&ProjectionThreadPool(), thread_count, [&](uint64_t worker) {
+    auto &[ends, neighbors, weights] = range_edges[worker];
+    const auto begin = vertices.size() * worker / thread_count;
+    const auto end = vertices.size() * (worker + 1) / thread_count;
+    ends.reserve(end - begin);
+    for (auto i = begin; i < end; ++i) {
+      auto maybe_edges = vertices[i].OutEdges(view, edge_types);
+      if (maybe_edges.HasError()) {
+        switch (maybe_edges.GetError()) {
+          case storage::Error::DELETED_OBJECT:
+            throw DeletedObjectException{"Cannot project the outbound edges of a deleted vertex!"};
+          case storage::Error::NONEXISTENT_OBJECT:
+          case storage::Error::PROPERTIES_DISABLED:
+          case storage::Error::VERTEX_HAS_EDGES:
+          case storage::Error::SERIALIZATION_ERROR:
+            LOG_FATAL("Unexpected error when projecting the outbound edges of a vertex.");
+        }
+      }
+      for (const auto &edge : *maybe_edges) {
+        const auto to_gid = edge.To().Gid().AsInt();
+        const auto to_it = std::lower_bound(vertex_ids.begin(), vertex_ids.end(), to_gid);
+        if (to_it == vertex_ids.end() || *to_it != to_gid) continue;
+        neighbors.push_back(static_cast<size_t>(to_it - vertex_ids.begin()));
+        if (weight_property_id) weights.push_back(GetProjectedEdgeWeight(edge, *weight_property_id, view));
+      }
+      ends.push_back(neighbors.size());
+    }
+  });
+
+  size_t edges_count = 0;
+  for (const auto &range : range_edges) edges_count += range.neighbors.size();
+  projection->offsets.reserve(vertices.size() + 1);
+  projection->neighbors.reserve(edges_count);
+  if (weight_property_id) projection->weights.reserve(edges_count);
+  projection->offsets.push_back(0);
+  for (const auto &range : range_edges) {
+    const auto base = projection->neighbors.size();
+    for (const auto end : range.ends) projection->offsets.push_back(base + end);
+    projection->neighbors.insert(projection->neighbors.end(), range.neighbors.begin(), range.neighbors.end());
+    projection->weights.insert(projection->weights.end(), range.weights.begin(), range.weights.end());
+  }
+  return projection.release();
+}
+}  // namespace
+
+mgp_error mgp_graph_project(mgp_graph *graph, const char *label, const char *edge_type, const char *weight_property,
+                            mgp_memory *memory, mgp_graph_projection **result) {
+  return WrapExceptions([=] { return ProjectGraph(graph, label, edge_type, weight_property, memory); }, result);
+}
+
+void mgp_graph_projection_destroy(mgp_graph_projection *projection) { DeleteRawMgpObject(projection); }
+
+mgp_error mgp_graph_projection_vertices_count(mgp_graph_projection *projection, size_t *result) {
+  return WrapExceptions([projection] { return projection->vertex_ids.size(); }, result);
+}
+
+mgp_error mgp_graph_projection_edges_count(mgp_graph_projection *projection, size_t *result) {
+  return WrapExceptions([projection] { return projection->neighbors.size(); }, result);
+}
+
+mgp_error mgp_graph_projection_vertex_id(mgp_graph_projection *projection, size_t index, mgp_vertex_id *result) {
+  return WrapExceptions(
+      [projection, index] {
+        if (index >= projection->vertex_ids.size()) {
+          throw std::out_of_range("Vertex id cannot be retrieved, because index exceeds the number of vertices!");
+        }
+        return mgp_vertex_id{.as_int = projection->vertex_ids[index]};
+      },
+      result);
+}
+
+mgp_error mgp_graph_projection_offsets(mgp_graph_projection *projection, const size_t **result) {
+  return WrapExceptions([projection] { return projection->offsets.data(); }, result);
+}
+
+mgp_error mgp_graph_projection_neighbors(mgp_graph_projection *projection, const size_t **result) {
+  return WrapExceptions([projection] { return projection->neighbors.data(); }, result);
+}
+
+mgp_error mgp_graph_projection_weights(mgp_graph_projection *projection, const double **result) {
+  return WrapExceptions(
+      [projection]() -> const double * { return projection->has_weights ? projection->weights.data() : nullptr; },
+      result);
+}
+
 /// Type System
 ///
 /// All types are allocated globally, so that we simplify the API and minimize
@@ -2311,6 +2477,25 @@ mgp_proc *mgp_module_add_procedure(mgp_module *module, const char *name, mgp_pro
   // May throw std::bad_alloc, std::length_error
   return &module->procedures.emplace(name, mgp_proc(name, cb, memory, is_write_procedure)).first->second;
 }
+
+mgp_proc *mgp_module_add_batch_procedure(mgp_module *module, const char *name, mgp_batch_proc_initializer initializer,
+                                         mgp_batch_proc_cb cb, mgp_batch_proc_cleanup cleanup,
+                                         bool is_write_procedure) {
+  if (!IsValidIdentifierName(name)) {
+    throw std::invalid_argument{fmt::format("Invalid procedure name: {}", name)};
+  }
+  if (!initializer || !cb || !cleanup) {
+    throw std::invalid_argument{fmt::format("Batched procedure '{}' requires all of its callbacks", name)};
+  }
+  if (module->procedures.find(name) != module->procedures.end()) {
+    throw std::logic_error{fmt::format("Procedure already exists with name '{}'", name)};
+  };
+
+  auto *memory = module->procedures.get_allocator().GetMemoryResource();
+  // May throw std::bad_alloc, std::length_error
+  return &module->procedures.emplace(name, mgp_proc(name, initializer, cb, cleanup, memory, is_write_procedure))
+              .first->second;
+}
 }  // namespace
 
 mgp_error mgp_module_add_read_procedure(mgp_module *module, const char *name, mgp_proc_cb cb, mgp_proc **result) {
@@ -2321,6 +2506,20 @@ mgp_error mgp_module_add_write_procedure(mgp_module *module, const char *name, m
   return WrapExceptions([=] { return mgp_module_add_procedure(module, name, cb, true); }, result);
 }
 
+mgp_error mgp_module_add_batch_read_procedure(mgp_module *module, const char *name,
+                                              mgp_batch_proc_initializer initializer, mgp_batch_proc_cb cb,
+                                              mgp_batch_proc_cleanup cleanup, mgp_proc **result) {
+  return WrapExceptions([=] { return mgp_module_add_batch_procedure(module, name, initializer, cb, cleanup, false); },
+                        result);
+}
+
+mgp_error mgp_module_add_batch_write_procedure(mgp_module *module, const char *name,
+                                               mgp_batch_proc_initializer initializer, mgp_batch_proc_cb cb,
+                                               mgp_batch_proc_cleanup cleanup, mgp_proc **result) {
+  return WrapExceptions([=] { return mgp_module_add_batch_procedure(module, name, initializer, cb, cleanup, true); },
+                        result);
+}
+
 mgp_error mgp_proc_add_arg(mgp_proc *proc, const char *name, mgp_type *type) {
   return WrapExceptions([=] {
     if (!IsValidIdentifierName(name)) {
@@ -2409,6 +2608,15 @@ mgp_error mgp_proc_add_deprecated_result(mgp_proc *proc, const char *name, mgp_t
   return AddResultToProp(proc, name, type, true);
 }
 
+mgp_error mgp_proc_set_parallel_safe(mgp_proc *proc) {
+  return WrapExceptions([proc] {
+    if (proc->is_write_procedure || proc->IsBatched()) {
+      throw std::logic_error{"Only read procedures which aren't batched can be called in parallel!"};
+    }
+    proc->is_parallel_safe = true;
+  });
+}
+
 int mgp_must_abort(mgp_graph *graph) {
   MG_ASSERT(graph->ctx);
   static_assert(noexcept(query::MustAbort(*graph->ctx)));
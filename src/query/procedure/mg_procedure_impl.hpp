@@ -648,6 +648,32 @@ struct mgp_vertices_iterator {
   std::optional<mgp_vertex> current_v;
 };
 
+struct mgp_graph_projection {
+  using allocator_type = utils::Allocator<mgp_graph_projection>;
+
+  explicit mgp_graph_projection(utils::MemoryResource *memory)
+      : vertex_ids(memory), offsets(memory), neighbors(memory), weights(memory) {}
+
+  mgp_graph_projection(const mgp_graph_projection &) = delete;
+  mgp_graph_projection(mgp_graph_projection &&) = delete;
+
+  mgp_graph_projection &operator=(const mgp_graph_projection &) = delete;
+  mgp_graph_projection &operator=(mgp_graph_projection &&) = delete;
+
+  ~mgp_graph_projection() = default;
+
+  utils::MemoryResource *GetMemoryResource() const noexcept { return vertex_ids.get_allocator().GetMemoryResource(); }
+
+  /// Gids of the projected vertices in ascending order, their positions are
+  /// the dense indices of the vertices.
+  utils::pmr::vector<int64_t> vertex_ids;
+  utils::pmr::vector<size_t> offsets;
+  utils::pmr::vector<size_t> neighbors;
+  /// Empty if the projection has no weights.
+  utils::pmr::vector<double> weights;
+  bool has_weights{false};
+};
+
 struct mgp_type {
   query::procedure::CypherTypePtr impl;
 };
@@ -676,23 +702,46 @@ struct mgp_proc {
         results(memory),
         is_write_procedure(is_write_procedure) {}
 
+  /// Construct a batched procedure.
+  /// @throw std::bad_alloc
+  /// @throw std::length_error
+  mgp_proc(const char *name, std::function<void *(mgp_list *, mgp_graph *, mgp_memory *)> batch_initializer,
+           std::function<void(void *, mgp_graph *, mgp_result *, mgp_memory *)> batch_cb,
+           std::function<void(void *)> batch_cleanup, utils::MemoryResource *memory, bool is_write_procedure)
+      : name(name, memory),
+        batch_initializer(std::move(batch_initializer)),
+        batch_cb(std::move(batch_cb)),
+        batch_cleanup(std::move(batch_cleanup)),
+        args(memory),
+        opt_args(memory),
+        results(memory),
+        is_write_procedure(is_write_procedure) {}
+
   /// @throw std::bad_alloc
   /// @throw std::length_error
   mgp_proc(const mgp_proc &other, utils::MemoryResource *memory)
       : name(other.name, memory),
         cb(other.cb),
+        batch_initializer(other.batch_initializer),
+        batch_cb(other.batch_cb),
+        batch_cleanup(other.batch_cleanup),
         args(other.args, memory),
         opt_args(other.opt_args, memory),
         results(other.results, memory),
-        is_write_procedure(other.is_write_procedure) {}
+        is_write_procedure(other.is_write_procedure),
+        is_parallel_safe(other.is_parallel_safe) {}
 
   mgp_proc(mgp_proc &&other, utils::MemoryResource *memory)
       : name(std::move(other.name), memory),
         cb(std::move(other.cb)),
+        batch_initializer(std::move(other.batch_initializer)),
+        batch_cb(std::move(other.batch_cb)),
+        batch_cleanup(std::move(other.batch_cleanup)),
         args(std::move(other.args), memory),
         opt_args(std::move(other.opt_args), memory),
         results(std::move(other.results), memory),
-        is_write_procedure(other.is_write_procedure) {}
+        is_write_procedure(other.is_write_procedure),
+        is_parallel_safe(other.is_parallel_safe) {}
 
   mgp_proc(const mgp_proc &other) = default;
   mgp_proc(mgp_proc &&other) = default;
@@ -704,8 +753,13 @@ struct mgp_proc {
 
   /// Name of the procedure.
   utils::pmr::string name;
-  /// Entry-point for the procedure.
+  /// Entry-point for the procedure, not set for batched procedures.
   std::function<void(mgp_list *, mgp_graph *, mgp_result *, mgp_memory *)> cb;
+  /// Entry-points of a batched procedure, see
+  /// `mgp_module_add_batch_read_procedure`.
+  std::function<void *(mgp_list *, mgp_graph *, mgp_memory *)> batch_initializer;
+  std::function<void(void *, mgp_graph *, mgp_result *, mgp_memory *)> batch_cb;
+  std::function<void(void *)> batch_cleanup;
   /// Required, positional arguments as a (name, type) pair.
   utils::pmr::vector<std::pair<utils::pmr::string, const query::procedure::CypherType *>> args;
   /// Optional positional arguments as a (name, type, default_value) tuple.
@@ -713,6 +767,11 @@ struct mgp_proc {
   /// Fields this procedure returns, as a (name -> (type, is_deprecated)) map.
   utils::pmr::map<utils::pmr::string, std::pair<const query::procedure::CypherType *, bool>> results;
   bool is_write_procedure{false};
+  /// Calls for different rows may run concurrently, see
+  /// `mgp_proc_set_parallel_safe`.
+  bool is_parallel_safe{false};
+
+  bool IsBatched() const { return static_cast<bool>(batch_cb); }
 };
 
 struct mgp_trans {
@@ -16,7 +16,11 @@ extern "C" {
 #include <dlfcn.h>
 }
 
+#include <algorithm>
+#include <atomic>
+#include <list>
 #include <optional>
+#include <unordered_set>
 
 #include "fmt/format.h"
 #include "py/py.hpp"
@@ -25,11 +29,121 @@ extern "C" {
 #include "utils/file.hpp"
 #include "utils/logging.hpp"
 #include "utils/message.hpp"
+#include "utils/on_scope_exit.hpp"
 #include "utils/pmr/vector.hpp"
+#include "utils/spin_lock.hpp"
 #include "utils/string.hpp"
+#include "utils/synchronized.hpp"
 
 namespace query::procedure {
 
+/// The snapshot used by the ModuleSnapshotPtr of a single thread. Writers scan
+/// all slots to find out which snapshots are still in use.
+struct alignas(64) ModuleReaderSlot {
+  std::atomic<const ModuleSnapshot *> snapshot{nullptr};
+  // Number of ModuleSnapshotPtr of the owning thread, accessed only by it.
+  uint64_t pins{0};
+  // Whether the slot is owned by a thread, accessed while holding the lock of
+  // ReaderSlots.
+  bool owned{false};
+};
+
+namespace {
+
+// Slots are reused after their threads exit, so there are only as many as
+// there were threads reading the modules concurrently.
+utils::Synchronized<std::list<ModuleReaderSlot>, utils::SpinLock> &ReaderSlots() {
+  static utils::Synchronized<std::list<ModuleReaderSlot>, utils::SpinLock> slots;
+  return slots;
+}
+
+class ReaderSlotOwner final {
+ public:
+  ReaderSlotOwner()
+      : slot_(ReaderSlots().WithLock([](auto &slots) {
+          auto found_it = std::find_if(slots.begin(), slots.end(), [](const auto &slot) { return !slot.owned; });
+          auto &slot = found_it == slots.end() ? slots.emplace_back() : *found_it;
+          slot.owned = true;
+          return &slot;
+        })) {}
+
+  ~ReaderSlotOwner() {
+    MG_ASSERT(slot_->pins == 0, "A thread exited while using the modules.");
+    ReaderSlots().WithLock([this](auto & /*slots*/) { slot_->owned = false; });
+  }
+
+  ReaderSlotOwner(const ReaderSlotOwner &) = delete;
+  ReaderSlotOwner(ReaderSlotOwner &&) = delete;
+  ReaderSlotOwner &operator=(const ReaderSlotOwner &) = delete;
+  ReaderSlotOwner &operator=(ReaderSlotOwner &&) = delete;
+
+  ModuleReaderSlot &Slot() { return *slot_; }
+
+ private:
+  ModuleReaderSlot *slot_;
+};
+
+ModuleReaderSlot &ThreadReaderSlot() {
+  thread_local ReaderSlotOwner owner;
+  return owner.Slot();
+}
+
+// Writers waiting in SynchronizeReaders wait for `reader_releases` to change.
+// Readers notify them only while there are such writers.
+std::atomic<uint64_t> waiting_writers{0};
+std::atomic<uint64_t> reader_releases{0};
+
+void NotifyWaitingWriters() {
+  if (waiting_writers.load(std::memory_order_seq_cst) > 0) {
+    reader_releases.fetch_add(1, std::memory_order_seq_cst);
+    reader_releases.notify_all();
+  }
+}
+
+void ReleaseSlot(ModuleReaderSlot &slot) {
+  slot.snapshot.store(nullptr, std::memory_order_seq_cst);
+  NotifyWaitingWriters();
+}
+
+// The snapshot may be retired before it's published in the slot, in which
+// case it's checked whether a writer might have missed it.
+void PinLatestSnapshot(ModuleReaderSlot &slot, const std::atomic<const ModuleSnapshot *> &latest) {
+  const auto *snapshot = latest.load(std::memory_order_seq_cst);
+  slot.snapshot.store(snapshot, std::memory_order_seq_cst);
+  while (true) {
+    const auto *current = latest.load(std::memory_order_seq_cst);
+    if (current == snapshot) break;
+    snapshot = current;
+    slot.snapshot.store(snapshot, std::memory_order_seq_cst);
+    // A writer may be waiting for the retired snapshot which was in the slot.
+    NotifyWaitingWriters();
+  }
+}
+
+}  // namespace
+
+ModuleSnapshotPtr::~ModuleSnapshotPtr() {
+  if (!slot_) return;
+  MG_ASSERT(slot_->pins > 0, "A snapshot was released while its thread was modifying the modules.");
+  if (--slot_->pins == 0) ReleaseSlot(*slot_);
+}
+
+ModuleSnapshotPtr &ModuleSnapshotPtr::operator=(ModuleSnapshotPtr &&other) noexcept {
+  if (this != &other) {
+    ModuleSnapshotPtr released(std::move(*this));
+    slot_ = std::exchange(other.slot_, nullptr);
+  }
+  return *this;
+}
+
+// A writer running on the same thread may have replaced the snapshot with a
+// newer one, so it is always read from the slot.
+const ModuleSnapshot &ModuleSnapshotPtr::operator*() const {
+  const auto *snapshot = slot_->snapshot.load(std::memory_order_relaxed);
+  MG_ASSERT(snapshot, "A snapshot was used while its thread was modifying the modules.");
+  return *snapshot;
+}
+
 ModuleRegistry gModuleRegistry;
 
 Module::~Module() {}
@@ -79,51 +193,26 @@ void BuiltinModule::AddTransformation(std::string_view name, mgp_trans trans) {
 
 namespace {
 
-void RegisterMgLoad(ModuleRegistry *module_registry, utils::RWLock *lock, BuiltinModule *module) {
-  // Loading relies on the fact that regular procedure invocation through
-  // CallProcedureCursor::Pull takes ModuleRegistry::lock_ with READ access. To
-  // load modules we have to upgrade our READ access to WRITE access,
-  // therefore we release the READ lock and invoke the load function which
-  // takes the WRITE lock. Obviously, some other thread may take a READ or WRITE
-  // lock during our transition when we hold no such lock. In this case it is
-  // fine, because our builtin module cannot be unloaded and we are ok with
-  // using the new state of module_registry when we manage to acquire the lock
-  // we desire. Note, deadlock between threads should not be possible, because a
-  // single thread may only take either a READ or a WRITE lock, it's not
-  // possible for a thread to hold both. If a thread tries to do that, it will
-  // deadlock immediately (no other thread needs to do anything).
-  auto with_unlock_shared = [lock](const auto &load_function) {
-    lock->unlock_shared();
-    try {
-      load_function();
-      // There's no finally in C++, but we have to return our original READ lock
-      // state in any possible case.
-    } catch (...) {
-      lock->lock_shared();
-      throw;
-    }
-    lock->lock_shared();
-  };
-  auto load_all_cb = [module_registry, with_unlock_shared](mgp_list * /*args*/, mgp_graph * /*graph*/,
-                                                           mgp_result * /*result*/, mgp_memory * /*memory*/) {
-    with_unlock_shared([&]() { module_registry->UnloadAndLoadModulesFromDirectories(); });
+void RegisterMgLoad(ModuleRegistry *module_registry, BuiltinModule *module) {
+  // The calling thread holds the builtin module, which is never unloaded, so
+  // the registry may be modified while it's held. See
+  // ModuleRegistry::WriteGuard.
+  auto load_all_cb = [module_registry](mgp_list * /*args*/, mgp_graph * /*graph*/, mgp_result * /*result*/,
+                                       mgp_memory * /*memory*/) {
+    module_registry->UnloadAndLoadModulesFromDirectories();
   };
   mgp_proc load_all("load_all", load_all_cb, utils::NewDeleteResource(), false);
   module->AddProcedure("load_all", std::move(load_all));
-  auto load_cb = [module_registry, with_unlock_shared](mgp_list *args, mgp_graph * /*graph*/, mgp_result *result,
-                                                       mgp_memory * /*memory*/) {
+  auto load_cb = [module_registry](mgp_list *args, mgp_graph * /*graph*/, mgp_result *result,
+                                   mgp_memory * /*memory*/) {
     MG_ASSERT(Call<size_t>(mgp_list_size, args) == 1U, "Should have been type checked already");
     auto *arg = Call<mgp_value *>(mgp_list_at, args, 0);
     MG_ASSERT(CallBool(mgp_value_is_string, arg), "Should have been type checked already");
     bool succ = false;
-    with_unlock_shared([&]() {
-      const char *arg_as_string{nullptr};
-      if (const auto err = mgp_value_get_string(arg, &arg_as_string); err != MGP_ERROR_NO_ERROR) {
-        succ = false;
-      } else {
-        succ = module_registry->LoadOrReloadModuleFromName(arg_as_string);
-      }
-    });
+    const char *arg_as_string{nullptr};
+    if (const auto err = mgp_value_get_string(arg, &arg_as_string); err == MGP_ERROR_NO_ERROR) {
+      succ = module_registry->LoadOrReloadModuleFromName(arg_as_string);
+    }
     if (!succ) {
       MG_ASSERT(mgp_result_set_error_msg(result, "Failed to (re)load the module.") == MGP_ERROR_NO_ERROR);
     }
@@ -133,16 +222,13 @@ void RegisterMgLoad(ModuleRegistry *module_registry, utils::RWLock *lock, Builti
   module->AddProcedure("load", std::move(load));
 }
 
-void RegisterMgProcedures(
+void RegisterMgProcedures(const ModuleRegistry *module_registry, BuiltinModule *module) {
+  auto procedures_cb = [module_registry](mgp_list * /*args*/, mgp_graph * /*graph*/, mgp_result *result,
+                                         mgp_memory *memory) {
+    // The snapshot is the one the caller used to find this procedure.
+    const auto snapshot = module_registry->GetSnapshot();
     // We expect modules to be sorted by name.
-    const std::map<std::string, std::unique_ptr<Module>, std::less<>> *all_modules, BuiltinModule *module) {
-  auto procedures_cb = [all_modules](mgp_list * /*args*/, mgp_graph * /*graph*/, mgp_result *result,
-                                     mgp_memory *memory) {
-    // Iterating over all_modules assumes that the standard mechanism of custom
-    // procedure invocations takes the ModuleRegistry::lock_ with READ access.
-    // For details on how the invocation is done, take a look at the
-    // CallProcedureCursor::Pull implementation.
-    for (const auto &[module_name, module] : *all_modules) {
+    for (const auto &[module_name, module] : snapshot->modules) {
       // Return the results in sorted order by module and by procedure.
       static_assert(
           std::is_same_v<decltype(module->Procedures()), const std::map<std::string, mgp_proc, std::less<>> *>,
@@ -210,11 +296,11 @@ void RegisterMgProcedures(
   module->AddProcedure("procedures", std::move(procedures));
 }
 
-void RegisterMgTransformations(const std::map<std::string, std::unique_ptr<Module>, std::less<>> *all_modules,
-                               BuiltinModule *module) {
-  auto transformations_cb = [all_modules](mgp_list * /*unused*/, mgp_graph * /*unused*/, mgp_result *result,
-                                          mgp_memory *memory) {
-    for (const auto &[module_name, module] : *all_modules) {
+void RegisterMgTransformations(const ModuleRegistry *module_registry, BuiltinModule *module) {
+  auto transformations_cb = [module_registry](mgp_list * /*unused*/, mgp_graph * /*unused*/, mgp_result *result,
+                                              mgp_memory *memory) {
+    const auto snapshot = module_registry->GetSnapshot();
+    for (const auto &[module_name, module] : snapshot->modules) {
       // Return the results in sorted order by module and by transformation.
       static_assert(
           std::is_same_v<decltype(module->Transformations()), const std::map<std::string, mgp_trans, std::less<>> *>,
@@ -531,6 +617,13 @@ std::unique_ptr<Module> LoadModuleFromFile(const std::filesystem::path &path) {
 }  // namespace
 
 bool ModuleRegistry::RegisterModule(const std::string_view &name, std::unique_ptr<Module> module) {
+  WriteGuard guard(this);
+  if (!DoRegisterModule(name, std::move(module))) return false;
+  PublishSnapshot();
+  return true;
+}
+
+bool ModuleRegistry::DoRegisterModule(const std::string_view &name, std::unique_ptr<Module> module) {
   MG_ASSERT(!name.empty(), "Module name cannot be empty");
   MG_ASSERT(module, "Tried to register an invalid module");
   if (modules_.find(name) != modules_.end()) {
@@ -541,23 +634,103 @@ bool ModuleRegistry::RegisterModule(const std::string_view &name, std::unique_pt
   return true;
 }
 
-void ModuleRegistry::DoUnloadAllModules() {
+std::vector<std::unique_ptr<Module>> ModuleRegistry::DoUnloadAllModules() {
   MG_ASSERT(modules_.find("mg") != modules_.end(), "Expected the builtin \"mg\" module to be present.");
-  // This is correct because the destructor will close each module. However,
-  // we don't want to unload the builtin "mg" module.
-  auto module = std::move(modules_["mg"]);
-  modules_.clear();
-  modules_.emplace("mg", std::move(module));
+  // The destructor of each unloaded module will close it. However, we don't
+  // want to unload the builtin "mg" module.
+  std::vector<std::unique_ptr<Module>> unloaded;
+  for (auto it = modules_.begin(); it != modules_.end();) {
+    if (it->first == "mg") {
+      ++it;
+      continue;
+    }
+    unloaded.emplace_back(std::move(it->second));
+    it = modules_.erase(it);
+  }
+  ++unload_count_;
+  return unloaded;
+}
+
+namespace {
+
+std::unordered_set<const ModuleSnapshot *> SnapshotsInUse() {
+  return ReaderSlots().WithLock([](const auto &slots) {
+    std::unordered_set<const ModuleSnapshot *> in_use;
+    for (const auto &slot : slots) {
+      if (const auto *snapshot = slot.snapshot.load(std::memory_order_seq_cst)) in_use.insert(snapshot);
+    }
+    return in_use;
+  });
+}
+
+}  // namespace
+
+void ModuleRegistry::PublishSnapshot() {
+  auto snapshot = std::make_unique<ModuleSnapshot>();
+  for (const auto &[name, module] : modules_) {
+    snapshot->modules.emplace(name, module.get());
+  }
+  snapshot->generation = ++generation_;
+  snapshot->unload_count = unload_count_;
+  const auto *published = snapshot.release();
+  if (const auto *previous = snapshot_.exchange(published, std::memory_order_seq_cst)) {
+    retired_snapshots_.emplace_back(previous);
+  }
+  const auto in_use = SnapshotsInUse();
+  std::erase_if(retired_snapshots_, [&](const auto &retired) { return !in_use.contains(retired.get()); });
+}
+
+void ModuleRegistry::SynchronizeReaders() {
+  if (retired_snapshots_.empty()) return;
+  waiting_writers.fetch_add(1, std::memory_order_seq_cst);
+  utils::OnScopeExit done{[] { waiting_writers.fetch_sub(1, std::memory_order_seq_cst); }};
+  while (true) {
+    const auto releases = reader_releases.load(std::memory_order_seq_cst);
+    const auto in_use = SnapshotsInUse();
+    std::erase_if(retired_snapshots_, [&](const auto &retired) { return !in_use.contains(retired.get()); });
+    if (retired_snapshots_.empty()) return;
+    reader_releases.wait(releases, std::memory_order_seq_cst);
+  }
+}
+
+// The writer may itself be a reader when a module is loaded with mg.load. Its
+// slot is cleared before it waits for other writers, which might otherwise wait
+// for it, and it moves to the latest snapshot once it's done. Modules of the
+// earlier snapshot which it still holds may be unloaded in the meantime.
+//
+// The pins of the earlier snapshots are suspended while the guard exists, so
+// snapshots taken by the writer pin the slot on their own. Using the earlier
+// snapshots meanwhile fails an assertion instead of reading a cleared slot.
+ModuleRegistry::WriteGuard::WriteGuard(const ModuleRegistry *registry) : registry_(registry) {
+  auto &slot = ThreadReaderSlot();
+  if (slot.pins > 0) {
+    ReleaseSlot(slot);
+    suspended_pins_ = std::exchange(slot.pins, 0);
+  }
+  guard_ = std::unique_lock(registry_->write_lock_);
+}
+
+ModuleRegistry::WriteGuard::~WriteGuard() {
+  guard_.unlock();
+  if (suspended_pins_ == 0) return;
+  auto &slot = ThreadReaderSlot();
+  MG_ASSERT(slot.pins == 0, "A snapshot taken while modifying the modules outlived the modification.");
+  slot.pins = suspended_pins_;
+  PinLatestSnapshot(slot, registry_->snapshot_);
 }
 
 ModuleRegistry::ModuleRegistry() {
   auto module = std::make_unique<BuiltinModule>();
-  RegisterMgProcedures(&modules_, module.get());
-  RegisterMgTransformations(&modules_, module.get());
-  RegisterMgLoad(this, &lock_, module.get());
+  RegisterMgProcedures(this, module.get());
+  RegisterMgTransformations(this, module.get());
+  RegisterMgLoad(this, module.get());
+  WriteGuard guard(this);
   modules_.emplace("mg", std::move(module));
+  PublishSnapshot();
 }
 
+ModuleRegistry::~ModuleRegistry() { delete snapshot_.load(); }
+
 void ModuleRegistry::SetModulesDirectory(std::vector<std::filesystem::path> modules_dirs) {
   modules_dirs_ = std::move(modules_dirs);
 }
@@ -572,7 +745,7 @@ bool ModuleRegistry::LoadModuleIfFound(const std::filesystem::path &modules_dir,
     if (entry.is_regular_file() && path.stem() == name) {
       auto module = LoadModuleFromFile(path);
       if (!module) return false;
-      return RegisterModule(name, std::move(module));
+      return DoRegisterModule(name, std::move(module));
     }
   }
   return false;
@@ -581,17 +754,22 @@ bool ModuleRegistry::LoadModuleIfFound(const std::filesystem::path &modules_dir,
 bool ModuleRegistry::LoadOrReloadModuleFromName(const std::string_view name) {
   if (modules_dirs_.empty()) return false;
   if (name.empty()) return false;
-  std::unique_lock<utils::RWLock> guard(lock_);
+  WriteGuard guard(this);
   auto found_it = modules_.find(name);
   if (found_it != modules_.end()) {
-    if (!found_it->second->Close()) {
-      spdlog::warn("Failed to close module {}", found_it->first);
-    }
+    auto module = std::move(found_it->second);
     modules_.erase(found_it);
+    ++unload_count_;
+    PublishSnapshot();
+    SynchronizeReaders();
+    if (!module->Close()) {
+      spdlog::warn("Failed to close module {}", name);
+    }
   }
 
   for (const auto &module_dir : modules_dirs_) {
     if (LoadModuleIfFound(module_dir, name)) {
+      PublishSnapshot();
       return true;
     }
   }
@@ -611,29 +789,50 @@ void ModuleRegistry::LoadModulesFromDirectory(const std::filesystem::path &modul
       if (name.empty()) continue;
       auto module = LoadModuleFromFile(path);
       if (!module) continue;
-      RegisterModule(name, std::move(module));
+      DoRegisterModule(name, std::move(module));
     }
   }
 }
 
 void ModuleRegistry::UnloadAndLoadModulesFromDirectories() {
-  std::unique_lock<utils::RWLock> guard(lock_);
-  DoUnloadAllModules();
+  WriteGuard guard(this);
+  {
+    auto unloaded = DoUnloadAllModules();
+    PublishSnapshot();
+    SynchronizeReaders();
+  }
   for (const auto &module_dir : modules_dirs_) {
     LoadModulesFromDirectory(module_dir);
   }
+  PublishSnapshot();
+}
+
+ModuleSnapshotPtr ModuleRegistry::GetSnapshot() const {
+  auto &slot = ThreadReaderSlot();
+  if (slot.pins++ == 0) PinLatestSnapshot(slot, snapshot_);
+  return ModuleSnapshotPtr(&slot);
 }
 
 ModulePtr ModuleRegistry::GetModuleNamed(const std::string_view &name) const {
-  std::shared_lock<utils::RWLock> guard(lock_);
-  auto found_it = modules_.find(name);
-  if (found_it == modules_.end()) return nullptr;
-  return ModulePtr(found_it->second.get(), std::move(guard));
+  auto find_module = [&]() -> ModulePtr {
+    auto snapshot = GetSnapshot();
+    auto found_it = snapshot->modules.find(name);
+    if (found_it == snapshot->modules.end()) return nullptr;
+    return ModulePtr(found_it->second, std::move(snapshot));
+  };
+  if (auto module = find_module()) return module;
+  // The module may be missing only while it's being reloaded. A thread which
+  // holds a snapshot mustn't wait for the writer, as the writer waits for it.
+  if (ThreadReaderSlot().pins > 0) return nullptr;
+  { std::lock_guard guard(write_lock_); }
+  return find_module();
 }
 
 void ModuleRegistry::UnloadAllModules() {
-  std::unique_lock<utils::RWLock> guard(lock_);
-  DoUnloadAllModules();
+  WriteGuard guard(this);
+  auto unloaded = DoUnloadAllModules();
+  PublishSnapshot();
+  SynchronizeReaders();
 }
 
 utils::MemoryResource &ModuleRegistry::GetSharedMemoryResource() noexcept { return *shared_; }
@@ -13,17 +13,21 @@
 /// API for loading and registering modules providing custom oC procedures
 #pragma once
 
+#include <atomic>
 #include <filesystem>
 #include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
-#include <shared_mutex>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "query/procedure/mg_procedure_impl.hpp"
 #include "utils/memory.hpp"
-#include "utils/rw_lock.hpp"
 
 class CypherMainVisitorTest;
 
@@ -47,33 +51,129 @@ class Module {
   virtual const std::map<std::string, mgp_trans, std::less<>> *Transformations() const = 0;
 };
 
-/// Proxy for a registered Module, acquires a read lock from ModuleRegistry.
+struct ModuleReaderSlot;
+
+/// Immutable set of the modules which were registered at some point in time.
+/// ModuleRegistry publishes a new snapshot whenever a module is (re)loaded or
+/// unloaded.
+struct ModuleSnapshot {
+  std::map<std::string, const Module *, std::less<>> modules;
+  /// Increases with each published snapshot of a registry.
+  uint64_t generation{0};
+  /// Number of times any module was unloaded or reloaded before this snapshot.
+  uint64_t unload_count{0};
+};
+
+/// Proxy for a ModuleSnapshot. Its modules won't be closed while it exists.
+///
+/// Taking a ModuleSnapshotPtr is lock-free, it only publishes the snapshot in
+/// use in a slot owned by the current thread. A thread may hold multiple
+/// ModuleSnapshotPtr, in which case they all refer to the snapshot which was
+/// published when the first one was taken. ModuleSnapshotPtr must be destroyed
+/// on the thread which took it.
+///
+/// A thread which modifies the registry while it holds ModuleSnapshotPtr, as
+/// mg.load does, releases their snapshot until the modification is done. They
+/// mustn't be used or destroyed meanwhile, which fails an assertion. Afterwards
+/// they refer to the latest snapshot, and a ModulePtr found earlier may refer
+/// to a module which was unloaded, so it must be looked up again.
+class ModuleSnapshotPtr final {
+  ModuleReaderSlot *slot_{nullptr};
+
+ public:
+  ModuleSnapshotPtr() = default;
+  explicit ModuleSnapshotPtr(ModuleReaderSlot *slot) : slot_(slot) {}
+  ~ModuleSnapshotPtr();
+
+  ModuleSnapshotPtr(const ModuleSnapshotPtr &) = delete;
+  ModuleSnapshotPtr &operator=(const ModuleSnapshotPtr &) = delete;
+  ModuleSnapshotPtr(ModuleSnapshotPtr &&other) noexcept : slot_(std::exchange(other.slot_, nullptr)) {}
+  ModuleSnapshotPtr &operator=(ModuleSnapshotPtr &&other) noexcept;
+
+  const ModuleSnapshot &operator*() const;
+  const ModuleSnapshot *operator->() const { return &**this; }
+};
+
+/// Proxy for a registered Module, holds a ModuleSnapshotPtr containing it.
 class ModulePtr final {
   const Module *module_{nullptr};
-  std::shared_lock<utils::RWLock> lock_;
+  ModuleSnapshotPtr snapshot_;
 
  public:
   ModulePtr() = default;
   ModulePtr(std::nullptr_t) {}
-  ModulePtr(const Module *module, std::shared_lock<utils::RWLock> lock) : module_(module), lock_(std::move(lock)) {}
+  ModulePtr(const Module *module, ModuleSnapshotPtr snapshot) : module_(module), snapshot_(std::move(snapshot)) {}
 
   explicit operator bool() const { return static_cast<bool>(module_); }
 
   const Module &operator*() const { return *module_; }
   const Module *operator->() const { return module_; }
+
+  /// Generation of the snapshot in which the module was found. The module and
+  /// its procedures are the same in all snapshots with the same generation.
+  uint64_t Generation() const { return snapshot_->generation; }
+
+  /// Number of times any module was unloaded or reloaded before the module was
+  /// found. Comparing it with an earlier value tells whether the procedures
+  /// found back then still exist.
+  uint64_t UnloadCount() const { return snapshot_->unload_count; }
 };
 
-/// Thread-safe registration of modules from libraries, uses utils::RWLock.
+/// Thread-safe registration of modules from libraries.
+///
+/// Lookups don't take any lock, they use the latest published ModuleSnapshot.
+/// Writers are serialized, they publish a new snapshot after modifying the
+/// modules and wait until no reader uses the modules they unload before
+/// closing them.
 class ModuleRegistry final {
   friend CypherMainVisitorTest;
 
+  // Modified only while holding write_lock_.
   std::map<std::string, std::unique_ptr<Module>, std::less<>> modules_;
-  mutable utils::RWLock lock_{utils::RWLock::Priority::WRITE};
+  std::atomic<const ModuleSnapshot *> snapshot_{nullptr};
+  // Published snapshots which may still be in use by readers.
+  std::vector<std::unique_ptr<const ModuleSnapshot>> retired_snapshots_;
+  mutable std::mutex write_lock_;
   std::unique_ptr<utils::MemoryResource> shared_{std::make_unique<utils::ResourceWithOutOfMemoryException>()};
+  // Modified only while holding write_lock_.
+  uint64_t unload_count_{0};
+  uint64_t generation_{0};
 
+  /// Registers the module and publishes a new snapshot.
   bool RegisterModule(const std::string_view &name, std::unique_ptr<Module> module);
 
-  void DoUnloadAllModules();
+  /// Must be called while holding write_lock_.
+  bool DoRegisterModule(const std::string_view &name, std::unique_ptr<Module> module);
+
+  /// Must be called while holding write_lock_. Returns the unloaded modules,
+  /// which mustn't be closed before the readers are synchronized.
+  std::vector<std::unique_ptr<Module>> DoUnloadAllModules();
+
+  /// Publishes the current modules_ as a new snapshot and deletes the retired
+  /// snapshots which aren't in use. Must be called while holding write_lock_.
+  void PublishSnapshot();
+
+  /// Waits until no reader uses a retired snapshot. Must be called while
+  /// holding write_lock_.
+  void SynchronizeReaders();
+
+  /// Holds write_lock_ for a writer, which may be holding a snapshot itself.
+  class WriteGuard final {
+   public:
+    explicit WriteGuard(const ModuleRegistry *registry);
+    ~WriteGuard();
+
+    WriteGuard(const WriteGuard &) = delete;
+    WriteGuard(WriteGuard &&) = delete;
+    WriteGuard &operator=(const WriteGuard &) = delete;
+    WriteGuard &operator=(WriteGuard &&) = delete;
+
+   private:
+    const ModuleRegistry *registry_;
+    std::unique_lock<std::mutex> guard_;
+    // Pins of the snapshots the writer held when the guard was created.
+    uint64_t suspended_pins_{0};
+  };
 
   /// Loads the module if it's in the modules_dir directory
   /// @return Whether the module was loaded
@@ -83,6 +183,12 @@ class ModuleRegistry final {
 
  public:
   ModuleRegistry();
+  ~ModuleRegistry();
+
+  ModuleRegistry(const ModuleRegistry &) = delete;
+  ModuleRegistry(ModuleRegistry &&) = delete;
+  ModuleRegistry &operator=(const ModuleRegistry &) = delete;
+  ModuleRegistry &operator=(ModuleRegistry &&) = delete;
 
   /// Set the modules directories that will be used when (re)loading modules.
   void SetModulesDirectory(std::vector<std::filesystem::path> modules_dir);
@@ -90,11 +196,11 @@ class ModuleRegistry final {
   /// Atomically load or reload a module with a particular name from the given
   /// directory.
   ///
-  /// Takes a write lock. If the module exists it is reloaded. Otherwise, the
-  /// module is loaded from the file whose filename, without the extension,
-  /// matches the module's name. If multiple such files exist, only one is
-  /// chosen, in an unspecified manner. If loading of the chosen file fails, no
-  /// other files are tried.
+  /// Blocks other writers. If the module exists it is unloaded once no reader
+  /// uses it anymore and then loaded again. Otherwise, the module is loaded
+  /// from the file whose filename, without the extension, matches the module's
+  /// name. If multiple such files exist, only one is chosen, in an unspecified
+  /// manner. If loading of the chosen file fails, no other files are tried.
   ///
   /// Return true if the module was loaded or reloaded successfully, false
   /// otherwise.
@@ -103,15 +209,21 @@ class ModuleRegistry final {
   /// Atomically unload all modules and then load all possible modules from the
   /// set directories.
   ///
-  /// Takes a write lock.
+  /// Blocks other writers.
   void UnloadAndLoadModulesFromDirectories();
 
+  /// Return the latest published snapshot of the modules.
+  ModuleSnapshotPtr GetSnapshot() const;
+
   /// Find a module with given name or return nullptr.
-  /// Takes a read lock.
+  ///
+  /// If the module isn't found while a writer is modifying the registry, waits
+  /// for the writer to finish and looks for the module again, unless the
+  /// current thread already holds a ModuleSnapshotPtr.
   ModulePtr GetModuleNamed(const std::string_view &name) const;
 
   /// Remove all loaded (non-builtin) modules.
-  /// Takes a write lock.
+  /// Blocks other writers.
   void UnloadAllModules();
 
   /// Returns the shared memory allocator used by modules
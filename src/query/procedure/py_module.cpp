@@ -13,17 +13,29 @@
 
 #include <datetime.h>
 #include <pyerrors.h>
+#include <algorithm>
 #include <array>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 #include "query/procedure/mg_procedure_helpers.hpp"
 #include "query/procedure/mg_procedure_impl.hpp"
 #include "utils/memory.hpp"
 #include "utils/on_scope_exit.hpp"
 #include "utils/pmr/vector.hpp"
+#include "utils/thread.hpp"
 
 namespace query::procedure {
 
@@ -39,17 +51,79 @@ PyObject *DisallowPickleAndCopy(PyObject *self, PyObject *Py_UNUSED(ignored)) {
   return nullptr;
 }
 
-PyObject *gMgpUnknownError{nullptr};             // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-PyObject *gMgpUnableToAllocateError{nullptr};    // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-PyObject *gMgpInsufficientBufferError{nullptr};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-PyObject *gMgpOutOfRangeError{nullptr};          // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-PyObject *gMgpLogicErrorError{nullptr};          // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-PyObject *gMgpDeletedObjectError{nullptr};       // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-PyObject *gMgpInvalidArgumentError{nullptr};     // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-PyObject *gMgpKeyAlreadyExistsError{nullptr};    // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-PyObject *gMgpImmutableObjectError{nullptr};     // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-PyObject *gMgpValueConversionError{nullptr};     // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
-PyObject *gMgpSerializationError{nullptr};       // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// What a worker interpreter needs to import its own instance of a Python
+// query module. A new one is made each time the main interpreter imports the
+// module.
+struct PyModuleSource {
+  std::string name;
+  std::vector<std::string> sys_path;
+};
+
+// The callbacks which a Python query module registers, by name.
+struct PyModuleCallbacks {
+  std::map<std::string, py::Object, std::less<>> procedures;
+  std::map<std::string, py::Object, std::less<>> transformations;
+};
+
+// The types and exceptions of the `_mgp` module of an interpreter. The main
+// interpreter uses the static types defined in this file. Worker interpreters
+// have their own GIL, so they get heap types made from the static ones.
+struct MgpModuleState {
+  PyTypeObject *properties_iterator_type{nullptr};
+  PyTypeObject *vertices_iterator_type{nullptr};
+  PyTypeObject *edges_iterator_type{nullptr};
+  PyTypeObject *graph_type{nullptr};
+  PyTypeObject *edge_type{nullptr};
+  PyTypeObject *proc_type{nullptr};
+  PyTypeObject *module_type{nullptr};
+  PyTypeObject *vertex_type{nullptr};
+  PyTypeObject *path_type{nullptr};
+  PyTypeObject *cypher_type_type{nullptr};
+  PyTypeObject *messages_type{nullptr};
+  PyTypeObject *message_type{nullptr};
+
+  PyObject *unknown_error{nullptr};
+  PyObject *unable_to_allocate_error{nullptr};
+  PyObject *insufficient_buffer_error{nullptr};
+  PyObject *out_of_range_error{nullptr};
+  PyObject *logic_error_error{nullptr};
+  PyObject *deleted_object_error{nullptr};
+  PyObject *invalid_argument_error{nullptr};
+  PyObject *key_already_exists_error{nullptr};
+  PyObject *immutable_object_error{nullptr};
+  PyObject *value_conversion_error{nullptr};
+  PyObject *serialization_error{nullptr};
+
+  // The datetime C API is imported only by the main interpreter.
+  bool has_datetime_api{false};
+  // Set while the main interpreter imports a query module.
+  std::shared_ptr<const PyModuleSource> module_source;
+  // Set while a worker interpreter imports a query module, collects the
+  // callbacks the module registers.
+  PyModuleCallbacks *module_callbacks{nullptr};
+};
+
+MgpModuleState gMainModuleState;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// Set on the threads of the worker interpreters.
+thread_local MgpModuleState *tWorkerModuleState{nullptr};  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+MgpModuleState &ModuleState() { return tWorkerModuleState ? *tWorkerModuleState : gMainModuleState; }
+
+// Temporal values are converted with the datetime C API, which only the main
+// interpreter has.
+bool EnsureDateTimeApi() {
+  if (ModuleState().has_datetime_api) return true;
+  PyErr_SetString(PyExc_TypeError, "Temporal values aren't supported by Python worker interpreters.");
+  return false;
+}
+
+// Instances of the heap types hold a reference to their type.
+template <class TObject>
+void FreePyMgpObject(TObject *self) {
+  auto *type = Py_TYPE(self);
+  type->tp_free(self);
+  if (PyType_HasFeature(type, Py_TPFLAGS_HEAPTYPE)) Py_DECREF(type);
+}
 
 // Returns true if an exception is raised
 bool RaiseExceptionFromErrorCode(const mgp_error error) {
@@ -57,47 +131,47 @@ bool RaiseExceptionFromErrorCode(const mgp_error error) {
     case MGP_ERROR_NO_ERROR:
       return false;
     case MGP_ERROR_UNKNOWN_ERROR: {
-      PyErr_SetString(gMgpUnknownError, "Unknown error happened.");
+      PyErr_SetString(ModuleState().unknown_error, "Unknown error happened.");
       return true;
     }
     case MGP_ERROR_UNABLE_TO_ALLOCATE: {
-      PyErr_SetString(gMgpUnableToAllocateError, "Unable to allocate memory.");
+      PyErr_SetString(ModuleState().unable_to_allocate_error, "Unable to allocate memory.");
       return true;
     }
     case MGP_ERROR_INSUFFICIENT_BUFFER: {
-      PyErr_SetString(gMgpInsufficientBufferError, "Insufficient buffer.");
+      PyErr_SetString(ModuleState().insufficient_buffer_error, "Insufficient buffer.");
       return true;
     }
     case MGP_ERROR_OUT_OF_RANGE: {
-      PyErr_SetString(gMgpOutOfRangeError, "Out of range.");
+      PyErr_SetString(ModuleState().out_of_range_error, "Out of range.");
       return true;
     }
     case MGP_ERROR_LOGIC_ERROR: {
-      PyErr_SetString(gMgpLogicErrorError, "Logic error.");
+      PyErr_SetString(ModuleState().logic_error_error, "Logic error.");
       return true;
     }
     case MGP_ERROR_DELETED_OBJECT: {
-      PyErr_SetString(gMgpDeletedObjectError, "Accessing deleted object.");
+      PyErr_SetString(ModuleState().deleted_object_error, "Accessing deleted object.");
       return true;
     }
     case MGP_ERROR_INVALID_ARGUMENT: {
-      PyErr_SetString(gMgpInvalidArgumentError, "Invalid argument.");
+      PyErr_SetString(ModuleState().invalid_argument_error, "Invalid argument.");
       return true;
     }
     case MGP_ERROR_KEY_ALREADY_EXISTS: {
-      PyErr_SetString(gMgpKeyAlreadyExistsError, "Key already exists.");
+      PyErr_SetString(ModuleState().key_already_exists_error, "Key already exists.");
       return true;
     }
     case MGP_ERROR_IMMUTABLE_OBJECT: {
-      PyErr_SetString(gMgpImmutableObjectError, "Cannot modify immutable object.");
+      PyErr_SetString(ModuleState().immutable_object_error, "Cannot modify immutable object.");
       return true;
     }
     case MGP_ERROR_VALUE_CONVERSION: {
-      PyErr_SetString(gMgpValueConversionError, "Value conversion failed.");
+      PyErr_SetString(ModuleState().value_conversion_error, "Value conversion failed.");
       return true;
     }
     case MGP_ERROR_SERIALIZATION_ERROR: {
-      PyErr_SetString(gMgpSerializationError, "Operation cannot be serialized.");
+      PyErr_SetString(ModuleState().serialization_error, "Operation cannot be serialized.");
       return true;
     }
   }
@@ -168,7 +242,7 @@ void PyVerticesIteratorDealloc(PyVerticesIterator *self) {
   // execution, so we may cause a double free issue.
   if (self->py_graph->graph) mgp_vertices_iterator_destroy(self->it);
   Py_DECREF(self->py_graph);
-  Py_TYPE(self)->tp_free(self);
+  FreePyMgpObject(self);
 }
 
 PyObject *PyVerticesIteratorGet(PyVerticesIterator *self, PyObject *Py_UNUSED(ignored)) {
@@ -238,7 +312,7 @@ void PyEdgesIteratorDealloc(PyEdgesIterator *self) {
   // execution, so we may cause a double free issue.
   if (self->py_graph->graph) mgp_edges_iterator_destroy(self->it);
   Py_DECREF(self->py_graph);
-  Py_TYPE(self)->tp_free(self);
+  FreePyMgpObject(self);
 }
 
 PyObject *PyEdgesIteratorGet(PyEdgesIterator *self, PyObject *Py_UNUSED(ignored)) {
@@ -356,7 +430,7 @@ PyObject *PyGraphIterVertices(PyGraph *self, PyObject *Py_UNUSED(ignored)) {
   if (RaiseExceptionFromErrorCode(mgp_graph_iter_vertices(self->graph, self->memory, &vertices_it))) {
     return nullptr;
   }
-  auto *py_vertices_it = PyObject_New(PyVerticesIterator, &PyVerticesIteratorType);
+  auto *py_vertices_it = PyObject_New(PyVerticesIterator, ModuleState().vertices_iterator_type);
   if (!py_vertices_it) {
     mgp_vertices_iterator_destroy(vertices_it);
     return nullptr;
@@ -367,6 +441,44 @@ PyObject *PyGraphIterVertices(PyGraph *self, PyObject *Py_UNUSED(ignored)) {
   return reinterpret_cast<PyObject *>(py_vertices_it);
 }
 
+PyObject *PyGraphProject(PyGraph *self, PyObject *args) {
+  MG_ASSERT(PyGraphIsValidImpl(*self));
+  MG_ASSERT(self->memory);
+  const char *label{nullptr};
+  const char *edge_type{nullptr};
+  const char *weight_property{nullptr};
+  if (!PyArg_ParseTuple(args, "zzz", &label, &edge_type, &weight_property)) return nullptr;
+  MgpUniquePtr<mgp_graph_projection> projection{nullptr, mgp_graph_projection_destroy};
+  mgp_error error{MGP_ERROR_NO_ERROR};
+  // Projecting walks the whole graph without touching any Python objects, so
+  // other Python procedures may run meanwhile.
+  Py_BEGIN_ALLOW_THREADS;
+  error = CreateMgpObject(projection, mgp_graph_project, self->graph, label, edge_type, weight_property, self->memory);
+  Py_END_ALLOW_THREADS;
+  if (RaiseExceptionFromErrorCode(error)) return nullptr;
+  // The arrays are copied into bytes objects which are viewed through
+  // `memoryview.cast` on the Python side, so no per-element objects are made.
+  auto to_bytes = [](const auto &array) {
+    return py::Object(PyBytes_FromStringAndSize(reinterpret_cast<const char *>(array.data()),
+                                                static_cast<Py_ssize_t>(array.size() * sizeof(array[0]))));
+  };
+  auto py_vertex_ids = to_bytes(projection->vertex_ids);
+  if (!py_vertex_ids) return nullptr;
+  auto py_offsets = to_bytes(projection->offsets);
+  if (!py_offsets) return nullptr;
+  auto py_neighbors = to_bytes(projection->neighbors);
+  if (!py_neighbors) return nullptr;
+  py::Object py_weights;
+  if (projection->has_weights) {
+    py_weights = to_bytes(projection->weights);
+    if (!py_weights) return nullptr;
+  } else {
+    Py_INCREF(Py_None);
+    py_weights = py::Object(Py_None);
+  }
+  return PyTuple_Pack(4, py_vertex_ids.Ptr(), py_offsets.Ptr(), py_neighbors.Ptr(), py_weights.Ptr());
+}
+
 PyObject *PyGraphMustAbort(PyGraph *self, PyObject *Py_UNUSED(ignored)) {
   MG_ASSERT(PyGraphIsValidImpl(*self));
   return PyBool_FromLong(mgp_must_abort(self->graph));
@@ -389,6 +501,8 @@ static PyMethodDef PyGraphMethods[] = {
      "Delete a vertex and all of its edges."},
     {"delete_edge", reinterpret_cast<PyCFunction>(PyGraphDeleteEdge), METH_VARARGS, "Delete an edge."},
     {"iter_vertices", reinterpret_cast<PyCFunction>(PyGraphIterVertices), METH_NOARGS, "Return _mgp.VerticesIterator."},
+    {"project", reinterpret_cast<PyCFunction>(PyGraphProject), METH_VARARGS,
+     "Return a tuple (vertex_ids, offsets, neighbors, weights) of bytes describing a CSR projection of the graph."},
     {"must_abort", reinterpret_cast<PyCFunction>(PyGraphMustAbort), METH_NOARGS,
      "Check whether the running procedure should abort"},
     {nullptr},
@@ -407,7 +521,7 @@ static PyTypeObject PyGraphType = {
 
 PyObject *MakePyGraph(mgp_graph *graph, mgp_memory *memory) {
   MG_ASSERT(!graph || (graph && memory));
-  auto *py_graph = PyObject_New(PyGraph, &PyGraphType);
+  auto *py_graph = PyObject_New(PyGraph, ModuleState().graph_type);
   if (!py_graph) return nullptr;
   py_graph->graph = graph;
   py_graph->memory = memory;
@@ -433,7 +547,7 @@ static PyTypeObject PyCypherTypeType = {
 
 PyObject *MakePyCypherType(mgp_type *type) {
   MG_ASSERT(type);
-  auto *py_type = PyObject_New(PyCypherType, &PyCypherTypeType);
+  auto *py_type = PyObject_New(PyCypherType, ModuleState().cypher_type_type);
   if (!py_type) return nullptr;
   py_type->type = type;
   return reinterpret_cast<PyObject *>(py_type);
@@ -450,7 +564,7 @@ PyObject *PyQueryProcAddArg(PyQueryProc *self, PyObject *args) {
   MG_ASSERT(self->proc);
   const char *name = nullptr;
   PyCypherType *py_type = nullptr;
-  if (!PyArg_ParseTuple(args, "sO!", &name, &PyCypherTypeType, &py_type)) return nullptr;
+  if (!PyArg_ParseTuple(args, "sO!", &name, ModuleState().cypher_type_type, &py_type)) return nullptr;
   auto *type = py_type->type;
   if (RaiseExceptionFromErrorCode(mgp_proc_add_arg(self->proc, name, type))) {
     return nullptr;
@@ -463,7 +577,7 @@ PyObject *PyQueryProcAddOptArg(PyQueryProc *self, PyObject *args) {
   const char *name = nullptr;
   PyCypherType *py_type = nullptr;
   PyObject *py_value = nullptr;
-  if (!PyArg_ParseTuple(args, "sO!O", &name, &PyCypherTypeType, &py_type, &py_value)) return nullptr;
+  if (!PyArg_ParseTuple(args, "sO!O", &name, ModuleState().cypher_type_type, &py_type, &py_value)) return nullptr;
   auto *type = py_type->type;
   mgp_memory memory{self->proc->opt_args.get_allocator().GetMemoryResource()};
   mgp_value *value = PyObjectToMgpValueWithPythonExceptions(py_value, &memory);
@@ -482,7 +596,7 @@ PyObject *PyQueryProcAddResult(PyQueryProc *self, PyObject *args) {
   MG_ASSERT(self->proc);
   const char *name = nullptr;
   PyCypherType *py_type = nullptr;
-  if (!PyArg_ParseTuple(args, "sO!", &name, &PyCypherTypeType, &py_type)) return nullptr;
+  if (!PyArg_ParseTuple(args, "sO!", &name, ModuleState().cypher_type_type, &py_type)) return nullptr;
 
   auto *type = reinterpret_cast<PyCypherType *>(py_type)->type;
   if (RaiseExceptionFromErrorCode(mgp_proc_add_result(self->proc, name, type))) {
@@ -495,7 +609,7 @@ PyObject *PyQueryProcAddDeprecatedResult(PyQueryProc *self, PyObject *args) {
   MG_ASSERT(self->proc);
   const char *name = nullptr;
   PyCypherType *py_type = nullptr;
-  if (!PyArg_ParseTuple(args, "sO!", &name, &PyCypherTypeType, &py_type)) return nullptr;
+  if (!PyArg_ParseTuple(args, "sO!", &name, ModuleState().cypher_type_type, &py_type)) return nullptr;
   auto *type = reinterpret_cast<PyCypherType *>(py_type)->type;
   if (RaiseExceptionFromErrorCode(mgp_proc_add_deprecated_result(self->proc, name, type))) {
     return nullptr;
@@ -641,7 +755,7 @@ void PyMessageDealloc(PyMessage *self) {
   // NOLINTNEXTLINE
   Py_DECREF(self->messages);
   // NOLINTNEXTLINE
-  Py_TYPE(self)->tp_free(self);
+  FreePyMgpObject(self);
 }
 
 // NOLINTNEXTLINE
@@ -682,7 +796,7 @@ PyObject *PyMessagesGetMessageAt(PyMessages *self, PyObject *args) {
   if (id < 0 || id >= self->messages->messages.size()) return nullptr;
   auto *message = &self->messages->messages[id];
   // NOLINTNEXTLINE
-  auto *py_message = PyObject_New(PyMessage, &PyMessageType);
+  auto *py_message = PyObject_New(PyMessage, ModuleState().message_type);
   if (!py_message) {
     return nullptr;
   }
@@ -727,7 +841,7 @@ static PyTypeObject PyMessagesType = {
 PyObject *MakePyMessages(mgp_messages *msgs, mgp_memory *memory) {
   MG_ASSERT(!msgs || (msgs && memory));
   // NOLINTNEXTLINE
-  auto *py_messages = PyObject_New(PyMessages, &PyMessagesType);
+  auto *py_messages = PyObject_New(PyMessages, ModuleState().messages_type);
   if (!py_messages) return nullptr;
   py_messages->messages = msgs;
   py_messages->memory = memory;
@@ -751,7 +865,7 @@ py::Object MgpListToPyTuple(mgp_list *list, PyGraph *py_graph) {
 }
 
 py::Object MgpListToPyTuple(mgp_list *list, PyObject *py_graph) {
-  if (Py_TYPE(py_graph) != &PyGraphType) {
+  if (Py_TYPE(py_graph) != ModuleState().graph_type) {
     PyErr_SetString(PyExc_TypeError, "Expected a _mgp.Graph.");
     return nullptr;
   }
@@ -760,11 +874,16 @@ py::Object MgpListToPyTuple(mgp_list *list, PyObject *py_graph) {
 
 namespace {
 
-std::optional<py::ExceptionInfo> AddRecordFromPython(mgp_result *result, py::Object py_record) {
+// Looked up once per call of a procedure rather than once per record, because
+// importing goes through `sys.modules` while holding the GIL.
+py::Object GetRecordClass() {
   py::Object py_mgp(PyImport_ImportModule("mgp"));
-  if (!py_mgp) return py::FetchError();
-  auto record_cls = py_mgp.GetAttr("Record");
-  if (!record_cls) return py::FetchError();
+  if (!py_mgp) return nullptr;
+  return py_mgp.GetAttr("Record");
+}
+
+std::optional<py::ExceptionInfo> AddRecordFromPython(mgp_result *result, py::Object py_record,
+                                                     const py::Object &record_cls) {
   if (!PyObject_IsInstance(py_record.Ptr(), record_cls.Ptr())) {
     std::stringstream ss;
     ss << "Value '" << py_record << "' is not an instance of 'mgp.Record'";
@@ -821,21 +940,142 @@ std::optional<py::ExceptionInfo> AddRecordFromPython(mgp_result *result, py::Obj
   return std::nullopt;
 }
 
-std::optional<py::ExceptionInfo> AddMultipleRecordsFromPython(mgp_result *result, py::Object py_seq) {
+std::optional<py::ExceptionInfo> AddMultipleRecordsFromPython(mgp_result *result, py::Object py_seq,
+                                                              const py::Object &record_cls) {
   Py_ssize_t len = PySequence_Size(py_seq.Ptr());
   if (len == -1) return py::FetchError();
   for (Py_ssize_t i = 0; i < len; ++i) {
     py::Object py_record(PySequence_GetItem(py_seq.Ptr(), i));
     if (!py_record) return py::FetchError();
-    auto maybe_exc = AddRecordFromPython(result, py_record);
+    auto maybe_exc = AddRecordFromPython(result, py_record, record_cls);
     if (maybe_exc) return maybe_exc;
   }
   return std::nullopt;
 }
 
-void CallPythonProcedure(const py::Object &py_cb, mgp_list *args, mgp_graph *graph, mgp_result *result,
-                         mgp_memory *memory) {
+// A callback registered by a Python query module. Worker interpreters call
+// their own instance of it, which they find by the module and the name.
+struct PyCallback {
+  py::Object py_cb;
+  std::shared_ptr<const PyModuleSource> source;
+  std::string name;
+};
+
+// An interpreter with its own GIL and its own thread, which runs Python
+// procedures and transformations in parallel with the other worker
+// interpreters.
+class PyWorkerInterpreter final {
+ public:
+  /// Returns this interpreter's instance of `callback`. Must be called on the
+  /// interpreter's thread. On failure, null is returned and the Python error
+  /// is set.
+  py::Object Resolve(const PyCallback &callback, bool is_transformation);
+
+  /// Drops all imported modules. Must be called on the interpreter's thread.
+  void Clear() { modules_.clear(); }
+
+  MgpModuleState &State() { return state_; }
+
+ private:
+  struct LoadedModule {
+    std::shared_ptr<const PyModuleSource> source;
+    std::unique_ptr<mgp_module> module_def;
+    PyModuleCallbacks callbacks;
+    py::Object py_module;
+  };
+
+  bool Import(const std::shared_ptr<const PyModuleSource> &source);
+
+  MgpModuleState state_;
+  std::map<std::string, LoadedModule, std::less<>> modules_;
+};
+
+// Threads of the worker interpreters, which take the calls of Python
+// procedures and transformations from a shared queue.
+class PyWorkerInterpreters final {
+ public:
+  bool Start(size_t count);
+  void Stop();
+
+  bool Started() const { return !threads_.empty(); }
+
+  /// Runs `fun` on the thread of `interpreter`, or of any worker interpreter
+  /// if it's null, and waits for it to finish. Exceptions thrown by `fun` are
+  /// rethrown.
+  void Run(PyWorkerInterpreter *interpreter, const std::function<void(PyWorkerInterpreter *)> &fun);
+
+ private:
+  struct Task {
+    const std::function<void(PyWorkerInterpreter *)> *fun;
+    PyWorkerInterpreter *interpreter;
+    std::exception_ptr exception;
+    bool done{false};
+  };
+
+  void Work(PyWorkerInterpreter *interpreter, std::promise<bool> *started);
+
+  std::mutex mutex_;
+  std::condition_variable task_cv_;
+  std::condition_variable done_cv_;
+  std::deque<Task *> tasks_;
+  bool stop_{false};
+  std::vector<std::unique_ptr<PyWorkerInterpreter>> interpreters_;
+  std::vector<std::thread> threads_;
+};
+
+PyWorkerInterpreters gPyWorkerInterpreters;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Runs `fun` while holding the GIL of `interpreter`. When it's null, any of
+// the worker interpreters is used, or the main interpreter if they weren't
+// started. `fun` gets the worker interpreter, or null for the main one.
+void RunPython(const std::function<void(PyWorkerInterpreter *)> &fun, PyWorkerInterpreter *interpreter = nullptr) {
+  if (interpreter || gPyWorkerInterpreters.Started()) {
+    gPyWorkerInterpreters.Run(interpreter, fun);
+    return;
+  }
   auto gil = py::EnsureGIL();
+  fun(nullptr);
+}
+
+py::Object GetCallback(PyWorkerInterpreter *interpreter, const PyCallback &callback, bool is_transformation) {
+  if (!interpreter) return callback.py_cb;
+  return interpreter->Resolve(callback, is_transformation);
+}
+
+void CollectGarbageAndInvalidateGraph(const py::Object &py_graph) {
+  // Run `gc.collect` (reference cycle-detection) explicitly, so that we are
+  // sure the procedure cleaned up everything it held references to. If the
+  // user stored a reference to one of our `_mgp` instances then the
+  // internally used `mgp_*` structs will stay unfreed and a memory leak
+  // will be reported at the end of the query execution.
+  //
+  // Every `_mgp` instance which wraps an `mgp_*` struct of the graph holds a
+  // reference to the `_mgp.Graph`. When ours is the only reference left, there
+  // is nothing to collect and the full collection, which walks all Python
+  // objects while holding the GIL, is skipped.
+  if (Py_REFCNT(py_graph.Ptr()) > 1) {
+    py::Object gc(PyImport_ImportModule("gc"));
+    if (!gc) {
+      LOG_FATAL(py::FetchError().value());
+    }
+
+    if (!gc.CallMethod("collect")) {
+      LOG_FATAL(py::FetchError().value());
+    }
+  }
+
+  // After making sure all references from our side have been cleared,
+  // invalidate the `_mgp.Graph` object. If the user kept a reference to one
+  // of our `_mgp` instances then this will prevent them from using those
+  // objects (whose internal `mgp_*` pointers are now invalid and would cause
+  // a crash).
+  if (!py_graph.CallMethod("invalidate")) {
+    LOG_FATAL(py::FetchError().value());
+  }
+}
+
+void CallPythonProcedure(PyWorkerInterpreter *interpreter, const PyCallback &callback, mgp_list *args,
+                         mgp_graph *graph, mgp_result *result, mgp_memory *memory) {
 
   auto error_to_msg = [](const std::optional<py::ExceptionInfo> &exc_info) -> std::optional<std::string> {
     if (!exc_info) return std::nullopt;
@@ -847,41 +1087,22 @@ void CallPythonProcedure(const py::Object &py_cb, mgp_list *args, mgp_graph *gra
   };
 
   auto call = [&](py::Object py_graph) -> std::optional<py::ExceptionInfo> {
+    auto py_cb = GetCallback(interpreter, callback, /* is_transformation = */ false);
+    if (!py_cb) return py::FetchError();
     py::Object py_args(MgpListToPyTuple(args, py_graph.Ptr()));
     if (!py_args) return py::FetchError();
     auto py_res = py_cb.Call(py_graph, py_args);
     if (!py_res) return py::FetchError();
+    auto record_cls = GetRecordClass();
+    if (!record_cls) return py::FetchError();
     if (PySequence_Check(py_res.Ptr())) {
-      return AddMultipleRecordsFromPython(result, py_res);
+      return AddMultipleRecordsFromPython(result, py_res, record_cls);
     } else {
-      return AddRecordFromPython(result, py_res);
+      return AddRecordFromPython(result, py_res, record_cls);
     }
   };
 
-  auto cleanup = [](py::Object py_graph) {
-    // Run `gc.collect` (reference cycle-detection) explicitly, so that we are
-    // sure the procedure cleaned up everything it held references to. If the
-    // user stored a reference to one of our `_mgp` instances then the
-    // internally used `mgp_*` structs will stay unfreed and a memory leak
-    // will be reported at the end of the query execution.
-    py::Object gc(PyImport_ImportModule("gc"));
-    if (!gc) {
-      LOG_FATAL(py::FetchError().value());
-    }
-
-    if (!gc.CallMethod("collect")) {
-      LOG_FATAL(py::FetchError().value());
-    }
-
-    // After making sure all references from our side have been cleared,
-    // invalidate the `_mgp.Graph` object. If the user kept a reference to one
-    // of our `_mgp` instances then this will prevent them from using those
-    // objects (whose internal `mgp_*` pointers are now invalid and would cause
-    // a crash).
-    if (!py_graph.CallMethod("invalidate")) {
-      LOG_FATAL(py::FetchError().value());
-    }
-  };
+  auto cleanup = [](const py::Object &py_graph) { CollectGarbageAndInvalidateGraph(py_graph); };
 
   // It is *VERY IMPORTANT* to note that this code takes great care not to keep
   // any extra references to any `_mgp` instances (except for `_mgp.Graph`), so
@@ -913,9 +1134,104 @@ void CallPythonProcedure(const py::Object &py_cb, mgp_list *args, mgp_graph *gra
   }
 }
 
-void CallPythonTransformation(const py::Object &py_cb, mgp_messages *msgs, mgp_graph *graph, mgp_result *result,
-                              mgp_memory *memory) {
-  auto gil = py::EnsureGIL();
+// How many records a batched Python procedure produces per invocation.
+constexpr size_t kPythonProcedureBatchSize = 1000;
+
+// State of a call of a batched Python procedure. The `_mgp.Graph` stays valid
+// until the call is cleaned up, because the records produced by the iterator
+// may reference it. It's invalidated before the generator is closed, as the
+// cleanup may run after the execution context of the query is destroyed.
+struct PyBatchedCall {
+  // Interpreter which owns the Python objects of the call, null for the main
+  // interpreter.
+  PyWorkerInterpreter *interpreter;
+  py::Object py_graph;
+  // Reset once all records were produced.
+  py::Object py_iterator;
+  std::optional<std::string> error_msg;
+};
+
+void *InitializePythonBatchedCall(PyWorkerInterpreter *interpreter, const PyCallback &callback, mgp_list *args,
+                                  mgp_graph *graph, mgp_memory *memory) {
+  auto call = std::make_unique<PyBatchedCall>();
+  call->interpreter = interpreter;
+  // The same care as in `CallPythonProcedure` is taken not to keep the
+  // `ExceptionInfo` alive.
+  auto call_cb = [&]() -> std::optional<py::ExceptionInfo> {
+    auto py_cb = GetCallback(interpreter, callback, /* is_transformation = */ false);
+    if (!py_cb) return py::FetchError();
+    call->py_graph = py::Object(MakePyGraph(graph, memory));
+    if (!call->py_graph) return py::FetchError();
+    py::Object py_args(MgpListToPyTuple(args, call->py_graph.Ptr()));
+    if (!py_args) return py::FetchError();
+    auto py_res = py_cb.Call(call->py_graph, py_args);
+    if (!py_res) return py::FetchError();
+    call->py_iterator = py::Object(PyObject_GetIter(py_res.Ptr()));
+    if (!call->py_iterator) return py::FetchError();
+    return std::nullopt;
+  };
+  if (auto maybe_exc = call_cb()) {
+    // The error is reported with the first batch.
+    call->error_msg = py::FormatException(*maybe_exc, /* skip_first_line = */ true);
+  }
+  return call.release();
+}
+
+void CallPythonBatchedProcedure(void *state, mgp_result *result) {
+  auto &call = *static_cast<PyBatchedCall *>(state);
+  if (call.error_msg) {
+    static_cast<void>(mgp_result_set_error_msg(result, call.error_msg->c_str()));
+    return;
+  }
+  if (!call.py_iterator) return;
+
+  auto produce_batch = [&]() -> std::optional<py::ExceptionInfo> {
+    auto record_cls = GetRecordClass();
+    if (!record_cls) return py::FetchError();
+    for (size_t i = 0; i < kPythonProcedureBatchSize; ++i) {
+      py::Object py_record(PyIter_Next(call.py_iterator.Ptr()));
+      if (!py_record) {
+        call.py_iterator = py::Object();
+        if (PyErr_Occurred()) return py::FetchError();
+        return std::nullopt;
+      }
+      if (auto maybe_exc = AddRecordFromPython(result, py_record, record_cls)) return maybe_exc;
+    }
+    return std::nullopt;
+  };
+  RunPython(
+      [&](PyWorkerInterpreter * /*interpreter*/) {
+        if (auto maybe_exc = produce_batch()) {
+          // Records are produced by the user's code directly, so there is no
+          // wrapper line to skip in the traceback.
+          const auto msg = py::FormatException(*maybe_exc);
+          static_cast<void>(mgp_result_set_error_msg(result, msg.c_str()));
+        }
+      },
+      call.interpreter);
+}
+
+void CleanupPythonBatchedCall(void *state) {
+  std::unique_ptr<PyBatchedCall> call(static_cast<PyBatchedCall *>(state));
+  auto *interpreter = call->interpreter;
+  RunPython(
+      [&](PyWorkerInterpreter * /*interpreter*/) {
+        if (call->py_iterator && PyGen_Check(call->py_iterator.Ptr())) {
+          // Let the generator run its `finally` blocks if it wasn't exhausted.
+          // Using the graph in them raises `InvalidContextError`, which is
+          // ignored.
+          if (call->py_graph && !call->py_graph.CallMethod("invalidate")) PyErr_Clear();
+          if (!call->py_iterator.CallMethod("close")) PyErr_Clear();
+        }
+        call->py_iterator = py::Object();
+        if (call->py_graph) CollectGarbageAndInvalidateGraph(call->py_graph);
+        call.reset();
+      },
+      interpreter);
+}
+
+void CallPythonTransformation(PyWorkerInterpreter *interpreter, const PyCallback &callback, mgp_messages *msgs,
+                              mgp_graph *graph, mgp_result *result, mgp_memory *memory) {
 
   auto error_to_msg = [](const std::optional<py::ExceptionInfo> &exc_info) -> std::optional<std::string> {
     if (!exc_info) return std::nullopt;
@@ -927,12 +1243,16 @@ void CallPythonTransformation(const py::Object &py_cb, mgp_messages *msgs, mgp_g
   };
 
   auto call = [&](py::Object py_graph, py::Object py_messages) -> std::optional<py::ExceptionInfo> {
+    auto py_cb = GetCallback(interpreter, callback, /* is_transformation = */ true);
+    if (!py_cb) return py::FetchError();
     auto py_res = py_cb.Call(py_graph, py_messages);
     if (!py_res) return py::FetchError();
+    auto record_cls = GetRecordClass();
+    if (!record_cls) return py::FetchError();
     if (PySequence_Check(py_res.Ptr())) {
-      return AddMultipleRecordsFromPython(result, py_res);
+      return AddMultipleRecordsFromPython(result, py_res, record_cls);
     }
-    return AddRecordFromPython(result, py_res);
+    return AddRecordFromPython(result, py_res, record_cls);
   };
 
   auto cleanup = [](py::Object py_graph, py::Object py_messages) {
@@ -994,7 +1314,7 @@ void CallPythonTransformation(const py::Object &py_cb, mgp_messages *msgs, mgp_g
   }
 }
 
-PyObject *PyQueryModuleAddProcedure(PyQueryModule *self, PyObject *cb, bool is_write_procedure) {
+PyObject *PyQueryModuleAddProcedure(PyQueryModule *self, PyObject *cb, bool is_write_procedure, bool is_batched) {
   MG_ASSERT(self->module);
   if (!PyCallable_Check(cb)) {
     PyErr_SetString(PyExc_TypeError, "Expected a callable object.");
@@ -1009,18 +1329,39 @@ PyObject *PyQueryModuleAddProcedure(PyQueryModule *self, PyObject *cb, bool is_w
     return nullptr;
   }
   auto *memory = self->module->procedures.get_allocator().GetMemoryResource();
-  mgp_proc proc(
-      name,
-      [py_cb](mgp_list *args, mgp_graph *graph, mgp_result *result, mgp_memory *memory) {
-        CallPythonProcedure(py_cb, args, graph, result, memory);
-      },
-      memory, is_write_procedure);
-  const auto &[proc_it, did_insert] = self->module->procedures.emplace(name, std::move(proc));
+  PyCallback callback{py_cb, ModuleState().module_source, name};
+  auto make_proc = [&]() {
+    if (is_batched) {
+      return mgp_proc(
+          name,
+          [callback](mgp_list *args, mgp_graph *graph, mgp_memory *memory) {
+            void *state{nullptr};
+            RunPython([&](PyWorkerInterpreter *interpreter) {
+              state = InitializePythonBatchedCall(interpreter, callback, args, graph, memory);
+            });
+            return state;
+          },
+          [](void *state, mgp_graph * /*graph*/, mgp_result *result, mgp_memory * /*memory*/) {
+            CallPythonBatchedProcedure(state, result);
+          },
+          [](void *state) { CleanupPythonBatchedCall(state); }, memory, is_write_procedure);
+    }
+    return mgp_proc(
+        name,
+        [callback](mgp_list *args, mgp_graph *graph, mgp_result *result, mgp_memory *memory) {
+          RunPython([&](PyWorkerInterpreter *interpreter) {
+            CallPythonProcedure(interpreter, callback, args, graph, result, memory);
+          });
+        },
+        memory, is_write_procedure);
+  };
+  const auto &[proc_it, did_insert] = self->module->procedures.emplace(name, make_proc());
   if (!did_insert) {
     PyErr_SetString(PyExc_ValueError, "Already registered a procedure with the same name.");
     return nullptr;
   }
-  auto *py_proc = PyObject_New(PyQueryProc, &PyQueryProcType);
+  if (auto *callbacks = ModuleState().module_callbacks) callbacks->procedures.emplace(name, py_cb);
+  auto *py_proc = PyObject_New(PyQueryProc, ModuleState().proc_type);
   if (!py_proc) return nullptr;
   py_proc->proc = &proc_it->second;
   return reinterpret_cast<PyObject *>(py_proc);
@@ -1028,11 +1369,19 @@ PyObject *PyQueryModuleAddProcedure(PyQueryModule *self, PyObject *cb, bool is_w
 }  // namespace
 
 PyObject *PyQueryModuleAddReadProcedure(PyQueryModule *self, PyObject *cb) {
-  return PyQueryModuleAddProcedure(self, cb, false);
+  return PyQueryModuleAddProcedure(self, cb, false, false);
 }
 
 PyObject *PyQueryModuleAddWriteProcedure(PyQueryModule *self, PyObject *cb) {
-  return PyQueryModuleAddProcedure(self, cb, true);
+  return PyQueryModuleAddProcedure(self, cb, true, false);
+}
+
+PyObject *PyQueryModuleAddBatchReadProcedure(PyQueryModule *self, PyObject *cb) {
+  return PyQueryModuleAddProcedure(self, cb, false, true);
+}
+
+PyObject *PyQueryModuleAddBatchWriteProcedure(PyQueryModule *self, PyObject *cb) {
+  return PyQueryModuleAddProcedure(self, cb, true, true);
 }
 
 PyObject *PyQueryModuleAddTransformation(PyQueryModule *self, PyObject *cb) {
@@ -1052,8 +1401,11 @@ PyObject *PyQueryModuleAddTransformation(PyQueryModule *self, PyObject *cb) {
   auto *memory = self->module->transformations.get_allocator().GetMemoryResource();
   mgp_trans trans(
       name,
-      [py_cb](mgp_messages *msgs, mgp_graph *graph, mgp_result *result, mgp_memory *memory) {
-        CallPythonTransformation(py_cb, msgs, graph, result, memory);
+      [callback = PyCallback{py_cb, ModuleState().module_source, name}](
+          mgp_messages *msgs, mgp_graph *graph, mgp_result *result, mgp_memory *memory) {
+        RunPython([&](PyWorkerInterpreter *interpreter) {
+          CallPythonTransformation(interpreter, callback, msgs, graph, result, memory);
+        });
       },
       memory);
   const auto [trans_it, did_insert] = self->module->transformations.emplace(name, std::move(trans));
@@ -1061,6 +1413,7 @@ PyObject *PyQueryModuleAddTransformation(PyQueryModule *self, PyObject *cb) {
     PyErr_SetString(PyExc_ValueError, "Already registered a procedure with the same name.");
     return nullptr;
   }
+  if (auto *callbacks = ModuleState().module_callbacks) callbacks->transformations.emplace(name, py_cb);
   Py_RETURN_NONE;
 }
 
@@ -1070,6 +1423,12 @@ static PyMethodDef PyQueryModuleMethods[] = {
      "Register a read-only procedure with this module."},
     {"add_write_procedure", reinterpret_cast<PyCFunction>(PyQueryModuleAddWriteProcedure), METH_O,
      "Register a writeable procedure with this module."},
+    {"add_batch_read_procedure", reinterpret_cast<PyCFunction>(PyQueryModuleAddBatchReadProcedure), METH_O,
+     "Register a read-only procedure, which produces its records in batches from the returned iterable, with this "
+     "module."},
+    {"add_batch_write_procedure", reinterpret_cast<PyCFunction>(PyQueryModuleAddBatchWriteProcedure), METH_O,
+     "Register a writeable procedure, which produces its records in batches from the returned iterable, with this "
+     "module."},
     {"add_transformation", reinterpret_cast<PyCFunction>(PyQueryModuleAddTransformation), METH_O,
      "Register a transformation with this module."},
     {nullptr},
@@ -1088,14 +1447,14 @@ static PyTypeObject PyQueryModuleType = {
 
 PyObject *MakePyQueryModule(mgp_module *module) {
   MG_ASSERT(module);
-  auto *py_query_module = PyObject_New(PyQueryModule, &PyQueryModuleType);
+  auto *py_query_module = PyObject_New(PyQueryModule, ModuleState().module_type);
   if (!py_query_module) return nullptr;
   py_query_module->module = module;
   return reinterpret_cast<PyObject *>(py_query_module);
 }
 
 PyObject *PyMgpModuleTypeNullable(PyObject *mod, PyObject *obj) {
-  if (Py_TYPE(obj) != &PyCypherTypeType) {
+  if (Py_TYPE(obj) != ModuleState().cypher_type_type) {
     PyErr_SetString(PyExc_TypeError, "Expected a _mgp.Type.");
     return nullptr;
   }
@@ -1108,7 +1467,7 @@ PyObject *PyMgpModuleTypeNullable(PyObject *mod, PyObject *obj) {
 }
 
 PyObject *PyMgpModuleTypeList(PyObject *mod, PyObject *obj) {
-  if (Py_TYPE(obj) != &PyCypherTypeType) {
+  if (Py_TYPE(obj) != ModuleState().cypher_type_type) {
     PyErr_SetString(PyExc_TypeError, "Expected a _mgp.Type.");
     return nullptr;
   }
@@ -1169,16 +1528,109 @@ static PyMethodDef PyMgpModuleMethods[] = {
     {nullptr},
 };
 
+namespace {
+int ExecMgpModule(PyObject *mgp);
+}  // namespace
+
+// The module is initialized in phases, so that each worker interpreter gets
+// its own instance of it.
+static PyModuleDef_Slot PyMgpModuleSlots[] = {
+    {Py_mod_exec, reinterpret_cast<void *>(ExecMgpModule)},
+#if PY_VERSION_HEX >= 0x030C0000
+    {Py_mod_multiple_interpreters, Py_MOD_PER_INTERPRETER_GIL_SUPPORTED},
+#endif
+    {0, nullptr},
+};
+
 // clang-format off
 static PyModuleDef PyMgpModule = {
     PyModuleDef_HEAD_INIT,
     .m_name = "_mgp",
     .m_doc = "Contains raw bindings to mg_procedure.h C API.",
-    .m_size = -1,
+    .m_size = 0,
     .m_methods = PyMgpModuleMethods,
+    .m_slots = PyMgpModuleSlots,
 };
 // clang-format on
 
+// Converts a property value straight into a Python object, without first
+// copying it into a `mgp_value`.
+py::Object PropertyValueToPyObject(const storage::PropertyValue &value, PyGraph *py_graph) {
+  switch (value.type()) {
+    case storage::PropertyValue::Type::Null:
+      Py_INCREF(Py_None);
+      return py::Object(Py_None);
+    case storage::PropertyValue::Type::Bool:
+      return py::Object(PyBool_FromLong(value.ValueBool()));
+    case storage::PropertyValue::Type::Int:
+      return py::Object(PyLong_FromLongLong(value.ValueInt()));
+    case storage::PropertyValue::Type::Double:
+      return py::Object(PyFloat_FromDouble(value.ValueDouble()));
+    case storage::PropertyValue::Type::String: {
+      const auto &string = value.ValueString();
+      return py::Object(PyUnicode_FromStringAndSize(string.data(), static_cast<Py_ssize_t>(string.size())));
+    }
+    case storage::PropertyValue::Type::List: {
+      const auto &list = value.ValueList();
+      py::Object py_tuple(PyTuple_New(static_cast<Py_ssize_t>(list.size())));
+      if (!py_tuple) return nullptr;
+      for (size_t i = 0; i < list.size(); ++i) {
+        auto elem = PropertyValueToPyObject(list[i], py_graph);
+        if (!elem) return nullptr;
+        PyTuple_SET_ITEM(py_tuple.Ptr(), i, elem.Steal());
+      }
+      return py_tuple;
+    }
+    case storage::PropertyValue::Type::Map: {
+      py::Object py_dict(PyDict_New());
+      if (!py_dict) return nullptr;
+      for (const auto &[key, val] : value.ValueMap()) {
+        auto py_val = PropertyValueToPyObject(val, py_graph);
+        if (!py_val) return nullptr;
+        if (PyDict_SetItemString(py_dict.Ptr(), key.c_str(), py_val.Ptr()) != 0) return nullptr;
+      }
+      return py_dict;
+    }
+    case storage::PropertyValue::Type::TemporalData: {
+      // Temporal values are small, so the conversion through `mgp_value` is
+      // kept in a single place.
+      mgp_value mgp_temporal(value, utils::NewDeleteResource());
+      return MgpValueToPyObject(mgp_temporal, py_graph);
+    }
+  }
+}
+
+// Reads all properties of a vertex or an edge in a single pass over its
+// property store and converts them into a dict of property names to values.
+template <class TAccessor>
+PyObject *MakePyProperties(const TAccessor &accessor, PyGraph *py_graph, const char *deleted_object_msg) {
+  auto maybe_props = accessor.Properties(py_graph->graph->view);
+  if (maybe_props.HasError()) {
+    switch (maybe_props.GetError()) {
+      case storage::Error::DELETED_OBJECT:
+        PyErr_SetString(ModuleState().deleted_object_error, deleted_object_msg);
+        return nullptr;
+      case storage::Error::NONEXISTENT_OBJECT:
+        LOG_FATAL("Query modules shouldn't have access to nonexistent objects when getting properties.");
+      case storage::Error::PROPERTIES_DISABLED:
+      case storage::Error::VERTEX_HAS_EDGES:
+      case storage::Error::SERIALIZATION_ERROR:
+        LOG_FATAL("Unexpected error when getting properties.");
+    }
+  }
+  py::Object py_dict(PyDict_New());
+  if (!py_dict) return nullptr;
+  for (const auto &[property_id, value] : *maybe_props) {
+    const auto &name = py_graph->graph->impl->PropertyToName(property_id);
+    py::Object py_name(PyUnicode_FromStringAndSize(name.data(), static_cast<Py_ssize_t>(name.size())));
+    if (!py_name) return nullptr;
+    auto py_value = PropertyValueToPyObject(value, py_graph);
+    if (!py_value) return nullptr;
+    if (PyDict_SetItem(py_dict.Ptr(), py_name.Ptr(), py_value.Ptr()) != 0) return nullptr;
+  }
+  return py_dict.Steal();
+}
+
 // clang-format off
 struct PyPropertiesIterator {
   PyObject_HEAD
@@ -1195,7 +1647,7 @@ void PyPropertiesIteratorDealloc(PyPropertiesIterator *self) {
   // execution, so we may cause a double free issue.
   if (self->py_graph->graph) mgp_properties_iterator_destroy(self->it);
   Py_DECREF(self->py_graph);
-  Py_TYPE(self)->tp_free(self);
+  FreePyMgpObject(self);
 }
 
 PyObject *PyPropertiesIteratorGet(PyPropertiesIterator *self, PyObject *Py_UNUSED(ignored)) {
@@ -1298,7 +1750,7 @@ void PyEdgeDealloc(PyEdge *self) {
   // cause a double free issue.
   if (self->py_graph->graph) mgp_edge_destroy(self->edge);
   Py_DECREF(self->py_graph);
-  Py_TYPE(self)->tp_free(self);
+  FreePyMgpObject(self);
 }
 
 PyObject *PyEdgeIsValid(PyEdge *self, PyObject *Py_UNUSED(ignored)) {
@@ -1334,7 +1786,7 @@ PyObject *PyEdgeIterProperties(PyEdge *self, PyObject *Py_UNUSED(ignored)) {
   if (RaiseExceptionFromErrorCode(mgp_edge_iter_properties(self->edge, self->py_graph->memory, &properties_it))) {
     return nullptr;
   }
-  auto *py_properties_it = PyObject_New(PyPropertiesIterator, &PyPropertiesIteratorType);
+  auto *py_properties_it = PyObject_New(PyPropertiesIterator, ModuleState().properties_iterator_type);
   if (!py_properties_it) {
     mgp_properties_iterator_destroy(properties_it);
     return nullptr;
@@ -1345,6 +1797,14 @@ PyObject *PyEdgeIterProperties(PyEdge *self, PyObject *Py_UNUSED(ignored)) {
   return reinterpret_cast<PyObject *>(py_properties_it);
 }
 
+PyObject *PyEdgeGetProperties(PyEdge *self, PyObject *Py_UNUSED(ignored)) {
+  MG_ASSERT(self);
+  MG_ASSERT(self->edge);
+  MG_ASSERT(self->py_graph);
+  MG_ASSERT(self->py_graph->graph);
+  return MakePyProperties(self->edge->impl, self->py_graph, "Cannot get the properties of a deleted edge!");
+}
+
 PyObject *PyEdgeGetProperty(PyEdge *self, PyObject *args) {
   MG_ASSERT(self);
   MG_ASSERT(self->edge);
@@ -1393,6 +1853,8 @@ static PyMethodDef PyEdgeMethods[] = {
     {"to_vertex", reinterpret_cast<PyCFunction>(PyEdgeToVertex), METH_NOARGS, "Return the edge's destination vertex."},
     {"iter_properties", reinterpret_cast<PyCFunction>(PyEdgeIterProperties), METH_NOARGS,
      "Return _mgp.PropertiesIterator for this edge."},
+    {"get_properties", reinterpret_cast<PyCFunction>(PyEdgeGetProperties), METH_NOARGS,
+     "Return a dict with all properties of this edge."},
     {"get_property", reinterpret_cast<PyCFunction>(PyEdgeGetProperty), METH_VARARGS,
      "Return edge property with given name."},
     {"set_property", reinterpret_cast<PyCFunction>(PyEdgeSetProperty), METH_VARARGS,
@@ -1419,7 +1881,7 @@ PyObject *MakePyEdgeWithoutCopy(mgp_edge &edge, PyGraph *py_graph) {
   MG_ASSERT(py_graph);
   MG_ASSERT(py_graph->graph && py_graph->memory);
   MG_ASSERT(edge.GetMemoryResource() == py_graph->memory->impl);
-  auto *py_edge = PyObject_New(PyEdge, &PyEdgeType);  // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+  auto *py_edge = PyObject_New(PyEdge, ModuleState().edge_type);  // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
   if (!py_edge) return nullptr;
   py_edge->edge = &edge;
   py_edge->py_graph = py_graph;
@@ -1449,7 +1911,7 @@ PyObject *PyEdgeRichCompare(PyObject *self, PyObject *other, int op) {
   MG_ASSERT(self);
   MG_ASSERT(other);
 
-  if (Py_TYPE(self) != &PyEdgeType || Py_TYPE(other) != &PyEdgeType || op != Py_EQ) {
+  if (Py_TYPE(self) != ModuleState().edge_type || Py_TYPE(other) != ModuleState().edge_type || op != Py_EQ) {
     Py_RETURN_NOTIMPLEMENTED;
   }
 
@@ -1476,7 +1938,7 @@ void PyVertexDealloc(PyVertex *self) {
   // execution, so  we may cause a double free issue.
   if (self->py_graph->graph) mgp_vertex_destroy(self->vertex);
   Py_DECREF(self->py_graph);
-  Py_TYPE(self)->tp_free(self);
+  FreePyMgpObject(self);
 }
 
 PyObject *PyVertexIsValid(PyVertex *self, PyObject *Py_UNUSED(ignored)) {
@@ -1541,7 +2003,7 @@ PyObject *PyVertexIterInEdges(PyVertex *self, PyObject *Py_UNUSED(ignored)) {
   if (RaiseExceptionFromErrorCode(mgp_vertex_iter_in_edges(self->vertex, self->py_graph->memory, &edges_it))) {
     return nullptr;
   }
-  auto *py_edges_it = PyObject_New(PyEdgesIterator, &PyEdgesIteratorType);
+  auto *py_edges_it = PyObject_New(PyEdgesIterator, ModuleState().edges_iterator_type);
   if (!py_edges_it) {
     mgp_edges_iterator_destroy(edges_it);
     return nullptr;
@@ -1561,7 +2023,7 @@ PyObject *PyVertexIterOutEdges(PyVertex *self, PyObject *Py_UNUSED(ignored)) {
   if (RaiseExceptionFromErrorCode(mgp_vertex_iter_out_edges(self->vertex, self->py_graph->memory, &edges_it))) {
     return nullptr;
   }
-  auto *py_edges_it = PyObject_New(PyEdgesIterator, &PyEdgesIteratorType);
+  auto *py_edges_it = PyObject_New(PyEdgesIterator, ModuleState().edges_iterator_type);
   if (!py_edges_it) {
     mgp_edges_iterator_destroy(edges_it);
     return nullptr;
@@ -1581,7 +2043,7 @@ PyObject *PyVertexIterProperties(PyVertex *self, PyObject *Py_UNUSED(ignored)) {
   if (RaiseExceptionFromErrorCode(mgp_vertex_iter_properties(self->vertex, self->py_graph->memory, &properties_it))) {
     return nullptr;
   }
-  auto *py_properties_it = PyObject_New(PyPropertiesIterator, &PyPropertiesIteratorType);
+  auto *py_properties_it = PyObject_New(PyPropertiesIterator, ModuleState().properties_iterator_type);
   if (!py_properties_it) {
     mgp_properties_iterator_destroy(properties_it);
     return nullptr;
@@ -1592,6 +2054,14 @@ PyObject *PyVertexIterProperties(PyVertex *self, PyObject *Py_UNUSED(ignored)) {
   return reinterpret_cast<PyObject *>(py_properties_it);
 }
 
+PyObject *PyVertexGetProperties(PyVertex *self, PyObject *Py_UNUSED(ignored)) {
+  MG_ASSERT(self);
+  MG_ASSERT(self->vertex);
+  MG_ASSERT(self->py_graph);
+  MG_ASSERT(self->py_graph->graph);
+  return MakePyProperties(self->vertex->impl, self->py_graph, "Cannot get the properties of a deleted vertex!");
+}
+
 PyObject *PyVertexGetProperty(PyVertex *self, PyObject *args) {
   MG_ASSERT(self);
   MG_ASSERT(self->vertex);
@@ -1681,6 +2151,8 @@ static PyMethodDef PyVertexMethods[] = {
      "Return _mgp.EdgesIterator for out edges."},
     {"iter_properties", reinterpret_cast<PyCFunction>(PyVertexIterProperties), METH_NOARGS,
      "Return _mgp.PropertiesIterator for this vertex."},
+    {"get_properties", reinterpret_cast<PyCFunction>(PyVertexGetProperties), METH_NOARGS,
+     "Return a dict with all properties of this vertex."},
     {"get_property", reinterpret_cast<PyCFunction>(PyVertexGetProperty), METH_VARARGS,
      "Return vertex property with given name."},
     {"set_property", reinterpret_cast<PyCFunction>(PyVertexSetProperty), METH_VARARGS,
@@ -1707,7 +2179,7 @@ PyObject *MakePyVertexWithoutCopy(mgp_vertex &vertex, PyGraph *py_graph) {
   MG_ASSERT(py_graph);
   MG_ASSERT(py_graph->graph && py_graph->memory);
   MG_ASSERT(vertex.GetMemoryResource() == py_graph->memory->impl);
-  auto *py_vertex = PyObject_New(PyVertex, &PyVertexType);
+  auto *py_vertex = PyObject_New(PyVertex, ModuleState().vertex_type);
   if (!py_vertex) return nullptr;
   py_vertex->vertex = &vertex;
   py_vertex->py_graph = py_graph;
@@ -1734,7 +2206,7 @@ PyObject *PyVertexRichCompare(PyObject *self, PyObject *other, int op) {
   MG_ASSERT(self);
   MG_ASSERT(other);
 
-  if (Py_TYPE(self) != &PyVertexType || Py_TYPE(other) != &PyVertexType || op != Py_EQ) {
+  if (Py_TYPE(self) != ModuleState().vertex_type || Py_TYPE(other) != ModuleState().vertex_type || op != Py_EQ) {
     Py_RETURN_NOTIMPLEMENTED;
   }
 
@@ -1762,7 +2234,7 @@ void PyPathDealloc(PyPath *self) {
   // execution, so  we may cause a double free issue.
   if (self->py_graph->graph) mgp_path_destroy(self->path);
   Py_DECREF(self->py_graph);
-  Py_TYPE(self)->tp_free(self);
+  FreePyMgpObject(self);
 }
 
 PyObject *PyPathIsValid(PyPath *self, PyObject *Py_UNUSED(ignored)) {
@@ -1775,7 +2247,7 @@ PyObject *PyPathExpand(PyPath *self, PyObject *edge) {
   MG_ASSERT(self->path);
   MG_ASSERT(self->py_graph);
   MG_ASSERT(self->py_graph->graph);
-  if (Py_TYPE(edge) != &PyEdgeType) {
+  if (Py_TYPE(edge) != ModuleState().edge_type) {
     PyErr_SetString(PyExc_TypeError, "Expected a _mgp.Edge.");
     return nullptr;
   }
@@ -1858,7 +2330,7 @@ PyObject *MakePyPath(mgp_path *path, PyGraph *py_graph) {
   MG_ASSERT(path);
   MG_ASSERT(py_graph->graph && py_graph->memory);
   MG_ASSERT(path->GetMemoryResource() == py_graph->memory->impl);
-  auto *py_path = PyObject_New(PyPath, &PyPathType);
+  auto *py_path = PyObject_New(PyPath, ModuleState().path_type);
   if (!py_path) return nullptr;
   py_path->path = path;
   py_path->py_graph = py_graph;
@@ -1880,11 +2352,11 @@ PyObject *MakePyPath(mgp_path &path, PyGraph *py_graph) {
 }
 
 PyObject *PyPathMakeWithStart(PyTypeObject *type, PyObject *vertex) {
-  if (type != &PyPathType) {
+  if (type != ModuleState().path_type) {
     PyErr_SetString(PyExc_TypeError, "Expected '<class _mgp.Path>' as the first argument.");
     return nullptr;
   }
-  if (Py_TYPE(vertex) != &PyVertexType) {
+  if (Py_TYPE(vertex) != ModuleState().vertex_type) {
     PyErr_SetString(PyExc_TypeError, "Expected a '_mgp.Vertex' as the second argument.");
     return nullptr;
   }
@@ -1905,60 +2377,94 @@ struct PyMgpError {
   const char *docstring;
 };
 
-PyObject *PyInitMgpModule() {
-  PyObject *mgp = PyModule_Create(&PyMgpModule);
-  if (!mgp) return nullptr;
-  auto register_type = [mgp](auto *type, const auto *name) -> bool {
-    if (PyType_Ready(type) < 0) {
-      Py_DECREF(mgp);
-      return false;
+namespace {
+
+#if PY_VERSION_HEX >= 0x030C0000
+void PyMgpObjectDealloc(PyObject *self) { FreePyMgpObject(self); }
+
+// Makes a heap type of a worker interpreter from one of the static types.
+PyTypeObject *MakeHeapType(PyObject *mgp, const PyTypeObject &type) {
+  std::vector<PyType_Slot> slots;
+  auto add_slot = [&slots](int slot, auto *value) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    if (value) slots.push_back({slot, const_cast<void *>(reinterpret_cast<const void *>(value))});
+  };
+  add_slot(Py_tp_dealloc, type.tp_dealloc ? type.tp_dealloc : PyMgpObjectDealloc);
+  add_slot(Py_tp_doc, type.tp_doc);
+  add_slot(Py_tp_methods, type.tp_methods);
+  add_slot(Py_tp_richcompare, type.tp_richcompare);
+  slots.push_back({0, nullptr});
+  PyType_Spec spec{
+      .name = type.tp_name,
+      .basicsize = static_cast<int>(type.tp_basicsize),
+      .itemsize = 0,
+      .flags = static_cast<unsigned int>(type.tp_flags | Py_TPFLAGS_DISALLOW_INSTANTIATION),
+      .slots = slots.data(),
+  };
+  return reinterpret_cast<PyTypeObject *>(PyType_FromModuleAndSpec(mgp, &spec, nullptr));
+}
+#endif
+
+int ExecMgpModule(PyObject *mgp) {
+  auto &state = ModuleState();
+  const bool is_main = &state == &gMainModuleState;
+  auto register_type = [mgp, is_main](PyTypeObject *&state_type, PyTypeObject *type, const auto *name) -> bool {
+    if (is_main) {
+      if (PyType_Ready(type) < 0) return false;
+      Py_INCREF(type);
+    } else {
+#if PY_VERSION_HEX >= 0x030C0000
+      type = MakeHeapType(mgp, *type);
+      if (!type) return false;
+#else
+      LOG_FATAL("Python worker interpreters require Python 3.12 or newer.");
+#endif
     }
-    Py_INCREF(type);
     if (PyModule_AddObject(mgp, name, reinterpret_cast<PyObject *>(type)) < 0) {
       Py_DECREF(type);
-      Py_DECREF(mgp);
       return false;
     }
+    // The module keeps the type alive for as long as the interpreter exists.
+    state_type = type;
     return true;
   };
-  if (!register_type(&PyPropertiesIteratorType, "PropertiesIterator")) return nullptr;
-  if (!register_type(&PyVerticesIteratorType, "VerticesIterator")) return nullptr;
-  if (!register_type(&PyEdgesIteratorType, "EdgesIterator")) return nullptr;
-  if (!register_type(&PyGraphType, "Graph")) return nullptr;
-  if (!register_type(&PyEdgeType, "Edge")) return nullptr;
-  if (!register_type(&PyQueryProcType, "Proc")) return nullptr;
-  if (!register_type(&PyQueryModuleType, "Module")) return nullptr;
-  if (!register_type(&PyVertexType, "Vertex")) return nullptr;
-  if (!register_type(&PyPathType, "Path")) return nullptr;
-  if (!register_type(&PyCypherTypeType, "Type")) return nullptr;
-  if (!register_type(&PyMessagesType, "Messages")) return nullptr;
-  if (!register_type(&PyMessageType, "Message")) return nullptr;
+  if (!register_type(state.properties_iterator_type, &PyPropertiesIteratorType, "PropertiesIterator")) return -1;
+  if (!register_type(state.vertices_iterator_type, &PyVerticesIteratorType, "VerticesIterator")) return -1;
+  if (!register_type(state.edges_iterator_type, &PyEdgesIteratorType, "EdgesIterator")) return -1;
+  if (!register_type(state.graph_type, &PyGraphType, "Graph")) return -1;
+  if (!register_type(state.edge_type, &PyEdgeType, "Edge")) return -1;
+  if (!register_type(state.proc_type, &PyQueryProcType, "Proc")) return -1;
+  if (!register_type(state.module_type, &PyQueryModuleType, "Module")) return -1;
+  if (!register_type(state.vertex_type, &PyVertexType, "Vertex")) return -1;
+  if (!register_type(state.path_type, &PyPathType, "Path")) return -1;
+  if (!register_type(state.cypher_type_type, &PyCypherTypeType, "Type")) return -1;
+  if (!register_type(state.messages_type, &PyMessagesType, "Messages")) return -1;
+  if (!register_type(state.message_type, &PyMessageType, "Message")) return -1;
 
   std::array py_mgp_errors{
-      PyMgpError{"_mgp.UnknownError", gMgpUnknownError, PyExc_RuntimeError, nullptr},
-      PyMgpError{"_mgp.UnableToAllocateError", gMgpUnableToAllocateError, PyExc_MemoryError, nullptr},
-      PyMgpError{"_mgp.InsufficientBufferError", gMgpInsufficientBufferError, PyExc_BufferError, nullptr},
-      PyMgpError{"_mgp.OutOfRangeError", gMgpOutOfRangeError, PyExc_BufferError, nullptr},
-      PyMgpError{"_mgp.LogicErrorError", gMgpLogicErrorError, PyExc_RuntimeError, nullptr},
-      PyMgpError{"_mgp.DeletedObjectError", gMgpDeletedObjectError, PyExc_RuntimeError, nullptr},
-      PyMgpError{"_mgp.InvalidArgumentError", gMgpInvalidArgumentError, PyExc_ValueError, nullptr},
-      PyMgpError{"_mgp.KeyAlreadyExistsError", gMgpKeyAlreadyExistsError, PyExc_RuntimeError, nullptr},
-      PyMgpError{"_mgp.ImmutableObjectError", gMgpImmutableObjectError, PyExc_RuntimeError, nullptr},
-      PyMgpError{"_mgp.ValueConversionError", gMgpValueConversionError, PyExc_RuntimeError, nullptr},
-      PyMgpError{"_mgp.SerializationError", gMgpSerializationError, PyExc_RuntimeError, nullptr},
+      PyMgpError{"_mgp.UnknownError", state.unknown_error, PyExc_RuntimeError, nullptr},
+      PyMgpError{"_mgp.UnableToAllocateError", state.unable_to_allocate_error, PyExc_MemoryError, nullptr},
+      PyMgpError{"_mgp.InsufficientBufferError", state.insufficient_buffer_error, PyExc_BufferError, nullptr},
+      PyMgpError{"_mgp.OutOfRangeError", state.out_of_range_error, PyExc_BufferError, nullptr},
+      PyMgpError{"_mgp.LogicErrorError", state.logic_error_error, PyExc_RuntimeError, nullptr},
+      PyMgpError{"_mgp.DeletedObjectError", state.deleted_object_error, PyExc_RuntimeError, nullptr},
+      PyMgpError{"_mgp.InvalidArgumentError", state.invalid_argument_error, PyExc_ValueError, nullptr},
+      PyMgpError{"_mgp.KeyAlreadyExistsError", state.key_already_exists_error, PyExc_RuntimeError, nullptr},
+      PyMgpError{"_mgp.ImmutableObjectError", state.immutable_object_error, PyExc_RuntimeError, nullptr},
+      PyMgpError{"_mgp.ValueConversionError", state.value_conversion_error, PyExc_RuntimeError, nullptr},
+      PyMgpError{"_mgp.SerializationError", state.serialization_error, PyExc_RuntimeError, nullptr},
   };
   Py_INCREF(Py_None);
 
-  utils::OnScopeExit clean_up{[mgp, &py_mgp_errors] {
+  utils::OnScopeExit clean_up{[&py_mgp_errors] {
     for (const auto &py_mgp_error : py_mgp_errors) {
       Py_XDECREF(py_mgp_error.exception);
     }
     Py_DECREF(Py_None);
-    Py_DECREF(mgp);
   }};
 
   if (PyModule_AddObject(mgp, "_MODULE", Py_None) < 0) {
-    return nullptr;
+    return -1;
   }
 
   auto register_custom_error = [mgp](PyMgpError &py_mgp_error) {
@@ -1973,17 +2479,26 @@ PyObject *PyInitMgpModule() {
 
   for (auto &py_mgp_error : py_mgp_errors) {
     if (!register_custom_error(py_mgp_error)) {
-      return nullptr;
+      return -1;
     }
   }
   clean_up.Disable();
 
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
-  PyDateTime_IMPORT;
+  // The datetime C API is a single global, which has to belong to the main
+  // interpreter.
+  if (is_main) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast)
+    PyDateTime_IMPORT;
+    state.has_datetime_api = PyDateTimeAPI != nullptr;
+  }
 
-  return mgp;
+  return 0;
 }
 
+}  // namespace
+
+PyObject *PyInitMgpModule() { return PyModuleDef_Init(&PyMgpModule); }
+
 namespace {
 
 template <class TFun>
@@ -2010,18 +2525,226 @@ auto WithMgpModule(mgp_module *module_def, const TFun &fun) {
   return ret;
 }
 
+// Remembers how the main interpreter imports the module `name`, so that the
+// callbacks registered by `fun` can be found in the worker interpreters.
+template <class TFun>
+auto WithModuleSource(const char *name, const TFun &fun) {
+  auto source = std::make_shared<PyModuleSource>();
+  source->name = name;
+  auto *sys_path = PySys_GetObject("path");
+  if (sys_path && PyList_Check(sys_path)) {
+    for (Py_ssize_t i = 0; i < PyList_GET_SIZE(sys_path); ++i) {
+      const auto *path = PyUnicode_AsUTF8(PyList_GET_ITEM(sys_path, i));
+      if (!path) {
+        PyErr_Clear();
+        continue;
+      }
+      source->sys_path.emplace_back(path);
+    }
+  }
+  auto &state = ModuleState();
+  state.module_source = std::move(source);
+  utils::OnScopeExit reset_source{[&state] { state.module_source = nullptr; }};
+  return fun();
+}
+
 }  // namespace
 
 py::Object ImportPyModule(const char *name, mgp_module *module_def) {
-  return WithMgpModule(module_def, [name]() { return py::Object(PyImport_ImportModule(name)); });
+  return WithModuleSource(name, [&]() {
+    return WithMgpModule(module_def, [name]() { return py::Object(PyImport_ImportModule(name)); });
+  });
 }
 
 py::Object ReloadPyModule(PyObject *py_module, mgp_module *module_def) {
-  return WithMgpModule(module_def, [py_module]() { return py::Object(PyImport_ReloadModule(py_module)); });
+  const auto *name = PyModule_GetName(py_module);
+  if (!name) return nullptr;
+  return WithModuleSource(name, [&]() {
+    return WithMgpModule(module_def, [py_module]() { return py::Object(PyImport_ReloadModule(py_module)); });
+  });
+}
+
+namespace {
+
+bool PyWorkerInterpreter::Import(const std::shared_ptr<const PyModuleSource> &source) {
+  // The module is found the same way as by the main interpreter.
+  py::Object sys_path(PyList_New(0));
+  if (!sys_path) return false;
+  for (const auto &path : source->sys_path) {
+    py::Object py_path(PyUnicode_FromString(path.c_str()));
+    if (!py_path || PyList_Append(sys_path.Ptr(), py_path.Ptr()) != 0) return false;
+  }
+  if (PySys_SetObject("path", sys_path.Ptr()) != 0) return false;
+  // The module was reloaded by the main interpreter, so it's imported anew.
+  auto *sys_modules = PyImport_GetModuleDict();
+  if (PyDict_GetItemString(sys_modules, source->name.c_str()) &&
+      PyDict_DelItemString(sys_modules, source->name.c_str()) != 0) {
+    return false;
+  }
+  modules_.erase(source->name);
+
+  LoadedModule module{.source = source, .module_def = std::make_unique<mgp_module>(utils::NewDeleteResource())};
+  state_.module_callbacks = &module.callbacks;
+  module.py_module = WithMgpModule(module.module_def.get(),
+                                   [&source]() { return py::Object(PyImport_ImportModule(source->name.c_str())); });
+  state_.module_callbacks = nullptr;
+  if (!module.py_module) return false;
+  modules_.emplace(source->name, std::move(module));
+  return true;
+}
+
+py::Object PyWorkerInterpreter::Resolve(const PyCallback &callback, bool is_transformation) {
+  if (!callback.source) {
+    PyErr_SetString(PyExc_RuntimeError, "The callback wasn't registered by a Python query module.");
+    return nullptr;
+  }
+  auto found = modules_.find(callback.source->name);
+  if (found == modules_.end() || found->second.source != callback.source) {
+    if (!Import(callback.source)) return nullptr;
+    found = modules_.find(callback.source->name);
+  }
+  const auto &callbacks =
+      is_transformation ? found->second.callbacks.transformations : found->second.callbacks.procedures;
+  auto callback_it = callbacks.find(callback.name);
+  if (callback_it == callbacks.end()) {
+    PyErr_Format(PyExc_RuntimeError, "Module '%s' didn't register '%s' in a Python worker interpreter.",
+                 callback.source->name.c_str(), callback.name.c_str());
+    return nullptr;
+  }
+  return callback_it->second;
 }
 
+bool PyWorkerInterpreters::Start(size_t count) {
+#if PY_VERSION_HEX >= 0x030C0000
+  MG_ASSERT(!Started(), "Python worker interpreters were already started");
+  {
+    // The main interpreter imports `_mgp` first, so it owns the static types
+    // and the datetime C API.
+    auto gil = py::EnsureGIL();
+    py::Object py_mgp(PyImport_ImportModule("_mgp"));
+    if (!py_mgp) {
+      spdlog::error("Unable to start Python worker interpreters: {}", py::FormatException(*py::FetchError()));
+      return false;
+    }
+  }
+  for (size_t i = 0; i < count; ++i) {
+    auto &interpreter = interpreters_.emplace_back(std::make_unique<PyWorkerInterpreter>());
+    std::promise<bool> started;
+    auto future = started.get_future();
+    threads_.emplace_back([this, interpreter = interpreter.get(), &started] { Work(interpreter, &started); });
+    if (!future.get()) {
+      Stop();
+      return false;
+    }
+  }
+  spdlog::info("Started {} Python worker interpreters", count);
+  return true;
+#else
+  spdlog::error("Python worker interpreters require Python 3.12 or newer, {} is used.", PY_VERSION);
+  return false;
+#endif
+}
+
+void PyWorkerInterpreters::Stop() {
+  {
+    std::lock_guard guard(mutex_);
+    stop_ = true;
+  }
+  task_cv_.notify_all();
+  for (auto &thread : threads_) {
+    if (thread.joinable()) thread.join();
+  }
+  threads_.clear();
+  interpreters_.clear();
+  stop_ = false;
+}
+
+void PyWorkerInterpreters::Run(PyWorkerInterpreter *interpreter,
+                               const std::function<void(PyWorkerInterpreter *)> &fun) {
+  Task task{.fun = &fun, .interpreter = interpreter};
+  std::unique_lock guard(mutex_);
+  tasks_.push_back(&task);
+  // Waking all is needed when the task is meant for a single interpreter.
+  task_cv_.notify_all();
+  done_cv_.wait(guard, [&task] { return task.done; });
+  guard.unlock();
+  if (task.exception) std::rethrow_exception(task.exception);
+}
+
+void PyWorkerInterpreters::Work(PyWorkerInterpreter *interpreter, std::promise<bool> *started) {
+#if PY_VERSION_HEX >= 0x030C0000
+  utils::ThreadSetName("PyWorker");
+  tWorkerModuleState = &interpreter->State();
+  // The worker interpreter is made by a thread state of the main interpreter
+  // and it takes over this thread afterwards.
+  auto *main_thread_state = PyThreadState_New(PyInterpreterState_Main());
+  PyEval_RestoreThread(main_thread_state);
+  PyInterpreterConfig config{
+      .use_main_obmalloc = 0,
+      .allow_fork = 0,
+      .allow_exec = 0,
+      .allow_threads = 1,
+      .allow_daemon_threads = 0,
+      .check_multi_interp_extensions = 1,
+      .gil = PyInterpreterConfig_OWN_GIL,
+  };
+  PyThreadState *thread_state{nullptr};
+  const auto status = Py_NewInterpreterFromConfig(&thread_state, &config);
+  if (PyStatus_Exception(status)) {
+    spdlog::error("Unable to start a Python worker interpreter: {}", status.err_msg ? status.err_msg : "unknown error");
+    PyThreadState_Clear(main_thread_state);
+    PyThreadState_DeleteCurrent();
+    started->set_value(false);
+    return;
+  }
+  started->set_value(true);
+
+  auto *idle_thread_state = PyEval_SaveThread();
+  std::unique_lock guard(mutex_);
+  while (true) {
+    auto next_task = tasks_.end();
+    task_cv_.wait(guard, [&] {
+      next_task = std::find_if(tasks_.begin(), tasks_.end(), [interpreter](const auto *task) {
+        return !task->interpreter || task->interpreter == interpreter;
+      });
+      return stop_ || next_task != tasks_.end();
+    });
+    if (next_task == tasks_.end()) break;
+    auto *task = *next_task;
+    tasks_.erase(next_task);
+    guard.unlock();
+    PyEval_RestoreThread(idle_thread_state);
+    try {
+      (*task->fun)(interpreter);
+    } catch (...) {
+      task->exception = std::current_exception();
+    }
+    idle_thread_state = PyEval_SaveThread();
+    guard.lock();
+    task->done = true;
+    done_cv_.notify_all();
+  }
+  guard.unlock();
+
+  PyEval_RestoreThread(idle_thread_state);
+  interpreter->Clear();
+  Py_EndInterpreter(thread_state);
+  PyEval_RestoreThread(main_thread_state);
+  PyThreadState_Clear(main_thread_state);
+  PyThreadState_DeleteCurrent();
+#else
+  started->set_value(false);
+#endif
+}
+
+}  // namespace
+
+bool StartPyWorkerInterpreters(size_t count) { return gPyWorkerInterpreters.Start(count); }
+
+void StopPyWorkerInterpreters() { gPyWorkerInterpreters.Stop(); }
+
 py::Object MgpValueToPyObject(const mgp_value &value, PyObject *py_graph) {
-  if (Py_TYPE(py_graph) != &PyGraphType) {
+  if (Py_TYPE(py_graph) != ModuleState().graph_type) {
     PyErr_SetString(PyExc_TypeError, "Expected a _mgp.Graph.");
     return nullptr;
   }
@@ -2081,17 +2804,20 @@ py::Object MgpValueToPyObject(const mgp_value &value, PyGraph *py_graph) {
       return py_mgp.CallMethod("Path", py_path);
     }
     case MGP_VALUE_TYPE_DATE: {
+      if (!EnsureDateTimeApi()) return nullptr;
       const auto &date = value.date_v->date;
       py::Object py_date(PyDate_FromDate(date.year, date.month, date.day));
       return py_date;
     }
     case MGP_VALUE_TYPE_LOCAL_TIME: {
+      if (!EnsureDateTimeApi()) return nullptr;
       const auto &local_time = value.local_time_v->local_time;
       py::Object py_local_time(PyTime_FromTime(local_time.hour, local_time.minute, local_time.second,
                                                local_time.millisecond * 1000 + local_time.microsecond));
       return py_local_time;
     }
     case MGP_VALUE_TYPE_LOCAL_DATE_TIME: {
+      if (!EnsureDateTimeApi()) return nullptr;
       const auto &local_time = value.local_date_time_v->local_date_time.local_time;
       const auto &date = value.local_date_time_v->local_date_time.date;
       py::Object py_local_date_time(PyDateTime_FromDateAndTime(date.year, date.month, date.day, local_time.hour,
@@ -2100,6 +2826,7 @@ py::Object MgpValueToPyObject(const mgp_value &value, PyGraph *py_graph) {
       return py_local_date_time;
     }
     case MGP_VALUE_TYPE_DURATION: {
+      if (!EnsureDateTimeApi()) return nullptr;
       const auto &duration = value.duration_v->duration;
       py::Object py_duration(PyDelta_FromDSU(0, 0, duration.microseconds));
       return py_duration;
@@ -2227,7 +2954,7 @@ mgp_value *PyObjectToMgpValue(PyObject *o, mgp_memory *memory) {
       throw std::runtime_error{"Unexpected error during creating mgp_value"};
     }
     static_cast<void>(map.release());
-  } else if (Py_TYPE(o) == &PyEdgeType) {
+  } else if (Py_TYPE(o) == ModuleState().edge_type) {
     MgpUniquePtr<mgp_edge> e{nullptr, mgp_edge_destroy};
     // Copy the edge and pass the ownership to the created mgp_value.
 
@@ -2243,7 +2970,7 @@ mgp_value *PyObjectToMgpValue(PyObject *o, mgp_memory *memory) {
       throw std::runtime_error{"Unexpected error during copying mgp_edge"};
     }
     static_cast<void>(e.release());
-  } else if (Py_TYPE(o) == &PyPathType) {
+  } else if (Py_TYPE(o) == ModuleState().path_type) {
     MgpUniquePtr<mgp_path> p{nullptr, mgp_path_destroy};
     // Copy the edge and pass the ownership to the created mgp_value.
 
@@ -2259,7 +2986,7 @@ mgp_value *PyObjectToMgpValue(PyObject *o, mgp_memory *memory) {
       throw std::runtime_error{"Unexpected error during copying mgp_path"};
     }
     static_cast<void>(p.release());
-  } else if (Py_TYPE(o) == &PyVertexType) {
+  } else if (Py_TYPE(o) == ModuleState().vertex_type) {
     MgpUniquePtr<mgp_vertex> v{nullptr, mgp_vertex_destroy};
     // Copy the edge and pass the ownership to the created mgp_value.
 
@@ -2418,7 +3145,7 @@ PyObject *PyGraphCreateEdge(PyGraph *self, PyObject *args) {
   PyVertex *from{nullptr};
   PyVertex *to{nullptr};
   const char *edge_type{nullptr};
-  if (!PyArg_ParseTuple(args, "O!O!s", &PyVertexType, &from, &PyVertexType, &to, &edge_type)) {
+  if (!PyArg_ParseTuple(args, "O!O!s", ModuleState().vertex_type, &from, ModuleState().vertex_type, &to, &edge_type)) {
     return nullptr;
   }
   MgpUniquePtr<mgp_edge> new_edge{nullptr, mgp_edge_destroy};
@@ -2437,7 +3164,7 @@ PyObject *PyGraphDeleteVertex(PyGraph *self, PyObject *args) {
   MG_ASSERT(PyGraphIsValidImpl(*self));
   MG_ASSERT(self->memory);
   PyVertex *vertex{nullptr};
-  if (!PyArg_ParseTuple(args, "O!", &PyVertexType, &vertex)) {
+  if (!PyArg_ParseTuple(args, "O!", ModuleState().vertex_type, &vertex)) {
     return nullptr;
   }
   if (RaiseExceptionFromErrorCode(mgp_graph_delete_vertex(self->graph, vertex->vertex))) {
@@ -2450,7 +3177,7 @@ PyObject *PyGraphDetachDeleteVertex(PyGraph *self, PyObject *args) {
   MG_ASSERT(PyGraphIsValidImpl(*self));
   MG_ASSERT(self->memory);
   PyVertex *vertex{nullptr};
-  if (!PyArg_ParseTuple(args, "O!", &PyVertexType, &vertex)) {
+  if (!PyArg_ParseTuple(args, "O!", ModuleState().vertex_type, &vertex)) {
     return nullptr;
   }
   if (RaiseExceptionFromErrorCode(mgp_graph_detach_delete_vertex(self->graph, vertex->vertex))) {
@@ -2463,7 +3190,7 @@ PyObject *PyGraphDeleteEdge(PyGraph *self, PyObject *args) {
   MG_ASSERT(PyGraphIsValidImpl(*self));
   MG_ASSERT(self->memory);
   PyEdge *edge{nullptr};
-  if (!PyArg_ParseTuple(args, "O!", &PyEdgeType, &edge)) {
+  if (!PyArg_ParseTuple(args, "O!", ModuleState().edge_type, &edge)) {
     return nullptr;
   }
   if (RaiseExceptionFromErrorCode(mgp_graph_delete_edge(self->graph, edge->edge))) {
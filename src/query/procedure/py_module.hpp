@@ -79,4 +79,18 @@ py::Object ImportPyModule(const char *, mgp_module *);
 /// Return nullptr and set appropriate Python exception on failure.
 py::Object ReloadPyModule(PyObject *, mgp_module *);
 
+/// Start `count` Python worker interpreters, each with its own GIL and thread,
+/// which then run all Python procedures and transformations in parallel.
+///
+/// Requires Python 3.12 or newer. Worker interpreters don't support temporal
+/// values and import only extension modules with per-interpreter GIL support.
+/// The function must be called without holding the GIL.
+///
+/// Return false and log the reason if the interpreters couldn't be started.
+bool StartPyWorkerInterpreters(size_t count);
+
+/// Stop the Python worker interpreters, if they were started. The function
+/// must be called without holding the GIL.
+void StopPyWorkerInterpreters();
+
 }  // namespace query::procedure
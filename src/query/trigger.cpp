@@ -163,13 +163,15 @@ Trigger::Trigger(std::string name, const std::string &query,
   GetPlan(db_accessor, auth_checker);
 }
 
-Trigger::TriggerPlan::TriggerPlan(std::unique_ptr<LogicalPlan> logical_plan, std::vector<IdentifierInfo> identifiers)
-    : cached_plan(std::move(logical_plan)), identifiers(std::move(identifiers)) {}
+Trigger::TriggerPlan::TriggerPlan(std::unique_ptr<LogicalPlan> logical_plan, std::vector<IdentifierInfo> identifiers,
+                                  const int64_t vertex_count)
+    : cached_plan(std::move(logical_plan), vertex_count), identifiers(std::move(identifiers)) {}
 
 std::shared_ptr<Trigger::TriggerPlan> Trigger::GetPlan(DbAccessor *db_accessor,
                                                        const query::AuthChecker *auth_checker) const {
   std::lock_guard plan_guard{plan_lock_};
-  if (!parsed_statements_.is_cacheable || !trigger_plan_ || trigger_plan_->cached_plan.IsExpired()) {
+  if (!parsed_statements_.is_cacheable || !trigger_plan_ ||
+      trigger_plan_->cached_plan.IsStale(parsed_statements_.parameters, db_accessor)) {
     auto identifiers = GetPredefinedIdentifiers(event_type_);
 
     AstStorage ast_storage;
@@ -185,7 +187,8 @@ std::shared_ptr<Trigger::TriggerPlan> Trigger::GetPlan(DbAccessor *db_accessor,
     auto logical_plan = MakeLogicalPlan(std::move(ast_storage), utils::Downcast<CypherQuery>(parsed_statements_.query),
                                         parsed_statements_.parameters, db_accessor, predefined_identifiers);
 
-    trigger_plan_ = std::make_shared<TriggerPlan>(std::move(logical_plan), std::move(identifiers));
+    trigger_plan_ =
+        std::make_shared<TriggerPlan>(std::move(logical_plan), std::move(identifiers), db_accessor->VerticesCount());
   }
   if (!auth_checker->IsUserAuthorized(owner_, parsed_statements_.required_privileges)) {
     throw utils::BasicException("The owner of trigger '{}' is not authorized to execute the query!", name_);
@@ -209,7 +212,7 @@ void Trigger::Execute(DbAccessor *dba, utils::MonotonicBufferResource *execution
   ctx.db_accessor = dba;
   ctx.symbol_table = plan.symbol_table();
   ctx.evaluation_context.timestamp = QueryTimestamp();
-  ctx.evaluation_context.parameters = parsed_statements_.parameters;
+  ctx.evaluation_context.parameters = plan.BindParameters(parsed_statements_.parameters, dba);
   ctx.evaluation_context.properties = NamesToProperties(plan.ast_storage().properties_, dba);
   ctx.evaluation_context.labels = NamesToLabels(plan.ast_storage().labels_, dba);
   ctx.timer = utils::AsyncTimer(max_execution_time_sec);
@@ -58,7 +58,8 @@ struct Trigger {
   struct TriggerPlan {
     using IdentifierInfo = std::pair<Identifier, TriggerIdentifierTag>;
 
-    explicit TriggerPlan(std::unique_ptr<LogicalPlan> logical_plan, std::vector<IdentifierInfo> identifiers);
+    explicit TriggerPlan(std::unique_ptr<LogicalPlan> logical_plan, std::vector<IdentifierInfo> identifiers,
+                         int64_t vertex_count);
 
     CachedPlan cached_plan;
     std::vector<IdentifierInfo> identifiers;
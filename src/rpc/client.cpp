@@ -11,17 +11,145 @@
 
 #include "rpc/client.hpp"
 
+#include "rpc/protocol.hpp"
+
 namespace rpc {
 
 Client::Client(const io::network::Endpoint &endpoint, communication::ClientContext *context)
     : endpoint_(endpoint), context_(context) {}
 
 void Client::Abort() {
+  std::lock_guard<std::mutex> guard(response_mutex_);
   if (!client_) return;
   // We need to call Shutdown on the client to abort any pending read or
-  // write operations.
+  // write operations. The client itself is replaced by the next call because
+  // other threads may still be using it.
   client_->Shutdown();
-  client_ = std::nullopt;
+  broken_ = true;
+}
+
+void Client::EnsureConnected() {
+  std::unique_lock<std::mutex> guard(response_mutex_);
+
+  // Check if the connection is broken (if we haven't used the client for a
+  // long time the server could have died).
+  if (client_ && (broken_ || client_->ErrorStatus())) {
+    // Calls that are still waiting on the old connection will fail, the
+    // connection can be replaced only after they are done.
+    if (waiting_ > 0) throw RpcFailedException(endpoint_);
+    client_ = std::nullopt;
+    responses_.clear();
+  }
+  broken_ = false;
+
+  // Connect to the remote server.
+  if (!client_) {
+    client_.emplace(context_);
+    if (!client_->Connect(endpoint_)) {
+      SPDLOG_ERROR("Couldn't connect to remote address {}", endpoint_);
+      client_ = std::nullopt;
+      throw RpcFailedException(endpoint_);
+    }
+    // No call is using the new connection yet, so the handshake doesn't need
+    // the lock and can be aborted by `Abort`.
+    guard.unlock();
+    const bool handshake_done = Handshake();
+    guard.lock();
+    if (!handshake_done) {
+      client_ = std::nullopt;
+      throw RpcFailedException(endpoint_);
+    }
+  }
+}
+
+bool Client::Handshake() {
+  bool written = true;
+  slk::Builder builder([&](const uint8_t *data, size_t size, bool have_more) {
+    if (written) written = client_->Write(data, size, have_more);
+  });
+  slk::Save(kProtocolMagic, &builder);
+  slk::Save(kProtocolVersion, &builder);
+  builder.Finalize();
+
+  auto response_size = written ? ReadResponse() : std::nullopt;
+  if (!response_size) {
+    // Servers that predate the handshake close the connection.
+    SPDLOG_ERROR("RPC server {} closed the connection during the handshake, it might use an older RPC protocol",
+               endpoint_);
+    return false;
+  }
+  uint64_t version = 0;
+  try {
+    slk::Reader reader(client_->GetData(), *response_size);
+    slk::Load(&version, &reader);
+    reader.Finalize();
+  } catch (const slk::SlkReaderException &) {
+    SPDLOG_ERROR("RPC server {} sent an invalid handshake response", endpoint_);
+    return false;
+  }
+  client_->ShiftData(*response_size);
+  if (version != kProtocolVersion) {
+    SPDLOG_ERROR("RPC server {} uses RPC protocol version {}, but the client uses version {}", endpoint_, version,
+               kProtocolVersion);
+    return false;
+  }
+  return true;
+}
+
+void Client::PendingRequest::Write(const uint8_t *data, const size_t size, const bool have_more) {
+  if (!guard_.owns_lock()) {
+    buffer_.insert(buffer_.end(), data, data + size);
+    if (!have_more || buffer_.size() >= kMaxBufferedRequestSize) Flush(have_more);
+    return;
+  }
+  if (!self_->client_->Write(data, size, have_more)) throw RpcFailedException(self_->endpoint_);
+}
+
+void Client::PendingRequest::Write(const iovec *iov, const size_t iovcnt, const bool have_more) {
+  if (!guard_.owns_lock()) {
+    for (size_t i = 0; i < iovcnt; ++i) {
+      const auto *data = static_cast<const uint8_t *>(iov[i].iov_base);
+      buffer_.insert(buffer_.end(), data, data + iov[i].iov_len);
+    }
+    if (!have_more || buffer_.size() >= kMaxBufferedRequestSize) Flush(have_more);
+    return;
+  }
+  if (!self_->client_->Write(iov, iovcnt, have_more)) throw RpcFailedException(self_->endpoint_);
+}
+
+void Client::PendingRequest::Flush(const bool have_more) {
+  guard_.lock();
+  self_->EnsureConnected();
+  const auto written = self_->client_->Write(buffer_.data(), buffer_.size(), have_more);
+  std::vector<uint8_t>().swap(buffer_);
+  if (!written) throw RpcFailedException(self_->endpoint_);
+}
+
+uint64_t Client::StartWaiting() {
+  std::lock_guard<std::mutex> guard(response_mutex_);
+  ++waiting_;
+  return generation_;
+}
+
+void Client::MarkBroken() {
+  std::lock_guard<std::mutex> guard(response_mutex_);
+  broken_ = true;
+}
+
+std::optional<size_t> Client::ReadResponse() {
+  while (true) {
+    auto ret = slk::CheckStreamComplete(client_->GetData(), client_->GetDataSize());
+    if (ret.status == slk::StreamStatus::INVALID) {
+      return std::nullopt;
+    } else if (ret.status == slk::StreamStatus::PARTIAL) {
+      if (!client_->Read(ret.stream_size - client_->GetDataSize(),
+                         /* exactly_len = */ false)) {
+        return std::nullopt;
+      }
+    } else {
+      return ret.stream_size;
+    }
+  }
 }
 
 }  // namespace rpc
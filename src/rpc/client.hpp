@@ -11,9 +11,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <vector>
 
 #include "communication/client.hpp"
 #include "io/network/endpoint.hpp"
@@ -26,8 +30,16 @@
 
 namespace rpc {
 
-/// Client is thread safe, but it is recommended to use thread_local clients.
+/// Client is thread safe. Calls from multiple threads are multiplexed over a
+/// single connection: each request is tagged with a call id and the responses
+/// are matched to the waiting calls by that id, so a call doesn't have to wait
+/// for the responses of other calls before sending its request. Requests
+/// themselves are still written one at a time. When SSL is used the connection
+/// can't be read and written concurrently, so the calls are executed one at a
+/// time.
 class Client {
+  class PendingRequest;
+
  public:
   Client(const io::network::Endpoint &endpoint, communication::ClientContext *context);
 
@@ -37,13 +49,16 @@ class Client {
    private:
     friend class Client;
 
-    StreamHandler(Client *self, std::unique_lock<std::mutex> &&guard,
+    StreamHandler(Client *self, uint64_t call_id,
                   std::function<typename TRequestResponse::Response(slk::Reader *)> res_load)
         : self_(self),
-          guard_(std::move(guard)),
-          req_builder_([self](const uint8_t *data, size_t size, bool have_more) {
-            if (!self->client_->Write(data, size, have_more)) throw RpcFailedException(self->endpoint_);
-          }),
+          request_(std::make_unique<PendingRequest>(self)),
+          call_id_(call_id),
+          req_builder_([request = request_.get()](const uint8_t *data, size_t size,
+                                                  bool have_more) { request->Write(data, size, have_more); },
+                       [request = request_.get()](const iovec *iov, size_t iovcnt, bool have_more) {
+                         request->Write(iov, iovcnt, have_more);
+                       }),
           res_load_(res_load) {}
 
    public:
@@ -63,54 +78,43 @@ class Client {
       // Finalize the request.
       req_builder_.Finalize();
 
-      // Receive the response.
-      uint64_t response_data_size = 0;
-      while (true) {
-        auto ret = slk::CheckStreamComplete(self_->client_->GetData(), self_->client_->GetDataSize());
-        if (ret.status == slk::StreamStatus::INVALID) {
+      // Register the call as waiting for its response and let other calls
+      // send their requests in the meantime.
+      const auto generation = self_->StartWaiting();
+      if (!self_->context_->use_ssl()) request_->Unlock();
+
+      return self_->AwaitResponse(call_id_, generation, [&](const uint64_t res_id, slk::Reader *res_reader) {
+        // Check the response ID.
+        if (res_id != res_type.id) {
+          spdlog::error("Message response was of unexpected type");
+          self_->MarkBroken();
           throw RpcFailedException(self_->endpoint_);
-        } else if (ret.status == slk::StreamStatus::PARTIAL) {
-          if (!self_->client_->Read(ret.stream_size - self_->client_->GetDataSize(),
-                                    /* exactly_len = */ false)) {
-            throw RpcFailedException(self_->endpoint_);
-          }
-        } else {
-          response_data_size = ret.stream_size;
-          break;
         }
-      }
 
-      // Load the response.
-      slk::Reader res_reader(self_->client_->GetData(), response_data_size);
-      utils::OnScopeExit res_cleanup([&, response_data_size] { self_->client_->ShiftData(response_data_size); });
-
-      uint64_t res_id = 0;
-      slk::Load(&res_id, &res_reader);
+        SPDLOG_TRACE("[RpcClient] received {}", res_type.name);
 
-      // Check the response ID.
-      if (res_id != res_type.id) {
-        spdlog::error("Message response was of unexpected type");
-        self_->client_ = std::nullopt;
-        throw RpcFailedException(self_->endpoint_);
-      }
-
-      SPDLOG_TRACE("[RpcClient] received {}", res_type.name);
-
-      return res_load_(&res_reader);
+        return res_load_(res_reader);
+      });
     }
 
    private:
     Client *self_;
-    std::unique_lock<std::mutex> guard_;
+    // Owned through a pointer because the builder refers to it.
+    std::unique_ptr<PendingRequest> request_;
+    uint64_t call_id_;
     slk::Builder req_builder_;
     std::function<typename TRequestResponse::Response(slk::Reader *)> res_load_;
   };
 
-  /// Stream a previously defined and registered RPC call. This function can
-  /// initiate only one request at a time. The call returns a `StreamHandler`
-  /// object that can be used to send additional data to the request (with the
-  /// automatically sent `TRequestResponse::Request` object) and await until the
-  /// response is received from the server.
+  /// Stream a previously defined and registered RPC call. The request is
+  /// collected in memory while it's built, so that it doesn't hold up other
+  /// calls. A request that outgrows `kMaxBufferedRequestSize` is written as
+  /// it's built and holds the connection exclusively until `AwaitResponse` is
+  /// called, after that other calls can send their requests while this one
+  /// waits for the response. The call returns a `StreamHandler` object that can be used to send additional
+  /// data to the request (with the automatically sent
+  /// `TRequestResponse::Request` object) and await until the response is
+  /// received from the server.
   ///
   /// @returns StreamHandler<TRequestResponse> object that is used to handle
   ///                                          streaming of additional data to
@@ -138,38 +142,21 @@ class Client {
     auto req_type = TRequestResponse::Request::kType;
     SPDLOG_TRACE("[RpcClient] sent {}", req_type.name);
 
-    std::unique_lock<std::mutex> guard(mutex_);
-
-    // Check if the connection is broken (if we haven't used the client for a
-    // long time the server could have died).
-    if (client_ && client_->ErrorStatus()) {
-      client_ = std::nullopt;
-    }
-
-    // Connect to the remote server.
-    if (!client_) {
-      client_.emplace(context_);
-      if (!client_->Connect(endpoint_)) {
-        SPDLOG_ERROR("Couldn't connect to remote address {}", endpoint_);
-        client_ = std::nullopt;
-        throw RpcFailedException(endpoint_);
-      }
-    }
-
     // Create the stream handler.
-    StreamHandler<TRequestResponse> handler(this, std::move(guard), load);
+    StreamHandler<TRequestResponse> handler(this, next_call_id_++, load);
 
-    // Build and send the request.
+    // Build and send the request. The call id follows the request type so
+    // that the server can tag the response with it.
     slk::Save(req_type.id, handler.GetBuilder());
+    slk::Save(handler.call_id_, handler.GetBuilder());
     TRequestResponse::Request::Save(request, handler.GetBuilder());
 
     // Return the handler to the user.
     return std::move(handler);
   }
 
-  /// Call a previously defined and registered RPC call. This function can
-  /// initiate only one request at a time. The call blocks until a response is
-  /// received.
+  /// Call a previously defined and registered RPC call. The call blocks until
+  /// a response is received.
   ///
   /// @returns TRequestResponse::Response object that was specified to be
   ///                                     returned by the RPC call
@@ -190,17 +177,148 @@ class Client {
     return stream.AwaitResponse();
   }
 
-  /// Call this function from another thread to abort a pending RPC call.
+  /// Call this function from another thread to abort all pending RPC calls.
   void Abort();
 
   const auto &Endpoint() const { return endpoint_; }
 
  private:
+  // Requests up to this size are collected in memory before they are written.
+  static constexpr size_t kMaxBufferedRequestSize = 1024UL * 1024UL;
+
+  // A request that is being built by a `StreamHandler`. The request is
+  // buffered until it's finished or outgrows `kMaxBufferedRequestSize`, and
+  // only then the connection is locked and the request is written to it. The
+  // rest of a larger request is written as it's built.
+  class PendingRequest {
+   public:
+    explicit PendingRequest(Client *self) : self_(self), guard_(self->mutex_, std::defer_lock) {}
+
+    void Write(const uint8_t *data, size_t size, bool have_more);
+    void Write(const iovec *iov, size_t iovcnt, bool have_more);
+
+    // Lets other calls use the connection once the request is written.
+    void Unlock() { guard_.unlock(); }
+
+   private:
+    // Locks the connection and writes the buffered part of the request.
+    void Flush(bool have_more);
+
+    Client *self_;
+    std::unique_lock<std::mutex> guard_;
+    std::vector<uint8_t> buffer_;
+  };
+
+  // (Re)connects to the server if there is no usable connection. `mutex_` must
+  // be held.
+  void EnsureConnected();
+
+  // Exchanges the protocol versions with the server over the new connection.
+  // Returns `false` if the connection failed or the server uses a different
+  // version.
+  bool Handshake();
+
+  // Registers a call whose request was sent. Returns the connection generation
+  // that must be passed to `AwaitResponse`.
+  uint64_t StartWaiting();
+
+  // Marks the connection as unusable so that it is replaced once no call is
+  // waiting on it.
+  void MarkBroken();
+
+  // Reads the next complete response from the connection. Returns its size or
+  // `std::nullopt` if the connection failed. Only the thread that set
+  // `reading_` may call it.
+  std::optional<size_t> ReadResponse();
+
+  // Waits for the response of the call with `call_id` and loads it with
+  // `load`, which gets the response type id and a reader positioned at the
+  // response data. Whichever waiting call isn't blocked reads the responses
+  // from the connection and hands them over to their calls.
+  template <class TLoad>
+  auto AwaitResponse(const uint64_t call_id, const uint64_t generation, const TLoad &load) {
+    utils::OnScopeExit finish_waiting([this] {
+      std::lock_guard<std::mutex> guard(response_mutex_);
+      --waiting_;
+    });
+    std::unique_lock<std::mutex> guard(response_mutex_);
+    while (true) {
+      if (generation_ != generation) throw RpcFailedException(endpoint_);
+
+      if (auto it = responses_.find(call_id); it != responses_.end()) {
+        auto data = std::move(it->second);
+        responses_.erase(it);
+        guard.unlock();
+        slk::Reader res_reader(data.data(), data.size());
+        uint64_t res_id = 0;
+        uint64_t res_call_id = 0;
+        slk::Load(&res_id, &res_reader);
+        slk::Load(&res_call_id, &res_reader);
+        return load(res_id, &res_reader);
+      }
+
+      if (reading_) {
+        response_cv_.wait(guard);
+        continue;
+      }
+
+      reading_ = true;
+      guard.unlock();
+      auto response_size = ReadResponse();
+      if (!response_size) {
+        guard.lock();
+        reading_ = false;
+        broken_ = true;
+        ++generation_;
+        responses_.clear();
+        response_cv_.notify_all();
+        throw RpcFailedException(endpoint_);
+      }
+
+      slk::Reader res_reader(client_->GetData(), *response_size);
+      uint64_t res_id = 0;
+      uint64_t res_call_id = 0;
+      slk::Load(&res_id, &res_reader);
+      slk::Load(&res_call_id, &res_reader);
+
+      if (res_call_id == call_id) {
+        // Our own response is loaded directly from the connection buffer.
+        utils::OnScopeExit res_cleanup([this, size = *response_size] {
+          client_->ShiftData(size);
+          std::lock_guard<std::mutex> guard(response_mutex_);
+          reading_ = false;
+          response_cv_.notify_all();
+        });
+        return load(res_id, &res_reader);
+      }
+
+      std::vector<uint8_t> data(client_->GetData(), client_->GetData() + *response_size);
+      client_->ShiftData(*response_size);
+      guard.lock();
+      reading_ = false;
+      responses_.emplace(res_call_id, std::move(data));
+      response_cv_.notify_all();
+    }
+  }
+
   io::network::Endpoint endpoint_;
   communication::ClientContext *context_;
   std::optional<communication::Client> client_;
 
+  // Serializes writing of requests and replacing of the connection.
   std::mutex mutex_;
+  std::atomic<uint64_t> next_call_id_{0};
+
+  // Protects the state below, which is used to hand the responses over to
+  // their calls. The connection is replaced only while holding both mutexes
+  // and when no call is waiting.
+  std::mutex response_mutex_;
+  std::condition_variable response_cv_;
+  bool reading_{false};
+  bool broken_{false};
+  uint64_t waiting_{0};
+  uint64_t generation_{0};
+  std::map<uint64_t, std::vector<uint8_t>> responses_;
 };
 
 }  // namespace rpc
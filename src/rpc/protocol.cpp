@@ -21,59 +21,154 @@ namespace rpc {
 
 Session::Session(Server *server, const io::network::Endpoint &endpoint, communication::InputStream *input_stream,
                  communication::OutputStream *output_stream)
-    : server_(server), endpoint_(endpoint), input_stream_(input_stream), output_stream_(output_stream) {}
+    : server_(server),
+      endpoint_(endpoint),
+      input_stream_(input_stream),
+      output_stream_(output_stream),
+      output_(std::make_shared<Output>()) {
+  output_->stream = output_stream;
+}
+
+Session::~Session() {
+  // Waits for a response that is being written, the later ones are dropped.
+  std::lock_guard<std::mutex> guard(output_->mutex);
+  output_->stream = nullptr;
+}
+
+void Session::Output::Write(const std::vector<uint8_t> &data) {
+  std::lock_guard<std::mutex> guard(mutex);
+  if (stream) stream->Write(data.data(), data.size());
+}
+
+void Session::Output::Close() {
+  std::lock_guard<std::mutex> guard(mutex);
+  if (stream) stream->Close();
+}
 
 void Session::Execute() {
-  auto ret = slk::CheckStreamComplete(input_stream_->data(), input_stream_->size());
-  if (ret.status == slk::StreamStatus::INVALID) {
-    throw SessionException("Received an invalid SLK stream!");
-  } else if (ret.status == slk::StreamStatus::PARTIAL) {
-    input_stream_->Resize(ret.stream_size);
-    return;
+  // A multiplexing client can send several requests without waiting for the
+  // responses, so all of the complete requests are executed.
+  while (input_stream_->size() > 0) {
+    auto ret = slk::CheckStreamComplete(input_stream_->data(), input_stream_->size());
+    if (ret.status == slk::StreamStatus::INVALID) {
+      throw SessionException("Received an invalid SLK stream!");
+    } else if (ret.status == slk::StreamStatus::PARTIAL) {
+      input_stream_->Resize(ret.stream_size);
+      return;
+    }
+    if (!handshake_done_) {
+      ExecuteHandshake(ret.stream_size);
+      continue;
+    }
+    DispatchRequest(ret.stream_size);
   }
+}
 
-  // Remove the data from the stream on scope exit.
-  utils::OnScopeExit shift_data([&, ret] { input_stream_->Shift(ret.stream_size); });
+void Session::ExecuteHandshake(const size_t stream_size) {
+  utils::OnScopeExit shift_data([&, stream_size] { input_stream_->Shift(stream_size); });
+
+  slk::Reader req_reader(input_stream_->data(), stream_size);
+  uint64_t magic = 0;
+  slk::Load(&magic, &req_reader);
+  if (magic != kProtocolMagic) {
+    throw SessionException("RPC client {} doesn't support RPC protocol version {}!", endpoint_, kProtocolVersion);
+  }
+  uint64_t version = 0;
+  slk::Load(&version, &req_reader);
+  req_reader.Finalize();
 
-  // Prepare SLK reader and builder.
-  slk::Reader req_reader(input_stream_->data(), input_stream_->size());
+  // The client is told the server's version even if it doesn't match, so that
+  // it can report the mismatch.
   slk::Builder res_builder(
       [&](const uint8_t *data, size_t size, bool have_more) { output_stream_->Write(data, size, have_more); });
+  slk::Save(kProtocolVersion, &res_builder);
+  res_builder.Finalize();
 
-  // Load the request ID.
-  uint64_t req_id = 0;
-  slk::Load(&req_id, &req_reader);
+  if (version != kProtocolVersion) {
+    throw SessionException("RPC client {} uses RPC protocol version {}, but the server uses version {}!", endpoint_,
+                           version, kProtocolVersion);
+  }
+  handshake_done_ = true;
+}
+
+void Session::DispatchRequest(const size_t stream_size) {
+  // Remove the data from the stream on scope exit.
+  utils::OnScopeExit shift_data([&, stream_size] { input_stream_->Shift(stream_size); });
 
   // Access to `callbacks_` and `extended_callbacks_` is done here without
   // acquiring the `mutex_` because we don't allow RPC registration after the
   // server was started so those two maps will never be updated when we `find`
   // over them.
-  auto it = server_->callbacks_.find(req_id);
-  auto extended_it = server_->extended_callbacks_.end();
-  if (it == server_->callbacks_.end()) {
-    // We couldn't find a regular callback to call, try to find an extended
-    // callback to call.
-    extended_it = server_->extended_callbacks_.find(req_id);
-
-    if (extended_it == server_->extended_callbacks_.end()) {
-      // Throw exception to close the socket and cleanup the session.
-      throw SessionException("Session trying to execute an unregistered RPC call!");
+  slk::Reader req_reader(input_stream_->data(), stream_size);
+  uint64_t req_id = 0;
+  slk::Load(&req_id, &req_reader);
+  if (server_->callbacks_.find(req_id) == server_->callbacks_.end() &&
+      server_->extended_callbacks_.find(req_id) == server_->extended_callbacks_.end()) {
+    // Throw exception to close the socket and cleanup the session.
+    throw SessionException("Session trying to execute an unregistered RPC call!");
+  }
+
+  // OpenSSL can't write the connection while it's being read, so requests
+  // over SSL are executed one at a time by the thread reading them.
+  if (server_->use_ssl_) {
+    ExecuteRequest(server_, endpoint_, output_.get(), input_stream_->data(), stream_size);
+    return;
+  }
+
+  // The request is copied, the input stream is reused for the next requests.
+  std::vector<uint8_t> request(input_stream_->data(), input_stream_->data() + stream_size);
+  server_->workers_.AddTask([server = server_, endpoint = endpoint_, output = output_, request = std::move(request)] {
+    try {
+      ExecuteRequest(server, endpoint, output.get(), request.data(), request.size());
+    } catch (const std::exception &e) {
+      // The client won't get the response, so the connection is closed in
+      // order to fail the call.
+      spdlog::error("RPC request from {} failed: {}", endpoint, e.what());
+      output->Close();
     }
-    SPDLOG_TRACE("[RpcServer] received {}", extended_it->second.req_type.name);
-    slk::Save(extended_it->second.res_type.id, &res_builder);
-    extended_it->second.callback(endpoint_, &req_reader, &res_builder);
-  } else {
+  });
+}
+
+void Session::ExecuteRequest(Server *server, const io::network::Endpoint &endpoint, Output *output,
+                             const uint8_t *data, const size_t size) {
+  // Prepare SLK reader and builder. The response is collected so that it can
+  // be written at once.
+  slk::Reader req_reader(data, size);
+  std::vector<uint8_t> response;
+  slk::Builder res_builder([&response](const uint8_t *data, size_t size, bool /*have_more*/) {
+    response.insert(response.end(), data, data + size);
+  });
+
+  // Load the request ID and the ID of the call that the response must be
+  // tagged with.
+  uint64_t req_id = 0;
+  uint64_t call_id = 0;
+  slk::Load(&req_id, &req_reader);
+  slk::Load(&call_id, &req_reader);
+
+  const utils::TypeInfo *res_type = nullptr;
+  if (auto it = server->callbacks_.find(req_id); it != server->callbacks_.end()) {
     SPDLOG_TRACE("[RpcServer] received {}", it->second.req_type.name);
-    slk::Save(it->second.res_type.id, &res_builder);
+    res_type = &it->second.res_type;
+    slk::Save(res_type->id, &res_builder);
+    slk::Save(call_id, &res_builder);
     it->second.callback(&req_reader, &res_builder);
+  } else {
+    auto extended_it = server->extended_callbacks_.find(req_id);
+    MG_ASSERT(extended_it != server->extended_callbacks_.end(), "Dispatched an unregistered RPC call!");
+    SPDLOG_TRACE("[RpcServer] received {}", extended_it->second.req_type.name);
+    res_type = &extended_it->second.res_type;
+    slk::Save(res_type->id, &res_builder);
+    slk::Save(call_id, &res_builder);
+    extended_it->second.callback(endpoint, &req_reader, &res_builder);
   }
 
   // Finalize the SLK streams.
   req_reader.Finalize();
   res_builder.Finalize();
 
-  SPDLOG_TRACE("[RpcServer] sent {}",
-               (it != server_->callbacks_.end() ? it->second.res_type.name : extended_it->second.res_type.name));
+  output->Write(response);
+  SPDLOG_TRACE("[RpcServer] sent {}", res_type->name);
 }
 
 }  // namespace rpc
@@ -14,6 +14,8 @@
 #include <chrono>
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "communication/session.hpp"
 #include "rpc/messages.hpp"
@@ -26,9 +28,27 @@
  *
  * Message layout: MessageSize message_size,
  *                 message_size bytes serialized_message
+ *
+ * The first message of every connection is the handshake: the client sends
+ * `kProtocolMagic` followed by its `kProtocolVersion` and the server responds
+ * with its own protocol version. If the versions differ the connection is
+ * closed. Peers that predate the handshake are rejected as well, the server
+ * doesn't know the magic as a request type ID and an old client doesn't start
+ * with the magic.
+ *
+ * Each serialized request starts with the request type ID followed by the
+ * call ID chosen by the client. The response starts with the response type ID
+ * followed by the same call ID so that the client can match responses to
+ * concurrent calls. The server executes the requests of a connection
+ * concurrently and responds to them in the order in which they finish.
  */
 namespace rpc {
 
+// Starts the handshake message, it never matches a request type ID.
+inline constexpr uint64_t kProtocolMagic = 0x4D47525043000000;  // "MGRPC"
+// Version 1 added the call IDs to requests and responses.
+inline constexpr uint64_t kProtocolVersion = 1;
+
 // Forward declaration of class Server
 class Server;
 
@@ -49,6 +69,12 @@ class Session {
  public:
   Session(Server *server, const io::network::Endpoint &endpoint, communication::InputStream *input_stream,
           communication::OutputStream *output_stream);
+  ~Session();
+
+  Session(const Session &) = delete;
+  Session(Session &&) = delete;
+  Session &operator=(const Session &) = delete;
+  Session &operator=(Session &&) = delete;
 
   /**
    * Executes the protocol after data has been read into the stream.
@@ -58,10 +84,37 @@ class Session {
   void Execute();
 
  private:
+  // Checks the handshake that occupies the first `stream_size` bytes of the
+  // input stream, responds with the server's protocol version and removes the
+  // handshake from the stream.
+  void ExecuteHandshake(size_t stream_size);
+
+  // The output stream of the session, shared with the server's workers that
+  // execute its requests. Each response is written whole while holding the
+  // `mutex`, so that concurrent responses don't interleave. The `stream` is
+  // null once the session is destroyed.
+  struct Output {
+    std::mutex mutex;
+    communication::OutputStream *stream;
+
+    void Write(const std::vector<uint8_t> &data);
+    void Close();
+  };
+
+  // Hands the request that occupies the first `stream_size` bytes of the
+  // input stream over to the server's workers and removes it from the stream.
+  void DispatchRequest(size_t stream_size);
+
+  // Executes the request in `data` and writes the response to `output`.
+  static void ExecuteRequest(Server *server, const io::network::Endpoint &endpoint, Output *output,
+                             const uint8_t *data, size_t size);
+
   Server *server_;
   io::network::Endpoint endpoint_;
   communication::InputStream *input_stream_;
   communication::OutputStream *output_stream_;
+  std::shared_ptr<Output> output_;
+  bool handshake_done_{false};
 };
 
 }  // namespace rpc
@@ -20,11 +20,14 @@
 #include "rpc/messages.hpp"
 #include "rpc/protocol.hpp"
 #include "slk/streams.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace rpc {
 
 class Server {
  public:
+  /// `workers_count` threads read the requests from the connections and as
+  /// many threads execute them.
   Server(const io::network::Endpoint &endpoint, communication::ServerContext *context,
          size_t workers_count = std::thread::hardware_concurrency());
   Server(const Server &) = delete;
@@ -89,6 +92,11 @@ class Server {
   std::map<uint64_t, RpcCallback> callbacks_;
   std::map<uint64_t, RpcExtendedCallback> extended_callbacks_;
 
+  // Execute the requests that the sessions read, so that a slow request
+  // doesn't hold up the requests sent after it over the same connection.
+  bool use_ssl_;
+  utils::ThreadPool workers_;
+
   communication::Server<Session, Server> server_;
 };
 
@@ -157,7 +157,7 @@ inline void Load(double *obj, Reader *reader) {
 inline void Save(const std::string &obj, Builder *builder) {
   uint64_t size = obj.size();
   Save(size, builder);
-  builder->Save(reinterpret_cast<const uint8_t *>(obj.data()), size);
+  builder->SaveView(reinterpret_cast<const uint8_t *>(obj.data()), size);
 }
 
 inline void Save(const char *obj, Builder *builder) {
@@ -169,7 +169,7 @@ inline void Save(const char *obj, Builder *builder) {
 inline void Save(const std::string_view &obj, Builder *builder) {
   uint64_t size = obj.size();
   Save(size, builder);
-  builder->Save(reinterpret_cast<const uint8_t *>(obj.data()), size);
+  builder->SaveView(reinterpret_cast<const uint8_t *>(obj.data()), size);
 }
 
 inline void Load(std::string *obj, Reader *reader) {
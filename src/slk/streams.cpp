@@ -11,6 +11,8 @@
 
 #include "slk/streams.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 
 #include "utils/logging.hpp"
@@ -19,6 +21,10 @@ namespace slk {
 
 Builder::Builder(std::function<void(const uint8_t *, size_t, bool)> write_func) : write_func_(write_func) {}
 
+Builder::Builder(std::function<void(const uint8_t *, size_t, bool)> write_func,
+                 std::function<void(const iovec *, size_t, bool)> gather_write_func)
+    : write_func_(write_func), gather_write_func_(gather_write_func) {}
+
 void Builder::Save(const uint8_t *data, uint64_t size) {
   size_t offset = 0;
   while (size > 0) {
@@ -38,10 +44,51 @@ void Builder::Save(const uint8_t *data, uint64_t size) {
   }
 }
 
+void Builder::SaveView(const uint8_t *data, uint64_t size) {
+  if (!gather_write_func_ || size < kSegmentMinViewSize) {
+    Save(data, size);
+    return;
+  }
+
+  while (size > 0) {
+    const auto to_write = std::min(size, kSegmentMaxDataSize);
+
+    // The data that is already in the segment buffer is sent as its own
+    // segment, followed by a segment that references the data.
+    std::array<iovec, 3> iov;
+    size_t iovcnt = 0;
+    if (pos_ > 0) {
+      SegmentSize buffered_size = pos_;
+      memcpy(segment_, &buffered_size, sizeof(SegmentSize));
+      iov[iovcnt++] = {segment_, sizeof(SegmentSize) + pos_};
+    }
+    uint8_t header[sizeof(SegmentSize)];
+    SegmentSize view_size = to_write;
+    memcpy(header, &view_size, sizeof(SegmentSize));
+    iov[iovcnt++] = {header, sizeof(SegmentSize)};
+    iov[iovcnt++] = {const_cast<uint8_t *>(data), to_write};
+
+    gather_write_func_(iov.data(), iovcnt, true);
+
+    pos_ = 0;
+    flushed_ = true;
+    data += to_write;
+    size -= to_write;
+  }
+}
+
 void Builder::Finalize() { FlushSegment(true); }
 
 void Builder::FlushSegment(bool final_segment) {
   if (!final_segment && pos_ < kSegmentMaxDataSize) return;
+  if (final_segment && pos_ == 0 && flushed_) {
+    // All of the data was already written by `SaveView`, only the footer is
+    // left.
+    SegmentSize footer = 0;
+    memcpy(segment_, &footer, sizeof(SegmentSize));
+    write_func_(segment_, sizeof(SegmentSize), false);
+    return;
+  }
   MG_ASSERT(pos_ > 0, "Trying to flush out a segment that has no data in it!");
 
   size_t total_size = sizeof(SegmentSize) + pos_;
@@ -58,6 +105,7 @@ void Builder::FlushSegment(bool final_segment) {
   write_func_(segment_, total_size, !final_segment);
 
   pos_ = 0;
+  flushed_ = true;
 }
 
 Reader::Reader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
@@ -78,6 +126,17 @@ void Reader::Load(uint8_t *data, uint64_t size) {
   }
 }
 
+void Reader::LoadView(uint64_t size, const std::function<void(const uint8_t *, size_t)> &consume) {
+  while (size > 0) {
+    GetSegment();
+    const auto to_read = std::min(size, static_cast<uint64_t>(have_));
+    consume(data_ + pos_, to_read);
+    pos_ += to_read;
+    have_ -= to_read;
+    size -= to_read;
+  }
+}
+
 void Reader::Finalize() { GetSegment(true); }
 
 void Reader::GetSegment(bool should_be_final) {
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <sys/uio.h>
+
 #include <cstdint>
 #include <functional>
 #include <limits>
@@ -31,6 +33,10 @@ const uint64_t kSegmentMaxTotalSize = kSegmentMaxDataSize + sizeof(SegmentSize)
 static_assert(kSegmentMaxDataSize <= std::numeric_limits<SegmentSize>::max(),
               "The SLK segment can't be larger than the type used to store its size!");
 
+// Data passed to `Builder::SaveView` that is smaller than this is copied into
+// the segment buffer because copying it is cheaper than an additional segment.
+const uint64_t kSegmentMinViewSize = 65536;
+
 /// SLK splits binary data into segments. Segments are used to avoid the need to
 /// have all of the encoded data in memory at once during the building process.
 /// That enables streaming during the building process and makes the whole
@@ -48,9 +54,20 @@ class Builder {
  public:
   Builder(std::function<void(const uint8_t *, size_t, bool)> write_func);
 
+  /// The `gather_write_func` must write all of the given buffers in order. It
+  /// is used to emit data saved with `SaveView` without copying it.
+  Builder(std::function<void(const uint8_t *, size_t, bool)> write_func,
+          std::function<void(const iovec *, size_t, bool)> gather_write_func);
+
   /// Function used internally by SLK to serialize the data.
   void Save(const uint8_t *data, uint64_t size);
 
+  /// Same as `Save`, but large data is written out directly from the given
+  /// memory (eg. an mmap-ed file) in its own segments instead of being copied
+  /// into the segment buffer. The data is written before the function returns.
+  /// Without a gather write function the data is copied.
+  void SaveView(const uint8_t *data, uint64_t size);
+
   /// Function that should be called after all `slk::Save` operations are done.
   void Finalize();
 
@@ -58,7 +75,9 @@ class Builder {
   void FlushSegment(bool final_segment);
 
   std::function<void(const uint8_t *, size_t, bool)> write_func_;
+  std::function<void(const iovec *, size_t, bool)> gather_write_func_;
   size_t pos_{0};
+  bool flushed_{false};
   uint8_t segment_[kSegmentMaxTotalSize];
 };
 
@@ -77,6 +96,11 @@ class Reader {
   /// Function used internally by SLK to deserialize the data.
   void Load(uint8_t *data, uint64_t size);
 
+  /// Loads `size` bytes without copying them. The `consume` function is called
+  /// with consecutive pieces of the data which point directly into the stream
+  /// (one piece for each segment the data spans).
+  void LoadView(uint64_t size, const std::function<void(const uint8_t *, size_t)> &consume);
+
   /// Function that should be called after all `slk::Load` operations are done.
   void Finalize();
 
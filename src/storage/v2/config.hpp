@@ -39,6 +39,8 @@ struct Config {
     std::filesystem::path storage_directory{"storage"};
 
     bool recover_on_startup{false};
+    // WAL deltas are applied sequentially when set to 1.
+    uint64_t recovery_thread_count{1};
 
     SnapshotWalMode snapshot_wal_mode{SnapshotWalMode::DISABLED};
 
@@ -50,6 +52,19 @@ struct Config {
 
     bool snapshot_on_exit{false};
 
+    // Snapshot and WAL files are split into independently compressed blocks
+    // of the given (uncompressed) size.
+    struct Compression {
+      enum class Type : uint8_t { NONE, ZLIB };
+
+      Type type{Type::NONE};
+      uint64_t block_size_kibibytes{1024};
+    } compression;
+
+    // Snapshot and WAL files are written through io_uring when the kernel
+    // supports it.
+    bool use_io_uring{false};
+
   } durability;
 
   struct Transaction {
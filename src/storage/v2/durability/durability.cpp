@@ -108,18 +108,50 @@ std::optional<std::vector<WalDurabilityInfo>> GetWalFiles(const std::filesystem:
   return std::move(wal_files);
 }
 
+namespace {
+// Splits the vertices into at most `count` ranges with about the same number
+// of vertices and returns the gid of the first vertex of every range.
+std::vector<Gid> SplitVertices(utils::SkipList<Vertex> *vertices, uint64_t count) {
+  auto acc = vertices->access();
+  const uint64_t range_size = std::max<uint64_t>(acc.size() / count, 1);
+  std::vector<Gid> range_starts;
+  uint64_t position = 0;
+  for (const auto &vertex : acc) {
+    if (position++ % range_size == 0 && range_starts.size() < count) range_starts.push_back(vertex.gid);
+  }
+  if (range_starts.empty()) range_starts.push_back(Gid::FromUint(0));
+  return range_starts;
+}
+}  // namespace
+
 // Function used to recover all discovered indices and constraints. The
 // indices and constraints must be recovered after the data recovery is done
 // to ensure that the indices and constraints are consistent at the end of the
 // recovery process.
 void RecoverIndicesAndConstraints(const RecoveredIndicesAndConstraints &indices_constraints, Indices *indices,
-                                  Constraints *constraints, utils::SkipList<Vertex> *vertices) {
+                                  Constraints *constraints, utils::SkipList<Vertex> *vertices, utils::ThreadPool *pool,
+                                  uint64_t thread_count) {
   spdlog::info("Recreating indices from metadata.");
+  // The vertices are split into ranges once and every index is filled by one
+  // worker per range.
+  std::vector<Gid> range_starts;
+  if (thread_count > 1 &&
+      (!indices_constraints.indices.label.empty() || !indices_constraints.indices.label_property.empty())) {
+    range_starts = SplitVertices(vertices, thread_count);
+  }
+  auto create_label_index = [&](LabelId label) {
+    if (range_starts.empty()) return indices->label_index.CreateIndex(label, vertices->access());
+    return indices->label_index.CreateIndex(label, vertices, range_starts, pool);
+  };
+  auto create_label_property_index = [&](LabelId label, PropertyId property) {
+    if (range_starts.empty()) return indices->label_property_index.CreateIndex(label, property, vertices->access());
+    return indices->label_property_index.CreateIndex(label, property, vertices, range_starts, pool);
+  };
+
   // Recover label indices.
   spdlog::info("Recreating {} label indices from metadata.", indices_constraints.indices.label.size());
   for (const auto &item : indices_constraints.indices.label) {
-    if (!indices->label_index.CreateIndex(item, vertices->access()))
-      throw RecoveryFailure("The label index must be created here!");
+    if (!create_label_index(item)) throw RecoveryFailure("The label index must be created here!");
     spdlog::info("A label index is recreated from metadata.");
   }
   spdlog::info("Label indices are recreated.");
@@ -128,7 +160,7 @@ void RecoverIndicesAndConstraints(const RecoveredIndicesAndConstraints &indices_
   spdlog::info("Recreating {} label+property indices from metadata.",
                indices_constraints.indices.label_property.size());
   for (const auto &item : indices_constraints.indices.label_property) {
-    if (!indices->label_property_index.CreateIndex(item.first, item.second, vertices->access()))
+    if (!create_label_property_index(item.first, item.second))
       throw RecoveryFailure("The label+property index must be created here!");
     spdlog::info("A label+property index is recreated from metadata.");
   }
@@ -164,7 +196,7 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
                                         utils::SkipList<Vertex> *vertices, utils::SkipList<Edge> *edges,
                                         std::atomic<uint64_t> *edge_count, NameIdMapper *name_id_mapper,
                                         Indices *indices, Constraints *constraints, Config::Items items,
-                                        uint64_t *wal_seq_num) {
+                                        uint64_t recovery_thread_count, uint64_t *wal_seq_num) {
   utils::MemoryTracker::OutOfMemoryExceptionEnabler oom_exception;
   spdlog::info("Recovering persisted data using snapshot ({}) and WAL directory ({}).", snapshot_directory,
                wal_directory);
@@ -174,6 +206,13 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
     return std::nullopt;
   }
 
+  // The pool is shared by all parallel steps of the recovery. The calling
+  // thread is one of the workers, the remaining thread of the pool decodes
+  // the WAL files ahead of the workers.
+  std::optional<utils::ThreadPool> recovery_pool;
+  if (recovery_thread_count > 1) recovery_pool.emplace(recovery_thread_count);
+  auto *pool = recovery_pool ? &*recovery_pool : nullptr;
+
   auto snapshot_files = GetSnapshotFiles(snapshot_directory);
 
   RecoveryInfo recovery_info;
@@ -213,7 +252,8 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
     *epoch_id = std::move(recovered_snapshot->snapshot_info.epoch_id);
 
     if (!utils::DirExists(wal_directory)) {
-      RecoverIndicesAndConstraints(indices_constraints, indices, constraints, vertices);
+      RecoverIndicesAndConstraints(indices_constraints, indices, constraints, vertices, pool,
+                                   recovery_thread_count);
       return recovered_snapshot->recovery_info;
     }
   } else {
@@ -299,6 +339,14 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
     }
     std::optional<uint64_t> previous_seq_num;
     auto last_loaded_timestamp = snapshot_timestamp;
+    std::optional<ParallelWalLoader> wal_loader;
+    if (pool) {
+      std::vector<std::filesystem::path> wal_paths;
+      wal_paths.reserve(wal_files.size());
+      for (const auto &wal_file : wal_files) wal_paths.push_back(wal_file.path);
+      wal_loader.emplace(std::move(wal_paths), last_loaded_timestamp, recovery_info.next_timestamp, pool,
+                         recovery_thread_count);
+    }
     spdlog::info("Trying to load WAL files.");
     for (auto &wal_file : wal_files) {
       if (previous_seq_num && (wal_file.seq_num - *previous_seq_num) > 1) {
@@ -317,8 +365,10 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
         *epoch_id = std::move(wal_file.epoch_id);
       }
       try {
-        auto info = LoadWal(wal_file.path, &indices_constraints, last_loaded_timestamp, vertices, edges, name_id_mapper,
-                            edge_count, items);
+        auto info = wal_loader ? wal_loader->LoadNext(&indices_constraints, vertices, edges, name_id_mapper,
+                                                      edge_count, items)
+                               : LoadWal(wal_file.path, &indices_constraints, last_loaded_timestamp, vertices, edges,
+                                         name_id_mapper, edge_count, items);
         recovery_info.next_vertex_id = std::max(recovery_info.next_vertex_id, info.next_vertex_id);
         recovery_info.next_edge_id = std::max(recovery_info.next_edge_id, info.next_edge_id);
         recovery_info.next_timestamp = std::max(recovery_info.next_timestamp, info.next_timestamp);
@@ -339,7 +389,8 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
     spdlog::info("All necessary WAL files are loaded successfully.");
   }
 
-  RecoverIndicesAndConstraints(indices_constraints, indices, constraints, vertices);
+  RecoverIndicesAndConstraints(indices_constraints, indices, constraints, vertices, pool,
+                               recovery_thread_count);
   return recovery_info;
 }
 
@@ -27,6 +27,7 @@
 #include "storage/v2/name_id_mapper.hpp"
 #include "storage/v2/vertex.hpp"
 #include "utils/skip_list.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace storage::durability {
 
@@ -94,10 +95,12 @@ std::optional<std::vector<WalDurabilityInfo>> GetWalFiles(const std::filesystem:
 // Helper function used to recover all discovered indices and constraints. The
 // indices and constraints must be recovered after the data recovery is done
 // to ensure that the indices and constraints are consistent at the end of the
-// recovery process.
+// recovery process. When `thread_count` is larger than 1, the indices are
+// filled by the calling thread and `thread_count - 1` threads of the `pool`.
 /// @throw RecoveryFailure
 void RecoverIndicesAndConstraints(const RecoveredIndicesAndConstraints &indices_constraints, Indices *indices,
-                                  Constraints *constraints, utils::SkipList<Vertex> *vertices);
+                                  Constraints *constraints, utils::SkipList<Vertex> *vertices,
+                                  utils::ThreadPool *pool = nullptr, uint64_t thread_count = 1);
 
 /// Recovers data either from a snapshot and/or WAL files.
 /// @throw RecoveryFailure
@@ -109,6 +112,6 @@ std::optional<RecoveryInfo> RecoverData(const std::filesystem::path &snapshot_di
                                         utils::SkipList<Vertex> *vertices, utils::SkipList<Edge> *edges,
                                         std::atomic<uint64_t> *edge_count, NameIdMapper *name_id_mapper,
                                         Indices *indices, Constraints *constraints, Config::Items items,
-                                        uint64_t *wal_seq_num);
+                                        uint64_t recovery_thread_count, uint64_t *wal_seq_num);
 
 }  // namespace storage::durability
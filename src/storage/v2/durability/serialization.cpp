@@ -11,8 +11,15 @@
 
 #include "storage/v2/durability/serialization.hpp"
 
+#include <algorithm>
+#include <cstring>
+
+#include <zlib.h>
+
+#include "storage/v2/durability/version.hpp"
 #include "storage/v2/temporal.hpp"
 #include "utils/endian.hpp"
+#include "utils/logging.hpp"
 
 namespace storage::durability {
 
@@ -20,31 +27,136 @@ namespace storage::durability {
 // Encoder implementation.
 //////////////////////////
 
+// Compressed data is stored in blocks, each block can be decompressed
+// independently of the others. A block is written as one or more fragments,
+// each fragment starts with its uncompressed size and the size of the stored
+// data (both uint32). The fragments of a block are a single deflate stream that
+// is flushed at the end of each fragment. That way data that is flushed before
+// the block is full (e.g. on each WAL commit) reaches the file, while the block
+// is still compressed as a whole. The top bits of the uncompressed size mark a
+// fragment that continues the block of the previous fragment and a fragment
+// that is stored as is, because compressing it didn't reduce its size. Only
+// blocks made of a single fragment are stored as is.
 namespace {
 void WriteSize(Encoder *encoder, uint64_t size) {
   size = utils::HostToLittleEndian(size);
   encoder->Write(reinterpret_cast<const uint8_t *>(&size), sizeof(size));
 }
+
+constexpr uint64_t kBlockHeaderSize = 2 * sizeof(uint32_t);
+constexpr uint32_t kFragmentStored = 1U << 31U;
+constexpr uint32_t kFragmentContinued = 1U << 30U;
+constexpr uint32_t kFragmentSizeMask = kFragmentContinued - 1;
+// Output space reserved for the sync flush marker on top of `deflateBound`.
+constexpr uint64_t kSyncFlushSize = 16;
+// The WAL is written on the commit path so speed is preferred over ratio.
+constexpr int kZlibCompressionLevel = Z_BEST_SPEED;
 }  // namespace
 
-void Encoder::Initialize(const std::filesystem::path &path, const std::string_view &magic, uint64_t version) {
+void Encoder::DeflateDeleter::operator()(z_stream_s *stream) const {
+  deflateEnd(stream);
+  delete stream;
+}
+
+void Encoder::Initialize(const std::filesystem::path &path, const std::string_view &magic, uint64_t version,
+                         Config::Durability::Compression compression) {
   file_.Open(path, utils::OutputFile::Mode::OVERWRITE_EXISTING);
   Write(reinterpret_cast<const uint8_t *>(magic.data()), magic.size());
   auto version_encoded = utils::HostToLittleEndian(version);
   Write(reinterpret_cast<const uint8_t *>(&version_encoded), sizeof(version_encoded));
+  compression_ = compression;
+  if (version < kCompressionVersion) {
+    MG_ASSERT(compression.type == Config::Durability::Compression::Type::NONE,
+              "Compression isn't supported in version {}!", version);
+    return;
+  }
+  auto type = static_cast<uint8_t>(compression.type);
+  Write(&type, sizeof(type));
+  if (compression.type != Config::Durability::Compression::Type::NONE) {
+    MG_ASSERT(compression.block_size_kibibytes > 0 && compression.block_size_kibibytes * 1024 <= kFragmentSizeMask,
+              "Invalid compression block size!");
+    // Placeholder for the position where the compressed data starts.
+    compressed_begin_position_ = GetPosition();
+    WriteSize(this, 0);
+  }
 }
 
 void Encoder::OpenExisting(const std::filesystem::path &path) {
   file_.Open(path, utils::OutputFile::Mode::APPEND_TO_EXISTING);
 }
 
+bool Encoder::UseIoUring() { return file_.UseIoUring(); }
+
+void Encoder::StartCompression() {
+  if (compression_.type == Config::Durability::Compression::Type::NONE) return;
+  MG_ASSERT(compressed_begin_ == 0, "Compression was already started!");
+  auto position = GetPosition();
+  SetPosition(compressed_begin_position_);
+  WriteSize(this, position);
+  SetPosition(position);
+  compressed_begin_ = position;
+  block_.reserve(compression_.block_size_kibibytes * 1024);
+  if (!deflate_) {
+    deflate_.reset(new z_stream{});
+    MG_ASSERT(deflateInit(deflate_.get(), kZlibCompressionLevel) == Z_OK, "Couldn't initialize the compression of {}!",
+              file_.path());
+  } else {
+    deflateReset(deflate_.get());
+  }
+  block_written_ = 0;
+}
+
+void Encoder::FlushBlock() { FlushFragment(true); }
+
+void Encoder::FlushFragment(bool end_block) {
+  if (!block_.empty()) {
+    auto *stream = deflate_.get();
+    stream->next_in = block_.data();
+    stream->avail_in = block_.size();
+    uint64_t stored_size = 0;
+    do {
+      compressed_block_.resize(stored_size + deflateBound(stream, stream->avail_in) + kSyncFlushSize);
+      stream->next_out = compressed_block_.data() + stored_size;
+      stream->avail_out = compressed_block_.size() - stored_size;
+      auto ret = deflate(stream, Z_SYNC_FLUSH);
+      MG_ASSERT(ret == Z_OK || ret == Z_BUF_ERROR, "Couldn't compress the data written to {}!", file_.path());
+      stored_size = compressed_block_.size() - stream->avail_out;
+    } while (stream->avail_out == 0);
+    uint32_t flags = block_written_ > 0 ? kFragmentContinued : 0;
+    const uint8_t *stored = compressed_block_.data();
+    if (block_written_ == 0 && end_block && stored_size >= block_.size()) {
+      flags |= kFragmentStored;
+      stored = block_.data();
+      stored_size = block_.size();
+    }
+    uint32_t header[2] = {utils::HostToLittleEndian(static_cast<uint32_t>(block_.size()) | flags),
+                          utils::HostToLittleEndian(static_cast<uint32_t>(stored_size))};
+    file_.Write(reinterpret_cast<const uint8_t *>(header), sizeof(header));
+    file_.Write(stored, stored_size);
+    compressed_size_ += block_.size();
+    block_written_ += block_.size();
+    block_.clear();
+  }
+  if (end_block && block_written_ > 0) {
+    deflateReset(deflate_.get());
+    block_written_ = 0;
+  }
+}
+
 void Encoder::Close() {
   if (file_.IsOpen()) {
     file_.Close();
   }
 }
 
-void Encoder::Write(const uint8_t *data, uint64_t size) { file_.Write(data, size); }
+void Encoder::Write(const uint8_t *data, uint64_t size) {
+  if (compressed_begin_ == 0 || overwriting_) {
+    file_.Write(data, size);
+    return;
+  }
+  block_.insert(block_.end(), data, data + size);
+  if (block_written_ + block_.size() >= compression_.block_size_kibibytes * 1024) FlushBlock();
+}
 
 void Encoder::WriteMarker(Marker marker) {
   auto value = static_cast<uint8_t>(marker);
@@ -66,6 +178,20 @@ void Encoder::WriteUint(uint64_t value) {
   Write(reinterpret_cast<const uint8_t *>(&value), sizeof(value));
 }
 
+void Encoder::WriteVarUint(uint64_t value) {
+  WriteMarker(Marker::TYPE_VARINT);
+  // LEB128, the lower 7 bits of each byte hold the value and the highest bit
+  // is set in all bytes except the last one.
+  uint8_t buffer[10];
+  uint8_t size = 0;
+  while (value >= 0x80) {
+    buffer[size++] = static_cast<uint8_t>(value) | 0x80;
+    value >>= 7;
+  }
+  buffer[size++] = static_cast<uint8_t>(value);
+  Write(buffer, size);
+}
+
 void Encoder::WriteDouble(double value) {
   auto value_uint = utils::MemcpyCast<uint64_t>(value);
   value_uint = utils::HostToLittleEndian(value_uint);
@@ -131,26 +257,56 @@ void Encoder::WritePropertyValue(const PropertyValue &value) {
   }
 }
 
-uint64_t Encoder::GetPosition() { return file_.GetPosition(); }
+uint64_t Encoder::GetPosition() {
+  if (compressed_begin_ == 0 || overwriting_) return file_.GetPosition();
+  return compressed_begin_ + compressed_size_ + block_.size();
+}
 
-void Encoder::SetPosition(uint64_t position) { file_.SetPosition(utils::OutputFile::Position::SET, position); }
+void Encoder::SetPosition(uint64_t position) {
+  if (compressed_begin_ == 0) {
+    file_.SetPosition(utils::OutputFile::Position::SET, position);
+    return;
+  }
+  if (position >= compressed_begin_) {
+    MG_ASSERT(position == compressed_begin_ + compressed_size_ + block_.size(),
+              "Compressed data in {} can't be overwritten!", file_.path());
+    file_.SetPosition(utils::OutputFile::Position::RELATIVE_TO_END, 0);
+    overwriting_ = false;
+    return;
+  }
+  FlushBlock();
+  file_.SetPosition(utils::OutputFile::Position::SET, position);
+  overwriting_ = true;
+}
 
-void Encoder::Sync() { file_.Sync(); }
+void Encoder::Sync() {
+  FlushBlock();
+  file_.Sync();
+}
 
 void Encoder::Finalize() {
+  FlushBlock();
   file_.Sync();
   file_.Close();
 }
 
-void Encoder::DisableFlushing() { file_.DisableFlushing(); }
+void Encoder::DisableFlushing() {
+  FlushBlock();
+  file_.DisableFlushing();
+}
 
 void Encoder::EnableFlushing() { file_.EnableFlushing(); }
 
-void Encoder::TryFlushing() { file_.TryFlushing(); }
+// Ending the block here would store each transaction of a WAL file in its own
+// small block, which doesn't compress. A fragment continues the block instead.
+void Encoder::TryFlushing() {
+  if (compressed_begin_ != 0 && !overwriting_) FlushFragment(false);
+  file_.TryFlushing();
+}
 
 std::pair<const uint8_t *, size_t> Encoder::CurrentFileBuffer() const { return file_.CurrentBuffer(); }
 
-size_t Encoder::GetSize() { return file_.GetSize(); }
+size_t Encoder::GetSize() { return file_.GetSize() + block_.size(); }
 
 //////////////////////////
 // Decoder implementation.
@@ -175,18 +331,156 @@ std::optional<uint64_t> ReadSize(Decoder *decoder) {
 }  // namespace
 
 std::optional<uint64_t> Decoder::Initialize(const std::filesystem::path &path, const std::string &magic) {
+  compressed_begin_ = 0;
   if (!file_.Open(path)) return std::nullopt;
   std::string file_magic(magic.size(), '\0');
   if (!Read(reinterpret_cast<uint8_t *>(file_magic.data()), file_magic.size())) return std::nullopt;
   if (file_magic != magic) return std::nullopt;
   uint64_t version_encoded;
   if (!Read(reinterpret_cast<uint8_t *>(&version_encoded), sizeof(version_encoded))) return std::nullopt;
-  return utils::LittleEndianToHost(version_encoded);
+  auto version = utils::LittleEndianToHost(version_encoded);
+  if (version < kCompressionVersion) return version;
+
+  uint8_t type;
+  if (!Read(&type, sizeof(type))) return std::nullopt;
+  switch (static_cast<Config::Durability::Compression::Type>(type)) {
+    case Config::Durability::Compression::Type::NONE:
+      return version;
+    case Config::Durability::Compression::Type::ZLIB:
+      break;
+    default:
+      return std::nullopt;
+  }
+  uint64_t compressed_begin;
+  if (!Read(reinterpret_cast<uint8_t *>(&compressed_begin), sizeof(compressed_begin))) return std::nullopt;
+  compressed_begin = utils::LittleEndianToHost(compressed_begin);
+  // The compressed data start is written only when the file header is
+  // complete, files without it contain no data.
+  if (compressed_begin != 0 && !ReadBlockIndex(compressed_begin)) return std::nullopt;
+  return version;
 }
 
-bool Decoder::Read(uint8_t *data, size_t size) { return file_.Read(data, size); }
+void Decoder::InflateDeleter::operator()(z_stream_s *stream) const {
+  inflateEnd(stream);
+  delete stream;
+}
 
-bool Decoder::Peek(uint8_t *data, size_t size) { return file_.Peek(data, size); }
+bool Decoder::ReadBlockIndex(uint64_t compressed_begin) {
+  auto header_end = file_.GetPosition();
+  if (compressed_begin < header_end) return false;
+  auto file_size = file_.GetSize();
+  blocks_.clear();
+  uint64_t position = compressed_begin;
+  uint64_t file_position = compressed_begin;
+  // Fragments that were only partially written (e.g. at the end of a WAL) are
+  // ignored, the fragments before them can still be decompressed.
+  while (file_position + kBlockHeaderSize <= file_size) {
+    uint32_t header[2];
+    if (!file_.SetPosition(utils::InputFile::Position::SET, file_position)) return false;
+    if (!file_.Read(reinterpret_cast<uint8_t *>(header), sizeof(header))) return false;
+    auto size = utils::LittleEndianToHost(header[0]);
+    auto flags = size & ~kFragmentSizeMask;
+    size &= kFragmentSizeMask;
+    auto stored_size = utils::LittleEndianToHost(header[1]);
+    if ((flags & kFragmentStored) && (stored_size != size || (flags & kFragmentContinued))) break;
+    if (file_position + kBlockHeaderSize + stored_size > file_size) break;
+    if (flags & kFragmentContinued) {
+      if (blocks_.empty() || blocks_.back().stored) break;
+      blocks_.back().size += size;
+      blocks_.back().file_size += kBlockHeaderSize + stored_size;
+    } else {
+      const bool stored = flags & kFragmentStored;
+      blocks_.push_back({position, file_position, size, kBlockHeaderSize + stored_size, stored});
+    }
+    position += size;
+    file_position += kBlockHeaderSize + stored_size;
+  }
+  if (!file_.SetPosition(utils::InputFile::Position::SET, header_end)) return false;
+  compressed_begin_ = compressed_begin;
+  position_ = header_end;
+  current_block_ = blocks_.size();
+  return true;
+}
+
+bool Decoder::LoadBlock(uint64_t position) {
+  if (current_block_ < blocks_.size()) {
+    const auto &block = blocks_[current_block_];
+    if (position >= block.position && position < block.position + block.size) return true;
+  }
+  auto it = std::upper_bound(blocks_.begin(), blocks_.end(), position,
+                             [](uint64_t position, const Block &block) { return position < block.position; });
+  if (it == blocks_.begin()) return false;
+  --it;
+  if (position >= it->position + it->size) return false;
+  current_block_ = blocks_.size();
+  stored_data_.resize(it->file_size);
+  if (!file_.SetPosition(utils::InputFile::Position::SET, it->file_position)) return false;
+  if (!file_.Read(stored_data_.data(), it->file_size)) return false;
+  // The spare byte lets the decompression consume the flush marker at the end
+  // of the last fragment.
+  block_data_.resize(it->size + 1);
+  if (it->stored) {
+    memcpy(block_data_.data(), stored_data_.data() + kBlockHeaderSize, it->size);
+  } else {
+    if (!inflate_) {
+      inflate_.reset(new z_stream{});
+      if (inflateInit(inflate_.get()) != Z_OK) {
+        inflate_.reset();
+        return false;
+      }
+    } else {
+      inflateReset(inflate_.get());
+    }
+    auto *stream = inflate_.get();
+    stream->next_out = block_data_.data();
+    stream->avail_out = block_data_.size();
+    for (uint64_t offset = 0; offset < it->file_size;) {
+      uint32_t header[2];
+      memcpy(header, stored_data_.data() + offset, sizeof(header));
+      auto size = utils::LittleEndianToHost(header[0]) & kFragmentSizeMask;
+      auto stored_size = utils::LittleEndianToHost(header[1]);
+      auto *out = stream->next_out;
+      stream->next_in = stored_data_.data() + offset + kBlockHeaderSize;
+      stream->avail_in = stored_size;
+      auto ret = inflate(stream, Z_SYNC_FLUSH);
+      if ((ret != Z_OK && ret != Z_STREAM_END) || stream->avail_in != 0 || stream->next_out != out + size) return false;
+      offset += kBlockHeaderSize + stored_size;
+    }
+  }
+  current_block_ = it - blocks_.begin();
+  return true;
+}
+
+bool Decoder::Read(uint8_t *data, size_t size) {
+  if (compressed_begin_ == 0) return file_.Read(data, size);
+  while (size > 0) {
+    if (position_ < compressed_begin_) {
+      auto to_read = std::min<uint64_t>(size, compressed_begin_ - position_);
+      if (!file_.Read(data, to_read)) return false;
+      data += to_read;
+      size -= to_read;
+      position_ += to_read;
+      continue;
+    }
+    if (!LoadBlock(position_)) return false;
+    const auto &block = blocks_[current_block_];
+    auto offset = position_ - block.position;
+    auto to_read = std::min<uint64_t>(size, block.size - offset);
+    memcpy(data, block_data_.data() + offset, to_read);
+    data += to_read;
+    size -= to_read;
+    position_ += to_read;
+  }
+  return true;
+}
+
+bool Decoder::Peek(uint8_t *data, size_t size) {
+  if (compressed_begin_ == 0) return file_.Peek(data, size);
+  auto position = position_;
+  auto ret = Read(data, size);
+  if (!SetPosition(position)) return false;
+  return ret;
+}
 
 std::optional<Marker> Decoder::PeekMarker() {
   uint8_t value;
@@ -221,6 +515,19 @@ std::optional<uint64_t> Decoder::ReadUint() {
   return value;
 }
 
+std::optional<uint64_t> Decoder::ReadVarUint() {
+  auto marker = ReadMarker();
+  if (!marker || *marker != Marker::TYPE_VARINT) return std::nullopt;
+  uint64_t value = 0;
+  for (uint8_t shift = 0; shift < 64; shift += 7) {
+    uint8_t byte;
+    if (!Read(&byte, sizeof(byte))) return std::nullopt;
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) return value;
+  }
+  return std::nullopt;
+}
+
 std::optional<double> Decoder::ReadDouble() {
   auto marker = ReadMarker();
   if (!marker || *marker != Marker::TYPE_DOUBLE) return std::nullopt;
@@ -324,6 +631,7 @@ std::optional<PropertyValue> Decoder::ReadPropertyValue() {
     }
 
     case Marker::TYPE_PROPERTY_VALUE:
+    case Marker::TYPE_VARINT:
     case Marker::SECTION_VERTEX:
     case Marker::SECTION_EDGE:
     case Marker::SECTION_MAPPER:
@@ -423,6 +731,7 @@ bool Decoder::SkipPropertyValue() {
     }
 
     case Marker::TYPE_PROPERTY_VALUE:
+    case Marker::TYPE_VARINT:
     case Marker::SECTION_VERTEX:
     case Marker::SECTION_EDGE:
     case Marker::SECTION_MAPPER:
@@ -455,10 +764,26 @@ bool Decoder::SkipPropertyValue() {
   }
 }
 
-std::optional<uint64_t> Decoder::GetSize() { return file_.GetSize(); }
+std::optional<uint64_t> Decoder::GetSize() {
+  if (compressed_begin_ == 0) return file_.GetSize();
+  if (blocks_.empty()) return compressed_begin_;
+  return blocks_.back().position + blocks_.back().size;
+}
 
-std::optional<uint64_t> Decoder::GetPosition() { return file_.GetPosition(); }
+std::optional<uint64_t> Decoder::GetPosition() {
+  if (compressed_begin_ == 0) return file_.GetPosition();
+  return position_;
+}
 
-bool Decoder::SetPosition(uint64_t position) { return !!file_.SetPosition(utils::InputFile::Position::SET, position); }
+bool Decoder::SetPosition(uint64_t position) {
+  if (compressed_begin_ == 0) return !!file_.SetPosition(utils::InputFile::Position::SET, position);
+  if (position < compressed_begin_) {
+    if (!file_.SetPosition(utils::InputFile::Position::SET, position)) return false;
+  } else if (position > *GetSize()) {
+    return false;
+  }
+  position_ = position;
+  return true;
+}
 
 }  // namespace storage::durability
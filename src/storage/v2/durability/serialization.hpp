@@ -13,7 +13,9 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <memory>
 #include <string_view>
+#include <vector>
 
 #include "storage/v2/config.hpp"
 #include "storage/v2/durability/marker.hpp"
@@ -21,6 +23,9 @@
 #include "storage/v2/property_value.hpp"
 #include "utils/file.hpp"
 
+// Defined by zlib.
+struct z_stream_s;
+
 namespace storage::durability {
 
 /// Encoder interface class. Used to implement streams to different targets
@@ -33,6 +38,9 @@ class BaseEncoder {
   virtual void WriteMarker(Marker marker) = 0;
   virtual void WriteBool(bool value) = 0;
   virtual void WriteUint(uint64_t value) = 0;
+  // Variable-length encoding, small values take fewer bytes. It can't be used
+  // for values that are overwritten in place later (e.g. section offsets).
+  virtual void WriteVarUint(uint64_t value) = 0;
   virtual void WriteDouble(double value) = 0;
   virtual void WriteString(const std::string_view &value) = 0;
   virtual void WritePropertyValue(const PropertyValue &value) = 0;
@@ -41,18 +49,31 @@ class BaseEncoder {
 /// Encoder that is used to generate a snapshot/WAL.
 class Encoder final : public BaseEncoder {
  public:
-  void Initialize(const std::filesystem::path &path, const std::string_view &magic, uint64_t version);
+  void Initialize(const std::filesystem::path &path, const std::string_view &magic, uint64_t version,
+                  Config::Durability::Compression compression = {});
 
+  // Appends raw data to the file, appending to a compressed file isn't
+  // supported.
   void OpenExisting(const std::filesystem::path &path);
 
+  // All data written after this call is split into compressed blocks if
+  // compression was requested in `Initialize`. Data written before it can
+  // still be overwritten using `SetPosition`, compressed data can't.
+  void StartCompression();
+
+  // Writes the file using io_uring if the kernel supports it. Returns `false`
+  // if blocking writes are used instead.
+  bool UseIoUring();
+
   void Close();
-  // Main write function, the only one that is allowed to write to the `file_`
-  // directly.
+  // Main write function, together with `FlushBlock` the only one that is
+  // allowed to write to the `file_` directly.
   void Write(const uint8_t *data, uint64_t size);
 
   void WriteMarker(Marker marker) override;
   void WriteBool(bool value) override;
   void WriteUint(uint64_t value) override;
+  void WriteVarUint(uint64_t value) override;
   void WriteDouble(double value) override;
   void WriteString(const std::string_view &value) override;
   void WritePropertyValue(const PropertyValue &value) override;
@@ -60,15 +81,22 @@ class Encoder final : public BaseEncoder {
   uint64_t GetPosition();
   void SetPosition(uint64_t position);
 
+  // Also ends the pending compressed block, so that all data written so far
+  // is in the file.
   void Sync();
 
   void Finalize();
 
-  // Disable flushing of the internal buffer.
+  // Disable flushing of the internal buffer. The pending compressed block is
+  // ended, so that all data written so far is either in the file or in the
+  // internal buffer.
   void DisableFlushing();
   // Enable flushing of the internal buffer.
   void EnableFlushing();
-  // Try flushing the internal buffer.
+  // Try flushing the internal buffer. The data of the pending compressed block
+  // is written as a fragment of the block, the block itself isn't ended. With
+  // io_uring the flush may still be in flight when the call returns, see
+  // `utils::OutputFile::UseIoUring`.
   void TryFlushing();
   // Get the current internal buffer with its size.
   std::pair<const uint8_t *, size_t> CurrentFileBuffer() const;
@@ -77,7 +105,33 @@ class Encoder final : public BaseEncoder {
   size_t GetSize();
 
  private:
+  struct DeflateDeleter {
+    void operator()(z_stream_s *stream) const;
+  };
+
+  // Writes the pending data and ends the block.
+  void FlushBlock();
+  // Compresses the pending data and writes it to the file as a fragment of the
+  // current block.
+  void FlushFragment(bool end_block);
+
   utils::OutputFile file_;
+
+  Config::Durability::Compression compression_;
+  // Position of the compressed data start stored in the file header.
+  uint64_t compressed_begin_position_{0};
+  // Position where the compressed data starts, 0 if it didn't start yet.
+  uint64_t compressed_begin_{0};
+  // Uncompressed size of all blocks that were already written.
+  uint64_t compressed_size_{0};
+  bool overwriting_{false};
+  // Compression state of the current block, shared by all of its fragments.
+  std::unique_ptr<z_stream_s, DeflateDeleter> deflate_;
+  // Uncompressed size of the fragments of the current block that were
+  // already written.
+  uint64_t block_written_{0};
+  std::vector<uint8_t> block_;
+  std::vector<uint8_t> compressed_block_;
 };
 
 /// Decoder interface class. Used to implement streams from different sources
@@ -90,6 +144,7 @@ class BaseDecoder {
   virtual std::optional<Marker> ReadMarker() = 0;
   virtual std::optional<bool> ReadBool() = 0;
   virtual std::optional<uint64_t> ReadUint() = 0;
+  virtual std::optional<uint64_t> ReadVarUint() = 0;
   virtual std::optional<double> ReadDouble() = 0;
   virtual std::optional<std::string> ReadString() = 0;
   virtual std::optional<PropertyValue> ReadPropertyValue() = 0;
@@ -113,6 +168,7 @@ class Decoder final : public BaseDecoder {
   std::optional<Marker> ReadMarker() override;
   std::optional<bool> ReadBool() override;
   std::optional<uint64_t> ReadUint() override;
+  std::optional<uint64_t> ReadVarUint() override;
   std::optional<double> ReadDouble() override;
   std::optional<std::string> ReadString() override;
   std::optional<PropertyValue> ReadPropertyValue() override;
@@ -125,7 +181,38 @@ class Decoder final : public BaseDecoder {
   bool SetPosition(uint64_t position);
 
  private:
+  struct InflateDeleter {
+    void operator()(z_stream_s *stream) const;
+  };
+
+  struct Block {
+    // Uncompressed position of the block's first byte.
+    uint64_t position;
+    // Position of the block's first fragment in the file.
+    uint64_t file_position;
+    uint64_t size;
+    // Size of all fragments in the file, including their headers.
+    uint64_t file_size;
+    // Whether the block is a single fragment stored as is.
+    bool stored;
+  };
+
+  // Builds the block index by following the fragment headers. Fragments that
+  // were only partially written (e.g. at the end of a WAL) are ignored.
+  bool ReadBlockIndex(uint64_t compressed_begin);
+  bool LoadBlock(uint64_t position);
+
   utils::InputFile file_;
+
+  // Position where the compressed data starts, 0 if the file isn't compressed.
+  uint64_t compressed_begin_{0};
+  uint64_t position_{0};
+  std::vector<Block> blocks_;
+  // Index of the block loaded into `block_data_`.
+  size_t current_block_{0};
+  std::vector<uint8_t> block_data_;
+  std::vector<uint8_t> stored_data_;
+  std::unique_ptr<z_stream_s, InflateDeleter> inflate_;
 };
 
 }  // namespace storage::durability
@@ -630,7 +630,8 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
                     utils::SkipList<Vertex> *vertices, utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper,
                     Indices *indices, Constraints *constraints, Config::Items items, const std::string &uuid,
                     const std::string_view epoch_id, const std::deque<std::pair<std::string, uint64_t>> &epoch_history,
-                    utils::FileRetainer *file_retainer) {
+                    utils::FileRetainer *file_retainer, Config::Durability::Compression compression,
+                    bool use_io_uring) {
   // Ensure that the storage directory exists.
   utils::EnsureDirOrDie(snapshot_directory);
 
@@ -638,7 +639,8 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
   auto path = snapshot_directory / MakeSnapshotName(transaction->start_timestamp);
   spdlog::info("Starting snapshot creation to {}", path);
   Encoder snapshot;
-  snapshot.Initialize(path, kSnapshotMagic, kVersion);
+  snapshot.Initialize(path, kSnapshotMagic, kVersion, compression);
+  if (use_io_uring) snapshot.UseIoUring();
 
   // Write placeholder offsets.
   uint64_t offset_offsets = 0;
@@ -661,6 +663,9 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
     snapshot.WriteUint(offset_metadata);
   }
 
+  // Everything after the offsets is compressed if requested.
+  snapshot.StartCompression();
+
   // Object counters.
   uint64_t edges_count = 0;
   uint64_t vertices_count = 0;
@@ -70,6 +70,7 @@ void CreateSnapshot(Transaction *transaction, const std::filesystem::path &snaps
                     utils::SkipList<Vertex> *vertices, utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper,
                     Indices *indices, Constraints *constraints, Config::Items items, const std::string &uuid,
                     std::string_view epoch_id, const std::deque<std::pair<std::string, uint64_t>> &epoch_history,
-                    utils::FileRetainer *file_retainer);
+                    utils::FileRetainer *file_retainer, Config::Durability::Compression compression,
+                    bool use_io_uring);
 
 }  // namespace storage::durability
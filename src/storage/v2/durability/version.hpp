@@ -20,10 +20,16 @@ namespace storage::durability {
 // The current version of snapshot and WAL encoding / decoding.
 // IMPORTANT: Please bump this version for every snapshot and/or WAL format
 // change!!!
-const uint64_t kVersion{14};
+const uint64_t kVersion{16};
 
 const uint64_t kOldestSupportedVersion{14};
 const uint64_t kUniqueConstraintVersion{13};
+// WAL files written before this version store full names and fixed-size
+// integers in every delta.
+const uint64_t kCompactWalVersion{15};
+// Files written starting with this version have the compression type stored
+// right after the version.
+const uint64_t kCompressionVersion{16};
 
 // Magic values written to the start of a snapshot/WAL file to identify it.
 const std::string kSnapshotMagic{"MGsn"};
@@ -11,6 +11,8 @@
 
 #include "storage/v2/durability/wal.hpp"
 
+#include <memory>
+
 #include "storage/v2/delta.hpp"
 #include "storage/v2/durability/exceptions.hpp"
 #include "storage/v2/durability/paths.hpp"
@@ -19,6 +21,7 @@
 #include "storage/v2/vertex.hpp"
 #include "utils/file_locker.hpp"
 #include "utils/logging.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace storage::durability {
 
@@ -38,24 +41,24 @@ namespace storage::durability {
 //       file)
 //
 // 5) Encoded deltas; each delta is written in the following format:
-//     * commit timestamp
+//     * commit timestamp (varint)
 //     * action (only one of the actions below are encoded)
 //         * vertex create, vertex delete
-//              * gid
+//              * gid (varint)
 //         * vertex add label, vertex remove label
-//              * gid
+//              * gid (varint)
 //              * label name
 //         * vertex set property
-//              * gid
+//              * gid (varint)
 //              * property name
 //              * property value
 //         * edge create, edge delete
-//              * gid
+//              * gid (varint)
 //              * edge type name
-//              * from vertex gid
-//              * to vertex gid
+//              * from vertex gid (varint)
+//              * to vertex gid (varint)
 //         * edge set property
-//              * gid
+//              * gid (varint)
 //              * property name
 //              * property value
 //         * transaction end (marks that the whole transaction is
@@ -70,6 +73,12 @@ namespace storage::durability {
 //              * label name
 //              * property names
 //
+//    Names are written as a varint holding the name ID shifted left by one.
+//    The lowest bit is set when the name string follows the ID, that happens
+//    only the first time the name is used in the file, see `WalNameEncoder`.
+//    Files older than `kCompactWalVersion` store the full name string in place
+//    of each name and fixed-size integers in place of the varints.
+//
 // IMPORTANT: When changing WAL encoding/decoding bump the snapshot/WAL version
 // in `version.hpp`.
 
@@ -171,6 +180,7 @@ WalDeltaData::Type MarkerToWalDeltaDataType(Marker marker) {
     case Marker::TYPE_MAP:
     case Marker::TYPE_TEMPORAL_DATA:
     case Marker::TYPE_PROPERTY_VALUE:
+    case Marker::TYPE_VARINT:
     case Marker::SECTION_VERTEX:
     case Marker::SECTION_EDGE:
     case Marker::SECTION_MAPPER:
@@ -190,123 +200,87 @@ WalDeltaData::Type MarkerToWalDeltaDataType(Marker marker) {
 // delta header must be read before calling this function. If the delta data is
 // read then the data returned is valid, if the delta data is skipped then the
 // returned data is not guaranteed to be set (it could be empty) and shouldn't
-// be used.
+// be used. Names are always read because later deltas may refer to them.
 // @throw RecoveryFailure
 template <bool read_data>
-WalDeltaData ReadSkipWalDeltaData(BaseDecoder *decoder) {
+WalDeltaData ReadSkipWalDeltaData(BaseDecoder *decoder, WalNameDecoder *names) {
   WalDeltaData delta;
 
   auto action = decoder->ReadMarker();
   if (!action) throw RecoveryFailure("Invalid WAL data!");
   delta.type = MarkerToWalDeltaDataType(*action);
 
+  // Files older than `kCompactWalVersion` store gids as fixed-size integers.
+  auto read_gid = [decoder, compact = names->version() >= kCompactWalVersion] {
+    auto gid = compact ? decoder->ReadVarUint() : decoder->ReadUint();
+    if (!gid) throw RecoveryFailure("Invalid WAL data!");
+    return Gid::FromUint(*gid);
+  };
+  auto read_name = [names, decoder](std::string *name) {
+    const auto &read = names->Read(decoder);
+    if constexpr (read_data) {
+      *name = read;
+    }
+  };
+
   switch (delta.type) {
     case WalDeltaData::Type::VERTEX_CREATE:
     case WalDeltaData::Type::VERTEX_DELETE: {
-      auto gid = decoder->ReadUint();
-      if (!gid) throw RecoveryFailure("Invalid WAL data!");
-      delta.vertex_create_delete.gid = Gid::FromUint(*gid);
+      delta.vertex_create_delete.gid = read_gid();
       break;
     }
     case WalDeltaData::Type::VERTEX_ADD_LABEL:
     case WalDeltaData::Type::VERTEX_REMOVE_LABEL: {
-      auto gid = decoder->ReadUint();
-      if (!gid) throw RecoveryFailure("Invalid WAL data!");
-      delta.vertex_add_remove_label.gid = Gid::FromUint(*gid);
-      if constexpr (read_data) {
-        auto label = decoder->ReadString();
-        if (!label) throw RecoveryFailure("Invalid WAL data!");
-        delta.vertex_add_remove_label.label = std::move(*label);
-      } else {
-        if (!decoder->SkipString()) throw RecoveryFailure("Invalid WAL data!");
-      }
+      delta.vertex_add_remove_label.gid = read_gid();
+      read_name(&delta.vertex_add_remove_label.label);
       break;
     }
     case WalDeltaData::Type::VERTEX_SET_PROPERTY:
     case WalDeltaData::Type::EDGE_SET_PROPERTY: {
-      auto gid = decoder->ReadUint();
-      if (!gid) throw RecoveryFailure("Invalid WAL data!");
-      delta.vertex_edge_set_property.gid = Gid::FromUint(*gid);
+      delta.vertex_edge_set_property.gid = read_gid();
+      read_name(&delta.vertex_edge_set_property.property);
       if constexpr (read_data) {
-        auto property = decoder->ReadString();
-        if (!property) throw RecoveryFailure("Invalid WAL data!");
-        delta.vertex_edge_set_property.property = std::move(*property);
         auto value = decoder->ReadPropertyValue();
         if (!value) throw RecoveryFailure("Invalid WAL data!");
         delta.vertex_edge_set_property.value = std::move(*value);
       } else {
-        if (!decoder->SkipString() || !decoder->SkipPropertyValue()) throw RecoveryFailure("Invalid WAL data!");
+        if (!decoder->SkipPropertyValue()) throw RecoveryFailure("Invalid WAL data!");
       }
       break;
     }
     case WalDeltaData::Type::EDGE_CREATE:
     case WalDeltaData::Type::EDGE_DELETE: {
-      auto gid = decoder->ReadUint();
-      if (!gid) throw RecoveryFailure("Invalid WAL data!");
-      delta.edge_create_delete.gid = Gid::FromUint(*gid);
-      if constexpr (read_data) {
-        auto edge_type = decoder->ReadString();
-        if (!edge_type) throw RecoveryFailure("Invalid WAL data!");
-        delta.edge_create_delete.edge_type = std::move(*edge_type);
-      } else {
-        if (!decoder->SkipString()) throw RecoveryFailure("Invalid WAL data!");
-      }
-      auto from_gid = decoder->ReadUint();
-      if (!from_gid) throw RecoveryFailure("Invalid WAL data!");
-      delta.edge_create_delete.from_vertex = Gid::FromUint(*from_gid);
-      auto to_gid = decoder->ReadUint();
-      if (!to_gid) throw RecoveryFailure("Invalid WAL data!");
-      delta.edge_create_delete.to_vertex = Gid::FromUint(*to_gid);
+      delta.edge_create_delete.gid = read_gid();
+      read_name(&delta.edge_create_delete.edge_type);
+      delta.edge_create_delete.from_vertex = read_gid();
+      delta.edge_create_delete.to_vertex = read_gid();
       break;
     }
     case WalDeltaData::Type::TRANSACTION_END:
       break;
     case WalDeltaData::Type::LABEL_INDEX_CREATE:
     case WalDeltaData::Type::LABEL_INDEX_DROP: {
-      if constexpr (read_data) {
-        auto label = decoder->ReadString();
-        if (!label) throw RecoveryFailure("Invalid WAL data!");
-        delta.operation_label.label = std::move(*label);
-      } else {
-        if (!decoder->SkipString()) throw RecoveryFailure("Invalid WAL data!");
-      }
+      read_name(&delta.operation_label.label);
       break;
     }
     case WalDeltaData::Type::LABEL_PROPERTY_INDEX_CREATE:
     case WalDeltaData::Type::LABEL_PROPERTY_INDEX_DROP:
     case WalDeltaData::Type::EXISTENCE_CONSTRAINT_CREATE:
     case WalDeltaData::Type::EXISTENCE_CONSTRAINT_DROP: {
-      if constexpr (read_data) {
-        auto label = decoder->ReadString();
-        if (!label) throw RecoveryFailure("Invalid WAL data!");
-        delta.operation_label_property.label = std::move(*label);
-        auto property = decoder->ReadString();
-        if (!property) throw RecoveryFailure("Invalid WAL data!");
-        delta.operation_label_property.property = std::move(*property);
-      } else {
-        if (!decoder->SkipString() || !decoder->SkipString()) throw RecoveryFailure("Invalid WAL data!");
-      }
+      read_name(&delta.operation_label_property.label);
+      read_name(&delta.operation_label_property.property);
       break;
     }
     case WalDeltaData::Type::UNIQUE_CONSTRAINT_CREATE:
     case WalDeltaData::Type::UNIQUE_CONSTRAINT_DROP: {
-      if constexpr (read_data) {
-        auto label = decoder->ReadString();
-        if (!label) throw RecoveryFailure("Invalid WAL data!");
-        delta.operation_label_properties.label = std::move(*label);
-        auto properties_count = decoder->ReadUint();
-        if (!properties_count) throw RecoveryFailure("Invalid WAL data!");
-        for (uint64_t i = 0; i < *properties_count; ++i) {
-          auto property = decoder->ReadString();
-          if (!property) throw RecoveryFailure("Invalid WAL data!");
-          delta.operation_label_properties.properties.emplace(std::move(*property));
-        }
-      } else {
-        if (!decoder->SkipString()) throw RecoveryFailure("Invalid WAL data!");
-        auto properties_count = decoder->ReadUint();
-        if (!properties_count) throw RecoveryFailure("Invalid WAL data!");
-        for (uint64_t i = 0; i < *properties_count; ++i) {
-          if (!decoder->SkipString()) throw RecoveryFailure("Invalid WAL data!");
+      read_name(&delta.operation_label_properties.label);
+      auto properties_count = decoder->ReadUint();
+      if (!properties_count) throw RecoveryFailure("Invalid WAL data!");
+      for (uint64_t i = 0; i < *properties_count; ++i) {
+        std::string property;
+        read_name(&property);
+        if constexpr (read_data) {
+          delta.operation_label_properties.properties.emplace(std::move(property));
         }
       }
     }
@@ -317,6 +291,41 @@ WalDeltaData ReadSkipWalDeltaData(BaseDecoder *decoder) {
 
 }  // namespace
 
+void WalNameEncoder::Write(BaseEncoder *encoder, uint64_t id) {
+  if (id >= written_.size()) written_.resize(id + 1, false);
+  if (written_[id]) {
+    encoder->WriteVarUint(id << 1U);
+    return;
+  }
+  encoder->WriteVarUint((id << 1U) | 1U);
+  encoder->WriteString(name_id_mapper_->IdToName(id));
+  written_[id] = true;
+}
+
+const std::string &WalNameDecoder::Read(BaseDecoder *decoder) {
+  if (version_ < kCompactWalVersion) {
+    auto name = decoder->ReadString();
+    if (!name) throw RecoveryFailure("Invalid WAL data!");
+    legacy_name_ = std::move(*name);
+    return legacy_name_;
+  }
+  auto value = decoder->ReadVarUint();
+  if (!value) throw RecoveryFailure("Invalid WAL data!");
+  auto id = *value >> 1U;
+  if (*value & 1U) {
+    auto name = decoder->ReadString();
+    if (!name) throw RecoveryFailure("Invalid WAL data!");
+    // A WAL file that is continued by another writer (e.g. a replica) may
+    // assign a different name to an ID that was already used.
+    auto &stored = names_[id];
+    stored = std::move(*name);
+    return stored;
+  }
+  auto found = names_.find(id);
+  if (found == names_.end()) throw RecoveryFailure("Invalid WAL data!");
+  return found->second;
+}
+
 // Function used to read information about the WAL file.
 WalInfo ReadWalInfo(const std::filesystem::path &path) {
   // Check magic and version.
@@ -370,10 +379,11 @@ WalInfo ReadWalInfo(const std::filesystem::path &path) {
 
   // Read deltas.
   info.num_deltas = 0;
-  auto validate_delta = [&wal]() -> std::optional<std::pair<uint64_t, bool>> {
+  WalNameDecoder names(*version);
+  auto validate_delta = [&wal, &names]() -> std::optional<std::pair<uint64_t, bool>> {
     try {
-      auto timestamp = ReadWalDeltaHeader(&wal);
-      auto type = SkipWalDeltaData(&wal);
+      auto timestamp = ReadWalDeltaHeader(&wal, names.version());
+      auto type = SkipWalDeltaData(&wal, &names);
       return {{timestamp, IsWalDeltaDataTypeTransactionEnd(type)}};
     } catch (const RecoveryFailure &) {
       return std::nullopt;
@@ -462,45 +472,47 @@ bool operator!=(const WalDeltaData &a, const WalDeltaData &b) { return !(a == b)
 
 // Function used to read the WAL delta header. The function returns the delta
 // timestamp.
-uint64_t ReadWalDeltaHeader(BaseDecoder *decoder) {
+uint64_t ReadWalDeltaHeader(BaseDecoder *decoder, uint64_t version) {
   auto marker = decoder->ReadMarker();
   if (!marker || *marker != Marker::SECTION_DELTA) throw RecoveryFailure("Invalid WAL data!");
 
-  auto timestamp = decoder->ReadUint();
+  auto timestamp = version >= kCompactWalVersion ? decoder->ReadVarUint() : decoder->ReadUint();
   if (!timestamp) throw RecoveryFailure("Invalid WAL data!");
   return *timestamp;
 }
 
 // Function used to read the current WAL delta data. The WAL delta header must
 // be read before calling this function.
-WalDeltaData ReadWalDeltaData(BaseDecoder *decoder) { return ReadSkipWalDeltaData<true>(decoder); }
+WalDeltaData ReadWalDeltaData(BaseDecoder *decoder, WalNameDecoder *names) {
+  return ReadSkipWalDeltaData<true>(decoder, names);
+}
 
 // Function used to skip the current WAL delta data. The WAL delta header must
 // be read before calling this function.
-WalDeltaData::Type SkipWalDeltaData(BaseDecoder *decoder) {
-  auto delta = ReadSkipWalDeltaData<false>(decoder);
+WalDeltaData::Type SkipWalDeltaData(BaseDecoder *decoder, WalNameDecoder *names) {
+  auto delta = ReadSkipWalDeltaData<false>(decoder, names);
   return delta.type;
 }
 
-void EncodeDelta(BaseEncoder *encoder, NameIdMapper *name_id_mapper, Config::Items items, const Delta &delta,
+void EncodeDelta(BaseEncoder *encoder, WalNameEncoder *names, Config::Items items, const Delta &delta,
                  const Vertex &vertex, uint64_t timestamp) {
   // When converting a Delta to a WAL delta the logic is inverted. That is
   // because the Delta's represent undo actions and we want to store redo
   // actions.
   encoder->WriteMarker(Marker::SECTION_DELTA);
-  encoder->WriteUint(timestamp);
+  encoder->WriteVarUint(timestamp);
   std::lock_guard<utils::SpinLock> guard(vertex.lock);
   switch (delta.action) {
     case Delta::Action::DELETE_OBJECT:
     case Delta::Action::RECREATE_OBJECT: {
       encoder->WriteMarker(VertexActionToMarker(delta.action));
-      encoder->WriteUint(vertex.gid.AsUint());
+      encoder->WriteVarUint(vertex.gid.AsUint());
       break;
     }
     case Delta::Action::SET_PROPERTY: {
       encoder->WriteMarker(Marker::DELTA_VERTEX_SET_PROPERTY);
-      encoder->WriteUint(vertex.gid.AsUint());
-      encoder->WriteString(name_id_mapper->IdToName(delta.property.key.AsUint()));
+      encoder->WriteVarUint(vertex.gid.AsUint());
+      names->Write(encoder, delta.property.key.AsUint());
       // The property value is the value that is currently stored in the
       // vertex.
       // TODO (mferencevic): Mitigate the memory allocation introduced here
@@ -512,21 +524,21 @@ void EncodeDelta(BaseEncoder *encoder, NameIdMapper *name_id_mapper, Config::Ite
     case Delta::Action::ADD_LABEL:
     case Delta::Action::REMOVE_LABEL: {
       encoder->WriteMarker(VertexActionToMarker(delta.action));
-      encoder->WriteUint(vertex.gid.AsUint());
-      encoder->WriteString(name_id_mapper->IdToName(delta.label.AsUint()));
+      encoder->WriteVarUint(vertex.gid.AsUint());
+      names->Write(encoder, delta.label.AsUint());
       break;
     }
     case Delta::Action::ADD_OUT_EDGE:
     case Delta::Action::REMOVE_OUT_EDGE: {
       encoder->WriteMarker(VertexActionToMarker(delta.action));
       if (items.properties_on_edges) {
-        encoder->WriteUint(delta.vertex_edge.edge.ptr->gid.AsUint());
+        encoder->WriteVarUint(delta.vertex_edge.edge.ptr->gid.AsUint());
       } else {
-        encoder->WriteUint(delta.vertex_edge.edge.gid.AsUint());
+        encoder->WriteVarUint(delta.vertex_edge.edge.gid.AsUint());
       }
-      encoder->WriteString(name_id_mapper->IdToName(delta.vertex_edge.edge_type.AsUint()));
-      encoder->WriteUint(vertex.gid.AsUint());
-      encoder->WriteUint(delta.vertex_edge.vertex->gid.AsUint());
+      names->Write(encoder, delta.vertex_edge.edge_type.AsUint());
+      encoder->WriteVarUint(vertex.gid.AsUint());
+      encoder->WriteVarUint(delta.vertex_edge.vertex->gid.AsUint());
       break;
     }
     case Delta::Action::ADD_IN_EDGE:
@@ -537,19 +549,19 @@ void EncodeDelta(BaseEncoder *encoder, NameIdMapper *name_id_mapper, Config::Ite
   }
 }
 
-void EncodeDelta(BaseEncoder *encoder, NameIdMapper *name_id_mapper, const Delta &delta, const Edge &edge,
+void EncodeDelta(BaseEncoder *encoder, WalNameEncoder *names, const Delta &delta, const Edge &edge,
                  uint64_t timestamp) {
   // When converting a Delta to a WAL delta the logic is inverted. That is
   // because the Delta's represent undo actions and we want to store redo
   // actions.
   encoder->WriteMarker(Marker::SECTION_DELTA);
-  encoder->WriteUint(timestamp);
+  encoder->WriteVarUint(timestamp);
   std::lock_guard<utils::SpinLock> guard(edge.lock);
   switch (delta.action) {
     case Delta::Action::SET_PROPERTY: {
       encoder->WriteMarker(Marker::DELTA_EDGE_SET_PROPERTY);
-      encoder->WriteUint(edge.gid.AsUint());
-      encoder->WriteString(name_id_mapper->IdToName(delta.property.key.AsUint()));
+      encoder->WriteVarUint(edge.gid.AsUint());
+      names->Write(encoder, delta.property.key.AsUint());
       // The property value is the value that is currently stored in the
       // edge.
       // TODO (mferencevic): Mitigate the memory allocation introduced here
@@ -578,20 +590,20 @@ void EncodeDelta(BaseEncoder *encoder, NameIdMapper *name_id_mapper, const Delta
 
 void EncodeTransactionEnd(BaseEncoder *encoder, uint64_t timestamp) {
   encoder->WriteMarker(Marker::SECTION_DELTA);
-  encoder->WriteUint(timestamp);
+  encoder->WriteVarUint(timestamp);
   encoder->WriteMarker(Marker::DELTA_TRANSACTION_END);
 }
 
-void EncodeOperation(BaseEncoder *encoder, NameIdMapper *name_id_mapper, StorageGlobalOperation operation,
-                     LabelId label, const std::set<PropertyId> &properties, uint64_t timestamp) {
+void EncodeOperation(BaseEncoder *encoder, WalNameEncoder *names, StorageGlobalOperation operation, LabelId label,
+                     const std::set<PropertyId> &properties, uint64_t timestamp) {
   encoder->WriteMarker(Marker::SECTION_DELTA);
-  encoder->WriteUint(timestamp);
+  encoder->WriteVarUint(timestamp);
   switch (operation) {
     case StorageGlobalOperation::LABEL_INDEX_CREATE:
     case StorageGlobalOperation::LABEL_INDEX_DROP: {
       MG_ASSERT(properties.empty(), "Invalid function call!");
       encoder->WriteMarker(OperationToMarker(operation));
-      encoder->WriteString(name_id_mapper->IdToName(label.AsUint()));
+      names->Write(encoder, label.AsUint());
       break;
     }
     case StorageGlobalOperation::LABEL_PROPERTY_INDEX_CREATE:
@@ -600,24 +612,294 @@ void EncodeOperation(BaseEncoder *encoder, NameIdMapper *name_id_mapper, Storage
     case StorageGlobalOperation::EXISTENCE_CONSTRAINT_DROP: {
       MG_ASSERT(properties.size() == 1, "Invalid function call!");
       encoder->WriteMarker(OperationToMarker(operation));
-      encoder->WriteString(name_id_mapper->IdToName(label.AsUint()));
-      encoder->WriteString(name_id_mapper->IdToName((*properties.begin()).AsUint()));
+      names->Write(encoder, label.AsUint());
+      names->Write(encoder, (*properties.begin()).AsUint());
       break;
     }
     case StorageGlobalOperation::UNIQUE_CONSTRAINT_CREATE:
     case StorageGlobalOperation::UNIQUE_CONSTRAINT_DROP: {
       MG_ASSERT(!properties.empty(), "Invalid function call!");
       encoder->WriteMarker(OperationToMarker(operation));
-      encoder->WriteString(name_id_mapper->IdToName(label.AsUint()));
+      names->Write(encoder, label.AsUint());
       encoder->WriteUint(properties.size());
       for (const auto &property : properties) {
-        encoder->WriteString(name_id_mapper->IdToName(property.AsUint()));
+        names->Write(encoder, property.AsUint());
       }
       break;
     }
   }
 }
 
+namespace {
+// Deltas are loaded in chunks when the WAL is replayed in parallel so that
+// the decoded deltas of a huge WAL file don't have to fit into memory.
+constexpr uint64_t kParallelRecoveryChunkSize = 100000;
+
+void RecoverLabelDelta(Vertex *vertex, const WalDeltaData &delta, NameIdMapper *name_id_mapper) {
+  auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.vertex_add_remove_label.label));
+  auto it = std::find(vertex->labels.begin(), vertex->labels.end(), label_id);
+
+  if (delta.type == WalDeltaData::Type::VERTEX_ADD_LABEL) {
+    if (it != vertex->labels.end()) throw RecoveryFailure("The vertex already has the label!");
+    vertex->labels.push_back(label_id);
+  } else {
+    if (it == vertex->labels.end()) throw RecoveryFailure("The vertex doesn't have the label!");
+    std::swap(*it, vertex->labels.back());
+    vertex->labels.pop_back();
+  }
+}
+
+// Indices and constraints are only collected here, they are created after all
+// of the data is recovered.
+void RecoverIndexConstraintDelta(const WalDeltaData &delta, RecoveredIndicesAndConstraints *indices_constraints,
+                                 NameIdMapper *name_id_mapper) {
+  switch (delta.type) {
+    case WalDeltaData::Type::LABEL_INDEX_CREATE: {
+      auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label.label));
+      AddRecoveredIndexConstraint(&indices_constraints->indices.label, label_id, "The label index already exists!");
+      break;
+    }
+    case WalDeltaData::Type::LABEL_INDEX_DROP: {
+      auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label.label));
+      RemoveRecoveredIndexConstraint(&indices_constraints->indices.label, label_id, "The label index doesn't exist!");
+      break;
+    }
+    case WalDeltaData::Type::LABEL_PROPERTY_INDEX_CREATE: {
+      auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
+      auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
+      AddRecoveredIndexConstraint(&indices_constraints->indices.label_property, {label_id, property_id},
+                                  "The label property index already exists!");
+      break;
+    }
+    case WalDeltaData::Type::LABEL_PROPERTY_INDEX_DROP: {
+      auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
+      auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
+      RemoveRecoveredIndexConstraint(&indices_constraints->indices.label_property, {label_id, property_id},
+                                     "The label property index doesn't exist!");
+      break;
+    }
+    case WalDeltaData::Type::EXISTENCE_CONSTRAINT_CREATE: {
+      auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
+      auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
+      AddRecoveredIndexConstraint(&indices_constraints->constraints.existence, {label_id, property_id},
+                                  "The existence constraint already exists!");
+      break;
+    }
+    case WalDeltaData::Type::EXISTENCE_CONSTRAINT_DROP: {
+      auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
+      auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
+      RemoveRecoveredIndexConstraint(&indices_constraints->constraints.existence, {label_id, property_id},
+                                     "The existence constraint doesn't exist!");
+      break;
+    }
+    case WalDeltaData::Type::UNIQUE_CONSTRAINT_CREATE: {
+      auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_properties.label));
+      std::set<PropertyId> property_ids;
+      for (const auto &prop : delta.operation_label_properties.properties) {
+        property_ids.insert(PropertyId::FromUint(name_id_mapper->NameToId(prop)));
+      }
+      AddRecoveredIndexConstraint(&indices_constraints->constraints.unique, {label_id, property_ids},
+                                  "The unique constraint already exists!");
+      break;
+    }
+    case WalDeltaData::Type::UNIQUE_CONSTRAINT_DROP: {
+      auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_properties.label));
+      std::set<PropertyId> property_ids;
+      for (const auto &prop : delta.operation_label_properties.properties) {
+        property_ids.insert(PropertyId::FromUint(name_id_mapper->NameToId(prop)));
+      }
+      RemoveRecoveredIndexConstraint(&indices_constraints->constraints.unique, {label_id, property_ids},
+                                     "The unique constraint doesn't exist!");
+      break;
+    }
+    case WalDeltaData::Type::VERTEX_CREATE:
+    case WalDeltaData::Type::VERTEX_DELETE:
+    case WalDeltaData::Type::VERTEX_ADD_LABEL:
+    case WalDeltaData::Type::VERTEX_REMOVE_LABEL:
+    case WalDeltaData::Type::VERTEX_SET_PROPERTY:
+    case WalDeltaData::Type::EDGE_CREATE:
+    case WalDeltaData::Type::EDGE_DELETE:
+    case WalDeltaData::Type::EDGE_SET_PROPERTY:
+    case WalDeltaData::Type::TRANSACTION_END:
+      LOG_FATAL("The WAL delta doesn't change indices or constraints!");
+  }
+}
+
+// Applies a chunk of WAL deltas using `thread_count` workers. Every vertex is
+// owned by a single worker (chosen by its gid) that applies all changes of the
+// vertex in WAL order. Edge creation and deletion is split into the change of
+// the from vertex and the change of the to vertex so that each part is applied
+// by the owner of that vertex, edge properties are owned by the edge gid.
+// Because gids are never reused, all vertices and edges can be created before
+// and removed after all other changes of the chunk, so the workers never have
+// to wait for each other.
+void ApplyWalDeltaChunk(const std::vector<std::pair<uint64_t, WalDeltaData>> &chunk,
+                        RecoveredIndicesAndConstraints *indices_constraints, utils::SkipList<Vertex> *vertices,
+                        utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper,
+                        std::atomic<uint64_t> *edge_count, Config::Items items, utils::ThreadPool *pool,
+                        uint64_t thread_count, RecoveryInfo *ret) {
+  std::vector<std::vector<const WalDeltaData *>> created(thread_count);
+  std::vector<std::vector<const WalDeltaData *>> removed(thread_count);
+  // The flag is set for the change of the from vertex of an edge.
+  std::vector<std::vector<std::pair<const WalDeltaData *, bool>>> changes(thread_count);
+  auto owner = [thread_count](Gid gid) { return gid.AsUint() % thread_count; };
+
+  for (const auto &[timestamp, delta] : chunk) {
+    switch (delta.type) {
+      case WalDeltaData::Type::VERTEX_CREATE:
+        created[owner(delta.vertex_create_delete.gid)].push_back(&delta);
+        ret->next_vertex_id = std::max(ret->next_vertex_id, delta.vertex_create_delete.gid.AsUint() + 1);
+        break;
+      case WalDeltaData::Type::VERTEX_DELETE:
+        removed[owner(delta.vertex_create_delete.gid)].push_back(&delta);
+        break;
+      case WalDeltaData::Type::VERTEX_ADD_LABEL:
+      case WalDeltaData::Type::VERTEX_REMOVE_LABEL:
+        changes[owner(delta.vertex_add_remove_label.gid)].emplace_back(&delta, false);
+        break;
+      case WalDeltaData::Type::VERTEX_SET_PROPERTY:
+      case WalDeltaData::Type::EDGE_SET_PROPERTY:
+        if (delta.type == WalDeltaData::Type::EDGE_SET_PROPERTY && !items.properties_on_edges)
+          throw RecoveryFailure(
+              "The WAL has properties on edges, but the storage is "
+              "configured without properties on edges!");
+        changes[owner(delta.vertex_edge_set_property.gid)].emplace_back(&delta, false);
+        break;
+      case WalDeltaData::Type::EDGE_CREATE:
+      case WalDeltaData::Type::EDGE_DELETE:
+        changes[owner(delta.edge_create_delete.from_vertex)].emplace_back(&delta, true);
+        changes[owner(delta.edge_create_delete.to_vertex)].emplace_back(&delta, false);
+        if (items.properties_on_edges) {
+          auto &objects = delta.type == WalDeltaData::Type::EDGE_CREATE ? created : removed;
+          objects[owner(delta.edge_create_delete.gid)].push_back(&delta);
+        }
+        if (delta.type == WalDeltaData::Type::EDGE_CREATE) {
+          ret->next_edge_id = std::max(ret->next_edge_id, delta.edge_create_delete.gid.AsUint() + 1);
+        }
+        break;
+      case WalDeltaData::Type::TRANSACTION_END:
+        break;
+      case WalDeltaData::Type::LABEL_INDEX_CREATE:
+      case WalDeltaData::Type::LABEL_INDEX_DROP:
+      case WalDeltaData::Type::LABEL_PROPERTY_INDEX_CREATE:
+      case WalDeltaData::Type::LABEL_PROPERTY_INDEX_DROP:
+      case WalDeltaData::Type::EXISTENCE_CONSTRAINT_CREATE:
+      case WalDeltaData::Type::EXISTENCE_CONSTRAINT_DROP:
+      case WalDeltaData::Type::UNIQUE_CONSTRAINT_CREATE:
+      case WalDeltaData::Type::UNIQUE_CONSTRAINT_DROP:
+        RecoverIndexConstraintDelta(delta, indices_constraints, name_id_mapper);
+        break;
+    }
+    ret->next_timestamp = std::max(ret->next_timestamp, timestamp + 1);
+  }
+
+  utils::RunOnThreads(pool, thread_count, [&](uint64_t worker) {
+    auto vertex_acc = vertices->access();
+    auto edge_acc = edges->access();
+    for (const auto *delta : created[worker]) {
+      if (delta->type == WalDeltaData::Type::VERTEX_CREATE) {
+        auto [vertex, inserted] = vertex_acc.insert(Vertex{delta->vertex_create_delete.gid, nullptr});
+        if (!inserted) throw RecoveryFailure("The vertex must be inserted here!");
+      } else {
+        auto [edge, inserted] = edge_acc.insert(Edge{delta->edge_create_delete.gid, nullptr});
+        if (!inserted) throw RecoveryFailure("The edge must be inserted here!");
+      }
+    }
+  });
+
+  utils::RunOnThreads(pool, thread_count, [&](uint64_t worker) {
+    auto vertex_acc = vertices->access();
+    auto edge_acc = edges->access();
+    for (const auto &[delta, is_from_vertex] : changes[worker]) {
+      switch (delta->type) {
+        case WalDeltaData::Type::VERTEX_ADD_LABEL:
+        case WalDeltaData::Type::VERTEX_REMOVE_LABEL: {
+          auto vertex = vertex_acc.find(delta->vertex_add_remove_label.gid);
+          if (vertex == vertex_acc.end()) throw RecoveryFailure("The vertex doesn't exist!");
+          RecoverLabelDelta(&*vertex, *delta, name_id_mapper);
+          break;
+        }
+        case WalDeltaData::Type::VERTEX_SET_PROPERTY: {
+          auto vertex = vertex_acc.find(delta->vertex_edge_set_property.gid);
+          if (vertex == vertex_acc.end()) throw RecoveryFailure("The vertex doesn't exist!");
+          auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta->vertex_edge_set_property.property));
+          vertex->properties.SetProperty(property_id, delta->vertex_edge_set_property.value);
+          break;
+        }
+        case WalDeltaData::Type::EDGE_SET_PROPERTY: {
+          auto edge = edge_acc.find(delta->vertex_edge_set_property.gid);
+          if (edge == edge_acc.end()) throw RecoveryFailure("The edge doesn't exist!");
+          auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta->vertex_edge_set_property.property));
+          edge->properties.SetProperty(property_id, delta->vertex_edge_set_property.value);
+          break;
+        }
+        case WalDeltaData::Type::EDGE_CREATE:
+        case WalDeltaData::Type::EDGE_DELETE: {
+          auto from_vertex = vertex_acc.find(delta->edge_create_delete.from_vertex);
+          if (from_vertex == vertex_acc.end()) throw RecoveryFailure("The from vertex doesn't exist!");
+          auto to_vertex = vertex_acc.find(delta->edge_create_delete.to_vertex);
+          if (to_vertex == vertex_acc.end()) throw RecoveryFailure("The to vertex doesn't exist!");
+
+          auto edge_gid = delta->edge_create_delete.gid;
+          auto edge_type_id = EdgeTypeId::FromUint(name_id_mapper->NameToId(delta->edge_create_delete.edge_type));
+          EdgeRef edge_ref(edge_gid);
+          if (items.properties_on_edges) {
+            auto edge = edge_acc.find(edge_gid);
+            if (edge == edge_acc.end()) throw RecoveryFailure("The edge doesn't exist!");
+            edge_ref = EdgeRef(&*edge);
+          }
+          auto &vertex_edges = is_from_vertex ? from_vertex->out_edges : to_vertex->in_edges;
+          std::tuple<EdgeTypeId, Vertex *, EdgeRef> link{edge_type_id, is_from_vertex ? &*to_vertex : &*from_vertex,
+                                                         edge_ref};
+          auto it = std::find(vertex_edges.begin(), vertex_edges.end(), link);
+          if (delta->type == WalDeltaData::Type::EDGE_CREATE) {
+            if (it != vertex_edges.end()) throw RecoveryFailure("The vertex already has this edge!");
+            vertex_edges.push_back(link);
+            if (is_from_vertex) edge_count->fetch_add(1, std::memory_order_acq_rel);
+          } else {
+            if (it == vertex_edges.end()) throw RecoveryFailure("The vertex doesn't have this edge!");
+            std::swap(*it, vertex_edges.back());
+            vertex_edges.pop_back();
+            if (is_from_vertex) edge_count->fetch_add(-1, std::memory_order_acq_rel);
+          }
+          break;
+        }
+        case WalDeltaData::Type::VERTEX_CREATE:
+        case WalDeltaData::Type::VERTEX_DELETE:
+        case WalDeltaData::Type::TRANSACTION_END:
+        case WalDeltaData::Type::LABEL_INDEX_CREATE:
+        case WalDeltaData::Type::LABEL_INDEX_DROP:
+        case WalDeltaData::Type::LABEL_PROPERTY_INDEX_CREATE:
+        case WalDeltaData::Type::LABEL_PROPERTY_INDEX_DROP:
+        case WalDeltaData::Type::EXISTENCE_CONSTRAINT_CREATE:
+        case WalDeltaData::Type::EXISTENCE_CONSTRAINT_DROP:
+        case WalDeltaData::Type::UNIQUE_CONSTRAINT_CREATE:
+        case WalDeltaData::Type::UNIQUE_CONSTRAINT_DROP:
+          LOG_FATAL("The WAL delta isn't applied by the workers!");
+      }
+    }
+  });
+
+  utils::RunOnThreads(pool, thread_count, [&](uint64_t worker) {
+    auto vertex_acc = vertices->access();
+    auto edge_acc = edges->access();
+    for (const auto *delta : removed[worker]) {
+      if (delta->type == WalDeltaData::Type::VERTEX_DELETE) {
+        auto vertex = vertex_acc.find(delta->vertex_create_delete.gid);
+        if (vertex == vertex_acc.end()) throw RecoveryFailure("The vertex doesn't exist!");
+        if (!vertex->in_edges.empty() || !vertex->out_edges.empty())
+          throw RecoveryFailure("The vertex can't be deleted because it still has edges!");
+        if (!vertex_acc.remove(delta->vertex_create_delete.gid))
+          throw RecoveryFailure("The vertex must be removed here!");
+      } else {
+        if (!edge_acc.remove(delta->edge_create_delete.gid)) throw RecoveryFailure("The edge must be removed here!");
+      }
+    }
+  });
+}
+
+}  // namespace
+
 RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConstraints *indices_constraints,
                      const std::optional<uint64_t> last_loaded_timestamp, utils::SkipList<Vertex> *vertices,
                      utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count,
@@ -643,16 +925,17 @@ RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConst
   // Recover deltas.
   wal.SetPosition(info.offset_deltas);
   uint64_t deltas_applied = 0;
+  WalNameDecoder names(*version);
   auto edge_acc = edges->access();
   auto vertex_acc = vertices->access();
   spdlog::info("WAL file contains {} deltas.", info.num_deltas);
   for (uint64_t i = 0; i < info.num_deltas; ++i) {
     // Read WAL delta header to find out the delta timestamp.
-    auto timestamp = ReadWalDeltaHeader(&wal);
+    auto timestamp = ReadWalDeltaHeader(&wal, *version);
 
     if (!last_loaded_timestamp || timestamp > *last_loaded_timestamp) {
       // This delta should be loaded.
-      auto delta = ReadWalDeltaData(&wal);
+      auto delta = ReadWalDeltaData(&wal, &names);
       switch (delta.type) {
         case WalDeltaData::Type::VERTEX_CREATE: {
           auto [vertex, inserted] = vertex_acc.insert(Vertex{delta.vertex_create_delete.gid, nullptr});
@@ -678,17 +961,7 @@ RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConst
           auto vertex = vertex_acc.find(delta.vertex_add_remove_label.gid);
           if (vertex == vertex_acc.end()) throw RecoveryFailure("The vertex doesn't exist!");
 
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.vertex_add_remove_label.label));
-          auto it = std::find(vertex->labels.begin(), vertex->labels.end(), label_id);
-
-          if (delta.type == WalDeltaData::Type::VERTEX_ADD_LABEL) {
-            if (it != vertex->labels.end()) throw RecoveryFailure("The vertex already has the label!");
-            vertex->labels.push_back(label_id);
-          } else {
-            if (it == vertex->labels.end()) throw RecoveryFailure("The vertex doesn't have the label!");
-            std::swap(*it, vertex->labels.back());
-            vertex->labels.pop_back();
-          }
+          RecoverLabelDelta(&*vertex, delta, name_id_mapper);
 
           break;
         }
@@ -788,71 +1061,22 @@ RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConst
         }
         case WalDeltaData::Type::TRANSACTION_END:
           break;
-        case WalDeltaData::Type::LABEL_INDEX_CREATE: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label.label));
-          AddRecoveredIndexConstraint(&indices_constraints->indices.label, label_id, "The label index already exists!");
-          break;
-        }
-        case WalDeltaData::Type::LABEL_INDEX_DROP: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label.label));
-          RemoveRecoveredIndexConstraint(&indices_constraints->indices.label, label_id,
-                                         "The label index doesn't exist!");
-          break;
-        }
-        case WalDeltaData::Type::LABEL_PROPERTY_INDEX_CREATE: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
-          auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
-          AddRecoveredIndexConstraint(&indices_constraints->indices.label_property, {label_id, property_id},
-                                      "The label property index already exists!");
-          break;
-        }
-        case WalDeltaData::Type::LABEL_PROPERTY_INDEX_DROP: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
-          auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
-          RemoveRecoveredIndexConstraint(&indices_constraints->indices.label_property, {label_id, property_id},
-                                         "The label property index doesn't exist!");
+        case WalDeltaData::Type::LABEL_INDEX_CREATE:
+        case WalDeltaData::Type::LABEL_INDEX_DROP:
+        case WalDeltaData::Type::LABEL_PROPERTY_INDEX_CREATE:
+        case WalDeltaData::Type::LABEL_PROPERTY_INDEX_DROP:
+        case WalDeltaData::Type::EXISTENCE_CONSTRAINT_CREATE:
+        case WalDeltaData::Type::EXISTENCE_CONSTRAINT_DROP:
+        case WalDeltaData::Type::UNIQUE_CONSTRAINT_CREATE:
+        case WalDeltaData::Type::UNIQUE_CONSTRAINT_DROP:
+          RecoverIndexConstraintDelta(delta, indices_constraints, name_id_mapper);
           break;
-        }
-        case WalDeltaData::Type::EXISTENCE_CONSTRAINT_CREATE: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
-          auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
-          AddRecoveredIndexConstraint(&indices_constraints->constraints.existence, {label_id, property_id},
-                                      "The existence constraint already exists!");
-          break;
-        }
-        case WalDeltaData::Type::EXISTENCE_CONSTRAINT_DROP: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.label));
-          auto property_id = PropertyId::FromUint(name_id_mapper->NameToId(delta.operation_label_property.property));
-          RemoveRecoveredIndexConstraint(&indices_constraints->constraints.existence, {label_id, property_id},
-                                         "The existence constraint doesn't exist!");
-          break;
-        }
-        case WalDeltaData::Type::UNIQUE_CONSTRAINT_CREATE: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_properties.label));
-          std::set<PropertyId> property_ids;
-          for (const auto &prop : delta.operation_label_properties.properties) {
-            property_ids.insert(PropertyId::FromUint(name_id_mapper->NameToId(prop)));
-          }
-          AddRecoveredIndexConstraint(&indices_constraints->constraints.unique, {label_id, property_ids},
-                                      "The unique constraint already exists!");
-          break;
-        }
-        case WalDeltaData::Type::UNIQUE_CONSTRAINT_DROP: {
-          auto label_id = LabelId::FromUint(name_id_mapper->NameToId(delta.operation_label_properties.label));
-          std::set<PropertyId> property_ids;
-          for (const auto &prop : delta.operation_label_properties.properties) {
-            property_ids.insert(PropertyId::FromUint(name_id_mapper->NameToId(prop)));
-          }
-          RemoveRecoveredIndexConstraint(&indices_constraints->constraints.unique, {label_id, property_ids},
-                                         "The unique constraint doesn't exist!");
-          break;
-        }
       }
       ret.next_timestamp = std::max(ret.next_timestamp, timestamp + 1);
       ++deltas_applied;
     } else {
       // This delta should be skipped.
-      SkipWalDeltaData(&wal);
+      SkipWalDeltaData(&wal, &names);
     }
   }
 
@@ -862,11 +1086,110 @@ RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConst
   return ret;
 }
 
+ParallelWalLoader::ParallelWalLoader(std::vector<std::filesystem::path> paths,
+                                     std::optional<uint64_t> last_loaded_timestamp, uint64_t next_timestamp,
+                                     utils::ThreadPool *pool, uint64_t thread_count)
+    : paths_(std::move(paths)),
+      pool_(pool),
+      thread_count_(thread_count),
+      last_loaded_timestamp_(last_loaded_timestamp),
+      next_timestamp_(next_timestamp) {
+  ScheduleRead();
+}
+
+ParallelWalLoader::~ParallelWalLoader() {
+  // The pending read uses the decoders of this loader.
+  if (next_chunk_.valid()) next_chunk_.wait();
+}
+
+RecoveryInfo ParallelWalLoader::LoadNext(RecoveredIndicesAndConstraints *indices_constraints,
+                                         utils::SkipList<Vertex> *vertices, utils::SkipList<Edge> *edges,
+                                         NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count,
+                                         Config::Items items) {
+  MG_ASSERT(next_chunk_.valid(), "There is no WAL file left to load!");
+  spdlog::info("Trying to load WAL file {} using {} threads.", paths_[loaded_file_], thread_count_);
+  RecoveryInfo ret;
+  uint64_t deltas_applied = 0;
+  while (true) {
+    auto chunk = next_chunk_.get();
+    // The next chunk, which can already belong to the next WAL file, is
+    // decoded while this one is applied.
+    ScheduleRead();
+    if (!chunk.deltas.empty()) {
+      ApplyWalDeltaChunk(chunk.deltas, indices_constraints, vertices, edges, name_id_mapper, edge_count, items, pool_,
+                         thread_count_, &ret);
+      deltas_applied += chunk.deltas.size();
+    }
+    if (!chunk.last) continue;
+
+    ++loaded_file_;
+    ret.last_commit_timestamp = chunk.to_timestamp;
+    if (chunk.skipped) {
+      spdlog::info("Skip loading WAL file because it is too old.");
+    } else {
+      spdlog::info("Applied {} deltas from WAL. Skipped {} deltas, because they were too old.", deltas_applied,
+                   chunk.num_deltas - deltas_applied);
+    }
+    return ret;
+  }
+}
+
+void ParallelWalLoader::ScheduleRead() {
+  if (read_file_ == paths_.size()) return;
+  auto task = std::make_shared<std::packaged_task<Chunk()>>([this] { return ReadChunk(); });
+  next_chunk_ = task->get_future();
+  pool_->AddTask([task] { (*task)(); });
+}
+
+ParallelWalLoader::Chunk ParallelWalLoader::ReadChunk() {
+  Chunk chunk;
+  if (!wal_) {
+    const auto &path = paths_[read_file_];
+    wal_.emplace();
+    auto version = wal_->Initialize(path, kWalMagic);
+    if (!version) throw RecoveryFailure("Couldn't read WAL magic and/or version!");
+    if (!IsVersionSupported(*version)) throw RecoveryFailure("Invalid WAL version!");
+    info_ = ReadWalInfo(path);
+    deltas_read_ = 0;
+    if (last_loaded_timestamp_ && info_.to_timestamp <= *last_loaded_timestamp_) {
+      chunk.skipped = true;
+      deltas_read_ = info_.num_deltas;
+    } else {
+      wal_->SetPosition(info_.offset_deltas);
+      names_.emplace(*version);
+    }
+  }
+
+  while (deltas_read_ < info_.num_deltas && chunk.deltas.size() < kParallelRecoveryChunkSize) {
+    ++deltas_read_;
+    auto timestamp = ReadWalDeltaHeader(&*wal_, names_->version());
+    if (!last_loaded_timestamp_ || timestamp > *last_loaded_timestamp_) {
+      chunk.deltas.emplace_back(timestamp, ReadWalDeltaData(&*wal_, &*names_));
+      next_timestamp_ = std::max(next_timestamp_, timestamp + 1);
+    } else {
+      SkipWalDeltaData(&*wal_, &*names_);
+    }
+  }
+
+  if (deltas_read_ == info_.num_deltas) {
+    chunk.last = true;
+    chunk.to_timestamp = info_.to_timestamp;
+    chunk.num_deltas = info_.num_deltas;
+    wal_.reset();
+    names_.reset();
+    ++read_file_;
+    // The same rule `RecoverData` uses to filter the deltas of the next file.
+    if (next_timestamp_ != 0) last_loaded_timestamp_.emplace(next_timestamp_ - 1);
+  }
+  return chunk;
+}
+
 WalFile::WalFile(const std::filesystem::path &wal_directory, const std::string_view uuid,
                  const std::string_view epoch_id, Config::Items items, NameIdMapper *name_id_mapper, uint64_t seq_num,
-                 utils::FileRetainer *file_retainer)
+                 utils::FileRetainer *file_retainer, Config::Durability::Compression compression,
+                 bool use_io_uring)
     : items_(items),
-      name_id_mapper_(name_id_mapper),
+      names_(name_id_mapper),
       path_(wal_directory / MakeWalName()),
       from_timestamp_(0),
       to_timestamp_(0),
@@ -877,7 +1200,8 @@ WalFile::WalFile(const std::filesystem::path &wal_directory, const std::string_v
   utils::EnsureDirOrDie(wal_directory);
 
   // Initialize the WAL file.
-  wal_.Initialize(path_, kWalMagic, kVersion);
+  wal_.Initialize(path_, kWalMagic, kVersion, compression);
+  if (use_io_uring) wal_.UseIoUring();
 
   // Write placeholder offsets.
   uint64_t offset_offsets = 0;
@@ -902,6 +1226,9 @@ WalFile::WalFile(const std::filesystem::path &wal_directory, const std::string_v
   wal_.WriteUint(offset_deltas);
   wal_.SetPosition(offset_deltas);
 
+  // Deltas are compressed if requested.
+  wal_.StartCompression();
+
   // Sync the initial data.
   wal_.Sync();
 }
@@ -910,7 +1237,7 @@ WalFile::WalFile(std::filesystem::path current_wal_path, Config::Items items, Na
                  uint64_t seq_num, uint64_t from_timestamp, uint64_t to_timestamp, uint64_t count,
                  utils::FileRetainer *file_retainer)
     : items_(items),
-      name_id_mapper_(name_id_mapper),
+      names_(name_id_mapper),
       path_(std::move(current_wal_path)),
       from_timestamp_(from_timestamp),
       to_timestamp_(to_timestamp),
@@ -947,12 +1274,12 @@ WalFile::~WalFile() {
 }
 
 void WalFile::AppendDelta(const Delta &delta, const Vertex &vertex, uint64_t timestamp) {
-  EncodeDelta(&wal_, name_id_mapper_, items_, delta, vertex, timestamp);
+  EncodeDelta(&wal_, &names_, items_, delta, vertex, timestamp);
   UpdateStats(timestamp);
 }
 
 void WalFile::AppendDelta(const Delta &delta, const Edge &edge, uint64_t timestamp) {
-  EncodeDelta(&wal_, name_id_mapper_, delta, edge, timestamp);
+  EncodeDelta(&wal_, &names_, delta, edge, timestamp);
   UpdateStats(timestamp);
 }
 
@@ -963,7 +1290,7 @@ void WalFile::AppendTransactionEnd(uint64_t timestamp) {
 
 void WalFile::AppendOperation(StorageGlobalOperation operation, LabelId label, const std::set<PropertyId> &properties,
                               uint64_t timestamp) {
-  EncodeOperation(&wal_, name_id_mapper_, operation, label, properties, timestamp);
+  EncodeOperation(&wal_, &names_, operation, label, properties, timestamp);
   UpdateStats(timestamp);
 }
 
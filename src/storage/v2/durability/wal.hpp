@@ -13,13 +13,18 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <future>
+#include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "storage/v2/config.hpp"
 #include "storage/v2/delta.hpp"
 #include "storage/v2/durability/metadata.hpp"
 #include "storage/v2/durability/serialization.hpp"
+#include "storage/v2/durability/version.hpp"
 #include "storage/v2/edge.hpp"
 #include "storage/v2/id_types.hpp"
 #include "storage/v2/name_id_mapper.hpp"
@@ -27,6 +32,7 @@
 #include "storage/v2/vertex.hpp"
 #include "utils/file_locker.hpp"
 #include "utils/skip_list.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace storage::durability {
 
@@ -152,6 +158,42 @@ constexpr bool IsWalDeltaDataTypeTransactionEnd(const WalDeltaData::Type type) {
   }
 }
 
+/// Names of labels, properties and edge types are written to a WAL file (or a
+/// replication stream) together with their ID only the first time they are
+/// used, later deltas contain just the ID. The IDs are those of the writer's
+/// `NameIdMapper`, they are meaningful only in combination with the names
+/// written before them.
+class WalNameEncoder {
+ public:
+  explicit WalNameEncoder(NameIdMapper *name_id_mapper) : name_id_mapper_(name_id_mapper) {}
+
+  void Write(BaseEncoder *encoder, uint64_t id);
+
+ private:
+  NameIdMapper *name_id_mapper_;
+  // Indexed by ID, the IDs of the `NameIdMapper` are dense.
+  std::vector<bool> written_;
+};
+
+/// Used to read the names written by `WalNameEncoder`. The same instance must
+/// be used to read (or skip) all deltas of a file (or a replication stream) in
+/// order. Files older than `kCompactWalVersion` contain the full name in every
+/// delta, the `version` of the file decides how the names are read.
+class WalNameDecoder {
+ public:
+  explicit WalNameDecoder(uint64_t version = kVersion) : version_(version) {}
+
+  /// @throw RecoveryFailure
+  const std::string &Read(BaseDecoder *decoder);
+
+  uint64_t version() const { return version_; }
+
+ private:
+  uint64_t version_;
+  std::unordered_map<uint64_t, std::string> names_;
+  std::string legacy_name_;
+};
+
 /// Function used to read information about the WAL file.
 /// @throw RecoveryFailure
 WalInfo ReadWalInfo(const std::filesystem::path &path);
@@ -159,34 +201,34 @@ WalInfo ReadWalInfo(const std::filesystem::path &path);
 /// Function used to read the WAL delta header. The function returns the delta
 /// timestamp.
 /// @throw RecoveryFailure
-uint64_t ReadWalDeltaHeader(BaseDecoder *decoder);
+uint64_t ReadWalDeltaHeader(BaseDecoder *decoder, uint64_t version = kVersion);
 
 /// Function used to read the current WAL delta data. The function returns the
 /// read delta data. The WAL delta header must be read before calling this
 /// function.
 /// @throw RecoveryFailure
-WalDeltaData ReadWalDeltaData(BaseDecoder *decoder);
+WalDeltaData ReadWalDeltaData(BaseDecoder *decoder, WalNameDecoder *names);
 
 /// Function used to skip the current WAL delta data. The function returns the
 /// skipped delta type. The WAL delta header must be read before calling this
-/// function.
+/// function. Names written in the delta are still added to `names`.
 /// @throw RecoveryFailure
-WalDeltaData::Type SkipWalDeltaData(BaseDecoder *decoder);
+WalDeltaData::Type SkipWalDeltaData(BaseDecoder *decoder, WalNameDecoder *names);
 
 /// Function used to encode a `Delta` that originated from a `Vertex`.
-void EncodeDelta(BaseEncoder *encoder, NameIdMapper *name_id_mapper, Config::Items items, const Delta &delta,
+void EncodeDelta(BaseEncoder *encoder, WalNameEncoder *names, Config::Items items, const Delta &delta,
                  const Vertex &vertex, uint64_t timestamp);
 
 /// Function used to encode a `Delta` that originated from an `Edge`.
-void EncodeDelta(BaseEncoder *encoder, NameIdMapper *name_id_mapper, const Delta &delta, const Edge &edge,
+void EncodeDelta(BaseEncoder *encoder, WalNameEncoder *names, const Delta &delta, const Edge &edge,
                  uint64_t timestamp);
 
 /// Function used to encode the transaction end.
 void EncodeTransactionEnd(BaseEncoder *encoder, uint64_t timestamp);
 
 /// Function used to encode non-transactional operation.
-void EncodeOperation(BaseEncoder *encoder, NameIdMapper *name_id_mapper, StorageGlobalOperation operation,
-                     LabelId label, const std::set<PropertyId> &properties, uint64_t timestamp);
+void EncodeOperation(BaseEncoder *encoder, WalNameEncoder *names, StorageGlobalOperation operation, LabelId label,
+                     const std::set<PropertyId> &properties, uint64_t timestamp);
 
 /// Function used to load the WAL data into the storage.
 /// @throw RecoveryFailure
@@ -195,11 +237,73 @@ RecoveryInfo LoadWal(const std::filesystem::path &path, RecoveredIndicesAndConst
                      utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper, std::atomic<uint64_t> *edge_count,
                      Config::Items items);
 
+/// Class used to load a sequence of WAL files using `thread_count` threads.
+/// The deltas are applied in chunks by the calling thread and
+/// `thread_count - 1` threads of the `pool`, while another thread of the
+/// `pool` decodes the next chunk, which can already belong to the next WAL
+/// file. The `pool` should therefore have `thread_count` threads.
+///
+/// The files must be loaded in the given order. For every file `LoadNext`
+/// returns the same as `LoadWal` given the `last_loaded_timestamp` that
+/// `RecoverData` derives from the files before it. `last_loaded_timestamp` and
+/// `next_timestamp` are the values `RecoverData` had before the first file.
+/// The loader can't be used anymore once `LoadNext` throws.
+class ParallelWalLoader {
+ public:
+  ParallelWalLoader(std::vector<std::filesystem::path> paths, std::optional<uint64_t> last_loaded_timestamp,
+                    uint64_t next_timestamp, utils::ThreadPool *pool, uint64_t thread_count);
+
+  ParallelWalLoader(const ParallelWalLoader &) = delete;
+  ParallelWalLoader(ParallelWalLoader &&) = delete;
+  ParallelWalLoader &operator=(const ParallelWalLoader &) = delete;
+  ParallelWalLoader &operator=(ParallelWalLoader &&) = delete;
+
+  ~ParallelWalLoader();
+
+  /// Function used to load the next WAL file into the storage.
+  /// @throw RecoveryFailure
+  RecoveryInfo LoadNext(RecoveredIndicesAndConstraints *indices_constraints, utils::SkipList<Vertex> *vertices,
+                        utils::SkipList<Edge> *edges, NameIdMapper *name_id_mapper,
+                        std::atomic<uint64_t> *edge_count, Config::Items items);
+
+ private:
+  struct Chunk {
+    std::vector<std::pair<uint64_t, WalDeltaData>> deltas;
+    // The remaining members are set only for the last chunk of a file.
+    bool last{false};
+    bool skipped{false};
+    uint64_t to_timestamp{0};
+    uint64_t num_deltas{0};
+  };
+
+  void ScheduleRead();
+
+  /// @throw RecoveryFailure
+  Chunk ReadChunk();
+
+  std::vector<std::filesystem::path> paths_;
+  utils::ThreadPool *pool_;
+  uint64_t thread_count_;
+  uint64_t loaded_file_{0};
+
+  // State of the reader, only used by the pending read.
+  uint64_t read_file_{0};
+  std::optional<Decoder> wal_;
+  std::optional<WalNameDecoder> names_;
+  WalInfo info_{};
+  uint64_t deltas_read_{0};
+  std::optional<uint64_t> last_loaded_timestamp_;
+  uint64_t next_timestamp_;
+
+  std::future<Chunk> next_chunk_;
+};
+
 /// WalFile class used to append deltas and operations to the WAL file.
 class WalFile {
  public:
   WalFile(const std::filesystem::path &wal_directory, std::string_view uuid, std::string_view epoch_id,
-          Config::Items items, NameIdMapper *name_id_mapper, uint64_t seq_num, utils::FileRetainer *file_retainer);
+          Config::Items items, NameIdMapper *name_id_mapper, uint64_t seq_num, utils::FileRetainer *file_retainer,
+          Config::Durability::Compression compression = {}, bool use_io_uring = false);
   WalFile(std::filesystem::path current_wal_path, Config::Items items, NameIdMapper *name_id_mapper, uint64_t seq_num,
           uint64_t from_timestamp, uint64_t to_timestamp, uint64_t count, utils::FileRetainer *file_retainer);
 
@@ -249,7 +353,7 @@ class WalFile {
   void UpdateStats(uint64_t timestamp);
 
   Config::Items items_;
-  NameIdMapper *name_id_mapper_;
+  WalNameEncoder names_;
   Encoder wal_;
   std::filesystem::path path_;
   uint64_t from_timestamp_;
@@ -261,6 +261,23 @@ bool CurrentVersionHasLabelProperty(const Vertex &vertex, LabelId label, Propert
   return !deleted && has_label && current_value_equal_to_value;
 }
 
+// Inserts the vertices into an index using `range_starts.size()` workers,
+// `insert(acc, vertex)` inserts a single vertex using the index accessor.
+template <typename TIndex, typename TInsert>
+void InsertVerticesInParallel(TIndex *index, utils::SkipList<Vertex> *vertices, const std::vector<Gid> &range_starts,
+                              utils::ThreadPool *pool, const TInsert &insert) {
+  utils::RunOnThreads(pool, range_starts.size(), [&](uint64_t worker) {
+    // The flag is thread local, so every worker has to enable it.
+    utils::MemoryTracker::OutOfMemoryExceptionEnabler oom_exception;
+    auto acc = index->access();
+    auto vertices_acc = vertices->access();
+    for (auto it = vertices_acc.find_equal_or_greater(range_starts[worker]); it != vertices_acc.end(); ++it) {
+      if (worker + 1 < range_starts.size() && it->gid >= range_starts[worker + 1]) break;
+      insert(acc, *it);
+    }
+  });
+}
+
 }  // namespace
 
 void LabelIndex::UpdateOnAddLabel(LabelId label, Vertex *vertex, const Transaction &tx) {
@@ -293,6 +310,29 @@ bool LabelIndex::CreateIndex(LabelId label, utils::SkipList<Vertex>::Accessor ve
   return true;
 }
 
+bool LabelIndex::CreateIndex(LabelId label, utils::SkipList<Vertex> *vertices, const std::vector<Gid> &range_starts,
+                             utils::ThreadPool *pool) {
+  utils::MemoryTracker::OutOfMemoryExceptionEnabler oom_exception;
+  auto [it, emplaced] = index_.emplace(std::piecewise_construct, std::forward_as_tuple(label), std::forward_as_tuple());
+  if (!emplaced) {
+    // Index already exists.
+    return false;
+  }
+  try {
+    InsertVerticesInParallel(&it->second, vertices, range_starts, pool, [label](auto &acc, Vertex &vertex) {
+      if (vertex.deleted || !utils::Contains(vertex.labels, label)) {
+        return;
+      }
+      acc.insert(Entry{&vertex, 0});
+    });
+  } catch (const utils::OutOfMemoryException &) {
+    utils::MemoryTracker::OutOfMemoryExceptionBlocker oom_exception_blocker;
+    index_.erase(it);
+    throw;
+  }
+  return true;
+}
+
 std::vector<LabelId> LabelIndex::ListIndices() const {
   std::vector<LabelId> ret;
   ret.reserve(index_.size());
@@ -444,6 +484,35 @@ bool LabelPropertyIndex::CreateIndex(LabelId label, PropertyId property, utils::
   return true;
 }
 
+bool LabelPropertyIndex::CreateIndex(LabelId label, PropertyId property, utils::SkipList<Vertex> *vertices,
+                                     const std::vector<Gid> &range_starts, utils::ThreadPool *pool) {
+  utils::MemoryTracker::OutOfMemoryExceptionEnabler oom_exception;
+  auto [it, emplaced] =
+      index_.emplace(std::piecewise_construct, std::forward_as_tuple(label, property), std::forward_as_tuple());
+  if (!emplaced) {
+    // Index already exists.
+    return false;
+  }
+  try {
+    InsertVerticesInParallel(&it->second, vertices, range_starts, pool,
+                             [label, property](auto &acc, Vertex &vertex) {
+                               if (vertex.deleted || !utils::Contains(vertex.labels, label)) {
+                                 return;
+                               }
+                               auto value = vertex.properties.GetProperty(property);
+                               if (value.IsNull()) {
+                                 return;
+                               }
+                               acc.insert(Entry{std::move(value), &vertex, 0});
+                             });
+  } catch (const utils::OutOfMemoryException &) {
+    utils::MemoryTracker::OutOfMemoryExceptionBlocker oom_exception_blocker;
+    index_.erase(it);
+    throw;
+  }
+  return true;
+}
+
 std::vector<std::pair<LabelId, PropertyId>> LabelPropertyIndex::ListIndices() const {
   std::vector<std::pair<LabelId, PropertyId>> ret;
   ret.reserve(index_.size());
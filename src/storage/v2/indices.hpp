@@ -14,6 +14,7 @@
 #include <optional>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include "storage/v2/config.hpp"
 #include "storage/v2/property_value.hpp"
@@ -22,6 +23,7 @@
 #include "utils/bound.hpp"
 #include "utils/logging.hpp"
 #include "utils/skip_list.hpp"
+#include "utils/thread_pool.hpp"
 
 namespace storage {
 
@@ -60,6 +62,14 @@ class LabelIndex {
   /// @throw std::bad_alloc
   bool CreateIndex(LabelId label, utils::SkipList<Vertex>::Accessor vertices);
 
+  /// Same as `CreateIndex`, but the vertices are inserted by
+  /// `range_starts.size()` workers, see `utils::RunOnThreads`. Worker `i`
+  /// inserts the vertices whose gids are at least `range_starts[i]` and less
+  /// than `range_starts[i + 1]`. Used by the recovery.
+  /// @throw std::bad_alloc
+  bool CreateIndex(LabelId label, utils::SkipList<Vertex> *vertices, const std::vector<Gid> &range_starts,
+                   utils::ThreadPool *pool);
+
   bool DropIndex(LabelId label) { return index_.erase(label) > 0; }
 
   bool IndexExists(LabelId label) const { return index_.find(label) != index_.end(); }
@@ -157,6 +167,12 @@ class LabelPropertyIndex {
   /// @throw std::bad_alloc
   bool CreateIndex(LabelId label, PropertyId property, utils::SkipList<Vertex>::Accessor vertices);
 
+  /// Same as `CreateIndex`, but the vertices are inserted in parallel, see
+  /// `LabelIndex::CreateIndex`.
+  /// @throw std::bad_alloc
+  bool CreateIndex(LabelId label, PropertyId property, utils::SkipList<Vertex> *vertices,
+                   const std::vector<Gid> &range_starts, utils::ThreadPool *pool);
+
   bool DropIndex(LabelId label, PropertyId property) { return index_.erase({label, property}) > 0; }
 
   bool IndexExists(LabelId label, PropertyId property) const { return index_.find({label, property}) != index_.end(); }
@@ -530,7 +530,9 @@ void Storage::ReplicationClient::TimeoutDispatcher::StartTimeoutTask(const doubl
 Storage::ReplicationClient::ReplicaStream::ReplicaStream(ReplicationClient *self,
                                                          const uint64_t previous_commit_timestamp,
                                                          const uint64_t current_seq_num)
-    : self_(self), stream_(self_->rpc_client_->Stream<AppendDeltasRpc>(previous_commit_timestamp, current_seq_num)) {
+    : self_(self),
+      stream_(self_->rpc_client_->Stream<AppendDeltasRpc>(previous_commit_timestamp, current_seq_num)),
+      names_(&self_->storage_->name_id_mapper_) {
   replication::Encoder encoder{stream_.GetBuilder()};
   encoder.WriteString(self_->storage_->epoch_id_);
 }
@@ -538,14 +540,13 @@ Storage::ReplicationClient::ReplicaStream::ReplicaStream(ReplicationClient *self
 void Storage::ReplicationClient::ReplicaStream::AppendDelta(const Delta &delta, const Vertex &vertex,
                                                             uint64_t final_commit_timestamp) {
   replication::Encoder encoder(stream_.GetBuilder());
-  EncodeDelta(&encoder, &self_->storage_->name_id_mapper_, self_->storage_->config_.items, delta, vertex,
-              final_commit_timestamp);
+  EncodeDelta(&encoder, &names_, self_->storage_->config_.items, delta, vertex, final_commit_timestamp);
 }
 
 void Storage::ReplicationClient::ReplicaStream::AppendDelta(const Delta &delta, const Edge &edge,
                                                             uint64_t final_commit_timestamp) {
   replication::Encoder encoder(stream_.GetBuilder());
-  EncodeDelta(&encoder, &self_->storage_->name_id_mapper_, delta, edge, final_commit_timestamp);
+  EncodeDelta(&encoder, &names_, delta, edge, final_commit_timestamp);
 }
 
 void Storage::ReplicationClient::ReplicaStream::AppendTransactionEnd(uint64_t final_commit_timestamp) {
@@ -557,7 +558,7 @@ void Storage::ReplicationClient::ReplicaStream::AppendOperation(durability::Stor
                                                                 LabelId label, const std::set<PropertyId> &properties,
                                                                 uint64_t timestamp) {
   replication::Encoder encoder(stream_.GetBuilder());
-  EncodeOperation(&encoder, &self_->storage_->name_id_mapper_, operation, label, properties, timestamp);
+  EncodeOperation(&encoder, &names_, operation, label, properties, timestamp);
 }
 
 AppendDeltasRes Storage::ReplicationClient::ReplicaStream::Finalize() { return stream_.AwaitResponse(); }
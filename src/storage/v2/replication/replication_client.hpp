@@ -68,6 +68,8 @@ class Storage::ReplicationClient {
 
     ReplicationClient *self_;
     rpc::Client::StreamHandler<AppendDeltasRpc> stream_;
+    // Names are sent only once per stream, see `durability::WalNameEncoder`.
+    durability::WalNameEncoder names_;
   };
 
   // Handler for transfering the current WAL file whose data is
@@ -25,11 +25,12 @@
 
 namespace storage {
 namespace {
-std::pair<uint64_t, durability::WalDeltaData> ReadDelta(durability::BaseDecoder *decoder) {
+std::pair<uint64_t, durability::WalDeltaData> ReadDelta(durability::BaseDecoder *decoder,
+                                                        durability::WalNameDecoder *names) {
   try {
-    auto timestamp = ReadWalDeltaHeader(decoder);
+    auto timestamp = ReadWalDeltaHeader(decoder, names->version());
     SPDLOG_INFO("       Timestamp {}", timestamp);
-    auto delta = ReadWalDeltaData(decoder);
+    auto delta = ReadWalDeltaData(decoder, names);
     return {timestamp, delta};
   } catch (const slk::SlkReaderException &) {
     throw utils::BasicException("Missing data!");
@@ -113,12 +114,13 @@ void Storage::ReplicationServer::AppendDeltasHandler(slk::Reader *req_reader, sl
     storage_->wal_seq_num_ = req.seq_num;
   }
 
+  durability::WalNameDecoder names;
   if (req.previous_commit_timestamp != storage_->last_commit_timestamp_.load()) {
     // Empty the stream
     bool transaction_complete = false;
     while (!transaction_complete) {
       SPDLOG_INFO("Skipping delta");
-      const auto [timestamp, delta] = ReadDelta(&decoder);
+      const auto [timestamp, delta] = ReadDelta(&decoder, &names);
       transaction_complete = durability::IsWalDeltaDataTypeTransactionEnd(delta.type);
     }
 
@@ -127,7 +129,7 @@ void Storage::ReplicationServer::AppendDeltasHandler(slk::Reader *req_reader, sl
     return;
   }
 
-  ReadAndApplyDelta(&decoder);
+  ReadAndApplyDelta(&decoder, &names);
 
   AppendDeltasRes res{true, storage_->last_commit_timestamp_.load()};
   slk::Save(res, res_builder);
@@ -263,8 +265,9 @@ void Storage::ReplicationServer::LoadWal(replication::Decoder *decoder) {
     if (!durability::IsVersionSupported(*version)) throw durability::RecoveryFailure("Invalid WAL version!");
     wal.SetPosition(wal_info.offset_deltas);
 
+    durability::WalNameDecoder names(*version);
     for (size_t i = 0; i < wal_info.num_deltas;) {
-      i += ReadAndApplyDelta(&wal);
+      i += ReadAndApplyDelta(&wal, &names);
     }
 
     spdlog::debug("{} loaded successfully", *maybe_wal_path);
@@ -279,7 +282,8 @@ Storage::ReplicationServer::~ReplicationServer() {
     rpc_server_->AwaitShutdown();
   }
 }
-uint64_t Storage::ReplicationServer::ReadAndApplyDelta(durability::BaseDecoder *decoder) {
+uint64_t Storage::ReplicationServer::ReadAndApplyDelta(durability::BaseDecoder *decoder,
+                                                       durability::WalNameDecoder *names) {
   auto edge_acc = storage_->edges_.access();
   auto vertex_acc = storage_->vertices_.access();
 
@@ -297,7 +301,7 @@ uint64_t Storage::ReplicationServer::ReadAndApplyDelta(durability::BaseDecoder *
   auto max_commit_timestamp = storage_->last_commit_timestamp_.load();
 
   for (bool transaction_complete = false; !transaction_complete; ++applied_deltas) {
-    const auto [timestamp, delta] = ReadDelta(decoder);
+    const auto [timestamp, delta] = ReadDelta(decoder, names);
     if (timestamp > max_commit_timestamp) {
       max_commit_timestamp = timestamp;
     }
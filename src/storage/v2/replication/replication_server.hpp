@@ -35,7 +35,7 @@ class Storage::ReplicationServer {
   void CurrentWalHandler(slk::Reader *req_reader, slk::Builder *res_builder);
 
   void LoadWal(replication::Decoder *decoder);
-  uint64_t ReadAndApplyDelta(durability::BaseDecoder *decoder);
+  uint64_t ReadAndApplyDelta(durability::BaseDecoder *decoder, durability::WalNameDecoder *names);
 
   std::optional<communication::ServerContext> rpc_server_context_;
   std::optional<rpc::Server> rpc_server_;
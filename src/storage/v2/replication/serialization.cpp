@@ -11,6 +11,12 @@
 
 #include "storage/v2/replication/serialization.hpp"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "utils/on_scope_exit.hpp"
+
 namespace storage::replication {
 ////// Encoder //////
 void Encoder::WriteMarker(durability::Marker marker) { slk::Save(marker, builder_); }
@@ -25,6 +31,11 @@ void Encoder::WriteUint(uint64_t value) {
   slk::Save(value, builder_);
 }
 
+void Encoder::WriteVarUint(uint64_t value) {
+  WriteMarker(durability::Marker::TYPE_VARINT);
+  slk::Save(value, builder_);
+}
+
 void Encoder::WriteDouble(double value) {
   WriteMarker(durability::Marker::TYPE_DOUBLE);
   slk::Save(value, builder_);
@@ -40,10 +51,25 @@ void Encoder::WritePropertyValue(const PropertyValue &value) {
   slk::Save(value, builder_);
 }
 
-void Encoder::WriteBuffer(const uint8_t *buffer, const size_t buffer_size) { builder_->Save(buffer, buffer_size); }
+void Encoder::WriteBuffer(const uint8_t *buffer, const size_t buffer_size) { builder_->SaveView(buffer, buffer_size); }
 
 void Encoder::WriteFileData(utils::InputFile *file) {
   auto file_size = file->GetSize();
+  if (file_size >= slk::kSegmentMinViewSize && file->GetPosition() == 0) {
+    // Map the file so that its data is sent directly from the page cache
+    // instead of being copied through the file and segment buffers.
+    auto fd = open(file->path().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd != -1) {
+      auto *data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if (data != MAP_FAILED) {
+        madvise(data, file_size, MADV_SEQUENTIAL);
+        utils::OnScopeExit unmap{[data, file_size] { munmap(data, file_size); }};
+        builder_->SaveView(static_cast<const uint8_t *>(data), file_size);
+        return;
+      }
+    }
+  }
   uint8_t buffer[utils::kFileBufferSize];
   while (file_size > 0) {
     const auto chunk_size = std::min(file_size, utils::kFileBufferSize);
@@ -86,6 +112,13 @@ std::optional<uint64_t> Decoder::ReadUint() {
   return value;
 }
 
+std::optional<uint64_t> Decoder::ReadVarUint() {
+  if (const auto marker = ReadMarker(); !marker || marker != durability::Marker::TYPE_VARINT) return std::nullopt;
+  uint64_t value;
+  slk::Load(&value, reader_);
+  return value;
+}
+
 std::optional<double> Decoder::ReadDouble() {
   if (const auto marker = ReadMarker(); !marker || marker != durability::Marker::TYPE_DOUBLE) return std::nullopt;
   double value;
@@ -135,14 +168,7 @@ std::optional<std::filesystem::path> Decoder::ReadFile(const std::filesystem::pa
   file.Open(path, utils::OutputFile::Mode::OVERWRITE_EXISTING);
   std::optional<size_t> maybe_file_size = ReadUint();
   MG_ASSERT(maybe_file_size, "File size missing");
-  auto file_size = *maybe_file_size;
-  uint8_t buffer[utils::kFileBufferSize];
-  while (file_size > 0) {
-    const auto chunk_size = std::min(file_size, utils::kFileBufferSize);
-    reader_->Load(buffer, chunk_size);
-    file.Write(buffer, chunk_size);
-    file_size -= chunk_size;
-  }
+  reader_->LoadView(*maybe_file_size, [&file](const uint8_t *data, size_t size) { file.Write(data, size); });
   file.Close();
   return std::move(path);
 }
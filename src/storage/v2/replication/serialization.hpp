@@ -31,6 +31,8 @@ class Encoder final : public durability::BaseEncoder {
 
   void WriteUint(uint64_t value) override;
 
+  void WriteVarUint(uint64_t value) override;
+
   void WriteDouble(double value) override;
 
   void WriteString(const std::string_view &value) override;
@@ -57,6 +59,8 @@ class Decoder final : public durability::BaseDecoder {
 
   std::optional<uint64_t> ReadUint() override;
 
+  std::optional<uint64_t> ReadVarUint() override;
+
   std::optional<double> ReadDouble() override;
 
   std::optional<std::string> ReadString() override;
@@ -31,6 +31,7 @@
 #include "storage/v2/transaction.hpp"
 #include "storage/v2/vertex_accessor.hpp"
 #include "utils/file.hpp"
+#include "utils/io_uring.hpp"
 #include "utils/logging.hpp"
 #include "utils/memory_tracker.hpp"
 #include "utils/message.hpp"
@@ -53,9 +54,10 @@ namespace {
 }  // namespace
 
 auto AdvanceToVisibleVertex(utils::SkipList<Vertex>::Iterator it, utils::SkipList<Vertex>::Iterator end,
-                            std::optional<VertexAccessor> *vertex, Transaction *tx, View view, Indices *indices,
-                            Constraints *constraints, Config::Items config) {
+                            std::optional<Gid> to, std::optional<VertexAccessor> *vertex, Transaction *tx, View view,
+                            Indices *indices, Constraints *constraints, Config::Items config) {
   while (it != end) {
+    if (to && it->gid >= *to) return end;
     *vertex = VertexAccessor::Create(&*it, tx, indices, constraints, config, view);
     if (!*vertex) {
       ++it;
@@ -68,15 +70,15 @@ auto AdvanceToVisibleVertex(utils::SkipList<Vertex>::Iterator it, utils::SkipLis
 
 AllVerticesIterable::Iterator::Iterator(AllVerticesIterable *self, utils::SkipList<Vertex>::Iterator it)
     : self_(self),
-      it_(AdvanceToVisibleVertex(it, self->vertices_accessor_.end(), &self->vertex_, self->transaction_, self->view_,
-                                 self->indices_, self_->constraints_, self->config_)) {}
+      it_(AdvanceToVisibleVertex(it, self->vertices_accessor_.end(), self->to_, &self->vertex_, self->transaction_,
+                                 self->view_, self->indices_, self_->constraints_, self->config_)) {}
 
 VertexAccessor AllVerticesIterable::Iterator::operator*() const { return *self_->vertex_; }
 
 AllVerticesIterable::Iterator &AllVerticesIterable::Iterator::operator++() {
   ++it_;
-  it_ = AdvanceToVisibleVertex(it_, self_->vertices_accessor_.end(), &self_->vertex_, self_->transaction_, self_->view_,
-                               self_->indices_, self_->constraints_, self_->config_);
+  it_ = AdvanceToVisibleVertex(it_, self_->vertices_accessor_.end(), self_->to_, &self_->vertex_, self_->transaction_,
+                               self_->view_, self_->indices_, self_->constraints_, self_->config_);
   return *this;
 }
 
@@ -316,6 +318,14 @@ Storage::Storage(Config config)
     // Same reasoning as above.
     utils::EnsureDirOrDie(wal_directory_);
 
+    if (config_.durability.use_io_uring) {
+      uint8_t probe_buffer[1];
+      if (!utils::IoUring::Create(1, probe_buffer, sizeof(probe_buffer))) {
+        spdlog::warn("io_uring isn't supported by the kernel, snapshot and WAL files will be written using blocking "
+                     "writes.");
+      }
+    }
+
     // Verify that the user that started the process is the same user that is
     // the owner of the storage directory.
     durability::VerifyStorageDirectoryOwnerAndProcessUserOrDie(config_.durability.storage_directory);
@@ -334,7 +344,7 @@ Storage::Storage(Config config)
   if (config_.durability.recover_on_startup) {
     auto info = durability::RecoverData(snapshot_directory_, wal_directory_, &uuid_, &epoch_id_, &epoch_history_,
                                         &vertices_, &edges_, &edge_count_, &name_id_mapper_, &indices_, &constraints_,
-                                        config_.items, &wal_seq_num_);
+                                        config_.items, config_.durability.recovery_thread_count, &wal_seq_num_);
     if (info) {
       vertex_id_ = info->next_vertex_id;
       edge_id_ = info->next_edge_id;
@@ -1538,7 +1548,7 @@ bool Storage::InitializeWalFile() {
     return false;
   if (!wal_file_) {
     wal_file_.emplace(wal_directory_, uuid_, epoch_id_, config_.items, &name_id_mapper_, wal_seq_num_++,
-                      &file_retainer_);
+                      &file_retainer_, config_.durability.compression, config_.durability.use_io_uring);
   }
   return true;
 }
@@ -1770,7 +1780,7 @@ utils::BasicResult<Storage::CreateSnapshotError> Storage::CreateSnapshot() {
   durability::CreateSnapshot(&transaction, snapshot_directory_, wal_directory_,
                              config_.durability.snapshot_retention_count, &vertices_, &edges_, &name_id_mapper_,
                              &indices_, &constraints_, config_.items, uuid_, epoch_id_, epoch_history_,
-                             &file_retainer_);
+                             &file_retainer_, config_.durability.compression, config_.durability.use_io_uring);
 
   // Finalize snapshot transaction.
   commit_log_->MarkFinished(transaction.start_timestamp);
@@ -66,6 +66,8 @@ class AllVerticesIterable final {
   Indices *indices_;
   Constraints *constraints_;
   Config::Items config_;
+  std::optional<Gid> from_;
+  std::optional<Gid> to_;
   std::optional<VertexAccessor> vertex_;
 
  public:
@@ -85,16 +87,23 @@ class AllVerticesIterable final {
     bool operator!=(const Iterator &other) const { return !(*this == other); }
   };
 
+  /// The iteration can be limited to the vertices whose gids are in
+  /// [`from`, `to`), a missing bound isn't limited.
   AllVerticesIterable(utils::SkipList<Vertex>::Accessor vertices_accessor, Transaction *transaction, View view,
-                      Indices *indices, Constraints *constraints, Config::Items config)
+                      Indices *indices, Constraints *constraints, Config::Items config,
+                      std::optional<Gid> from = std::nullopt, std::optional<Gid> to = std::nullopt)
       : vertices_accessor_(std::move(vertices_accessor)),
         transaction_(transaction),
         view_(view),
         indices_(indices),
         constraints_(constraints),
-        config_(config) {}
+        config_(config),
+        from_(from),
+        to_(to) {}
 
-  Iterator begin() { return Iterator(this, vertices_accessor_.begin()); }
+  Iterator begin() {
+    return Iterator(this, from_ ? vertices_accessor_.find_equal_or_greater(*from_) : vertices_accessor_.begin());
+  }
   Iterator end() { return Iterator(this, vertices_accessor_.end()); }
 };
 
@@ -220,6 +229,15 @@ class Storage final {
                                                   storage_->config_.items));
     }
 
+    /// Return the vertices whose gids are in [`from`, `to`), all vertices from
+    /// `from` on if `to` isn't given. Used to split the vertices into ranges
+    /// that are iterated in parallel, see `VertexGidUpperBound`.
+    VerticesIterable Vertices(Gid from, std::optional<Gid> to, View view) {
+      return VerticesIterable(AllVerticesIterable(storage_->vertices_.access(), &transaction_, view,
+                                                  &storage_->indices_, &storage_->constraints_,
+                                                  storage_->config_.items, from, to));
+    }
+
     VerticesIterable Vertices(LabelId label, View view);
 
     VerticesIterable Vertices(LabelId label, PropertyId property, View view);
@@ -234,6 +252,11 @@ class Storage final {
     /// Note that this is always an over-estimate and never an under-estimate.
     int64_t ApproximateVertexCount() const { return storage_->vertices_.size(); }
 
+    /// Return a gid that is larger than the gid of every existing vertex. The
+    /// gids are handed out in increasing order, so they are dense below it
+    /// unless many vertices were deleted.
+    Gid VertexGidUpperBound() const { return Gid::FromUint(storage_->vertex_id_.load(std::memory_order_acquire)); }
+
     /// Return approximate number of vertices with the given label.
     /// Note that this is always an over-estimate and never an under-estimate.
     int64_t ApproximateVertexCount(LabelId label) const {
@@ -16,6 +16,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <cerrno>
 #include <cstring>
 #include <fstream>
 #include <mutex>
@@ -293,10 +294,16 @@ OutputFile::~OutputFile() {
 }
 
 OutputFile::OutputFile(OutputFile &&other) noexcept
-    : fd_(other.fd_), written_since_last_sync_(other.written_since_last_sync_), path_(std::move(other.path_)) {
+    : fd_(other.fd_),
+      written_since_last_sync_(other.written_since_last_sync_),
+      path_(std::move(other.path_)),
+      io_uring_(std::move(other.io_uring_)),
+      io_uring_buffer_(std::move(other.io_uring_buffer_)),
+      io_uring_in_flight_(other.io_uring_in_flight_) {
   memcpy(buffer_, other.buffer_, kFileBufferSize);
   buffer_position_.store(other.buffer_position_.load());
   other.fd_ = -1;
+  other.io_uring_in_flight_ = 0;
   other.written_since_last_sync_ = 0;
   other.buffer_position_ = 0;
 }
@@ -309,8 +316,12 @@ OutputFile &OutputFile::operator=(OutputFile &&other) noexcept {
   path_ = std::move(other.path_);
   buffer_position_ = other.buffer_position_.load();
   memcpy(buffer_, other.buffer_, kFileBufferSize);
+  io_uring_ = std::move(other.io_uring_);
+  io_uring_buffer_ = std::move(other.io_uring_buffer_);
+  io_uring_in_flight_ = other.io_uring_in_flight_;
 
   other.fd_ = -1;
+  other.io_uring_in_flight_ = 0;
   other.written_since_last_sync_ = 0;
   other.buffer_position_ = 0;
 
@@ -346,6 +357,19 @@ void OutputFile::Open(const std::filesystem::path &path, Mode mode) {
 
 bool OutputFile::IsOpen() const { return fd_ != -1; }
 
+bool OutputFile::UseIoUring(const IoUring::Factory &create_ring) {
+  // Only a single write and an fsync are ever in flight.
+  constexpr unsigned kIoUringEntries = 2;
+
+  if (io_uring_) return true;
+  auto buffer = std::make_unique<uint8_t[]>(kFileBufferSize);
+  auto ring = create_ring(kIoUringEntries, buffer.get(), kFileBufferSize);
+  if (!ring) return false;
+  io_uring_buffer_ = std::move(buffer);
+  io_uring_ = std::move(ring);
+  return true;
+}
+
 const std::filesystem::path &OutputFile::path() const { return path_; }
 
 void OutputFile::Write(const uint8_t *data, size_t size) {
@@ -373,6 +397,13 @@ void OutputFile::Write(const char *data, size_t size) { Write(reinterpret_cast<c
 void OutputFile::Write(const std::string_view &data) { Write(data.data(), data.size()); }
 
 size_t OutputFile::SeekFile(const Position position, const ssize_t offset) {
+  if (io_uring_) {
+    // The file position and size are known only after the pending write is
+    // done.
+    std::lock_guard guard(io_uring_lock_);
+    WaitForIoUringWrite();
+  }
+
   int whence;
   switch (position) {
     case Position::SET:
@@ -426,6 +457,14 @@ bool OutputFile::AcquireLock() {
 }
 
 void OutputFile::Sync() {
+  if (io_uring_) {
+    MG_ASSERT(IsOpen(), "Syncing an unopend file.");
+    std::unique_lock flush_guard(flush_lock_);
+    SubmitIoUringWrite(true);
+    written_since_last_sync_ = 0;
+    return;
+  }
+
   FlushBuffer(true);
 
   int ret = 0;
@@ -475,6 +514,10 @@ void OutputFile::Sync() {
 
 void OutputFile::Close() noexcept {
   FlushBuffer(true);
+  if (io_uring_) {
+    std::lock_guard guard(io_uring_lock_);
+    WaitForIoUringWrite();
+  }
 
   int ret = 0;
   while (true) {
@@ -514,10 +557,18 @@ void OutputFile::FlushBufferInternal() {
             "buffer than the buffer has space!",
             path_);
 
-  auto *buffer = buffer_;
-  auto buffer_position = buffer_position_.load();
-  while (buffer_position > 0) {
-    auto written = write(fd_, buffer, buffer_position_);
+  if (io_uring_) {
+    SubmitIoUringWrite(false);
+    return;
+  }
+
+  WriteToFile(buffer_, buffer_position_.load());
+  buffer_position_.store(0);
+}
+
+void OutputFile::WriteToFile(const uint8_t *data, size_t size) {
+  while (size > 0) {
+    auto written = write(fd_, data, size);
     if (written == -1 && errno == EINTR) {
       continue;
     }
@@ -526,16 +577,99 @@ void OutputFile::FlushBufferInternal() {
               "while trying to write to {} an error occurred: {} ({}). "
               "Possibly {} bytes of data were lost from this call and "
               "possibly {} bytes were lost from previous calls.",
-              path_, strerror(errno), errno, buffer_position_, written_since_last_sync_);
+              path_, strerror(errno), errno, size, written_since_last_sync_);
+
+    size -= written;
+    data += written;
+  }
+}
+
+void OutputFile::SubmitIoUringWrite(bool sync) {
+  constexpr uint64_t kWriteId = 1;
+  constexpr uint64_t kFsyncId = 2;
+
+  std::lock_guard guard(io_uring_lock_);
+  // The ring's buffer can be reused only after the previous write is done.
+  WaitForIoUringWrite();
+
+  const auto size = buffer_position_.load();
+  if (size > 0) {
+    memcpy(io_uring_buffer_.get(), buffer_, size);
+    buffer_position_.store(0);
+    io_uring_->PrepareWriteFixed(fd_, io_uring_buffer_.get(), size, kWriteId, sync);
+    io_uring_in_flight_ = size;
+  }
+  if (!sync) {
+    if (size > 0) io_uring_->Submit(0);
+    return;
+  }
+
+  io_uring_->PrepareFsync(fd_, kFsyncId);
+  io_uring_->Submit(size > 0 ? 2 : 1);
+  std::optional<int32_t> fsync_result;
+  while (io_uring_in_flight_ > 0 || !fsync_result) {
+    auto completion = io_uring_->PopCompletion();
+    if (!completion) {
+      io_uring_->Submit(1);
+      continue;
+    }
+    if (completion->user_data == kFsyncId) {
+      fsync_result = completion->result;
+      continue;
+    }
+    const auto written = completion->result;
+    MG_ASSERT(written > 0,
+              "while trying to write to {} an error occurred: {} ({}). "
+              "Possibly {} bytes of data were lost from this call and "
+              "possibly {} bytes were lost from previous calls.",
+              path_, strerror(-written), -written, io_uring_in_flight_, written_since_last_sync_);
+    // A short write cancels the linked fsync, the rest of the data is written
+    // and synced the usual way.
+    WriteToFile(io_uring_buffer_.get() + written, io_uring_in_flight_ - written);
+    io_uring_in_flight_ = 0;
+  }
 
-    buffer_position -= written;
-    buffer += written;
+  int ret = *fsync_result;
+  if (ret == -ECANCELED) {
+    while ((ret = fsync(fd_)) == -1 && errno == EINTR) {
+    }
+    if (ret == -1) ret = -errno;
   }
+  // The same rules as in `Sync` apply, any error is fatal.
+  MG_ASSERT(ret == 0,
+            "While trying to sync {}, an error occurred: {} ({}). Possibly {} "
+            "bytes from previous write calls were lost.",
+            path_, strerror(-ret), -ret, written_since_last_sync_);
+}
 
-  buffer_position_.store(buffer_position);
+void OutputFile::WaitForIoUringWrite() {
+  while (io_uring_in_flight_ > 0) {
+    auto completion = io_uring_->PopCompletion();
+    if (!completion) {
+      io_uring_->Submit(1);
+      continue;
+    }
+    const auto written = completion->result;
+    MG_ASSERT(written > 0,
+              "while trying to write to {} an error occurred: {} ({}). "
+              "Possibly {} bytes of data were lost from this call and "
+              "possibly {} bytes were lost from previous calls.",
+              path_, strerror(-written), -written, io_uring_in_flight_, written_since_last_sync_);
+    // The kernel may write less than requested, the rest is written directly.
+    WriteToFile(io_uring_buffer_.get() + written, io_uring_in_flight_ - written);
+    io_uring_in_flight_ = 0;
+  }
 }
 
-void OutputFile::DisableFlushing() { flush_lock_.lock_shared(); }
+void OutputFile::DisableFlushing() {
+  flush_lock_.lock_shared();
+  if (io_uring_) {
+    // Whoever reads the file while flushing is disabled expects all of the
+    // data that isn't in the buffer to be in the file.
+    std::lock_guard guard(io_uring_lock_);
+    WaitForIoUringWrite();
+  }
+}
 
 void OutputFile::EnableFlushing() {
   flush_lock_.unlock_shared();
@@ -557,6 +691,9 @@ size_t OutputFile::GetSize() {
 
 void OutputFile::TryFlushing() {
   if (std::unique_lock guard(flush_lock_, std::try_to_lock); guard.owns_lock()) {
+    // With io_uring this waits only if the previous write is still in flight.
+    // Leaving the data in the buffer instead would lose the flushed data (e.g.
+    // committed WAL deltas) if the process crashed.
     FlushBufferInternal();
   }
 }
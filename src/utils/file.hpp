@@ -19,11 +19,14 @@
 
 #include <atomic>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "utils/io_uring.hpp"
 #include "utils/rw_lock.hpp"
 
 namespace utils {
@@ -201,6 +204,16 @@ class OutputFile {
   /// Returns a boolean indicating whether a file is opened.
   bool IsOpen() const;
 
+  /// Makes the internal buffer flushes of this handle go through io_uring.
+  /// A flush then only copies the buffer and submits the write, so the caller
+  /// can keep writing while the kernel handles it. The data of a submitted
+  /// write is guaranteed to be in the file only after the next flush,
+  /// `GetPosition`, `SetPosition`, `GetSize`, `DisableFlushing`, `Sync` or
+  /// `Close`. `Sync` submits the final write linked with the `fsync`. Returns
+  /// `false` and keeps using blocking writes if the kernel doesn't support
+  /// io_uring. The ring is created with `create_ring`.
+  bool UseIoUring(const IoUring::Factory &create_ring = IoUring::Create);
+
   /// Returns the path to the currently opened file. If a file isn't opened the
   /// path is empty.
   const std::filesystem::path &path() const;
@@ -244,7 +257,10 @@ class OutputFile {
   /// is flushed.
   void EnableFlushing();
 
-  /// Try flushing the internal buffer.
+  /// Try flushing the internal buffer. With io_uring the write is only
+  /// submitted, it may still be in flight when the call returns. If the
+  /// previous write is still in flight, it waits for it first, so the data is
+  /// always handed to the kernel.
   void TryFlushing();
 
   /// Get the internal buffer with its current size.
@@ -257,6 +273,15 @@ class OutputFile {
   void FlushBuffer(bool force_flush);
   void FlushBufferInternal();
 
+  // Submits the internal buffer to io_uring. If `sync` is set, the file is also
+  // synced and the function waits for both operations.
+  void SubmitIoUringWrite(bool sync);
+  // Waits for the io_uring write that is in flight, if any. `io_uring_lock_`
+  // must be held.
+  void WaitForIoUringWrite();
+  // Writes the data with blocking `write` calls.
+  void WriteToFile(const uint8_t *data, size_t size);
+
   size_t SeekFile(Position position, ssize_t offset);
 
   int fd_{-1};
@@ -267,6 +292,15 @@ class OutputFile {
 
   // Flushing buffer should be a higher priority
   utils::RWLock flush_lock_{RWLock::Priority::WRITE};
+
+  // Set only when `UseIoUring` succeeded. The ring writes from its own copy of
+  // the buffer so that `buffer_` can be filled while the write is in flight.
+  std::unique_ptr<IoUring> io_uring_;
+  std::unique_ptr<uint8_t[]> io_uring_buffer_;
+  size_t io_uring_in_flight_{0};
+  // Held while waiting for the kernel, which can take as long as a disk
+  // write, so a spin lock would burn the CPU of the waiting threads.
+  std::mutex io_uring_lock_;
 };
 
 }  // namespace utils
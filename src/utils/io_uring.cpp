@@ -0,0 +1,226 @@
+// Copyright 2021 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#include "utils/io_uring.hpp"
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+
+#include "utils/logging.hpp"
+
+// The ring is used only when the kernel headers know about all of the
+// features that `OutputFile` relies on.
+#if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup)
+#define MG_HAS_IO_URING 1
+#endif
+
+namespace utils {
+
+#ifdef MG_HAS_IO_URING
+
+namespace {
+
+int IoUringSetup(unsigned entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int fd, unsigned opcode, const void *arg, unsigned nr_args) {
+  return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T>
+T *RingField(void *ring, uint32_t offset) {
+  return reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(ring) + offset);
+}
+
+}  // namespace
+
+std::unique_ptr<IoUring> IoUring::Create(unsigned entries, uint8_t *buffer, size_t buffer_size) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = IoUringSetup(entries, &params);
+  if (fd < 0) {
+    spdlog::debug("io_uring isn't available: {} ({})", strerror(errno), errno);
+    return nullptr;
+  }
+
+  std::unique_ptr<IoUring> ring(new IoUring());
+  ring->fd_ = fd;
+
+  // Writes must continue from the current file position so that files opened
+  // in append mode and positions set with `lseek` behave the same as with
+  // `write`.
+  if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+    spdlog::debug("io_uring doesn't support writing at the current file position");
+    return nullptr;
+  }
+
+  ring->sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    ring->sq_ring_size_ = std::max(ring->sq_ring_size_, ring->cq_ring_size_);
+    ring->cq_ring_size_ = 0;
+  }
+
+  ring->sq_ring_ =
+      mmap(nullptr, ring->sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (ring->sq_ring_ == MAP_FAILED) {
+    ring->sq_ring_ = nullptr;
+    return nullptr;
+  }
+  if (single_mmap) {
+    ring->cq_ring_ = ring->sq_ring_;
+  } else {
+    ring->cq_ring_ =
+        mmap(nullptr, ring->cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ring_ == MAP_FAILED) {
+      ring->cq_ring_ = nullptr;
+      return nullptr;
+    }
+  }
+  ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  ring->sqes_ = mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (ring->sqes_ == MAP_FAILED) {
+    ring->sqes_ = nullptr;
+    return nullptr;
+  }
+
+  ring->sq_head_ = RingField<unsigned>(ring->sq_ring_, params.sq_off.head);
+  ring->sq_tail_ = RingField<unsigned>(ring->sq_ring_, params.sq_off.tail);
+  ring->sq_mask_ = RingField<unsigned>(ring->sq_ring_, params.sq_off.ring_mask);
+  ring->sq_array_ = RingField<unsigned>(ring->sq_ring_, params.sq_off.array);
+  ring->cq_head_ = RingField<unsigned>(ring->cq_ring_, params.cq_off.head);
+  ring->cq_tail_ = RingField<unsigned>(ring->cq_ring_, params.cq_off.tail);
+  ring->cq_mask_ = RingField<unsigned>(ring->cq_ring_, params.cq_off.ring_mask);
+  ring->cqes_ = RingField<uint8_t>(ring->cq_ring_, params.cq_off.cqes);
+
+  // Registering the buffer lets the kernel skip mapping its pages on every
+  // write.
+  iovec iov{buffer, buffer_size};
+  if (buffer && IoUringRegister(fd, IORING_REGISTER_BUFFERS, &iov, 1) < 0) {
+    spdlog::debug("Couldn't register the io_uring buffer: {} ({})", strerror(errno), errno);
+    return nullptr;
+  }
+
+  return ring;
+}
+
+IoUring::~IoUring() {
+  if (sqes_) munmap(sqes_, sqes_size_);
+  if (cq_ring_ && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_) munmap(sq_ring_, sq_ring_size_);
+  if (fd_ != -1) close(fd_);
+}
+
+io_uring_sqe *IoUring::NextSubmissionEntry() {
+  const unsigned tail = *sq_tail_;
+  const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  MG_ASSERT(tail - head <= *sq_mask_, "The io_uring submission queue is full!");
+  const unsigned index = tail & *sq_mask_;
+  auto *sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  ++to_submit_;
+  return sqe;
+}
+
+void IoUring::PrepareWriteFixed(int fd, const uint8_t *data, size_t size, uint64_t user_data, bool link) {
+  auto *sqe = NextSubmissionEntry();
+  sqe->opcode = IORING_OP_WRITE_FIXED;
+  sqe->fd = fd;
+  // An offset of -1 makes the kernel use and advance the file position.
+  sqe->off = static_cast<uint64_t>(-1);
+  sqe->addr = reinterpret_cast<uint64_t>(data);
+  sqe->len = static_cast<uint32_t>(size);
+  sqe->buf_index = 0;
+  sqe->user_data = user_data;
+  if (link) sqe->flags |= IOSQE_IO_LINK;
+}
+
+void IoUring::PrepareFsync(int fd, uint64_t user_data) {
+  auto *sqe = NextSubmissionEntry();
+  sqe->opcode = IORING_OP_FSYNC;
+  sqe->fd = fd;
+  sqe->user_data = user_data;
+}
+
+void IoUring::PrepareRecv(int fd, uint8_t *data, size_t size, uint64_t user_data) {
+  auto *sqe = NextSubmissionEntry();
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(data);
+  sqe->len = static_cast<uint32_t>(size);
+  sqe->msg_flags = MSG_DONTWAIT;
+  sqe->user_data = user_data;
+}
+
+void IoUring::Submit(unsigned wait_count) {
+  while (true) {
+    const int ret = IoUringEnter(fd_, to_submit_, wait_count, wait_count > 0 ? IORING_ENTER_GETEVENTS : 0);
+    if (ret == -1 && errno == EINTR) {
+      // The call was interrupted, try again...
+      continue;
+    }
+    MG_ASSERT(ret >= 0, "While submitting io_uring operations an error occurred: {} ({})", strerror(errno), errno);
+    to_submit_ -= static_cast<unsigned>(ret);
+    if (to_submit_ == 0) return;
+  }
+}
+
+std::optional<IoUring::Completion> IoUring::PopCompletion() {
+  const unsigned head = *cq_head_;
+  if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) return std::nullopt;
+  const auto &cqe = static_cast<const io_uring_cqe *>(cqes_)[head & *cq_mask_];
+  Completion completion{cqe.user_data, cqe.res};
+  __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+  return completion;
+}
+
+#else
+
+std::unique_ptr<IoUring> IoUring::Create(unsigned, uint8_t *, size_t) { return nullptr; }
+
+IoUring::~IoUring() {}
+
+io_uring_sqe *IoUring::NextSubmissionEntry() { LOG_FATAL("io_uring isn't supported!"); }
+
+void IoUring::PrepareWriteFixed(int, const uint8_t *, size_t, uint64_t, bool) {
+  LOG_FATAL("io_uring isn't supported!");
+}
+
+void IoUring::PrepareFsync(int, uint64_t) { LOG_FATAL("io_uring isn't supported!"); }
+
+void IoUring::PrepareRecv(int, uint8_t *, size_t, uint64_t) { LOG_FATAL("io_uring isn't supported!"); }
+
+void IoUring::Submit(unsigned) { LOG_FATAL("io_uring isn't supported!"); }
+
+std::optional<IoUring::Completion> IoUring::PopCompletion() { LOG_FATAL("io_uring isn't supported!"); }
+
+#endif
+
+}  // namespace utils
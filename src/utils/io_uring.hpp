@@ -0,0 +1,102 @@
+// Copyright 2021 Memgraph Ltd.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.txt; by using this file, you agree to be bound by the terms of the Business Source
+// License, and you may not use this file except in compliance with the Business Source License.
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0, included in the file
+// licenses/APL.txt.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+
+struct io_uring_sqe;
+
+namespace utils {
+
+/// Minimal wrapper around a Linux io_uring instance that is used directly
+/// through its system calls. It supports only the operations needed by
+/// `OutputFile` (writes from registered buffers and `fsync`) and by the network
+/// listener (socket receives). The wrapper isn't thread safe. The operations are virtual so that tests can wrap a ring and
+/// inject faults.
+class IoUring {
+ public:
+  struct Completion {
+    uint64_t user_data;
+    int32_t result;
+  };
+
+  /// Signature of `Create`, used to replace the created rings in tests.
+  using Factory = std::function<std::unique_ptr<IoUring>(unsigned entries, uint8_t *buffer, size_t buffer_size)>;
+
+  /// Creates a ring with `entries` submission slots and registers the given
+  /// buffer as the ring's fixed buffer with index 0, unless `buffer` is
+  /// `nullptr`. Returns `nullptr` if the kernel doesn't support io_uring or the
+  /// features needed by `OutputFile`.
+  static std::unique_ptr<IoUring> Create(unsigned entries, uint8_t *buffer, size_t buffer_size);
+
+  virtual ~IoUring();
+
+  IoUring(const IoUring &) = delete;
+  IoUring(IoUring &&) = delete;
+  IoUring &operator=(const IoUring &) = delete;
+  IoUring &operator=(IoUring &&) = delete;
+
+  /// Prepares a write of `size` bytes from the registered buffer to the
+  /// current position of `fd`. If `link` is set, the next prepared operation
+  /// is started only after this one completes successfully.
+  virtual void PrepareWriteFixed(int fd, const uint8_t *data, size_t size, uint64_t user_data, bool link);
+
+  /// Prepares an `fsync` of `fd`.
+  virtual void PrepareFsync(int fd, uint64_t user_data);
+
+  /// Prepares a `recv` of at most `size` bytes from the socket `fd`. The
+  /// receive doesn't wait for data, the completion's result is the same as the
+  /// return value of a non-blocking `recv`, with the error negated.
+  virtual void PrepareRecv(int fd, uint8_t *data, size_t size, uint64_t user_data);
+
+  /// Submits all prepared operations and waits until at least `wait_count`
+  /// completions are available. On failure it crashes the program.
+  virtual void Submit(unsigned wait_count);
+
+  /// Returns the next available completion without blocking.
+  virtual std::optional<Completion> PopCompletion();
+
+ protected:
+  /// Creates an object without a ring, for wrappers that forward the
+  /// operations to another ring.
+  IoUring() = default;
+
+ private:
+
+  io_uring_sqe *NextSubmissionEntry();
+
+  int fd_{-1};
+
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  void *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  unsigned *sq_head_{nullptr};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  void *cqes_{nullptr};
+
+  unsigned to_submit_{0};
+};
+
+}  // namespace utils
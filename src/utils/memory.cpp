@@ -12,12 +12,15 @@
 #include "utils/memory.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <limits>
 #include <type_traits>
+#include <unordered_map>
 
 #include "utils/logging.hpp"
+#include "utils/synchronized.hpp"
 
 namespace utils {
 
@@ -347,4 +350,152 @@ void PoolResource::Release() {
 
 // PoolResource END
 
+// ThreadCachingPoolResource
+
+namespace {
+
+// Thread caches outlive the resources they cache blocks for, so they check
+// whether the resource is still alive before touching it.
+auto &LiveThreadCachingResources() {
+  static utils::Synchronized<std::unordered_map<uint64_t, ThreadCachingPoolResource *>, std::mutex> resources;
+  return resources;
+}
+
+std::atomic<uint64_t> thread_caching_resource_id{0};
+
+template <class TFreeBlocks>
+auto FindFreeBlocks(std::vector<TFreeBlocks> *free_blocks, size_t block_size) {
+  auto it = std::lower_bound(free_blocks->begin(), free_blocks->end(), block_size,
+                             [](const auto &a, size_t size) { return a.block_size < size; });
+  if (it == free_blocks->end() || it->block_size != block_size) {
+    it = free_blocks->insert(it, TFreeBlocks{block_size, {}});
+  }
+  return it;
+}
+
+}  // namespace
+
+struct ThreadCachingPoolResource::ThreadCache {
+  uint64_t resource_id;
+  // Sorted by block_size.
+  std::vector<FreeBlocks> magazines;
+  FreeBlocks *last_magazine{nullptr};
+
+  explicit ThreadCache(uint64_t id) : resource_id(id) {}
+
+  ThreadCache(const ThreadCache &) = delete;
+  ThreadCache &operator=(const ThreadCache &) = delete;
+  ThreadCache(ThreadCache &&) = delete;
+  ThreadCache &operator=(ThreadCache &&) = delete;
+
+  ~ThreadCache() {
+    // The resource can't be destroyed while we hold the lock on the live
+    // resources.
+    LiveThreadCachingResources().WithLock([this](auto &resources) {
+      auto found = resources.find(resource_id);
+      if (found == resources.end()) return;
+      auto *resource = found->second;
+      std::lock_guard<SpinLock> guard(resource->lock_);
+      for (auto &magazine : magazines) {
+        auto &depot = FindFreeBlocks(&resource->depot_, magazine.block_size)->blocks;
+        depot.insert(depot.end(), magazine.blocks.begin(), magazine.blocks.end());
+      }
+    });
+  }
+};
+
+ThreadCachingPoolResource::ThreadCachingPoolResource(size_t max_blocks_per_chunk, size_t max_block_size,
+                                                     MemoryResource *memory)
+    : id_(thread_caching_resource_id.fetch_add(1, std::memory_order_relaxed)),
+      max_block_size_(max_block_size),
+      pool_memory_(max_blocks_per_chunk, max_block_size, memory) {
+  LiveThreadCachingResources()->emplace(id_, this);
+}
+
+ThreadCachingPoolResource::~ThreadCachingPoolResource() { LiveThreadCachingResources()->erase(id_); }
+
+ThreadCachingPoolResource::FreeBlocks &ThreadCachingPoolResource::GetMagazine(size_t block_size) {
+  thread_local std::vector<std::unique_ptr<ThreadCache>> caches;
+  thread_local ThreadCache *last_cache{nullptr};
+  if (!last_cache || last_cache->resource_id != id_) {
+    auto found =
+        std::find_if(caches.begin(), caches.end(), [this](const auto &cache) { return cache->resource_id == id_; });
+    if (found != caches.end()) {
+      last_cache = found->get();
+    } else {
+      // Drop the caches of destroyed resources, their blocks are gone anyway.
+      auto live_ids = LiveThreadCachingResources().WithLock([](const auto &resources) {
+        std::vector<uint64_t> ids;
+        for (const auto &cache : caches) {
+          if (resources.contains(cache->resource_id)) ids.push_back(cache->resource_id);
+        }
+        return ids;
+      });
+      std::erase_if(caches, [&live_ids](const auto &cache) {
+        return std::find(live_ids.begin(), live_ids.end(), cache->resource_id) == live_ids.end();
+      });
+      last_cache = caches.emplace_back(std::make_unique<ThreadCache>(id_)).get();
+    }
+  }
+  auto *magazine = last_cache->last_magazine;
+  if (!magazine || magazine->block_size != block_size) {
+    magazine = &*FindFreeBlocks(&last_cache->magazines, block_size);
+    magazine->blocks.reserve(kMagazineSize);
+    last_cache->last_magazine = magazine;
+  }
+  return *magazine;
+}
+
+void ThreadCachingPoolResource::Refill(FreeBlocks *magazine, size_t alignment) {
+  const auto count = kMagazineSize / 2;
+  std::lock_guard<SpinLock> guard(lock_);
+  auto &depot = FindFreeBlocks(&depot_, magazine->block_size)->blocks;
+  const auto taken = std::min(count, depot.size());
+  magazine->blocks.insert(magazine->blocks.end(), depot.end() - taken, depot.end());
+  depot.resize(depot.size() - taken);
+  for (auto i = taken; i < count; ++i) {
+    magazine->blocks.push_back(pool_memory_.Allocate(magazine->block_size, alignment));
+  }
+}
+
+void ThreadCachingPoolResource::Flush(FreeBlocks *magazine, size_t count) {
+  auto &blocks = magazine->blocks;
+  std::lock_guard<SpinLock> guard(lock_);
+  auto &depot = FindFreeBlocks(&depot_, magazine->block_size)->blocks;
+  depot.insert(depot.end(), blocks.end() - count, blocks.end());
+  blocks.resize(blocks.size() - count);
+}
+
+void *ThreadCachingPoolResource::DoAllocate(size_t bytes, size_t alignment) {
+  // Same restrictions as in PoolResource, see PoolResource::DoAllocate.
+  size_t block_size = std::max(bytes, alignment);
+  if (block_size % alignment != 0) throw BadAlloc("Requested bytes must be a multiple of alignment");
+  if (block_size > max_block_size_) {
+    std::lock_guard<SpinLock> guard(lock_);
+    return pool_memory_.Allocate(bytes, alignment);
+  }
+  auto &magazine = GetMagazine(block_size);
+  if (magazine.blocks.empty()) Refill(&magazine, alignment);
+  auto *block = magazine.blocks.back();
+  magazine.blocks.pop_back();
+  return block;
+}
+
+void ThreadCachingPoolResource::DoDeallocate(void *p, size_t bytes, size_t alignment) {
+  size_t block_size = std::max(bytes, alignment);
+  MG_ASSERT(block_size % alignment == 0,
+            "ThreadCachingPoolResource shouldn't serve allocation requests where bytes aren't "
+            "a multiple of alignment");
+  if (block_size > max_block_size_) {
+    std::lock_guard<SpinLock> guard(lock_);
+    pool_memory_.Deallocate(p, bytes, alignment);
+    return;
+  }
+  auto &magazine = GetMagazine(block_size);
+  if (magazine.blocks.size() >= kMagazineSize) Flush(&magazine, kMagazineSize / 2);
+  magazine.blocks.push_back(p);
+}
+
+// ThreadCachingPoolResource END
+
 }  // namespace utils
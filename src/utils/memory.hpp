@@ -537,6 +537,66 @@ class SynchronizedPoolResource final : public MemoryResource {
   bool DoIsEqual(const MemoryResource &other) const noexcept override { return this == &other; }
 };
 
+/// Like SynchronizedPoolResource but most requests don't synchronize with
+/// other threads.
+///
+/// This class has the following properties with regards to memory management.
+///
+///   * Each thread caches free blocks of every block size in a magazine of at
+///     most kMagazineSize blocks. Allocations and deallocations use only the
+///     magazine of the calling thread.
+///   * An empty magazine is refilled with kMagazineSize / 2 blocks, taken from
+///     a shared depot of free blocks or allocated from the underlying
+///     PoolResource. A full magazine returns kMagazineSize / 2 blocks to the
+///     depot. Both take the lock once per batch.
+///   * Blocks cached by a thread are returned to the depot when it exits.
+///     Free blocks are never returned to the underlying PoolResource, all
+///     memory is freed upon destruction.
+///   * Allocation requests which exceed the maximum block size are forwarded
+///     to the underlying PoolResource while holding the lock.
+class ThreadCachingPoolResource final : public MemoryResource {
+ public:
+  static constexpr size_t kMagazineSize = 64;
+
+  ThreadCachingPoolResource(size_t max_blocks_per_chunk, size_t max_block_size,
+                            MemoryResource *memory = NewDeleteResource());
+
+  ThreadCachingPoolResource(const ThreadCachingPoolResource &) = delete;
+  ThreadCachingPoolResource &operator=(const ThreadCachingPoolResource &) = delete;
+  ThreadCachingPoolResource(ThreadCachingPoolResource &&) = delete;
+  ThreadCachingPoolResource &operator=(ThreadCachingPoolResource &&) = delete;
+
+  ~ThreadCachingPoolResource() override;
+
+ private:
+  struct FreeBlocks {
+    size_t block_size;
+    std::vector<void *> blocks;
+  };
+
+  struct ThreadCache;
+
+  // Identifies the resource in thread caches, it's never reused.
+  uint64_t id_;
+  size_t max_block_size_;
+  SpinLock lock_;
+  // Both are protected by lock_.
+  PoolResource pool_memory_;
+  std::vector<FreeBlocks> depot_;
+
+  FreeBlocks &GetMagazine(size_t block_size);
+
+  void Refill(FreeBlocks *magazine, size_t alignment);
+
+  void Flush(FreeBlocks *magazine, size_t count);
+
+  void *DoAllocate(size_t bytes, size_t alignment) override;
+
+  void DoDeallocate(void *p, size_t bytes, size_t alignment) override;
+
+  bool DoIsEqual(const MemoryResource &other) const noexcept override { return this == &other; }
+};
+
 class LimitedMemoryResource final : public utils::MemoryResource {
  public:
   explicit LimitedMemoryResource(utils::MemoryResource *memory, size_t max_allocated_bytes)
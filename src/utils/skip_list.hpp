@@ -99,18 +99,40 @@ struct SkipListNode {
   std::atomic<SkipListNode<TObj> *> nexts[0];
 };
 
+/// Get the size in bytes of a SkipListNode instance with the given height.
+///
+/// The size is always a multiple of the node alignment, so nodes of the same
+/// height can be served from a pool allocator (e.g. PoolResource) which keeps
+/// a separate pool for each block size.
+template <typename TObj>
+constexpr size_t SkipListNodeSize(uint64_t height) {
+  constexpr size_t alignment = alignof(SkipListNode<TObj>);
+  size_t size = sizeof(SkipListNode<TObj>) + height * sizeof(std::atomic<SkipListNode<TObj> *>);
+  return (size + alignment - 1) / alignment * alignment;
+}
+
 /// Maximum size of a single SkipListNode instance.
 ///
 /// This can be used to tune the pool allocator for SkipListNode instances.
 template <typename TObj>
 constexpr size_t MaxSkipListNodeSize() {
-  return sizeof(SkipListNode<TObj>) + kSkipListMaxHeight * sizeof(std::atomic<SkipListNode<TObj> *>);
+  return SkipListNodeSize<TObj>(kSkipListMaxHeight);
 }
 
 /// Get the size in bytes of the given SkipListNode instance.
 template <typename TObj>
 size_t SkipListNodeSize(const SkipListNode<TObj> &node) {
-  return sizeof(node) + node.height * sizeof(std::atomic<SkipListNode<TObj> *>);
+  return SkipListNodeSize<TObj>(node.height);
+}
+
+/// Hint the CPU to start loading the parts of the node which are read when
+/// the node is visited on the given layer. The load then overlaps with the
+/// comparison of the current node instead of stalling the next step.
+template <typename TObj>
+inline void PrefetchSkipListNode(const SkipListNode<TObj> *node, int layer) {
+  if (node == nullptr) return;
+  __builtin_prefetch(&node->obj);
+  __builtin_prefetch(&node->nexts[layer]);
 }
 
 /// A helper function for determining the skip list layer used for estimating
@@ -332,7 +354,7 @@ class SkipListGc final {
       if (item->first < last_dead) {
         size_t bytes = SkipListNodeSize(*item->second);
         item->second->~TNode();
-        memory_->Deallocate(item->second, bytes);
+        memory_->Deallocate(item->second, bytes, alignof(TNode));
       } else {
         leftover.Push(*item);
       }
@@ -363,7 +385,7 @@ class SkipListGc final {
     while ((item = deleted_.Pop())) {
       size_t bytes = SkipListNodeSize(*item->second);
       item->second->~TNode();
-      memory_->Deallocate(item->second, bytes);
+      memory_->Deallocate(item->second, bytes, alignof(TNode));
     }
 
     // Reset all variables.
@@ -580,6 +602,9 @@ class SkipList final {
         if (node_ != nullptr && node_->marked.load(std::memory_order_acquire)) {
           continue;
         } else {
+          // The caller processes the current object before moving on, so the
+          // next node can be loaded in the meantime.
+          if (node_ != nullptr) PrefetchSkipListNode(node_->nexts[0].load(std::memory_order_relaxed), 0);
           return *this;
         }
       }
@@ -612,6 +637,7 @@ class SkipList final {
         if (node_ != nullptr && node_->marked.load(std::memory_order_acquire)) {
           continue;
         } else {
+          if (node_ != nullptr) PrefetchSkipListNode(node_->nexts[0].load(std::memory_order_relaxed), 0);
           return *this;
         }
       }
@@ -825,7 +851,7 @@ class SkipList final {
 
   explicit SkipList(MemoryResource *memory = NewDeleteResource()) : gc_(memory) {
     static_assert(kSkipListMaxHeight <= 32, "The SkipList height must be less or equal to 32!");
-    void *ptr = memory->Allocate(MaxSkipListNodeSize<TObj>());
+    void *ptr = memory->Allocate(MaxSkipListNodeSize<TObj>(), alignof(TNode));
     // `calloc` would be faster, but the API has no such call.
     memset(ptr, 0, MaxSkipListNodeSize<TObj>());
     // Here we don't call the `SkipListNode` constructor so that the `TObj`
@@ -851,7 +877,7 @@ class SkipList final {
       TNode *succ = head->nexts[0].load(std::memory_order_acquire);
       size_t bytes = SkipListNodeSize(*head);
       head->~TNode();
-      GetMemoryResource()->Deallocate(head, bytes);
+      GetMemoryResource()->Deallocate(head, bytes, alignof(TNode));
       head = succ;
     }
     head_ = other.head_;
@@ -872,7 +898,7 @@ class SkipList final {
       // constructor (see the note in the `SkipList` constructor). We mustn't
       // call the `TObj` destructor because we didn't call its constructor.
       head_->lock.~SpinLock();
-      GetMemoryResource()->Deallocate(head_, SkipListNodeSize(*head_));
+      GetMemoryResource()->Deallocate(head_, SkipListNodeSize(*head_), alignof(TNode));
     }
   }
 
@@ -896,7 +922,7 @@ class SkipList final {
       TNode *succ = curr->nexts[0].load(std::memory_order_acquire);
       size_t bytes = SkipListNodeSize(*curr);
       curr->~TNode();
-      GetMemoryResource()->Deallocate(curr, bytes);
+      GetMemoryResource()->Deallocate(curr, bytes, alignof(TNode));
       curr = succ;
     }
     for (int layer = 0; layer < kSkipListMaxHeight; ++layer) {
@@ -916,9 +942,14 @@ class SkipList final {
     for (int layer = kSkipListMaxHeight - 1; layer >= 0; --layer) {
       TNode *curr = pred->nexts[layer].load(std::memory_order_acquire);
       // Existence test is missing in the paper.
-      while (curr != nullptr && curr->obj < key) {
+      while (curr != nullptr) {
+        // Start loading the successor before comparing `curr`, the comparison
+        // may take a while (e.g. for `PropertyValue` keys).
+        TNode *succ = curr->nexts[layer].load(std::memory_order_acquire);
+        PrefetchSkipListNode(succ, layer);
+        if (!(curr->obj < key)) break;
         pred = curr;
-        curr = pred->nexts[layer].load(std::memory_order_acquire);
+        curr = succ;
       }
       // Existence test is missing in the paper.
       if (layer_found == -1 && curr && curr->obj == key) {
@@ -968,8 +999,8 @@ class SkipList final {
 
       if (!valid) continue;
 
-      size_t node_bytes = sizeof(TNode) + top_layer * sizeof(std::atomic<TNode *>);
-      void *ptr = GetMemoryResource()->Allocate(node_bytes);
+      size_t node_bytes = SkipListNodeSize<TObj>(top_layer);
+      void *ptr = GetMemoryResource()->Allocate(node_bytes, alignof(TNode));
       // `calloc` would be faster, but the API has no such call.
       memset(ptr, 0, node_bytes);
       auto *new_node = static_cast<TNode *>(ptr);
@@ -11,6 +11,12 @@
 
 #include "utils/thread_pool.hpp"
 
+#include <exception>
+
+#include <fmt/format.h>
+
+#include "utils/logging.hpp"
+
 namespace utils {
 
 ThreadPool::ThreadPool(const size_t pool_size) {
@@ -87,4 +93,108 @@ void ThreadPool::ThreadLoop() {
 
 size_t ThreadPool::UnfinishedTasksNum() const { return unfinished_tasks_num_.load(); }
 
+void RunOnThreads(ThreadPool *pool, uint64_t worker_count, const std::function<void(uint64_t)> &task) {
+  std::vector<std::exception_ptr> exceptions(worker_count);
+  auto run_task = [&task, &exceptions](uint64_t worker) noexcept {
+    try {
+      task(worker);
+    } catch (...) {
+      exceptions[worker] = std::current_exception();
+    }
+  };
+  std::mutex mutex;
+  std::condition_variable finished_cv;
+  uint64_t unfinished_workers = worker_count - 1;
+  for (uint64_t worker = 1; worker < worker_count; ++worker) {
+    pool->AddTask([&, worker] {
+      run_task(worker);
+      std::lock_guard guard(mutex);
+      --unfinished_workers;
+      // Notify under the lock, as the waiting thread destroys the condition
+      // variable as soon as it sees that all workers finished.
+      finished_cv.notify_one();
+    });
+  }
+  run_task(0);
+  {
+    std::unique_lock guard(mutex);
+    finished_cv.wait(guard, [&] { return unfinished_workers == 0; });
+  }
+  for (auto &exception : exceptions) {
+    if (exception) std::rethrow_exception(exception);
+  }
+}
+
+PriorityThreadPool::PriorityThreadPool(const size_t pool_size, const size_t reserved_count, const std::string &name) {
+  MG_ASSERT(reserved_count < pool_size, "At least one thread of the pool must run low priority tasks!");
+  for (size_t i = 0; i < pool_size; ++i) {
+    const bool high_priority_only = i < reserved_count;
+    thread_pool_.emplace_back([this, high_priority_only, name, i] {
+      utils::ThreadSetName(fmt::format("{} exec {}", name, i + 1));
+      this->ThreadLoop(high_priority_only);
+    });
+  }
+}
+
+void PriorityThreadPool::AddTask(std::function<void()> new_task, const Priority priority) {
+  {
+    std::lock_guard guard(lock_);
+    if (priority == Priority::HIGH) {
+      high_priority_tasks_.push_back(std::move(new_task));
+    } else {
+      low_priority_tasks_.push_back(std::move(new_task));
+    }
+    unfinished_tasks_num_.fetch_add(1);
+  }
+  if (priority == Priority::HIGH) {
+    // Either kind of thread can take the task, prefer the reserved ones so
+    // that the shared threads stay free for low priority work.
+    reserved_cv_.notify_one();
+  }
+  shared_cv_.notify_one();
+}
+
+void PriorityThreadPool::Shutdown() {
+  {
+    std::lock_guard guard(lock_);
+    terminate_pool_ = true;
+  }
+  reserved_cv_.notify_all();
+  shared_cv_.notify_all();
+
+  for (auto &thread : thread_pool_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  thread_pool_.clear();
+}
+
+PriorityThreadPool::~PriorityThreadPool() { Shutdown(); }
+
+void PriorityThreadPool::ThreadLoop(const bool high_priority_only) {
+  auto &cv = high_priority_only ? reserved_cv_ : shared_cv_;
+  std::unique_lock guard(lock_);
+  while (true) {
+    cv.wait(guard, [&] {
+      return terminate_pool_ || !high_priority_tasks_.empty() ||
+             (!high_priority_only && !low_priority_tasks_.empty());
+    });
+    if (terminate_pool_) {
+      return;
+    }
+
+    auto &tasks = high_priority_tasks_.empty() ? low_priority_tasks_ : high_priority_tasks_;
+    auto task = std::move(tasks.front());
+    tasks.pop_front();
+
+    guard.unlock();
+    task();
+    unfinished_tasks_num_.fetch_sub(1);
+    guard.lock();
+  }
+}
+
+size_t PriorityThreadPool::UnfinishedTasksNum() const { return unfinished_tasks_num_.load(); }
+
 }  // namespace utils
@@ -12,10 +12,14 @@
 #pragma once
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "utils/spin_lock.hpp"
 #include "utils/synchronized.hpp"
@@ -57,4 +61,53 @@ class ThreadPool {
   std::condition_variable queue_cv_;
 };
 
+/// Runs `task(worker)` for every worker in [0, `worker_count`), worker 0 on the
+/// calling thread and the others on the `pool`. Waits for all of them and
+/// rethrows the first exception thrown by any of them. The pool must have
+/// `worker_count - 1` idle threads, otherwise some workers wait for a thread.
+void RunOnThreads(ThreadPool *pool, uint64_t worker_count, const std::function<void(uint64_t)> &task);
+
+/**
+ * Thread pool with two task priorities. High priority tasks are always taken
+ * before low priority ones and `reserved_count` of the threads run only high
+ * priority tasks, so a burst of low priority tasks can never occupy the whole
+ * pool. Tasks that are still queued when the pool is shut down are dropped.
+ */
+class PriorityThreadPool {
+  using TaskSignature = std::function<void()>;
+
+ public:
+  enum class Priority : uint8_t { LOW, HIGH };
+
+  PriorityThreadPool(size_t pool_size, size_t reserved_count, const std::string &name);
+
+  void AddTask(std::function<void()> new_task, Priority priority);
+
+  void Shutdown();
+
+  ~PriorityThreadPool();
+
+  PriorityThreadPool(const PriorityThreadPool &) = delete;
+  PriorityThreadPool(PriorityThreadPool &&) = delete;
+  PriorityThreadPool &operator=(const PriorityThreadPool &) = delete;
+  PriorityThreadPool &operator=(PriorityThreadPool &&) = delete;
+
+  size_t UnfinishedTasksNum() const;
+
+ private:
+  void ThreadLoop(bool high_priority_only);
+
+  std::vector<std::thread> thread_pool_;
+
+  std::atomic<size_t> unfinished_tasks_num_{0};
+  bool terminate_pool_{false};
+  std::mutex lock_;
+  std::deque<TaskSignature> high_priority_tasks_;
+  std::deque<TaskSignature> low_priority_tasks_;
+  // Reserved threads wait on their own condition variable so that a low
+  // priority task never wakes up a thread that can't run it.
+  std::condition_variable reserved_cv_;
+  std::condition_variable shared_cv_;
+};
+
 }  // namespace utils
@@ -0,0 +1,44 @@
+#include <array>
+
+#include <benchmark/benchmark.h>
+
+#include "utils/memory.hpp"
+
+// Every thread allocates and deallocates kBatchSize blocks of mixed sizes in
+// each iteration, all threads share the same memory resource.
+constexpr size_t kBatchSize = 16;
+constexpr size_t kMaxBlocksPerChunk = 128;
+constexpr size_t kMaxBlockSize = 1024;
+
+utils::MemoryResource *NewDelete() { return utils::NewDeleteResource(); }
+
+utils::MemoryResource *SynchronizedPool() {
+  static utils::SynchronizedPoolResource memory(kMaxBlocksPerChunk, kMaxBlockSize);
+  return &memory;
+}
+
+utils::MemoryResource *ThreadCachingPool() {
+  static utils::ThreadCachingPoolResource memory(kMaxBlocksPerChunk, kMaxBlockSize);
+  return &memory;
+}
+
+// NOLINTNEXTLINE(google-runtime-references)
+static void Allocations(benchmark::State &state, utils::MemoryResource *(*get_memory)()) {
+  auto *memory = get_memory();
+  std::array<void *, kBatchSize> blocks{};
+  auto block_size = [](size_t i) { return 16U << (i % 4U); };
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kBatchSize; ++i) blocks[i] = memory->Allocate(block_size(i));
+    benchmark::DoNotOptimize(blocks.data());
+    for (size_t i = 0; i < kBatchSize; ++i) memory->Deallocate(blocks[i], block_size(i));
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+BENCHMARK_CAPTURE(Allocations, NewDelete, &NewDelete)->ThreadRange(1, 32)->UseRealTime();
+
+BENCHMARK_CAPTURE(Allocations, SynchronizedPool, &SynchronizedPool)->ThreadRange(1, 32)->UseRealTime();
+
+BENCHMARK_CAPTURE(Allocations, ThreadCachingPool, &ThreadCachingPool)->ThreadRange(1, 32)->UseRealTime();
+
+BENCHMARK_MAIN();
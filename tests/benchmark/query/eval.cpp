@@ -74,4 +74,40 @@ BENCHMARK_TEMPLATE(AdditionOperator, NewDeleteResource)->Range(1024, 1U << 15U)-
 
 BENCHMARK_TEMPLATE(AdditionOperator, MonotonicBufferResource)->Range(1024, 1U << 15U)->Unit(benchmark::kMicrosecond);
 
+template <class TMemory>
+// NOLINTNEXTLINE(google-runtime-references)
+static void PropertyComparison(benchmark::State &state) {
+  query::AstStorage ast;
+  query::SymbolTable symbol_table;
+  auto *ident = ast.Create<query::Identifier>("n");
+  ident->MapTo(symbol_table.CreateSymbol("n", true));
+  TMemory memory;
+  query::Frame frame(symbol_table.max_position(), memory.get());
+  storage::Storage db;
+  auto storage_dba = db.Access();
+  query::DbAccessor dba(&storage_dba);
+  auto vertex = dba.InsertVertex();
+  MG_ASSERT(vertex.SetProperty(dba.NameToProperty("prop"), storage::PropertyValue(42)).HasValue());
+  dba.AdvanceCommand();
+  frame[symbol_table.at(*ident)] = query::TypedValue(vertex);
+  // n.prop < 0 AND n.prop < 1 AND ...
+  query::Expression *expr = ast.Create<query::PrimitiveLiteral>(true);
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    auto *lookup = ast.Create<query::PropertyLookup>(ident, ast.GetPropertyIx("prop"));
+    expr = ast.Create<query::AndOperator>(
+        expr, ast.Create<query::GreaterOperator>(lookup, ast.Create<query::PrimitiveLiteral>(i)));
+  }
+  query::EvaluationContext evaluation_context{memory.get()};
+  evaluation_context.properties = query::NamesToProperties(ast.properties_, &dba);
+  query::ExpressionEvaluator evaluator(&frame, symbol_table, evaluation_context, &dba, storage::View::NEW);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(expr->Accept(evaluator));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(PropertyComparison, NewDeleteResource)->Range(8, 32)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TEMPLATE(PropertyComparison, MonotonicBufferResource)->Range(8, 32)->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_MAIN();
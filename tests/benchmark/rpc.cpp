@@ -49,6 +49,7 @@ std::optional<rpc::Server> server;
 std::optional<communication::ClientContext> client_context;
 std::optional<rpc::Client> clients[kThreadsNum];
 std::optional<rpc::ClientPool> client_pool;
+std::optional<rpc::Client> shared_client;
 
 static void BenchmarkRpc(benchmark::State &state) {
   std::string data(state.range(0), 'a');
@@ -66,6 +67,14 @@ static void BenchmarkRpcPool(benchmark::State &state) {
   state.SetItemsProcessed(state.iterations());
 }
 
+static void BenchmarkRpcShared(benchmark::State &state) {
+  std::string data(state.range(0), 'a');
+  while (state.KeepRunning()) {
+    shared_client->Call<Echo>(data);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
 BENCHMARK(BenchmarkRpc)
     ->RangeMultiplier(4)
     ->Range(4, 1 << 13)
@@ -80,6 +89,13 @@ BENCHMARK(BenchmarkRpcPool)
     ->Unit(benchmark::kNanosecond)
     ->UseRealTime();
 
+BENCHMARK(BenchmarkRpcShared)
+    ->RangeMultiplier(4)
+    ->Range(4, 1 << 13)
+    ->ThreadRange(1, kThreadsNum)
+    ->Unit(benchmark::kNanosecond)
+    ->UseRealTime();
+
 int main(int argc, char **argv) {
   ::benchmark::Initialize(&argc, argv);
   gflags::AllowCommandLineReparsing();
@@ -120,6 +136,11 @@ int main(int argc, char **argv) {
       clients[i]->Call<Echo>("init");
     }
 
+    // All of the threads call the Echo RPC concurrently over this client's
+    // single connection.
+    shared_client.emplace(endpoint, &client_context.value());
+    shared_client->Call<Echo>("init");
+
     // The client pool connects to the server only when there are no leftover
     // unused RPC clients (during concurrent execution). To reduce the overhead
     // of making connections to the server during the benchmark here we
@@ -1,14 +1,17 @@
 #include "skip_list_common.hpp"
 
+#include "utils/memory.hpp"
 #include "utils/skip_list.hpp"
 
 DEFINE_int32(max_element, 20000, "Maximum element in the intial list");
 DEFINE_int32(max_range, 2000000, "Maximum range used for the test");
+DEFINE_bool(node_pool, false, "Allocate the nodes from a pool with a separate block size for each node height");
 
 int main(int argc, char **argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
-  utils::SkipList<uint64_t> list;
+  utils::ThreadCachingPoolResource node_pool(128, utils::MaxSkipListNodeSize<uint64_t>());
+  utils::SkipList<uint64_t> list(FLAGS_node_pool ? &node_pool : utils::NewDeleteResource());
 
   {
     auto acc = list.access();
@@ -0,0 +1,111 @@
+import sys
+import pytest
+from common import execute_and_fetch_all
+
+# Vertices with ids 0-6 and the edges between them:
+#   0 -> 1 -> 2 -> 0, 2 -> 3, 3 -> 4, 4 -> 3, 6 -> 5
+EDGES = [(0, 1), (1, 2), (2, 0), (2, 3), (3, 4), (4, 3), (6, 5)]
+
+
+@pytest.fixture
+def cursor(connection):
+    cursor = connection.cursor()
+    execute_and_fetch_all(cursor, "UNWIND range(0, 6) AS id "
+                                  "CREATE (:Node {id: id})")
+    execute_and_fetch_all(
+        cursor, "UNWIND $edges AS edge "
+                "MATCH (a:Node {id: edge[0]}), (b:Node {id: edge[1]}) "
+                "CREATE (a)-[:EDGE]->(b)", {"edges": EDGES})
+    return cursor
+
+
+def fetch_by_id(cursor, query):
+    return dict(execute_and_fetch_all(cursor, query))
+
+
+def group_components(cursor, procedure, field, args=""):
+    components = {}
+    for node_id, component in execute_and_fetch_all(
+            cursor, f"CALL graph_algorithms.{procedure}({args}) "
+                    f"YIELD node, {field} RETURN node.id, {field}"):
+        components.setdefault(component, set()).add(node_id)
+    return sorted(sorted(component) for component in components.values())
+
+
+def test_weakly_connected_components(cursor):
+    assert group_components(
+        cursor, "weakly_connected_components",
+        "component_id") == [[0, 1, 2, 3, 4], [5, 6]]
+
+
+def test_strongly_connected_components(cursor):
+    assert group_components(
+        cursor, "strongly_connected_components",
+        "component_id") == [[0, 1, 2], [3, 4], [5], [6]]
+
+
+def test_pagerank(cursor):
+    ranks = fetch_by_id(cursor, "CALL graph_algorithms.pagerank() "
+                                "YIELD node, rank RETURN node.id, rank")
+    assert len(ranks) == 7
+    assert sum(ranks.values()) == pytest.approx(1.0)
+    assert ranks[3] > ranks[2] > ranks[0]
+    assert ranks[5] > ranks[6]
+
+
+def test_betweenness_centrality(cursor):
+    betweenness = fetch_by_id(
+        cursor, "CALL graph_algorithms.betweenness_centrality() "
+                "YIELD node, betweenness RETURN node.id, betweenness")
+    expected = {0: 1, 1: 3, 2: 5, 3: 3, 4: 0, 5: 0, 6: 0}
+    for node_id, paths in expected.items():
+        assert betweenness[node_id] == pytest.approx(paths / 30)
+
+
+def test_triangle_count(cursor):
+    triangles = fetch_by_id(
+        cursor, "CALL graph_algorithms.triangle_count() "
+                "YIELD node, triangles RETURN node.id, triangles")
+    assert triangles == {0: 1, 1: 1, 2: 1, 3: 0, 4: 0, 5: 0, 6: 0}
+
+
+def test_label_propagation(cursor):
+    communities = fetch_by_id(
+        cursor, "CALL graph_algorithms.label_propagation() "
+                "YIELD node, community_id RETURN node.id, community_id")
+    assert communities[0] == communities[1] == communities[2]
+    assert communities[5] == communities[6]
+    assert communities[0] != communities[5]
+
+
+def test_projection_filters(cursor):
+    execute_and_fetch_all(cursor, "CREATE (:Other)-[:EDGE]->(:Other)")
+    execute_and_fetch_all(
+        cursor, "MATCH (a:Node {id: 4}), (b:Node {id: 5}) "
+                "CREATE (a)-[:OTHER]->(b)")
+    assert group_components(
+        cursor, "weakly_connected_components", "component_id",
+        "'Node', 'EDGE'") == [[0, 1, 2, 3, 4], [5, 6]]
+
+
+
+def test_projection_unindexed_label(cursor):
+    execute_and_fetch_all(
+        cursor, "MATCH (n:Node) WHERE n.id IN [0, 1, 2, 3] SET n:Core")
+    assert group_components(
+        cursor, "strongly_connected_components", "component_id",
+        "'Core'") == [[0, 1, 2], [3]]
+
+
+def test_projection_indexed_label(cursor):
+    execute_and_fetch_all(cursor, "CREATE (:Other)-[:EDGE]->(:Other)")
+    execute_and_fetch_all(cursor, "CREATE INDEX ON :Node")
+    try:
+        assert group_components(
+            cursor, "weakly_connected_components", "component_id",
+            "'Node'") == [[0, 1, 2, 3, 4], [5, 6]]
+    finally:
+        execute_and_fetch_all(cursor, "DROP INDEX ON :Node")
+
+if __name__ == "__main__":
+    sys.exit(pytest.main([__file__, "-rA"]))
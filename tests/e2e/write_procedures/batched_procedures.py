@@ -0,0 +1,70 @@
+import sys
+import time
+
+import mgclient
+import pytest
+from common import connect, execute_and_fetch_all
+
+
+def pop_closed_generators(cursor: mgclient.Cursor):
+    return [row[0] for row in execute_and_fetch_all(
+        cursor, "CALL read.pop_closed_generators() YIELD graph_valid "
+                "RETURN graph_valid")]
+
+
+def test_exhausted_generator(connection):
+    cursor = connection.cursor()
+    pop_closed_generators(cursor)
+    # More records than fit into a single batch.
+    result = execute_and_fetch_all(
+        cursor, "CALL read.generate(2500) YIELD value RETURN value")
+    assert [row[0] for row in result] == list(range(2500))
+    assert pop_closed_generators(cursor) == [True]
+
+
+def test_generator_stopped_by_limit(connection):
+    cursor = connection.cursor()
+    pop_closed_generators(cursor)
+    result = execute_and_fetch_all(
+        cursor, "CALL read.generate(2500) YIELD value RETURN value LIMIT 10")
+    assert [row[0] for row in result] == list(range(10))
+    # The graph is invalidated before the generator is closed.
+    assert pop_closed_generators(cursor) == [False]
+
+
+def test_exception_in_generator(connection):
+    cursor = connection.cursor()
+    pop_closed_generators(cursor)
+    with pytest.raises(mgclient.DatabaseError, match="Failed at 1500"):
+        execute_and_fetch_all(
+            cursor, "CALL read.generate(2500, 1500) YIELD value RETURN value")
+    assert pop_closed_generators(cursor) == [True]
+    result = execute_and_fetch_all(
+        cursor, "CALL read.generate(3) YIELD value RETURN value")
+    assert [row[0] for row in result] == [0, 1, 2]
+
+
+def test_abandoned_generator(connection):
+    cursor = connection.cursor()
+    pop_closed_generators(cursor)
+    lazy_connection = connect(lazy=True)
+    lazy_cursor = lazy_connection.cursor()
+    lazy_cursor.execute(
+        "CALL read.generate(2500) YIELD value RETURN value")
+    assert lazy_cursor.fetchone()[0] == 0
+    # The query is aborted together with the session, before all of its
+    # results were pulled.
+    lazy_connection.close()
+
+    closed = []
+    for _ in range(50):
+        closed += pop_closed_generators(cursor)
+        if closed:
+            break
+        time.sleep(0.1)
+    assert closed == [False]
+    assert execute_and_fetch_all(cursor, "RETURN 1") == [(1,)]
+
+
+if __name__ == "__main__":
+    sys.exit(pytest.main([__file__, "-rA"]))
@@ -10,3 +10,27 @@ def underlying_graph_is_mutable(ctx: mgp.ProcCtx,
 @mgp.read_proc
 def graph_is_mutable(ctx: mgp.ProcCtx) -> mgp.Record(mutable=bool):
     return mgp.Record(mutable=ctx.graph.is_mutable())
+
+
+# Whether the graph was valid when the `finally` block of a `generate` call
+# ran, in the order of the calls.
+closed_generators = []
+
+
+@mgp.read_proc
+def generate(ctx: mgp.ProcCtx, count: int,
+             fail_at: int = -1) -> mgp.Record(value=int):
+    try:
+        for i in range(count):
+            if i == fail_at:
+                raise RuntimeError(f"Failed at {i}")
+            yield mgp.Record(value=i)
+    finally:
+        closed_generators.append(ctx.is_valid())
+
+
+@mgp.read_proc
+def pop_closed_generators(ctx: mgp.ProcCtx) -> mgp.Record(graph_valid=bool):
+    result = [mgp.Record(graph_valid=valid) for valid in closed_generators]
+    closed_generators.clear()
+    return result
@@ -105,6 +105,12 @@ parser.add_argument("--temporary-directory", default="/tmp",
                     "be stored")
 parser.add_argument("--no-properties-on-edges", action="store_true",
                     help="disable properties on edges")
+parser.add_argument("--query-modules-directory",
+                    default=",".join([
+                        helpers.get_binary_path("query_modules"),
+                        helpers.get_source_path("query_modules")]),
+                    help="comma separated directories from which Memgraph "
+                    "loads the query modules used by the benchmarks")
 args = parser.parse_args()
 
 # Detect available datasets.
@@ -161,7 +167,8 @@ for dataset, tests in benchmarks:
 
     # Prepare runners and import the dataset.
     memgraph = runners.Memgraph(args.memgraph_binary, args.temporary_directory,
-                                not args.no_properties_on_edges)
+                                not args.no_properties_on_edges,
+                                args.query_modules_directory)
     client = runners.Client(args.client_binary, args.temporary_directory)
     memgraph.start_preparation()
     ret = client.execute(file_path=dataset.get_file(),
@@ -277,3 +277,46 @@ class Pokec(Dataset):
     def benchmark__match__vertex_on_property(self):
         return ("MATCH (n {id: $id}) RETURN n",
                 {"id": self._get_random_vertex()})
+
+    # Graph algorithms, the native module compared against the NetworkX
+    # based procedures.
+
+    def benchmark__graph_algorithms__pagerank_native(self):
+        return ("CALL graph_algorithms.pagerank() YIELD rank "
+                "RETURN count(rank)", {})
+
+    def benchmark__graph_algorithms__pagerank_networkx(self):
+        return ("CALL nxalg.pagerank() YIELD rank "
+                "RETURN count(rank)", {})
+
+    def benchmark__graph_algorithms__betweenness_native(self):
+        return ("CALL graph_algorithms.betweenness_centrality(NULL, NULL, "
+                "100) YIELD betweenness RETURN count(betweenness)", {})
+
+    def benchmark__graph_algorithms__betweenness_networkx(self):
+        return ("CALL nxalg.betweenness_centrality(100) YIELD betweenness "
+                "RETURN count(betweenness)", {})
+
+    def benchmark__graph_algorithms__strongly_connected_components_native(
+            self):
+        return ("CALL graph_algorithms.strongly_connected_components() "
+                "YIELD component_id "
+                "RETURN count(DISTINCT component_id)", {})
+
+    def benchmark__graph_algorithms__strongly_connected_components_networkx(
+            self):
+        return ("CALL nxalg.strongly_connected_components() "
+                "YIELD components RETURN size(components)", {})
+
+    def benchmark__graph_algorithms__weakly_connected_components_native(
+            self):
+        return ("CALL graph_algorithms.weakly_connected_components() "
+                "YIELD component_id "
+                "RETURN count(DISTINCT component_id)", {})
+
+    def benchmark__graph_algorithms__weakly_connected_components_networkx(
+            self):
+        return ("MATCH (n) OPTIONAL MATCH (n)-[e]->() "
+                "WITH collect(DISTINCT n) AS vertices, collect(e) AS edges "
+                "CALL wcc.get_components(vertices, edges) "
+                "YIELD n_components RETURN n_components", {})
@@ -16,6 +16,10 @@ def get_binary_path(path, base=""):
     return os.path.join(dirpath, path)
 
 
+def get_source_path(path):
+    return os.path.normpath(os.path.join(SCRIPT_DIR, "..", "..", path))
+
+
 def download_file(url, path):
     ret = subprocess.run(["wget", "-nv", "--content-disposition", url],
                          stderr=subprocess.PIPE, cwd=path, check=True)
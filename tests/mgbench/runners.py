@@ -41,10 +41,12 @@ def _get_usage(pid):
 
 
 class Memgraph:
-    def __init__(self, memgraph_binary, temporary_dir, properties_on_edges):
+    def __init__(self, memgraph_binary, temporary_dir, properties_on_edges,
+                 query_modules_directory=""):
         self._memgraph_binary = memgraph_binary
         self._directory = tempfile.TemporaryDirectory(dir=temporary_dir)
         self._properties_on_edges = properties_on_edges
+        self._query_modules_directory = query_modules_directory
         self._proc_mg = None
         atexit.register(self._cleanup)
 
@@ -70,6 +72,8 @@ class Memgraph:
         else:
             assert self._properties_on_edges, \
                 "Older versions of Memgraph can't disable properties on edges!"
+        if self._query_modules_directory:
+            kwargs["query_modules_directory"] = self._query_modules_directory
         return _convert_args_to_flags(self._memgraph_binary, **kwargs)
 
     def _start(self, **kwargs):
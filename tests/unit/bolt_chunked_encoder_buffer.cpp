@@ -98,3 +98,15 @@ TEST_F(BoltChunkedEncoderBuffer, OneAndAHalfOfMaxChunk) {
   VerifyChunkOfTestData(output, kChunkMaxDataSize);
   VerifyChunkOfTestData(output + kChunkWholeSize, kTestDataSize - kChunkMaxDataSize, kChunkMaxDataSize);
 }
+
+TEST_F(BoltChunkedEncoderBuffer, ChunkLeaseSize) {
+  communication::BufferPool pool;
+  TestOutputStream output_stream;
+  BufferT buffer(output_stream, &pool);
+
+  // A whole chunk fits into the smallest block of the pool.
+  buffer.Write(test_data, kChunkMaxDataSize - 1);
+  ASSERT_EQ(pool.LeasedBytes(), communication::BufferPool::BlockSize(communication::BufferPool::kMinBlockSize));
+  buffer.Flush();
+  ASSERT_EQ(pool.LeasedBytes(), 0);
+}
@@ -102,6 +102,22 @@ TEST_F(BoltEncoder, Double) {
   CheckOutput(output, nullptr, 0);
 }
 
+TEST_F(BoltEncoder, NumericListBulk) {
+  output.clear();
+  std::vector<Value> ints;
+  for (int i = 0; i < 1000; ++i) ints.push_back(Value(int_decoded[i % 28]));
+  std::vector<Value> doubles;
+  for (int i = 0; i < 1000; ++i) doubles.push_back(Value(double_decoded[i % 4]));
+  std::vector<Value> vals{Value(ints), Value(doubles)};
+  bolt_encoder.MessageRecord(vals);
+  CheckRecordHeader(output, vals.size());
+  CheckTypeSize(output, LIST, ints.size());
+  for (int i = 0; i < 1000; ++i) CheckOutput(output, int_encoded[i % 28], int_encoded_len[i % 28], false);
+  CheckTypeSize(output, LIST, doubles.size());
+  for (int i = 0; i < 1000; ++i) CheckOutput(output, double_encoded[i % 4], 9, false);
+  CheckOutput(output, nullptr, 0);
+}
+
 TEST_F(BoltEncoder, String) {
   output.clear();
   std::vector<Value> vals;
@@ -211,6 +227,62 @@ TEST_F(BoltEncoder, VertexAndEdge) {
   CheckOutput(output, vertexedge_encoded + 48, 26);
 }
 
+TEST_F(BoltEncoder, VertexAndEdgeFromStorage) {
+  storage::Storage db;
+  auto dba = db.Access();
+  auto va1 = dba.CreateVertex();
+  auto va2 = dba.CreateVertex();
+  ASSERT_TRUE(va1.AddLabel(dba.NameToLabel("label1")).HasValue());
+  ASSERT_TRUE(va1.AddLabel(dba.NameToLabel("label2")).HasValue());
+  ASSERT_TRUE(va1.SetProperty(dba.NameToProperty("prop1"), storage::PropertyValue(12)).HasValue());
+  ASSERT_TRUE(va1.SetProperty(dba.NameToProperty("prop2"), storage::PropertyValue("value")).HasValue());
+  std::vector<storage::PropertyValue> list{storage::PropertyValue(1.5), storage::PropertyValue(true)};
+  ASSERT_TRUE(va2.SetProperty(dba.NameToProperty("prop3"), storage::PropertyValue(list)).HasValue());
+  auto ea = dba.CreateEdge(&va1, &va2, dba.NameToEdgeType("edgetype"));
+  ASSERT_TRUE(ea->SetProperty(dba.NameToProperty("prop4"), storage::PropertyValue(1234)).HasValue());
+
+  std::vector<query::TypedValue> values{query::TypedValue(query::VertexAccessor(va1)),
+                                        query::TypedValue(query::VertexAccessor(va2)),
+                                        query::TypedValue(query::EdgeAccessor(*ea)), query::TypedValue(5)};
+
+  output.clear();
+  std::vector<Value> vals;
+  for (const auto &value : values) vals.push_back(*glue::ToBoltValue(value, db, storage::View::NEW));
+  bolt_encoder.MessageRecord(vals);
+  auto expected = output;
+
+  // The properties were created in the order of their names, so encoding the
+  // values directly produces the same output.
+  output.clear();
+  glue::BoltNameCache names(&db);
+  std::vector<glue::BoltField> fields;
+  for (const auto &value : values) fields.push_back(*glue::ToBoltField(value, db, storage::View::NEW));
+  bolt_encoder.MessageRecord(fields.size(), [&](auto &encoder) {
+    for (const auto &field : fields) glue::EncodeBoltField(encoder, field, &names);
+  });
+  ASSERT_EQ(output, expected);
+}
+
+TEST_F(BoltEncoder, VertexFromStoragePropertyOrder) {
+  storage::Storage db;
+  auto dba = db.Access();
+  auto va = dba.CreateVertex();
+  // The properties are created in the reverse order of their names.
+  ASSERT_TRUE(va.SetProperty(dba.NameToProperty("b"), storage::PropertyValue(1)).HasValue());
+  ASSERT_TRUE(va.SetProperty(dba.NameToProperty("a"), storage::PropertyValue(2)).HasValue());
+  auto field = glue::ToBoltField(query::TypedValue(query::VertexAccessor(va)), db, storage::View::NEW);
+  ASSERT_TRUE(field.HasValue());
+
+  // The properties are written in the order of their ids. The second record
+  // is encoded with the names that are already cached.
+  glue::BoltNameCache names(&db);
+  for (int i = 0; i < 2; ++i) {
+    output.clear();
+    bolt_encoder.MessageRecord(1, [&](auto &encoder) { glue::EncodeBoltField(encoder, *field, &names); });
+    CheckOutput(output, (const uint8_t *)"\xB1\x71\x91\xB3\x4E\x00\x90\xA2\x81\x62\x01\x81\x61\x02", 14);
+  }
+}
+
 TEST_F(BoltEncoder, BoltV1ExampleMessages) {
   // this test checks example messages from: http://boltprotocol.org/v1/
 
@@ -2,6 +2,7 @@
 
 #include "bolt_common.hpp"
 #include "communication/bolt/v1/session.hpp"
+#include "communication/buffer.hpp"
 #include "communication/exceptions.hpp"
 #include "utils/logging.hpp"
 
@@ -531,6 +532,24 @@ TEST(BoltSession, ExecutePullAllDiscardAllReset) {
   }
 }
 
+TEST(BoltSession, IdleSessionFootprint) {
+  auto *pool = communication::GlobalBufferPool();
+  const auto leased_before = pool->LeasedBytes();
+  INIT_VARS;
+
+  ExecuteHandshake(input_stream, session, output);
+  ExecuteInit(input_stream, session, output);
+  WriteRunRequest(input_stream, kQueryReturn42);
+  session.Execute();
+  ExecuteCommand(input_stream, session, pullall_req, sizeof(pullall_req));
+  ASSERT_EQ(session.state_, State::Idle);
+
+  // The chunk buffers are leased only while a message is being decoded or
+  // encoded, so between messages the session holds only its own members.
+  EXPECT_EQ(pool->LeasedBytes(), leased_before);
+  EXPECT_LT(sizeof(TestSession), 1024);
+}
+
 TEST(BoltSession, ExecuteInvalidMessage) {
   INIT_VARS;
 
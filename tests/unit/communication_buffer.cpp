@@ -5,6 +5,7 @@ constexpr const int SIZE = 4096;
 uint8_t data[SIZE];
 
 using communication::Buffer;
+using communication::BufferPool;
 
 struct CommunicationBuffer : ::testing::Test {
   // In newer gtest library (1.8.1+) this is changed to SetUpTestSuite
@@ -54,5 +55,60 @@ TEST_F(CommunicationBuffer, Resize) {
   buffer.read_end()->Resize(sb.len + 1000);
 
   auto sbn = buffer.write_end()->Allocate();
-  ASSERT_EQ(sb.len + 1000, sbn.len);
+  ASSERT_GE(sbn.len, sb.len + 1000);
+}
+
+TEST_F(CommunicationBuffer, GrowWhenFull) {
+  Buffer buffer;
+  auto sb = buffer.write_end()->Allocate();
+  const auto len = sb.len;
+  memset(sb.data, 0, len);
+  memcpy(sb.data + len - 1000, data, 1000);
+  buffer.write_end()->Written(len);
+
+  sb = buffer.write_end()->Allocate();
+  ASSERT_GT(sb.len, 0);
+  memcpy(sb.data, data + 1000, 1000);
+  buffer.write_end()->Written(1000);
+
+  ASSERT_EQ(buffer.read_end()->size(), len + 1000);
+  uint8_t *tmp = buffer.read_end()->data() + len - 1000;
+  for (int i = 0; i < 2000; ++i) EXPECT_EQ(data[i], tmp[i]);
+}
+
+TEST_F(CommunicationBuffer, ReleaseToPool) {
+  BufferPool pool;
+  {
+    Buffer buffer(&pool);
+    auto sb = buffer.write_end()->Allocate();
+    memcpy(sb.data, data, 1000);
+    buffer.write_end()->Written(1000);
+    ASSERT_EQ(pool.FreeBytes(), 0);
+
+    buffer.read_end()->Shift(1000);
+    ASSERT_EQ(pool.FreeBytes(), BufferPool::BlockSize(1));
+
+    // An allocation that isn't followed by a write is released explicitly.
+    buffer.write_end()->Allocate();
+    ASSERT_EQ(pool.FreeBytes(), 0);
+    buffer.write_end()->Release();
+    ASSERT_EQ(pool.FreeBytes(), BufferPool::BlockSize(1));
+  }
+
+  // Overflow blocks aren't kept by the pool.
+  Buffer buffer(&pool);
+  buffer.write_end()->Resize(BufferPool::BlockSize(BufferPool::kMaxPooledBlockSize) + 1);
+  auto sb = buffer.write_end()->Allocate();
+  memcpy(sb.data, data, 1000);
+  buffer.write_end()->Written(1000);
+  buffer.read_end()->Clear();
+  ASSERT_EQ(pool.FreeBytes(), BufferPool::BlockSize(1));
+}
+
+TEST_F(CommunicationBuffer, BlockSizeHeadroom) {
+  // A power of two payload with a small header stays in its size class.
+  ASSERT_EQ(BufferPool::BlockSize(BufferPool::kMinBlockSize + 2), BufferPool::BlockSize(1));
+  ASSERT_EQ(BufferPool::BlockSize(BufferPool::kMinBlockSize + BufferPool::kBlockHeadroom + 1),
+            BufferPool::BlockSize(2 * BufferPool::kMinBlockSize));
+  ASSERT_EQ(BufferPool::BlockSize(BufferPool::BlockSize(1)), BufferPool::BlockSize(1));
 }
@@ -678,6 +678,140 @@ TEST_F(InterpreterTest, ExplainQueryWithParams) {
   EXPECT_EQ(interpreter_context.ast_cache.size(), 2U);
 }
 
+TEST_F(InterpreterTest, PlanCacheDataSizeDrift) {
+  auto &interpreter_context = default_interpreter.interpreter_context;
+  const std::string query{"MATCH (n) RETURN n;"};
+  auto cached_plan = [&] {
+    auto access = interpreter_context.plan_cache.access();
+    auto it = access.find(query::PlanCacheKey{query::frontend::StrippedQuery(query).hash(), std::nullopt});
+    MG_ASSERT(it != access.end());
+    return it->second;
+  };
+
+  Interpret("CREATE ()");
+  Interpret(query);
+  const auto first_plan = cached_plan();
+  Interpret(query);
+  // Nothing changed so the plan should be reused.
+  EXPECT_EQ(cached_plan(), first_plan);
+  Interpret("UNWIND range(1, 10) AS x CREATE ()");
+  Interpret(query);
+  // The number of vertices changed more than 2 times.
+  EXPECT_NE(cached_plan(), first_plan);
+}
+
+TEST_F(InterpreterTest, PlanCacheParameterSelectivity) {
+  auto &interpreter_context = default_interpreter.interpreter_context;
+  const std::string query{"MATCH (n:Label {prop: $value}) RETURN n;"};
+  auto cached_plan = [&] {
+    auto access = interpreter_context.plan_cache.access();
+    auto it = access.find(query::PlanCacheKey{query::frontend::StrippedQuery(query).hash(), std::nullopt});
+    MG_ASSERT(it != access.end());
+    return it->second;
+  };
+
+  Interpret("CREATE INDEX ON :Label(prop)");
+  Interpret("UNWIND range(1, 100) AS x CREATE (:Label {prop: 1})");
+  Interpret("CREATE (:Label {prop: 2})");
+  Interpret(query, {{"value", storage::PropertyValue(2)}});
+  const auto first_plan = cached_plan();
+  Interpret(query, {{"value", storage::PropertyValue(3)}});
+  // Both values are rare so the plan should be reused.
+  EXPECT_EQ(cached_plan(), first_plan);
+  const auto plan_count = interpreter_context.plan_cache.size();
+  Interpret(query, {{"value", storage::PropertyValue(1)}});
+  // The value matches most of the vertices, so the query was planned again.
+  // The new plan is cached besides the first one.
+  EXPECT_EQ(cached_plan(), first_plan);
+  EXPECT_EQ(interpreter_context.plan_cache.size(), plan_count + 1);
+  {
+    // It's cached under the cost class of the value, next to the first plan.
+    auto access = interpreter_context.plan_cache.access();
+    EXPECT_EQ(std::count_if(access.begin(), access.end(),
+                            [](const auto &entry) { return entry.first.cost_class.has_value(); }),
+              1);
+  }
+
+  // Alternating between the values of different selectivity reuses both
+  // plans instead of planning the query again.
+  for (int i = 0; i < 3; ++i) {
+    Interpret(query, {{"value", storage::PropertyValue(2)}});
+    Interpret(query, {{"value", storage::PropertyValue(1)}});
+  }
+  EXPECT_EQ(cached_plan(), first_plan);
+  EXPECT_EQ(interpreter_context.plan_cache.size(), plan_count + 1);
+}
+
+TEST_F(InterpreterTest, CachedPlanReplanDecision) {
+  auto &interpreter_context = default_interpreter.interpreter_context;
+  const std::string query{"MATCH (n:Label {prop: $value}) RETURN n;"};
+  Interpret("CREATE INDEX ON :Label(prop)");
+  Interpret("UNWIND range(1, 100) AS x CREATE (:Label {prop: 1})");
+  Interpret("CREATE (:Label {prop: 2})");
+  Interpret(query, {{"value", storage::PropertyValue(2)}});
+  const query::frontend::StrippedQuery stripped_query(query);
+  auto plan = [&] {
+    auto access = interpreter_context.plan_cache.access();
+    auto it = access.find(query::PlanCacheKey{stripped_query.hash(), std::nullopt});
+    MG_ASSERT(it != access.end());
+    return it->second;
+  }();
+
+  auto storage_dba = db_.Access();
+  query::DbAccessor dba(&storage_dba);
+  const auto parameters = [&](int64_t value) {
+    query::Parameters parameters;
+    for (const auto &[position, name] : stripped_query.parameters()) {
+      parameters.Add(position, storage::PropertyValue(value));
+    }
+    return parameters;
+  };
+  EXPECT_FALSE(plan->IsStale(&dba));
+  // Rare values fit the plan, the common one doesn't.
+  EXPECT_FALSE(plan->IsStale(parameters(2), &dba));
+  EXPECT_FALSE(plan->IsStale(parameters(3), &dba));
+  EXPECT_TRUE(plan->IsStale(parameters(1), &dba));
+  // The estimates are cached by the parameter values.
+  EXPECT_EQ(plan->EstimateCost(parameters(1), &dba), plan->EstimateCost(parameters(1), &dba));
+  EXPECT_GT(plan->EstimateCost(parameters(1), &dba), 2 * plan->EstimateCost(parameters(2), &dba));
+}
+
+TEST_F(InterpreterTest, ConstantFolding) {
+  Interpret("UNWIND range(1, 10) AS x CREATE (:Node {x: x})");
+  // The constant subexpressions are folded when the query is planned, and the
+  // plan is reused for other parameter values.
+  const std::string query{"MATCH (n:Node) WHERE n.x = $value * 2 + 1 RETURN n.x AS x, toUpper('a') + $suffix AS s"};
+  for (int64_t value : {1, 3, 4}) {
+    auto stream =
+        Interpret(query, {{"value", storage::PropertyValue(value)}, {"suffix", storage::PropertyValue("b")}});
+    ASSERT_EQ(stream.GetResults().size(), 1U);
+    EXPECT_EQ(stream.GetResults()[0][0].ValueInt(), value * 2 + 1);
+    EXPECT_EQ(stream.GetResults()[0][1].ValueString(), "Ab");
+  }
+  {
+    auto stream = Interpret("MATCH (n:Node) WHERE n.x IN [1 + 1, 2 * 2] RETURN n.x ORDER BY n.x");
+    ASSERT_EQ(stream.GetResults().size(), 2U);
+    EXPECT_EQ(stream.GetResults()[0][0].ValueInt(), 2);
+    EXPECT_EQ(stream.GetResults()[1][0].ValueInt(), 4);
+  }
+  {
+    // Expressions which fail aren't folded, so they fail only for the rows
+    // which evaluate them.
+    auto stream = Interpret("MATCH (n:Node) RETURN CASE WHEN n.x > 10 THEN 1 / $zero ELSE 0 END AS x",
+                            {{"zero", storage::PropertyValue(0)}});
+    EXPECT_EQ(stream.GetResults().size(), 10U);
+  }
+}
+
+TEST_F(InterpreterTest, QueryMemoryLimit) {
+  {
+    auto stream = Interpret("UNWIND range(1, 1000) AS x WITH x ORDER BY x DESC RETURN x QUERY MEMORY LIMIT 1 MB");
+    ASSERT_EQ(stream.GetResults().size(), 1000U);
+    EXPECT_EQ(stream.GetResults()[0][0].ValueInt(), 1000);
+  }
+  ASSERT_THROW(Interpret("UNWIND range(1, 1000000) AS x RETURN x QUERY MEMORY LIMIT 1 MB"), utils::BadAlloc);
+}
+
 TEST_F(InterpreterTest, ProfileQuery) {
   const auto &interpreter_context = default_interpreter.interpreter_context;
 
@@ -36,8 +36,7 @@ class TestSession {
 const std::string safe_query("tttt");
 const std::string expensive_query("eeee");
 
-bool QueryServer(io::network::Socket &socket, const std::string &query) {
-  if (!socket.Write(query)) return false;
+bool ReadResponse(io::network::Socket &socket, const std::string &query) {
   char response[105];
   int len = 0;
   while (len < query.size()) {
@@ -50,6 +49,11 @@ bool QueryServer(io::network::Socket &socket, const std::string &query) {
   return true;
 }
 
+bool QueryServer(io::network::Socket &socket, const std::string &query) {
+  if (!socket.Write(query)) return false;
+  return ReadResponse(socket, query);
+}
+
 TEST(NetworkTimeouts, InactiveSession) {
   // Instantiate the server and set the session timeout to 2 seconds.
   TestData test_data;
@@ -111,3 +115,74 @@ TEST(NetworkTimeouts, ActiveSession) {
   server.Shutdown();
   server.AwaitShutdown();
 }
+
+TEST(NetworkTimeouts, ExecutionPool) {
+  // Use a single I/O thread and two execution threads, one of which is
+  // reserved for sessions that aren't long running.
+  TestData test_data;
+  communication::ServerContext context;
+  communication::Server<TestSession, TestData> server{
+      {"127.0.0.1", 0}, &test_data, &context, 2, "Test", 1, communication::ExecutionPoolConfig{2, 1, 100ms}};
+  ASSERT_TRUE(server.Start());
+
+  io::network::Socket expensive_clients[2];
+  for (auto &client : expensive_clients) ASSERT_TRUE(client.Connect(server.endpoint()));
+
+  // Both sessions haven't executed anything yet, so their first expensive
+  // queries run concurrently on both threads.
+  for (auto &client : expensive_clients) ASSERT_TRUE(client.Write(expensive_query));
+  for (auto &client : expensive_clients) ASSERT_TRUE(ReadResponse(client, expensive_query));
+
+  // Connected only now so that it doesn't time out while waiting.
+  io::network::Socket safe_client;
+  ASSERT_TRUE(safe_client.Connect(server.endpoint()));
+
+  // The next requests of both sessions are queued with the low priority. Only
+  // one of them runs at a time, on the thread that isn't reserved, so the
+  // reserved thread still serves the other session.
+  for (auto &client : expensive_clients) ASSERT_TRUE(client.Write(expensive_query));
+  std::this_thread::sleep_for(100ms);
+  for (int i = 0; i < 3; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(QueryServer(safe_client, safe_query));
+    ASSERT_LT(std::chrono::steady_clock::now() - start, 1s);
+  }
+
+  // The second expensive request waits in the queue for longer than the
+  // inactivity timeout, but the session isn't closed.
+  for (auto &client : expensive_clients) ASSERT_TRUE(ReadResponse(client, expensive_query));
+
+  // Shutdown the server.
+  server.Shutdown();
+  server.AwaitShutdown();
+}
+
+TEST(NetworkTimeouts, ExecutionPoolIoUring) {
+  // The I/O thread reads the sockets of all clients that sent data with a
+  // single io_uring submission, or one by one if io_uring isn't supported.
+  TestData test_data;
+  communication::ServerContext context;
+  communication::Server<TestSession, TestData> server{{"127.0.0.1", 0},
+                                                      &test_data,
+                                                      &context,
+                                                      2,
+                                                      "Test",
+                                                      1,
+                                                      communication::ExecutionPoolConfig{2, 1, 100ms, true}};
+  ASSERT_TRUE(server.Start());
+
+  io::network::Socket clients[10];
+  for (auto &client : clients) ASSERT_TRUE(client.Connect(server.endpoint()));
+  for (int i = 0; i < 3; ++i) {
+    for (auto &client : clients) ASSERT_TRUE(client.Write(safe_query));
+    for (auto &client : clients) ASSERT_TRUE(ReadResponse(client, safe_query));
+  }
+
+  // A closed connection doesn't affect the other sessions.
+  clients[0].Close();
+  for (size_t i = 1; i < std::size(clients); ++i) ASSERT_TRUE(QueryServer(clients[i], safe_query));
+
+  // Shutdown the server.
+  server.Shutdown();
+  server.AwaitShutdown();
+}
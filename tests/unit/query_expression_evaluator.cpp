@@ -241,6 +241,26 @@ TEST_F(ExpressionEvaluatorTest, GreaterEqualOperator) {
   ASSERT_EQ(val3.ValueBool(), true);
 }
 
+TEST_F(ExpressionEvaluatorTest, ComparisonOperatorsMixedTypes) {
+  auto *int_ident = CreateIdentifierWithValue("int", TypedValue(2));
+  auto *double_ident = CreateIdentifierWithValue("double", TypedValue(2.5));
+  auto *bool_ident = CreateIdentifierWithValue("bool", TypedValue(true));
+  auto *null_ident = CreateIdentifierWithValue("null", TypedValue());
+  EXPECT_TRUE(Eval(storage.Create<LessOperator>(int_ident, double_ident)).ValueBool());
+  EXPECT_FALSE(Eval(storage.Create<GreaterEqualOperator>(int_ident, double_ident)).ValueBool());
+  EXPECT_TRUE(Eval(storage.Create<EqualOperator>(int_ident, storage.Create<PrimitiveLiteral>(2.0))).ValueBool());
+  EXPECT_FALSE(Eval(storage.Create<NotEqualOperator>(storage.Create<PrimitiveLiteral>(2.5), double_ident)).ValueBool());
+  EXPECT_TRUE(Eval(storage.Create<EqualOperator>(bool_ident, storage.Create<PrimitiveLiteral>(true))).ValueBool());
+  EXPECT_TRUE(Eval(storage.Create<NotEqualOperator>(bool_ident, storage.Create<PrimitiveLiteral>(false))).ValueBool());
+  EXPECT_FALSE(Eval(storage.Create<EqualOperator>(bool_ident, int_ident)).ValueBool());
+  EXPECT_TRUE(Eval(storage.Create<LessEqualOperator>(null_ident, int_ident)).IsNull());
+  EXPECT_TRUE(Eval(storage.Create<EqualOperator>(int_ident, null_ident)).IsNull());
+  EXPECT_THROW(Eval(storage.Create<LessOperator>(bool_ident, storage.Create<PrimitiveLiteral>(false))),
+               QueryRuntimeException);
+  EXPECT_THROW(Eval(storage.Create<GreaterOperator>(int_ident, storage.Create<PrimitiveLiteral>("2"))),
+               QueryRuntimeException);
+}
+
 TEST_F(ExpressionEvaluatorTest, InListOperator) {
   auto *list_literal = storage.Create<ListLiteral>(std::vector<Expression *>{
       storage.Create<PrimitiveLiteral>(1), storage.Create<PrimitiveLiteral>(2), storage.Create<PrimitiveLiteral>("a")});
@@ -1144,6 +1164,13 @@ TEST_F(ExpressionEvaluatorPropertyLookup, MapLiteral) {
   EXPECT_TRUE(Value(prop_height).IsNull());
 }
 
+TEST_F(ExpressionEvaluatorPropertyLookup, MapIdentifierIsNotModified) {
+  frame[symbol] = TypedValue(std::map<std::string, TypedValue>{{prop_age.first, TypedValue("ten")}});
+  EXPECT_EQ(Value(prop_age).ValueString(), "ten");
+  // The lookup must not move the value out of the frame.
+  EXPECT_EQ(Value(prop_age).ValueString(), "ten");
+}
+
 class FunctionTest : public ExpressionEvaluatorTest {
  protected:
   std::vector<Expression *> ExpressionsFromTypedValues(const std::vector<TypedValue> &tvs) {
@@ -357,6 +357,135 @@ TEST(QueryPlan, AggregateMultipleGroupBy) {
   EXPECT_EQ(results.size(), 2 * 3 * 5);
 }
 
+TEST(QueryPlan, AggregateBatches) {
+  // Enough input rows for several aggregation batches, with the first values
+  // and Null values of the groups spread over all of them.
+  storage::Storage db;
+  auto storage_dba = db.Access();
+  query::DbAccessor dba(&storage_dba);
+
+  constexpr int kVertexCount = 2500;
+  constexpr int kGroupCount = 3;
+  auto group_prop = dba.NameToProperty("group");
+  auto value_prop = dba.NameToProperty("value");
+  std::vector<std::vector<int64_t>> group_values(kGroupCount);
+  for (int i = 0; i < kVertexCount; ++i) {
+    auto v = dba.InsertVertex();
+    ASSERT_TRUE(v.SetProperty(group_prop, storage::PropertyValue(i % kGroupCount)).HasValue());
+    // every 7th vertex has a Null value
+    if (i % 7 == 0) continue;
+    ASSERT_TRUE(v.SetProperty(value_prop, storage::PropertyValue(i)).HasValue());
+    group_values[i % kGroupCount].push_back(i);
+  }
+  dba.AdvanceCommand();
+
+  AstStorage storage;
+  SymbolTable symbol_table;
+
+  auto n = MakeScanAll(storage, symbol_table, "n");
+  auto n_group = PROPERTY_LOOKUP(IDENT("n")->MapTo(n.sym_), group_prop);
+  auto n_value = PROPERTY_LOOKUP(IDENT("n")->MapTo(n.sym_), value_prop);
+  auto produce = MakeAggregationProduce(
+      n.op_, symbol_table, storage, {nullptr, n_value, n_value, n_value, n_value, n_value, n_value},
+      {Aggregation::Op::COUNT, Aggregation::Op::COUNT, Aggregation::Op::MIN, Aggregation::Op::MAX,
+       Aggregation::Op::SUM, Aggregation::Op::AVG, Aggregation::Op::COLLECT_LIST},
+      {n_group}, {});
+
+  auto context = MakeContext(storage, symbol_table, &dba);
+  auto results = CollectProduce(*produce, &context);
+  ASSERT_EQ(results.size(), kGroupCount);
+  for (const auto &row : results) {
+    ASSERT_EQ(row.size(), 8);
+    ASSERT_EQ(row[7].type(), TypedValue::Type::Int);
+    const auto group = row[7].ValueInt();
+    const auto &values = group_values[group];
+    int64_t sum = 0;
+    for (auto value : values) sum += value;
+    // count(*)
+    EXPECT_EQ(row[0].ValueInt(), (kVertexCount - group + kGroupCount - 1) / kGroupCount);
+    // count
+    EXPECT_EQ(row[1].ValueInt(), static_cast<int64_t>(values.size()));
+    // min
+    EXPECT_EQ(row[2].ValueInt(), values.front());
+    // max
+    EXPECT_EQ(row[3].ValueInt(), values.back());
+    // sum
+    EXPECT_EQ(row[4].ValueInt(), sum);
+    // avg
+    EXPECT_FLOAT_EQ(row[5].ValueDouble(), static_cast<double>(sum) / values.size());
+    // collect list keeps the input order
+    EXPECT_EQ(ToIntList(row[6]), values);
+  }
+}
+
+TEST(QueryPlan, AggregateBatchesTypeError) {
+  // The invalid value is in a later batch than the first value of its group.
+  storage::Storage db;
+  auto storage_dba = db.Access();
+  query::DbAccessor dba(&storage_dba);
+
+  auto prop = dba.NameToProperty("prop");
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_TRUE(dba.InsertVertex().SetProperty(prop, storage::PropertyValue(i)).HasValue());
+  }
+  ASSERT_TRUE(dba.InsertVertex().SetProperty(prop, storage::PropertyValue("string")).HasValue());
+  dba.AdvanceCommand();
+
+  AstStorage storage;
+  SymbolTable symbol_table;
+
+  auto n = MakeScanAll(storage, symbol_table, "n");
+  auto n_p = PROPERTY_LOOKUP(IDENT("n")->MapTo(n.sym_), prop);
+  for (auto op : {Aggregation::Op::SUM, Aggregation::Op::MIN}) {
+    auto produce = MakeAggregationProduce(n.op_, symbol_table, storage, {n_p}, {op}, {}, {});
+    auto context = MakeContext(storage, symbol_table, &dba);
+    EXPECT_THROW(CollectProduce(*produce, &context), QueryRuntimeException);
+  }
+}
+
+TEST(QueryPlan, AggregateBatchesMixedNumbers) {
+  // A batch of integers followed by a batch of doubles, so the typed batch
+  // columns have to fold into group values of the other numeric type.
+  storage::Storage db;
+  auto storage_dba = db.Access();
+  query::DbAccessor dba(&storage_dba);
+
+  constexpr int kBatchSize = 1024;
+  auto prop = dba.NameToProperty("prop");
+  double sum = 0;
+  for (int i = 0; i < kBatchSize; ++i) {
+    ASSERT_TRUE(dba.InsertVertex().SetProperty(prop, storage::PropertyValue(i)).HasValue());
+    sum += i;
+  }
+  for (int i = 0; i < kBatchSize; ++i) {
+    ASSERT_TRUE(dba.InsertVertex().SetProperty(prop, storage::PropertyValue(i - 0.5)).HasValue());
+    sum += i - 0.5;
+  }
+  dba.AdvanceCommand();
+
+  AstStorage storage;
+  SymbolTable symbol_table;
+
+  auto n = MakeScanAll(storage, symbol_table, "n");
+  auto n_p = PROPERTY_LOOKUP(IDENT("n")->MapTo(n.sym_), prop);
+  auto produce = MakeAggregationProduce(n.op_, symbol_table, storage, {n_p, n_p, n_p, n_p},
+                                        {Aggregation::Op::MIN, Aggregation::Op::MAX, Aggregation::Op::SUM,
+                                         Aggregation::Op::AVG},
+                                        {}, {});
+  auto context = MakeContext(storage, symbol_table, &dba);
+  auto results = CollectProduce(*produce, &context);
+  ASSERT_EQ(results.size(), 1);
+  const auto &row = results[0];
+  ASSERT_EQ(row.size(), 4);
+  ASSERT_EQ(row[0].type(), TypedValue::Type::Double);
+  EXPECT_DOUBLE_EQ(row[0].ValueDouble(), -0.5);
+  ASSERT_EQ(row[1].type(), TypedValue::Type::Int);
+  EXPECT_EQ(row[1].ValueInt(), kBatchSize - 1);
+  ASSERT_EQ(row[2].type(), TypedValue::Type::Double);
+  EXPECT_DOUBLE_EQ(row[2].ValueDouble(), sum);
+  EXPECT_DOUBLE_EQ(row[3].ValueDouble(), sum / (2 * kBatchSize));
+}
+
 TEST(QueryPlan, AggregateNoInput) {
   storage::Storage db;
   auto storage_dba = db.Access();
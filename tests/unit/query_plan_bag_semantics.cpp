@@ -4,8 +4,11 @@
 //
 
 #include <algorithm>
+#include <filesystem>
 #include <iterator>
 #include <memory>
+#include <numeric>
+#include <optional>
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -14,6 +17,7 @@
 #include "query/context.hpp"
 #include "query/exceptions.hpp"
 #include "query/plan/operator.hpp"
+#include "query/plan/spill.hpp"
 
 #include "query_plan_common.hpp"
 
@@ -231,6 +235,149 @@ TEST(QueryPlan, OrderByMultiple) {
   }
 }
 
+TEST(QueryPlan, OrderByTopK) {
+  storage::Storage db;
+  auto storage_dba = db.Access();
+  query::DbAccessor dba(&storage_dba);
+  AstStorage storage;
+  SymbolTable symbol_table;
+  auto prop = dba.NameToProperty("prop");
+
+  const int N = 100;
+  std::vector<int> values(N);
+  std::iota(values.begin(), values.end(), 0);
+  std::random_shuffle(values.begin(), values.end());
+  for (auto value : values) ASSERT_TRUE(dba.InsertVertex().SetProperty(prop, storage::PropertyValue(value)).HasValue());
+  dba.AdvanceCommand();
+
+  auto check = [&](Ordering ordering, Expression *skip, Expression *limit, const std::vector<int> &expected) {
+    auto n = MakeScanAll(storage, symbol_table, "n");
+    auto n_p = PROPERTY_LOOKUP(IDENT("n")->MapTo(n.sym_), prop);
+    auto order_by = std::make_shared<plan::OrderBy>(n.op_, std::vector<SortItem>{{ordering, n_p}},
+                                                    std::vector<Symbol>{n.sym_}, skip, limit);
+    auto n_p_ne = NEXPR("n.p", n_p)->MapTo(symbol_table.CreateSymbol("n.p", true));
+    auto produce = MakeProduce(order_by, n_p_ne);
+    auto context = MakeContext(storage, symbol_table, &dba);
+    auto results = CollectProduce(*produce, &context);
+    ASSERT_EQ(results.size(), expected.size());
+    for (size_t i = 0; i < results.size(); ++i) EXPECT_EQ(results[i][0].ValueInt(), expected[i]);
+  };
+
+  // OrderBy produces only the first skip + limit rows, the following Skip
+  // drops the skipped ones.
+  check(Ordering::ASC, nullptr, LITERAL(3), {0, 1, 2});
+  check(Ordering::DESC, LITERAL(2), LITERAL(3), {99, 98, 97, 96, 95});
+  check(Ordering::ASC, nullptr, LITERAL(0), {});
+  // Rows are not cut off when the limit exceeds the input.
+  std::vector<int> all(N);
+  std::iota(all.begin(), all.end(), 0);
+  check(Ordering::ASC, LITERAL(10), LITERAL(2 * N), all);
+  // Invalid limits are left to the Limit operator.
+  check(Ordering::ASC, nullptr, LITERAL(-1), all);
+}
+
+class QueryPlanOrderBySpill : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::filesystem::remove_all(spill_directory);
+    FLAGS_query_spill_directory = spill_directory.string();
+  }
+
+  void TearDown() override {
+    FLAGS_query_spill_directory = "";
+    std::filesystem::remove_all(spill_directory);
+  }
+
+  size_t SpillFileCount() const {
+    if (!std::filesystem::exists(spill_directory)) return 0;
+    return std::distance(std::filesystem::directory_iterator(spill_directory), std::filesystem::directory_iterator());
+  }
+
+  // Creates `count` vertices with shuffled values of `prop`, from 0 to
+  // `count - 1`.
+  void CreateVertices(int count) {
+    std::vector<int> values(count);
+    std::iota(values.begin(), values.end(), 0);
+    std::random_shuffle(values.begin(), values.end());
+    for (auto value : values) {
+      ASSERT_TRUE(dba.InsertVertex().SetProperty(prop, ::storage::PropertyValue(value)).HasValue());
+    }
+    dba.AdvanceCommand();
+  }
+
+  // Pulls all rows of `op`, which outputs vertices as `symbol`, and checks
+  // that they are ordered by `prop`. Returns the number of spill files that
+  // existed after the first row was pulled.
+  size_t PullOrdered(const LogicalOperator &op, const Symbol &symbol, int count,
+                     std::optional<size_t> memory_limit) {
+    auto context = MakeContext(storage, symbol_table, &dba);
+    context.memory_limit = memory_limit;
+    Frame frame(symbol_table.max_position());
+    auto cursor = op.MakeCursor(utils::NewDeleteResource());
+    size_t spill_file_count = 0;
+    for (int i = 0; i < count; ++i) {
+      EXPECT_TRUE(cursor->Pull(frame, context));
+      if (i == 0) spill_file_count = SpillFileCount();
+      EXPECT_EQ(frame[symbol].ValueVertex().GetProperty(::storage::View::OLD, prop).GetValue().ValueInt(), i);
+    }
+    EXPECT_FALSE(cursor->Pull(frame, context));
+    cursor.reset();
+    EXPECT_EQ(SpillFileCount(), 0U);
+    return spill_file_count;
+  }
+
+  const std::filesystem::path spill_directory{std::filesystem::temp_directory_path() /
+                                              "MG_test_unit_query_plan_order_by_spill"};
+  ::storage::Storage db;
+  ::storage::Storage::Accessor storage_dba{db.Access()};
+  query::DbAccessor dba{&storage_dba};
+  ::storage::PropertyId prop{dba.NameToProperty("prop")};
+  AstStorage storage;
+  SymbolTable symbol_table;
+};
+
+TEST_F(QueryPlanOrderBySpill, SpillAndMerge) {
+  // Enough rows for more than kSpillMaxMergedRuns runs.
+  const int N = 200000;
+  CreateVertices(N);
+  auto n = MakeScanAll(storage, symbol_table, "n");
+  auto n_p = PROPERTY_LOOKUP(IDENT("n")->MapTo(n.sym_), prop);
+  auto order_by = std::make_shared<plan::OrderBy>(n.op_, std::vector<SortItem>{{Ordering::ASC, n_p}},
+                                                  std::vector<Symbol>{n.sym_});
+
+  // Without a memory limit everything is sorted in memory.
+  EXPECT_EQ(PullOrdered(*order_by, n.sym_, N, std::nullopt), 0U);
+  // The rows exceed the QUERY MEMORY LIMIT, so they are spilled. The number
+  // of runs which are read at once stays bounded, as they are merged in levels.
+  const auto spill_file_count = PullOrdered(*order_by, n.sym_, N, kSpillMinRunBytes);
+  EXPECT_GT(spill_file_count, 1U);
+  EXPECT_LE(spill_file_count, kSpillMaxMergedRuns);
+}
+
+TEST_F(QueryPlanOrderBySpill, MemoryLimitNotReached) {
+  const int N = 20000;
+  CreateVertices(N);
+  auto n = MakeScanAll(storage, symbol_table, "n");
+  auto n_p = PROPERTY_LOOKUP(IDENT("n")->MapTo(n.sym_), prop);
+  auto order_by = std::make_shared<plan::OrderBy>(n.op_, std::vector<SortItem>{{Ordering::ASC, n_p}},
+                                                  std::vector<Symbol>{n.sym_});
+  EXPECT_EQ(PullOrdered(*order_by, n.sym_, N, 1024UL * kSpillMinRunBytes), 0U);
+}
+
+TEST_F(QueryPlanOrderBySpill, DeletedVertices) {
+  const int N = 50000;
+  CreateVertices(N);
+  // MATCH (n) DELETE n WITH n ORDER BY n.prop
+  auto n = MakeScanAll(storage, symbol_table, "n");
+  auto delete_op =
+      std::make_shared<plan::Delete>(n.op_, std::vector<Expression *>{IDENT("n")->MapTo(n.sym_)}, false);
+  auto n_p = PROPERTY_LOOKUP(IDENT("n")->MapTo(n.sym_), prop);
+  auto order_by = std::make_shared<plan::OrderBy>(delete_op, std::vector<SortItem>{{Ordering::ASC, n_p}},
+                                                  std::vector<Symbol>{n.sym_});
+  // The spilled vertices are restored even though they were deleted.
+  EXPECT_GT(PullOrdered(*order_by, n.sym_, N, kSpillMinRunBytes), 0U);
+}
+
 TEST(QueryPlan, OrderByExceptions) {
   storage::Storage db;
   auto storage_dba = db.Access();
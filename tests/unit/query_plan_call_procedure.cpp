@@ -0,0 +1,264 @@
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "query/context.hpp"
+#include "query/plan/operator.hpp"
+#include "query/procedure/cypher_types.hpp"
+#include "query/procedure/mg_procedure_impl.hpp"
+#include "query/procedure/module.hpp"
+#include "query_plan_common.hpp"
+#include "test_utils.hpp"
+
+namespace {
+
+class MockModule : public procedure::Module {
+ public:
+  MockModule() = default;
+  ~MockModule() override = default;
+  MockModule(const MockModule &) = delete;
+  MockModule(MockModule &&) = delete;
+  MockModule &operator=(const MockModule &) = delete;
+  MockModule &operator=(MockModule &&) = delete;
+
+  bool Close() override { return true; }
+
+  const std::map<std::string, mgp_proc, std::less<>> *Procedures() const override { return &procedures; }
+
+  const std::map<std::string, mgp_trans, std::less<>> *Transformations() const override { return &transformations; }
+
+  std::map<std::string, mgp_proc, std::less<>> procedures{};
+  std::map<std::string, mgp_trans, std::less<>> transformations{};
+};
+
+const procedure::AnyType kAnyType{};
+
+// The batched procedure produces `kRecordCount` records, `kBatchSize` of them
+// per batch.
+constexpr int64_t kRecordCount = 10;
+constexpr int64_t kBatchSize = 3;
+
+struct BatchState {
+  mgp_graph *graph;
+  int64_t produced{0};
+};
+
+int batch_calls{0};
+int cleanups{0};
+// Whether the graph of the last cleaned up call still referenced an execution
+// context.
+bool cleanup_had_context{false};
+
+void *BatchInitializer(mgp_list * /*args*/, mgp_graph *graph, mgp_memory * /*memory*/) {
+  return new BatchState{graph};
+}
+
+void BatchCallback(void *state, mgp_graph *graph, mgp_result *result, mgp_memory *memory) {
+  ++batch_calls;
+  auto *call = static_cast<BatchState *>(state);
+  EXPECT_EQ(call->graph, graph);
+  EXPECT_NE(graph->ctx, nullptr);
+  for (int64_t i = 0; i < kBatchSize && call->produced < kRecordCount; ++i, ++call->produced) {
+    auto *record = EXPECT_MGP_NO_ERROR(mgp_result_record *, mgp_result_new_record, result);
+    auto *value = EXPECT_MGP_NO_ERROR(mgp_value *, mgp_value_make_int, call->produced, memory);
+    EXPECT_EQ(mgp_result_record_insert(record, "value", value), MGP_ERROR_NO_ERROR);
+    mgp_value_destroy(value);
+  }
+}
+
+void BatchCleanup(void *state) {
+  ++cleanups;
+  auto *call = static_cast<BatchState *>(state);
+  cleanup_had_context = call->graph->ctx != nullptr;
+  delete call;
+}
+
+// Threads on which the parallel-safe procedure was called.
+std::mutex call_threads_mutex;
+std::set<std::thread::id> call_threads;
+// The parallel-safe procedure throws when called with this argument.
+int64_t fail_at{-1};
+
+void ParallelCallback(mgp_list *args, mgp_graph * /*graph*/, mgp_result *result, mgp_memory *memory) {
+  {
+    std::lock_guard guard(call_threads_mutex);
+    call_threads.insert(std::this_thread::get_id());
+  }
+  auto *arg = EXPECT_MGP_NO_ERROR(mgp_value *, mgp_list_at, args, 0);
+  const auto x = EXPECT_MGP_NO_ERROR(int64_t, mgp_value_get_int, arg);
+  if (x == fail_at) throw std::runtime_error("Parallel call failed");
+  auto *record = EXPECT_MGP_NO_ERROR(mgp_result_record *, mgp_result_new_record, result);
+  auto *value = EXPECT_MGP_NO_ERROR(mgp_value *, mgp_value_make_int, x * 10, memory);
+  EXPECT_EQ(mgp_result_record_insert(record, "value", value), MGP_ERROR_NO_ERROR);
+  mgp_value_destroy(value);
+}
+
+class CallProcedureTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    auto module = std::make_unique<MockModule>();
+    mgp_proc proc("batched", BatchInitializer, BatchCallback, BatchCleanup, utils::NewDeleteResource(), false);
+    proc.results.emplace(utils::pmr::string{"value", utils::NewDeleteResource()}, std::make_pair(&kAnyType, false));
+    module->procedures.emplace("batched", std::move(proc));
+    mgp_proc parallel_proc("parallel", ParallelCallback, utils::NewDeleteResource(), false);
+    parallel_proc.args.emplace_back(utils::pmr::string{"x", utils::NewDeleteResource()}, &kAnyType);
+    parallel_proc.results.emplace(utils::pmr::string{"value", utils::NewDeleteResource()},
+                                  std::make_pair(&kAnyType, false));
+    parallel_proc.is_parallel_safe = true;
+    module->procedures.emplace("parallel", std::move(parallel_proc));
+    procedure::gModuleRegistry.RegisterModule("mock_module", std::move(module));
+    batch_calls = 0;
+    cleanups = 0;
+    cleanup_had_context = false;
+    call_threads.clear();
+    fail_at = -1;
+  }
+
+  void TearDown() override { procedure::gModuleRegistry.UnloadAllModules(); }
+
+  std::shared_ptr<CallProcedure> MakeCall(const std::string &name,
+                                          std::shared_ptr<LogicalOperator> input = std::make_shared<Once>(),
+                                          std::vector<Expression *> arguments = {}) {
+    return std::make_shared<CallProcedure>(std::move(input), name, std::move(arguments),
+                                           std::vector<std::string>{"value"}, std::vector<Symbol>{value_sym},
+                                           nullptr, 1024U, false);
+  }
+
+  // UNWIND range(0, count - 1) AS x CALL mock_module.parallel(x) YIELD value
+  std::shared_ptr<CallProcedure> MakeParallelCall(int64_t count, std::shared_ptr<LogicalOperator> input = nullptr) {
+    std::vector<Expression *> elements;
+    for (int64_t i = 0; i < count; ++i) elements.push_back(ast_storage.Create<PrimitiveLiteral>(i));
+    auto unwind = std::make_shared<Unwind>(std::move(input), ast_storage.Create<ListLiteral>(elements), x_sym);
+    return MakeCall("mock_module.parallel", unwind,
+                    {ast_storage.Create<Identifier>("x")->MapTo(x_sym)});
+  }
+
+  storage::Storage db;
+  storage::Storage::Accessor storage_dba{db.Access()};
+  query::DbAccessor dba{&storage_dba};
+  AstStorage ast_storage;
+  SymbolTable symbol_table;
+  Symbol value_sym{symbol_table.CreateSymbol("value", true)};
+  Symbol x_sym{symbol_table.CreateSymbol("x", true)};
+};
+
+}  // namespace
+
+TEST_F(CallProcedureTest, BatchedCallStreamsBatches) {
+  auto call = MakeCall("mock_module.batched");
+  auto context = MakeContext(ast_storage, symbol_table, &dba);
+  Frame frame(symbol_table.max_position());
+  auto cursor = call->MakeCursor(utils::NewDeleteResource());
+  for (int64_t i = 0; i < kRecordCount; ++i) {
+    ASSERT_TRUE(cursor->Pull(frame, context));
+    EXPECT_EQ(frame[value_sym].ValueInt(), i);
+    // The next batch is requested only once the rows of the previous one
+    // were produced.
+    EXPECT_EQ(batch_calls, i / kBatchSize + 1);
+    EXPECT_EQ(cleanups, 0);
+  }
+  EXPECT_FALSE(cursor->Pull(frame, context));
+  // The last batch is empty.
+  EXPECT_EQ(batch_calls, kRecordCount / kBatchSize + 2);
+  EXPECT_EQ(cleanups, 1);
+  cursor.reset();
+  EXPECT_EQ(cleanups, 1);
+}
+
+TEST_F(CallProcedureTest, ShutdownFinishesBatchedCall) {
+  auto call = MakeCall("mock_module.batched");
+  auto context = MakeContext(ast_storage, symbol_table, &dba);
+  Frame frame(symbol_table.max_position());
+  auto cursor = call->MakeCursor(utils::NewDeleteResource());
+  ASSERT_TRUE(cursor->Pull(frame, context));
+  cursor->Shutdown();
+  EXPECT_EQ(cleanups, 1);
+  EXPECT_TRUE(cleanup_had_context);
+  cursor.reset();
+  EXPECT_EQ(cleanups, 1);
+  EXPECT_EQ(batch_calls, 1);
+}
+
+TEST_F(CallProcedureTest, AbandonedBatchedCall) {
+  auto call = MakeCall("mock_module.batched");
+  auto cursor = call->MakeCursor(utils::NewDeleteResource());
+  {
+    auto context = MakeContext(ast_storage, symbol_table, &dba);
+    Frame frame(symbol_table.max_position());
+    ASSERT_TRUE(cursor->Pull(frame, context));
+  }
+  // The execution context is gone, so the cleanup mustn't be able to reach it.
+  cursor.reset();
+  EXPECT_EQ(cleanups, 1);
+  EXPECT_FALSE(cleanup_had_context);
+}
+
+TEST_F(CallProcedureTest, ResetRestartsBatchedCall) {
+  auto call = MakeCall("mock_module.batched");
+  auto context = MakeContext(ast_storage, symbol_table, &dba);
+  Frame frame(symbol_table.max_position());
+  auto cursor = call->MakeCursor(utils::NewDeleteResource());
+  ASSERT_TRUE(cursor->Pull(frame, context));
+  cursor->Reset();
+  EXPECT_EQ(cleanups, 1);
+  std::vector<int64_t> values;
+  while (cursor->Pull(frame, context)) values.push_back(frame[value_sym].ValueInt());
+  ASSERT_EQ(values.size(), kRecordCount);
+  for (int64_t i = 0; i < kRecordCount; ++i) EXPECT_EQ(values[i], i);
+  EXPECT_EQ(cleanups, 2);
+}
+
+TEST_F(CallProcedureTest, ParallelCallsKeepInputOrder) {
+  // More rows than are called at once, so the calls run in several rounds.
+  constexpr int64_t kRowCount = 1000;
+  auto call = MakeParallelCall(kRowCount);
+  auto context = MakeContext(ast_storage, symbol_table, &dba);
+  Frame frame(symbol_table.max_position());
+  auto cursor = call->MakeCursor(utils::NewDeleteResource());
+  for (int64_t i = 0; i < kRowCount; ++i) {
+    ASSERT_TRUE(cursor->Pull(frame, context));
+    EXPECT_EQ(frame[value_sym].ValueInt(), i * 10);
+    // The input row of the call is restored in the frame.
+    EXPECT_EQ(frame[x_sym].ValueInt(), i);
+  }
+  EXPECT_FALSE(cursor->Pull(frame, context));
+  std::lock_guard guard(call_threads_mutex);
+  EXPECT_GT(call_threads.size(), 1U);
+}
+
+TEST_F(CallProcedureTest, ParallelCallException) {
+  // The first call of each round runs on the pulling thread, the call for the
+  // second row runs on the thread pool.
+  fail_at = 1;
+  auto call = MakeParallelCall(10);
+  auto context = MakeContext(ast_storage, symbol_table, &dba);
+  Frame frame(symbol_table.max_position());
+  auto cursor = call->MakeCursor(utils::NewDeleteResource());
+  EXPECT_THROW(cursor->Pull(frame, context), std::runtime_error);
+}
+
+TEST_F(CallProcedureTest, NoParallelCallsAfterWrites) {
+  NodeCreationInfo node;
+  node.symbol = symbol_table.CreateSymbol("n", true);
+  auto create = std::make_shared<CreateNode>(std::make_shared<Once>(), node);
+  constexpr int64_t kRowCount = 100;
+  auto call = MakeParallelCall(kRowCount, create);
+  auto context = MakeContext(ast_storage, symbol_table, &dba);
+  Frame frame(symbol_table.max_position());
+  auto cursor = call->MakeCursor(utils::NewDeleteResource());
+  for (int64_t i = 0; i < kRowCount; ++i) {
+    ASSERT_TRUE(cursor->Pull(frame, context));
+    EXPECT_EQ(frame[value_sym].ValueInt(), i * 10);
+  }
+  EXPECT_FALSE(cursor->Pull(frame, context));
+  // The input wasn't read ahead, so every call ran on the pulling thread.
+  std::lock_guard guard(call_threads_mutex);
+  EXPECT_EQ(call_threads, std::set<std::thread::id>{std::this_thread::get_id()});
+}
@@ -234,6 +234,65 @@ TEST(QueryPlan, NodeFilterMultipleLabels) {
   EXPECT_EQ(results.size(), 2);
 }
 
+// Counts the allocations which reach the evaluation memory.
+class EvaluationMemoryCounter final : public utils::MemoryResource {
+ public:
+  size_t allocations_{0};
+
+ private:
+  void *DoAllocate(size_t bytes, size_t alignment) override {
+    ++allocations_;
+    return utils::NewDeleteResource()->Allocate(bytes, alignment);
+  }
+
+  void DoDeallocate(void *ptr, size_t bytes, size_t alignment) override {
+    utils::NewDeleteResource()->Deallocate(ptr, bytes, alignment);
+  }
+
+  bool DoIsEqual(const utils::MemoryResource &other) const noexcept override { return this == &other; }
+};
+
+TEST(QueryPlan, RowEvaluationMemory) {
+  // Filter, OrderBy and Aggregate evaluate their expressions in memory which
+  // is released after each input row, so the strings built for each row
+  // don't reach the evaluation memory.
+  storage::Storage db;
+  auto storage_dba = db.Access();
+  query::DbAccessor dba(&storage_dba);
+
+  constexpr int kVertexCount = 1000;
+  constexpr int kGroupCount = 10;
+  auto prop = dba.NameToProperty("prop");
+  const std::string long_string(100, 'a');
+  for (int i = 0; i < kVertexCount; ++i) {
+    auto value = storage::PropertyValue(long_string + std::to_string(i % kGroupCount));
+    ASSERT_TRUE(dba.InsertVertex().SetProperty(prop, value).HasValue());
+  }
+  dba.AdvanceCommand();
+
+  AstStorage storage;
+  SymbolTable symbol_table;
+
+  // MATCH (n) WHERE n.prop + 'suffix' <> 'x'
+  // WITH n ORDER BY n.prop + 'suffix'
+  // RETURN n.prop + 'suffix', count(*)
+  auto n = MakeScanAll(storage, symbol_table, "n");
+  auto n_p_suffix = [&] { return ADD(PROPERTY_LOOKUP(IDENT("n")->MapTo(n.sym_), prop), LITERAL("suffix")); };
+  auto filter = std::make_shared<Filter>(n.op_, NEQ(n_p_suffix(), LITERAL("x")));
+  auto order_by = std::make_shared<OrderBy>(filter, std::vector<SortItem>{{Ordering::ASC, n_p_suffix()}},
+                                            std::vector<Symbol>{n.sym_});
+  auto count_sym = symbol_table.CreateSymbol("count", true);
+  auto aggregate = std::make_shared<Aggregate>(
+      order_by, std::vector<Aggregate::Element>{{nullptr, nullptr, Aggregation::Op::COUNT, count_sym}},
+      std::vector<Expression *>{n_p_suffix()}, std::vector<Symbol>{});
+
+  auto context = MakeContext(storage, symbol_table, &dba);
+  EvaluationMemoryCounter evaluation_memory;
+  context.evaluation_context.memory = &evaluation_memory;
+  EXPECT_EQ(PullAll(*aggregate, &context), kGroupCount);
+  EXPECT_EQ(evaluation_memory.allocations_, 0);
+}
+
 TEST(QueryPlan, Cartesian) {
   storage::Storage db;
   auto storage_dba = db.Access();
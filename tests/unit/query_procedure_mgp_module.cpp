@@ -51,6 +51,58 @@ TEST(Module, CaseSensitiveProcedureNames) {
   EXPECT_EQ(module.procedures.size(), 3U);
 }
 
+static void *DummyBatchInitializer(mgp_list *, mgp_graph *, mgp_memory *) { return nullptr; }
+
+static void DummyBatchCallback(void *, mgp_graph *, mgp_result *, mgp_memory *) {}
+
+static void DummyBatchCleanup(void *) {}
+
+TEST(Module, BatchProcedureRegistration) {
+  mgp_module module(utils::NewDeleteResource());
+  mgp_proc *proc{nullptr};
+  EXPECT_EQ(mgp_module_add_batch_read_procedure(&module, "batched", DummyBatchInitializer, DummyBatchCallback,
+                                                DummyBatchCleanup, &proc),
+            MGP_ERROR_NO_ERROR);
+  ASSERT_NE(proc, nullptr);
+  EXPECT_TRUE(proc->IsBatched());
+  EXPECT_FALSE(proc->is_write_procedure);
+  EXPECT_EQ(mgp_module_add_batch_write_procedure(&module, "batched_write", DummyBatchInitializer, DummyBatchCallback,
+                                                 DummyBatchCleanup, &proc),
+            MGP_ERROR_NO_ERROR);
+  EXPECT_TRUE(proc->IsBatched());
+  EXPECT_TRUE(proc->is_write_procedure);
+  EXPECT_EQ(mgp_module_add_read_procedure(&module, "not_batched", DummyCallback, &proc), MGP_ERROR_NO_ERROR);
+  EXPECT_FALSE(proc->IsBatched());
+
+  EXPECT_EQ(mgp_module_add_batch_read_procedure(&module, "batched", DummyBatchInitializer, DummyBatchCallback,
+                                                DummyBatchCleanup, &proc),
+            MGP_ERROR_LOGIC_ERROR);
+  EXPECT_EQ(mgp_module_add_batch_read_procedure(&module, "no_cleanup", DummyBatchInitializer, DummyBatchCallback,
+                                                nullptr, &proc),
+            MGP_ERROR_INVALID_ARGUMENT);
+  EXPECT_EQ(mgp_module_add_batch_read_procedure(&module, "div/", DummyBatchInitializer, DummyBatchCallback,
+                                                DummyBatchCleanup, &proc),
+            MGP_ERROR_INVALID_ARGUMENT);
+  EXPECT_EQ(module.procedures.size(), 3U);
+}
+
+TEST(Module, ParallelSafeProcedure) {
+  mgp_module module(utils::NewDeleteResource());
+  mgp_proc *proc{nullptr};
+  EXPECT_EQ(mgp_module_add_read_procedure(&module, "read", DummyCallback, &proc), MGP_ERROR_NO_ERROR);
+  EXPECT_FALSE(proc->is_parallel_safe);
+  EXPECT_EQ(mgp_proc_set_parallel_safe(proc), MGP_ERROR_NO_ERROR);
+  EXPECT_TRUE(proc->is_parallel_safe);
+  EXPECT_EQ(mgp_module_add_write_procedure(&module, "write", DummyCallback, &proc), MGP_ERROR_NO_ERROR);
+  EXPECT_EQ(mgp_proc_set_parallel_safe(proc), MGP_ERROR_LOGIC_ERROR);
+  EXPECT_FALSE(proc->is_parallel_safe);
+  EXPECT_EQ(mgp_module_add_batch_read_procedure(&module, "batched", DummyBatchInitializer, DummyBatchCallback,
+                                                DummyBatchCleanup, &proc),
+            MGP_ERROR_NO_ERROR);
+  EXPECT_EQ(mgp_proc_set_parallel_safe(proc), MGP_ERROR_LOGIC_ERROR);
+  EXPECT_FALSE(proc->is_parallel_safe);
+}
+
 static void CheckSignature(const mgp_proc *proc, const std::string &expected) {
   std::stringstream ss;
   query::procedure::PrintProcSignature(*proc, &ss);
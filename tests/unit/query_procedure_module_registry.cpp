@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "query/procedure/mg_procedure_impl.hpp"
+#include "query/procedure/module.hpp"
+
+using query::procedure::gModuleRegistry;
+
+TEST(ModuleRegistry, FindBuiltinProcedure) {
+  auto maybe_found = query::procedure::FindProcedure(gModuleRegistry, "mg.procedures", utils::NewDeleteResource());
+  ASSERT_TRUE(maybe_found);
+  EXPECT_EQ(maybe_found->first.Generation(), gModuleRegistry.GetSnapshot()->generation);
+  EXPECT_FALSE(query::procedure::FindProcedure(gModuleRegistry, "mg.missing", utils::NewDeleteResource()));
+  EXPECT_FALSE(query::procedure::FindProcedure(gModuleRegistry, "missing.procedures", utils::NewDeleteResource()));
+}
+
+TEST(ModuleRegistry, UnloadPublishesSnapshot) {
+  const auto generation = gModuleRegistry.GetSnapshot()->generation;
+  const auto unload_count = gModuleRegistry.GetSnapshot()->unload_count;
+  gModuleRegistry.UnloadAllModules();
+  const auto snapshot = gModuleRegistry.GetSnapshot();
+  EXPECT_GT(snapshot->generation, generation);
+  EXPECT_EQ(snapshot->unload_count, unload_count + 1);
+  ASSERT_EQ(snapshot->modules.size(), 1U);
+  EXPECT_EQ(snapshot->modules.begin()->first, "mg");
+}
+
+TEST(ModuleRegistry, NestedSnapshots) {
+  const auto outer = gModuleRegistry.GetSnapshot();
+  {
+    const auto inner = gModuleRegistry.GetSnapshot();
+    EXPECT_EQ(&*outer, &*inner);
+  }
+  // The writer doesn't wait for its own thread.
+  gModuleRegistry.UnloadAllModules();
+  EXPECT_EQ(&*outer, &*gModuleRegistry.GetSnapshot());
+}
+
+TEST(ModuleRegistry, UnloadWaitsForReaders) {
+  std::promise<void> snapshot_taken;
+  std::promise<void> release_snapshot;
+  std::thread reader([&] {
+    const auto module = gModuleRegistry.GetModuleNamed("mg");
+    ASSERT_TRUE(module);
+    snapshot_taken.set_value();
+    release_snapshot.get_future().wait();
+  });
+  snapshot_taken.get_future().wait();
+
+  std::atomic<bool> unloaded{false};
+  std::thread writer([&] {
+    gModuleRegistry.UnloadAllModules();
+    unloaded = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(unloaded);
+  // Readers aren't blocked by the waiting writer.
+  EXPECT_TRUE(gModuleRegistry.GetModuleNamed("mg"));
+
+  release_snapshot.set_value();
+  reader.join();
+  writer.join();
+  EXPECT_TRUE(unloaded);
+}
+
+TEST(ModuleRegistry, ConcurrentLoadAll) {
+  // Each thread calls mg.load_all while holding the snapshot in which it found
+  // the procedure, like a query calling it does.
+  constexpr auto kThreads = 2;
+  constexpr auto kCalls = 20;
+  std::atomic<int> ready{0};
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&] {
+      ++ready;
+      while (ready < kThreads) {
+      }
+      for (auto call = 0; call < kCalls; ++call) {
+        auto maybe_found =
+            query::procedure::FindProcedure(gModuleRegistry, "mg.load_all", utils::NewDeleteResource());
+        ASSERT_TRUE(maybe_found);
+        const auto unload_count = maybe_found->first.UnloadCount();
+        maybe_found->second->cb(nullptr, nullptr, nullptr, nullptr);
+        // The caller moves to a snapshot published after its own unload.
+        EXPECT_GT(maybe_found->first.UnloadCount(), unload_count);
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+}
+
+TEST(ModuleRegistry, ReadersAndWritersStress) {
+  constexpr auto kReaders = 4;
+  constexpr auto kWriters = 2;
+  constexpr auto kUnloads = 200;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (auto i = 0; i < kReaders; ++i) {
+    readers.emplace_back([&] {
+      uint64_t last_generation = 0;
+      while (!done) {
+        const auto module = gModuleRegistry.GetModuleNamed("mg");
+        ASSERT_TRUE(module);
+        const auto *procedures = module->Procedures();
+        ASSERT_TRUE(procedures->contains("procedures"));
+        // Snapshots are published in order and don't change while held.
+        const auto generation = module.Generation();
+        EXPECT_GE(generation, last_generation);
+        last_generation = generation;
+        const auto nested = gModuleRegistry.GetSnapshot();
+        EXPECT_EQ(nested->generation, generation);
+        ASSERT_TRUE(nested->modules.contains("mg"));
+        EXPECT_EQ(nested->modules.find("mg")->second, &*module);
+      }
+    });
+  }
+  std::vector<std::thread> writers;
+  for (auto i = 0; i < kWriters; ++i) {
+    writers.emplace_back([&] {
+      for (auto unload = 0; unload < kUnloads; ++unload) gModuleRegistry.UnloadAllModules();
+    });
+  }
+  for (auto &writer : writers) writer.join();
+  done = true;
+  for (auto &reader : readers) reader.join();
+  EXPECT_EQ(gModuleRegistry.GetSnapshot()->modules.size(), 1U);
+}
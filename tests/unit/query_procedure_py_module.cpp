@@ -116,6 +116,19 @@ TEST(PyModule, PyVertex) {
   py::Object py_vertex_value(query::procedure::MgpValueToPyObject(*vertex_value, py_graph.Ptr()));
   ASSERT_TRUE(py_vertex_value);
   AssertPickleAndCopyAreNotSupported(py_vertex_value.GetAttr("_vertex").Ptr());
+  // Read all properties at once.
+  {
+    py::Object py_properties(py_vertex_value.GetAttr("_vertex").CallMethod("get_properties"));
+    ASSERT_TRUE(py_properties);
+    ASSERT_TRUE(PyDict_Check(py_properties.Ptr()));
+    EXPECT_EQ(PyDict_Size(py_properties.Ptr()), 2);
+    auto *py_value1 = PyDict_GetItemString(py_properties.Ptr(), "key1");
+    ASSERT_TRUE(py_value1 && PyUnicode_Check(py_value1));
+    EXPECT_EQ(std::string(PyUnicode_AsUTF8(py_value1)), "value1");
+    auto *py_value2 = PyDict_GetItemString(py_properties.Ptr(), "key2");
+    ASSERT_TRUE(py_value2 && PyLong_Check(py_value2));
+    EXPECT_EQ(PyLong_AsLong(py_value2), 1337);
+  }
   // Convert from mgp.Vertex to mgp_value.
   auto *new_vertex_value = query::procedure::PyObjectToMgpValue(py_vertex_value.Ptr(), &memory);
   // Test for equality.
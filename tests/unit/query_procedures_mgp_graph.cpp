@@ -604,3 +604,150 @@ TEST_F(MgpGraphTest, EdgeSetPropertyWithImmutableGraph) {
   EXPECT_EQ(EXPECT_MGP_NO_ERROR(int, mgp_edge_underlying_graph_is_mutable, edge.get()), 0);
   EXPECT_EQ(mgp_edge_set_property(edge.get(), "property", value.get()), MGP_ERROR_IMMUTABLE_OBJECT);
 }
+
+TEST_F(MgpGraphTest, Project) {
+  std::array<storage::Gid, 3> vertex_ids{};
+  {
+    auto accessor = CreateDbAccessor(storage::IsolationLevel::SNAPSHOT_ISOLATION);
+    const auto node_label = accessor.NameToLabel("Node");
+    const auto weight = accessor.NameToProperty("weight");
+    const auto edge_type_a = accessor.NameToEdgeType("A");
+    std::array<query::VertexAccessor, 3> vertices{accessor.InsertVertex(), accessor.InsertVertex(),
+                                                  accessor.InsertVertex()};
+    for (size_t i = 0; i < vertices.size(); ++i) vertex_ids[i] = vertices[i].Gid();
+    ASSERT_TRUE(vertices[0].AddLabel(node_label).HasValue());
+    ASSERT_TRUE(vertices[1].AddLabel(node_label).HasValue());
+
+    auto edge1 = accessor.InsertEdge(&vertices[0], &vertices[1], edge_type_a);
+    ASSERT_TRUE(edge1.HasValue());
+    ASSERT_TRUE(edge1->SetProperty(weight, storage::PropertyValue{2.5}).HasValue());
+    auto edge2 = accessor.InsertEdge(&vertices[1], &vertices[0], edge_type_a);
+    ASSERT_TRUE(edge2.HasValue());
+    ASSERT_TRUE(edge2->SetProperty(weight, storage::PropertyValue{3}).HasValue());
+    ASSERT_TRUE(accessor.InsertEdge(&vertices[0], &vertices[2], edge_type_a).HasValue());
+    ASSERT_TRUE(accessor.InsertEdge(&vertices[1], &vertices[1], accessor.NameToEdgeType("B")).HasValue());
+    ASSERT_FALSE(accessor.Commit().HasError());
+  }
+  auto graph = CreateGraph();
+  auto get_vertex_ids = [](mgp_graph_projection *projection) {
+    std::vector<int64_t> ids;
+    const auto count = EXPECT_MGP_NO_ERROR(size_t, mgp_graph_projection_vertices_count, projection);
+    for (size_t i = 0; i < count; ++i) {
+      ids.push_back(EXPECT_MGP_NO_ERROR(mgp_vertex_id, mgp_graph_projection_vertex_id, projection, i).as_int);
+    }
+    return ids;
+  };
+  auto get_array = [](const auto *data, size_t size) { return std::vector(data, data + size); };
+  {
+    SCOPED_TRACE("Whole graph");
+    auto *projection =
+        EXPECT_MGP_NO_ERROR(mgp_graph_projection *, mgp_graph_project, &graph, nullptr, nullptr, nullptr, &memory);
+    ASSERT_NE(projection, nullptr);
+    EXPECT_THAT(get_vertex_ids(projection), ::testing::ElementsAre(vertex_ids[0].AsInt(), vertex_ids[1].AsInt(),
+                                                                   vertex_ids[2].AsInt()));
+    EXPECT_EQ(EXPECT_MGP_NO_ERROR(size_t, mgp_graph_projection_edges_count, projection), 4);
+    const auto offsets = get_array(EXPECT_MGP_NO_ERROR(const size_t *, mgp_graph_projection_offsets, projection), 4);
+    EXPECT_THAT(offsets, ::testing::ElementsAre(0, 2, 4, 4));
+    const auto neighbors =
+        get_array(EXPECT_MGP_NO_ERROR(const size_t *, mgp_graph_projection_neighbors, projection), 4);
+    EXPECT_THAT(std::vector(neighbors.begin(), neighbors.begin() + 2), ::testing::UnorderedElementsAre(1, 2));
+    EXPECT_THAT(std::vector(neighbors.begin() + 2, neighbors.end()), ::testing::UnorderedElementsAre(0, 1));
+    EXPECT_EQ(EXPECT_MGP_NO_ERROR(const double *, mgp_graph_projection_weights, projection), nullptr);
+    mgp_vertex_id out_of_range_id{};
+    EXPECT_EQ(mgp_graph_projection_vertex_id(projection, 3, &out_of_range_id), MGP_ERROR_OUT_OF_RANGE);
+    mgp_graph_projection_destroy(projection);
+  }
+  {
+    SCOPED_TRACE("Labeled vertices with weighted edges of a single type");
+    auto *projection =
+        EXPECT_MGP_NO_ERROR(mgp_graph_projection *, mgp_graph_project, &graph, "Node", "A", "weight", &memory);
+    ASSERT_NE(projection, nullptr);
+    EXPECT_THAT(get_vertex_ids(projection), ::testing::ElementsAre(vertex_ids[0].AsInt(), vertex_ids[1].AsInt()));
+    EXPECT_EQ(EXPECT_MGP_NO_ERROR(size_t, mgp_graph_projection_edges_count, projection), 2);
+    EXPECT_THAT(get_array(EXPECT_MGP_NO_ERROR(const size_t *, mgp_graph_projection_offsets, projection), 3),
+                ::testing::ElementsAre(0, 1, 2));
+    EXPECT_THAT(get_array(EXPECT_MGP_NO_ERROR(const size_t *, mgp_graph_projection_neighbors, projection), 2),
+                ::testing::ElementsAre(1, 0));
+    const auto *weights = EXPECT_MGP_NO_ERROR(const double *, mgp_graph_projection_weights, projection);
+    ASSERT_NE(weights, nullptr);
+    EXPECT_THAT(get_array(weights, 2), ::testing::ElementsAre(2.5, 3.0));
+    mgp_graph_projection_destroy(projection);
+  }
+}
+
+TEST_F(MgpGraphTest, ProjectLargeGraph) {
+  // Large enough to be split between several workers, each vertex points to
+  // the next one and some of the vertices are deleted.
+  constexpr size_t kVerticesCount = 50000;
+  {
+    auto accessor = CreateDbAccessor(storage::IsolationLevel::SNAPSHOT_ISOLATION);
+    const auto edge_type = accessor.NameToEdgeType("NEXT");
+    std::vector<query::VertexAccessor> vertices;
+    vertices.reserve(kVerticesCount);
+    for (size_t i = 0; i < kVerticesCount; ++i) vertices.push_back(accessor.InsertVertex());
+    for (size_t i = 0; i < kVerticesCount; ++i) {
+      ASSERT_TRUE(accessor.InsertEdge(&vertices[i], &vertices[(i + 1) % kVerticesCount], edge_type).HasValue());
+    }
+    ASSERT_FALSE(accessor.Commit().HasError());
+  }
+  {
+    auto accessor = CreateDbAccessor(storage::IsolationLevel::SNAPSHOT_ISOLATION);
+    for (auto vertex : accessor.Vertices(storage::View::OLD)) {
+      if (vertex.Gid().AsUint() % 10 == 0) ASSERT_TRUE(accessor.DetachRemoveVertex(&vertex).HasValue());
+    }
+    ASSERT_FALSE(accessor.Commit().HasError());
+  }
+  auto graph = CreateGraph();
+  auto *projection =
+      EXPECT_MGP_NO_ERROR(mgp_graph_projection *, mgp_graph_project, &graph, nullptr, nullptr, nullptr, &memory);
+  ASSERT_NE(projection, nullptr);
+  const auto count = EXPECT_MGP_NO_ERROR(size_t, mgp_graph_projection_vertices_count, projection);
+  ASSERT_EQ(count, kVerticesCount - kVerticesCount / 10);
+  const auto *offsets = EXPECT_MGP_NO_ERROR(const size_t *, mgp_graph_projection_offsets, projection);
+  const auto *neighbors = EXPECT_MGP_NO_ERROR(const size_t *, mgp_graph_projection_neighbors, projection);
+  ASSERT_EQ(offsets[0], 0);
+  int64_t previous_id = -1;
+  for (size_t i = 0; i < count; ++i) {
+    const auto id = EXPECT_MGP_NO_ERROR(mgp_vertex_id, mgp_graph_projection_vertex_id, projection, i).as_int;
+    ASSERT_GT(id, previous_id);
+    previous_id = id;
+    // The edge to the next vertex is gone if the next vertex was deleted.
+    if ((id + 1) % 10 == 0) {
+      ASSERT_EQ(offsets[i + 1], offsets[i]);
+    } else {
+      ASSERT_EQ(offsets[i + 1], offsets[i] + 1);
+      ASSERT_EQ(neighbors[offsets[i]], i + 1);
+    }
+  }
+  mgp_graph_projection_destroy(projection);
+}
+
+TEST_F(MgpGraphTest, ProjectIndexedLabel) {
+  ASSERT_TRUE(storage.CreateIndex(storage.NameToLabel("Node")));
+  std::array<storage::Gid, 2> vertex_ids{};
+  {
+    auto accessor = CreateDbAccessor(storage::IsolationLevel::SNAPSHOT_ISOLATION);
+    const auto node_label = accessor.NameToLabel("Node");
+    std::array<query::VertexAccessor, 3> vertices{accessor.InsertVertex(), accessor.InsertVertex(),
+                                                  accessor.InsertVertex()};
+    ASSERT_TRUE(vertices[0].AddLabel(node_label).HasValue());
+    ASSERT_TRUE(vertices[2].AddLabel(node_label).HasValue());
+    vertex_ids = {vertices[0].Gid(), vertices[2].Gid()};
+    ASSERT_TRUE(accessor.InsertEdge(&vertices[2], &vertices[0], accessor.NameToEdgeType("A")).HasValue());
+    ASSERT_TRUE(accessor.InsertEdge(&vertices[0], &vertices[1], accessor.NameToEdgeType("A")).HasValue());
+    ASSERT_FALSE(accessor.Commit().HasError());
+  }
+  auto graph = CreateGraph();
+  auto *projection =
+      EXPECT_MGP_NO_ERROR(mgp_graph_projection *, mgp_graph_project, &graph, "Node", nullptr, nullptr, &memory);
+  ASSERT_NE(projection, nullptr);
+  ASSERT_EQ(EXPECT_MGP_NO_ERROR(size_t, mgp_graph_projection_vertices_count, projection), 2);
+  EXPECT_EQ(EXPECT_MGP_NO_ERROR(mgp_vertex_id, mgp_graph_projection_vertex_id, projection, 0).as_int,
+            vertex_ids[0].AsInt());
+  EXPECT_EQ(EXPECT_MGP_NO_ERROR(mgp_vertex_id, mgp_graph_projection_vertex_id, projection, 1).as_int,
+            vertex_ids[1].AsInt());
+  EXPECT_EQ(EXPECT_MGP_NO_ERROR(size_t, mgp_graph_projection_edges_count, projection), 1);
+  const auto *neighbors = EXPECT_MGP_NO_ERROR(const size_t *, mgp_graph_projection_neighbors, projection);
+  EXPECT_EQ(neighbors[0], 0);
+  mgp_graph_projection_destroy(projection);
+}
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <thread>
 
 #include "gmock/gmock.h"
@@ -6,6 +7,7 @@
 #include "rpc/client.hpp"
 #include "rpc/client_pool.hpp"
 #include "rpc/messages.hpp"
+#include "rpc/protocol.hpp"
 #include "rpc/server.hpp"
 #include "utils/timer.hpp"
 
@@ -96,9 +98,155 @@ TEST(Rpc, Abort) {
   server.AwaitShutdown();
 }
 
-TEST(Rpc, ClientPool) {
+TEST(Rpc, AbortWithWaiters) {
+  std::atomic<bool> slow{true};
+  communication::ServerContext server_context;
+  Server server({"127.0.0.1", 0}, &server_context);
+  server.Register<Sum>([&slow](auto *req_reader, auto *res_builder) {
+    SumReq req;
+    slk::Load(&req, req_reader);
+    if (slow) std::this_thread::sleep_for(500ms);
+    SumRes res(req.x + req.y);
+    slk::Save(res, res_builder);
+  });
+  ASSERT_TRUE(server.Start());
+  std::this_thread::sleep_for(100ms);
+
+  communication::ClientContext client_context;
+  Client client(server.endpoint(), &client_context);
+
+  // All of the calls wait on the same connection, the abort must wake up
+  // every one of them and not only the one reading the connection.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&client, i] {
+      utils::Timer timer;
+      EXPECT_THROW(client.Call<Sum>(i, i), RpcFailedException);
+      EXPECT_LT(timer.Elapsed(), 300ms);
+    });
+  }
+  std::this_thread::sleep_for(100ms);
+  client.Abort();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Every waiting call returned, so the next call replaces the connection.
+  slow = false;
+  auto sum = client.Call<Sum>(10, 20);
+  EXPECT_EQ(sum.sum, 30);
+
+  server.Shutdown();
+  server.AwaitShutdown();
+}
+
+TEST(Rpc, ConnectionLostWithWaiters) {
+  communication::ServerContext server_context;
+  Server server({"127.0.0.1", 0}, &server_context);
+  server.Register<Sum>([](auto *req_reader, auto *res_builder) {
+    SumReq req;
+    slk::Load(&req, req_reader);
+    // The exception closes the connection.
+    if (req.x < 0) {
+      std::this_thread::sleep_for(200ms);
+      throw std::runtime_error("Sum failed");
+    }
+    if (req.y < 0) std::this_thread::sleep_for(500ms);
+    SumRes res(req.x + req.y);
+    slk::Save(res, res_builder);
+  });
+  ASSERT_TRUE(server.Start());
+  std::this_thread::sleep_for(100ms);
+
+  communication::ClientContext client_context;
+  Client client(server.endpoint(), &client_context);
+
+  // The calls that are still executed when the failing one closes the
+  // connection never get their responses, the lost connection must fail all
+  // of them.
+  std::vector<std::thread> threads;
+  threads.emplace_back([&client] { EXPECT_THROW(client.Call<Sum>(-1, 1), RpcFailedException); });
+  std::this_thread::sleep_for(50ms);
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&client, i] { EXPECT_THROW(client.Call<Sum>(i, -1), RpcFailedException); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto sum = client.Call<Sum>(10, 20);
+  EXPECT_EQ(sum.sum, 30);
+
+  server.Shutdown();
+  server.AwaitShutdown();
+}
+
+TEST(Rpc, HandshakeRejectsOldClient) {
+  communication::ServerContext server_context;
+  Server server({"127.0.0.1", 0}, &server_context);
+  server.Register<Sum>([](auto *req_reader, auto *res_builder) {
+    SumReq req;
+    slk::Load(&req, req_reader);
+    SumRes res(req.x + req.y);
+    slk::Save(res, res_builder);
+  });
+  ASSERT_TRUE(server.Start());
+  std::this_thread::sleep_for(100ms);
+
+  // A request in the format of a client without the handshake.
+  communication::ClientContext client_context;
+  communication::Client client(&client_context);
+  ASSERT_TRUE(client.Connect(server.endpoint()));
+  slk::Builder builder(
+      [&client](const uint8_t *data, size_t size, bool have_more) { ASSERT_TRUE(client.Write(data, size, have_more)); });
+  slk::Save(Sum::Request::kType.id, &builder);
+  SumReq::Save(SumReq(10, 20), &builder);
+  builder.Finalize();
+
+  // The server closes the connection without a response.
+  EXPECT_FALSE(client.Read(1));
+
+  server.Shutdown();
+  server.AwaitShutdown();
+}
+
+TEST(Rpc, HandshakeVersionMismatch) {
   communication::ServerContext server_context;
   Server server({"127.0.0.1", 0}, &server_context);
+  ASSERT_TRUE(server.Start());
+  std::this_thread::sleep_for(100ms);
+
+  communication::ClientContext client_context;
+  communication::Client client(&client_context);
+  ASSERT_TRUE(client.Connect(server.endpoint()));
+  slk::Builder builder(
+      [&client](const uint8_t *data, size_t size, bool have_more) { ASSERT_TRUE(client.Write(data, size, have_more)); });
+  slk::Save(kProtocolMagic, &builder);
+  slk::Save(kProtocolVersion + 1, &builder);
+  builder.Finalize();
+
+  // The server responds with its own version and closes the connection.
+  slk::StreamInfo info;
+  while ((info = slk::CheckStreamComplete(client.GetData(), client.GetDataSize())).status ==
+         slk::StreamStatus::PARTIAL) {
+    ASSERT_TRUE(client.Read(info.stream_size - client.GetDataSize(), /* exactly_len = */ false));
+  }
+  ASSERT_EQ(info.status, slk::StreamStatus::COMPLETE);
+  slk::Reader reader(client.GetData(), info.stream_size);
+  uint64_t version = 0;
+  slk::Load(&version, &reader);
+  reader.Finalize();
+  EXPECT_EQ(version, kProtocolVersion);
+  client.ShiftData(info.stream_size);
+  EXPECT_FALSE(client.Read(1));
+
+  server.Shutdown();
+  server.AwaitShutdown();
+}
+
+TEST(Rpc, ClientPool) {
+  communication::ServerContext server_context;
+  Server server({"127.0.0.1", 0}, &server_context, /* workers_count = */ 4);
   server.Register<Sum>([](const auto &req_reader, auto *res_builder) {
     SumReq req;
     Load(&req, req_reader);
@@ -112,8 +260,9 @@ TEST(Rpc, ClientPool) {
   communication::ClientContext client_context;
   Client client(server.endpoint(), &client_context);
 
-  // These calls should take more than 400ms because we're using a regular
-  // client
+  // These calls shouldn't take much more than 100ms either, the regular
+  // client multiplexes them over its connection and the server executes them
+  // in parallel
   auto get_sum_client = [&client](int x, int y) {
     auto sum = client.Call<Sum>(x, y);
     EXPECT_EQ(sum.sum, x + y);
@@ -129,7 +278,7 @@ TEST(Rpc, ClientPool) {
   }
   threads.clear();
 
-  EXPECT_GE(t1.Elapsed(), 400ms);
+  EXPECT_LE(t1.Elapsed(), 200ms);
 
   communication::ClientContext pool_context;
   ClientPool pool(server.endpoint(), &pool_context);
@@ -154,6 +303,82 @@ TEST(Rpc, ClientPool) {
   server.AwaitShutdown();
 }
 
+TEST(Rpc, Multiplexing) {
+  communication::ServerContext server_context;
+  Server server({"127.0.0.1", 0}, &server_context);
+  server.Register<Sum>([](const auto &req_reader, auto *res_builder) {
+    SumReq req;
+    Load(&req, req_reader);
+    SumRes res(req.x + req.y);
+    Save(res, res_builder);
+  });
+  ASSERT_TRUE(server.Start());
+  std::this_thread::sleep_for(100ms);
+
+  communication::ClientContext client_context;
+  Client client(server.endpoint(), &client_context);
+
+  // All threads share a single connection, every call must get the response
+  // to its own request.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&client, i] {
+      for (int j = 0; j < 1000; ++j) {
+        auto sum = client.Call<Sum>(i, j);
+        EXPECT_EQ(sum.sum, i + j);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  server.Shutdown();
+  server.AwaitShutdown();
+}
+
+TEST(Rpc, HeartbeatDuringSlowCall) {
+  communication::ServerContext server_context;
+  Server server({"127.0.0.1", 0}, &server_context, /* workers_count = */ 2);
+  server.Register<Sum>([](auto *req_reader, auto *res_builder) {
+    SumReq req;
+    slk::Load(&req, req_reader);
+    std::this_thread::sleep_for(1000ms);
+    SumRes res(req.x + req.y);
+    slk::Save(res, res_builder);
+  });
+  server.Register<Echo>([](auto *req_reader, auto *res_builder) {
+    EchoMessage res;
+    slk::Load(&res, req_reader);
+    slk::Save(res, res_builder);
+  });
+  ASSERT_TRUE(server.Start());
+  std::this_thread::sleep_for(100ms);
+
+  communication::ClientContext client_context;
+  Client client(server.endpoint(), &client_context);
+
+  // The heartbeat is sent over the same connection after the slow call and
+  // must not wait for it to be executed.
+  std::thread slow_call([&client] { EXPECT_EQ(client.Call<Sum>(10, 20).sum, 30); });
+  std::this_thread::sleep_for(100ms);
+  utils::Timer timer;
+  EXPECT_EQ(client.Call<Echo>("heartbeat").data, "heartbeat");
+  EXPECT_LT(timer.Elapsed(), 500ms);
+  slow_call.join();
+
+  // A request that is still being streamed doesn't block the other calls
+  // either.
+  auto stream = client.Stream<Echo>("hello");
+  timer = utils::Timer();
+  EXPECT_EQ(client.Call<Echo>("heartbeat").data, "heartbeat");
+  EXPECT_LT(timer.Elapsed(), 500ms);
+  EXPECT_EQ(stream.AwaitResponse().data, "hello");
+
+  server.Shutdown();
+  server.AwaitShutdown();
+}
+
 TEST(Rpc, LargeMessage) {
   communication::ServerContext server_context;
   Server server({"127.0.0.1", 0}, &server_context);
@@ -399,6 +399,32 @@ bool operator<(const Inception &a, const Inception &b) { return a.id < b.id; }
 bool operator==(const Inception &a, const uint64_t &b) { return a.id == b; }
 bool operator<(const Inception &a, const uint64_t &b) { return a.id < b; }
 
+TEST(SkipList, PoolResource) {
+  // Nodes of each height are served from a separate pool.
+  utils::SynchronizedPoolResource memory(128, utils::MaxSkipListNodeSize<int64_t>());
+  utils::SkipList<int64_t> list(&memory);
+  {
+    auto acc = list.access();
+    for (int64_t i = 0; i < 10000; ++i) {
+      ASSERT_TRUE(acc.insert(i).second);
+    }
+    for (int64_t i = 0; i < 10000; i += 2) {
+      ASSERT_TRUE(acc.remove(i));
+    }
+  }
+  list.run_gc();
+  {
+    auto acc = list.access();
+    ASSERT_EQ(acc.size(), 5000);
+    int64_t val = 1;
+    for (auto item : acc) {
+      ASSERT_EQ(item, val);
+      val += 2;
+    }
+    ASSERT_EQ(val, 10001);
+  }
+}
+
 TEST(SkipList, Inception) {
   utils::SkipList<Inception> list;
 
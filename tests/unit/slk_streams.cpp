@@ -122,6 +122,78 @@ TEST(Builder, MultipleSegments) {
   ASSERT_EQ(splits[4], footer_expected);
 }
 
+TEST(Builder, SaveView) {
+  std::vector<uint8_t> buffer;
+  size_t gather_writes = 0;
+  slk::Builder builder(
+      [&buffer](const uint8_t *data, size_t size, bool have_more) {
+        for (size_t i = 0; i < size; ++i) buffer.push_back(data[i]);
+      },
+      [&buffer, &gather_writes](const iovec *iov, size_t iovcnt, bool have_more) {
+        ++gather_writes;
+        for (size_t i = 0; i < iovcnt; ++i) {
+          auto data = static_cast<const uint8_t *>(iov[i].iov_base);
+          buffer.insert(buffer.end(), data, data + iov[i].iov_len);
+        }
+      });
+
+  auto prefix = GetRandomData(5);
+  auto view = GetRandomData(slk::kSegmentMaxDataSize + 100);
+  auto suffix = GetRandomData(3);
+  builder.Save(prefix.data(), prefix.size());
+  builder.SaveView(view.data(), view.size());
+  builder.Save(suffix.data(), suffix.size());
+  builder.Finalize();
+
+  ASSERT_EQ(gather_writes, 2);
+  ASSERT_EQ(buffer.size(), prefix.size() + view.size() + suffix.size() + 5 * sizeof(slk::SegmentSize));
+
+  slk::Reader reader(buffer.data(), buffer.size());
+  uint8_t prefix_read[5];
+  reader.Load(prefix_read, sizeof(prefix_read));
+  ASSERT_EQ(BinaryData(prefix_read, sizeof(prefix_read)), prefix);
+
+  std::vector<uint8_t> view_read;
+  size_t pieces = 0;
+  reader.LoadView(view.size(), [&view_read, &pieces](const uint8_t *data, size_t size) {
+    ++pieces;
+    view_read.insert(view_read.end(), data, data + size);
+  });
+  ASSERT_EQ(pieces, 2);
+  ASSERT_EQ(BinaryData(view_read.data(), view_read.size()), view);
+
+  uint8_t suffix_read[3];
+  reader.Load(suffix_read, sizeof(suffix_read));
+  ASSERT_EQ(BinaryData(suffix_read, sizeof(suffix_read)), suffix);
+  reader.Finalize();
+}
+
+TEST(Builder, SaveViewOnly) {
+  std::vector<uint8_t> buffer;
+  slk::Builder builder(
+      [&buffer](const uint8_t *data, size_t size, bool have_more) {
+        for (size_t i = 0; i < size; ++i) buffer.push_back(data[i]);
+      },
+      [&buffer](const iovec *iov, size_t iovcnt, bool have_more) {
+        for (size_t i = 0; i < iovcnt; ++i) {
+          auto data = static_cast<const uint8_t *>(iov[i].iov_base);
+          buffer.insert(buffer.end(), data, data + iov[i].iov_len);
+        }
+      });
+
+  auto input = GetRandomData(slk::kSegmentMinViewSize);
+  builder.SaveView(input.data(), input.size());
+  builder.Finalize();
+
+  ASSERT_EQ(buffer.size(), input.size() + 2 * sizeof(slk::SegmentSize));
+
+  slk::Reader reader(buffer.data(), buffer.size());
+  std::vector<uint8_t> output(input.size());
+  reader.Load(output.data(), output.size());
+  reader.Finalize();
+  ASSERT_EQ(BinaryData(output.data(), output.size()), input);
+}
+
 TEST(Reader, SingleSegment) {
   std::vector<uint8_t> buffer;
   slk::Builder builder([&buffer](const uint8_t *data, size_t size, bool have_more) {
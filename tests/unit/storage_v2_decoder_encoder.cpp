@@ -4,6 +4,7 @@
 #include <limits>
 
 #include "storage/v2/durability/serialization.hpp"
+#include "storage/v2/durability/version.hpp"
 #include "storage/v2/property_value.hpp"
 #include "storage/v2/temporal.hpp"
 
@@ -105,6 +106,9 @@ GENERATE_READ_TEST(Bool, bool, false, true);
 // NOLINTNEXTLINE(hicpp-special-member-functions)
 GENERATE_READ_TEST(Uint, uint64_t, 0, 1, 1000, 123123123, std::numeric_limits<uint64_t>::max());
 
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+GENERATE_READ_TEST(VarUint, uint64_t, 0, 1, 127, 128, 1000, 123123123, std::numeric_limits<uint64_t>::max());
+
 // NOLINTNEXTLINE(hicpp-special-member-functions)
 GENERATE_READ_TEST(Double, double, 1.123, 3.1415926535, 0, -505.505, std::numeric_limits<double>::infinity(),
                    -std::numeric_limits<double>::infinity());
@@ -310,6 +314,7 @@ TEST_F(DecoderEncoderTest, PropertyValueInvalidMarker) {
           valid_marker = true;
           break;
 
+        case storage::durability::Marker::TYPE_VARINT:
         case storage::durability::Marker::SECTION_VERTEX:
         case storage::durability::Marker::SECTION_EDGE:
         case storage::durability::Marker::SECTION_MAPPER:
@@ -440,3 +445,88 @@ TEST_F(DecoderEncoderTest, EncoderPosition) {
     ASSERT_EQ(pos, decoder.GetSize());
   }
 }
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_F(DecoderEncoderTest, CompressedBlocks) {
+  const storage::Config::Durability::Compression compression{
+      .type = storage::Config::Durability::Compression::Type::ZLIB, .block_size_kibibytes = 1};
+  std::vector<uint64_t> positions;
+  uint64_t offset_position = 0;
+  uint64_t size = 0;
+  {
+    storage::durability::Encoder encoder;
+    encoder.Initialize(storage_file, kTestMagic, storage::durability::kVersion, compression);
+    offset_position = encoder.GetPosition();
+    encoder.WriteUint(0);
+    encoder.StartCompression();
+    for (uint64_t i = 0; i < 10000; ++i) {
+      positions.push_back(encoder.GetPosition());
+      encoder.WriteString("value" + std::to_string(i));
+      encoder.WriteUint(i);
+    }
+    size = encoder.GetPosition();
+    encoder.SetPosition(offset_position);
+    encoder.WriteUint(size);
+    encoder.Finalize();
+  }
+  ASSERT_LT(std::filesystem::file_size(storage_file), size);
+  {
+    storage::durability::Decoder decoder;
+    auto version = decoder.Initialize(storage_file, kTestMagic);
+    ASSERT_TRUE(version);
+    ASSERT_EQ(*version, storage::durability::kVersion);
+    ASSERT_EQ(decoder.GetSize(), size);
+    ASSERT_EQ(decoder.ReadUint(), size);
+    for (uint64_t i = 0; i < positions.size(); ++i) {
+      ASSERT_EQ(decoder.GetPosition(), positions[i]);
+      ASSERT_EQ(decoder.ReadString(), "value" + std::to_string(i));
+      ASSERT_EQ(decoder.ReadUint(), i);
+    }
+    ASSERT_EQ(decoder.GetPosition(), decoder.GetSize());
+    ASSERT_FALSE(decoder.ReadMarker());
+    // Random access.
+    for (uint64_t i = 0; i < positions.size(); i += 97) {
+      auto index = positions.size() - 1 - i;
+      ASSERT_TRUE(decoder.SetPosition(positions[index]));
+      ASSERT_EQ(decoder.PeekMarker(), storage::durability::Marker::TYPE_STRING);
+      ASSERT_EQ(decoder.ReadString(), "value" + std::to_string(index));
+    }
+    ASSERT_TRUE(decoder.SetPosition(offset_position));
+    ASSERT_EQ(decoder.ReadUint(), size);
+  }
+}
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_F(DecoderEncoderTest, CompressedPartialBlock) {
+  const storage::Config::Durability::Compression compression{
+      .type = storage::Config::Durability::Compression::Type::ZLIB, .block_size_kibibytes = 1};
+  {
+    storage::durability::Encoder encoder;
+    encoder.Initialize(storage_file, kTestMagic, storage::durability::kVersion, compression);
+    encoder.StartCompression();
+    for (uint64_t i = 0; i < 1000; ++i) {
+      encoder.WriteUint(i);
+    }
+    encoder.Finalize();
+  }
+  {
+    // Remove the end of the last block.
+    utils::InputFile ifile;
+    utils::OutputFile ofile;
+    ASSERT_TRUE(ifile.Open(storage_file));
+    ofile.Open(alternate_file, utils::OutputFile::Mode::OVERWRITE_EXISTING);
+    std::vector<uint8_t> data(ifile.GetSize() - 1);
+    ASSERT_TRUE(ifile.Read(data.data(), data.size()));
+    ofile.Write(data.data(), data.size());
+    ofile.Sync();
+  }
+  {
+    storage::durability::Decoder decoder;
+    auto version = decoder.Initialize(alternate_file, kTestMagic);
+    ASSERT_TRUE(version);
+    uint64_t count = 0;
+    while (decoder.ReadUint()) ++count;
+    ASSERT_GT(count, 0);
+    ASSERT_LT(count, 1000);
+  }
+}
@@ -1364,6 +1364,62 @@ TEST_P(DurabilityTest, WalCreateInSingleTransaction) {
   }
 }
 
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_P(DurabilityTest, WalParallelRecovery) {
+  // Create WALs.
+  {
+    storage::Storage store(
+        {.items = {.properties_on_edges = GetParam()},
+         .durability = {.storage_directory = storage_directory,
+                        .snapshot_wal_mode = storage::Config::Durability::SnapshotWalMode::PERIODIC_SNAPSHOT_WITH_WAL,
+                        .snapshot_interval = std::chrono::minutes(20),
+                        .wal_file_flush_every_n_tx = kFlushWalEvery}});
+    CreateBaseDataset(&store, GetParam());
+    CreateExtendedDataset(&store);
+    // Remove some of the vertices with their edges to have deletions in the
+    // WALs.
+    std::vector<storage::Gid> removed_gids;
+    for (auto gid : base_vertex_gids_) {
+      auto acc = store.Access();
+      auto vertex = acc.FindVertex(gid, storage::View::OLD);
+      ASSERT_TRUE(vertex);
+      auto removed = acc.CreateVertex();
+      ASSERT_TRUE(acc.CreateEdge(&*vertex, &removed, store.NameToEdgeType("removed")).HasValue());
+      removed_gids.push_back(removed.Gid());
+      ASSERT_FALSE(acc.Commit().HasError());
+    }
+    {
+      auto acc = store.Access();
+      for (auto gid : removed_gids) {
+        auto vertex = acc.FindVertex(gid, storage::View::OLD);
+        ASSERT_TRUE(vertex);
+        ASSERT_TRUE(acc.DetachDeleteVertex(&*vertex).HasValue());
+      }
+      ASSERT_FALSE(acc.Commit().HasError());
+    }
+  }
+
+  ASSERT_EQ(GetSnapshotsList().size(), 0);
+  ASSERT_EQ(GetBackupSnapshotsList().size(), 0);
+  ASSERT_GE(GetWalsList().size(), 1);
+  ASSERT_EQ(GetBackupWalsList().size(), 0);
+
+  // Recover WALs.
+  storage::Storage store(
+      {.items = {.properties_on_edges = GetParam()},
+       .durability = {.storage_directory = storage_directory, .recover_on_startup = true, .recovery_thread_count = 4}});
+  VerifyDataset(&store, DatasetType::BASE_WITH_EXTENDED, GetParam());
+
+  // Try to use the storage.
+  {
+    auto acc = store.Access();
+    auto vertex = acc.CreateVertex();
+    auto edge = acc.CreateEdge(&vertex, &vertex, store.NameToEdgeType("et"));
+    ASSERT_TRUE(edge.HasValue());
+    ASSERT_FALSE(acc.Commit().HasError());
+  }
+}
+
 // NOLINTNEXTLINE(hicpp-special-member-functions)
 TEST_P(DurabilityTest, WalCreateAndRemoveEverything) {
   // Create WALs.
@@ -1494,9 +1550,10 @@ TEST_P(DurabilityTest, WalTransactionOrdering) {
     wal.SetPosition(info.offset_deltas);
     ASSERT_EQ(info.num_deltas, 9);
     std::vector<std::pair<uint64_t, storage::durability::WalDeltaData>> data;
+    storage::durability::WalNameDecoder names;
     for (uint64_t i = 0; i < info.num_deltas; ++i) {
       auto timestamp = storage::durability::ReadWalDeltaHeader(&wal);
-      data.emplace_back(timestamp, storage::durability::ReadWalDeltaData(&wal));
+      data.emplace_back(timestamp, storage::durability::ReadWalDeltaData(&wal, &names));
     }
     // Verify timestamps.
     ASSERT_EQ(data[1].first, data[0].first);
@@ -13,6 +13,7 @@
 #include "storage/v2/name_id_mapper.hpp"
 #include "utils/file.hpp"
 #include "utils/file_locker.hpp"
+#include "utils/thread_pool.hpp"
 #include "utils/uuid.hpp"
 
 // Helper function used to convert between enum types.
@@ -167,12 +168,13 @@ class DeltaGenerator final {
 
   using DataT = std::vector<std::pair<uint64_t, storage::durability::WalDeltaData>>;
 
-  DeltaGenerator(const std::filesystem::path &data_directory, bool properties_on_edges, uint64_t seq_num)
+  DeltaGenerator(const std::filesystem::path &data_directory, bool properties_on_edges, uint64_t seq_num,
+                 storage::Config::Durability::Compression compression = {})
       : uuid_(utils::GenerateUUID()),
         epoch_id_(utils::GenerateUUID()),
         seq_num_(seq_num),
         wal_file_(data_directory, uuid_, epoch_id_, {.properties_on_edges = properties_on_edges}, &mapper_, seq_num,
-                  &file_retainer_) {}
+                  &file_retainer_, compression) {}
 
   Transaction CreateTransaction() { return Transaction(this); }
 
@@ -216,6 +218,9 @@ class DeltaGenerator final {
 
   uint64_t GetPosition() { return wal_file_.GetSize(); }
 
+  // The storage does this after each commit.
+  void TryFlushing() { wal_file_.TryFlushing(); }
+
   storage::durability::WalInfo GetInfo() {
     return {.offset_metadata = 0,
             .offset_deltas = 0,
@@ -286,9 +291,10 @@ void AssertWalDataEqual(const DeltaGenerator::DataT &data, const std::filesystem
   wal.Initialize(path, storage::durability::kWalMagic);
   wal.SetPosition(info.offset_deltas);
   DeltaGenerator::DataT current;
+  storage::durability::WalNameDecoder names;
   for (uint64_t i = 0; i < info.num_deltas; ++i) {
     auto timestamp = storage::durability::ReadWalDeltaHeader(&wal);
-    current.emplace_back(timestamp, storage::durability::ReadWalDeltaData(&wal));
+    current.emplace_back(timestamp, storage::durability::ReadWalDeltaData(&wal, &names));
   }
   ASSERT_EQ(data.size(), current.size());
   ASSERT_EQ(data, current);
@@ -601,3 +607,244 @@ TEST_P(WalFileTest, PartialData) {
   ASSERT_EQ(pos, infos.size() - 2);
   AssertWalInfoEqual(infos[infos.size() - 1].second, storage::durability::ReadWalInfo(current_file));
 }
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_P(WalFileTest, CompressedTransactions) {
+  auto generate = [this](const std::filesystem::path &directory,
+                         storage::Config::Durability::Compression compression) {
+    DeltaGenerator gen(directory, GetParam(), 5, compression);
+    for (int64_t i = 0; i < 1000; ++i) {
+      TRANSACTION(true, {
+        auto vertex = tx.CreateVertex();
+        tx.AddLabel(vertex, "label");
+        tx.SetProperty(vertex, "property", storage::PropertyValue(i));
+      });
+      gen.TryFlushing();
+    }
+    return std::pair(gen.GetInfo(), gen.GetData());
+  };
+  const auto [info, data] =
+      generate(storage_directory / "compressed", {.type = storage::Config::Durability::Compression::Type::ZLIB,
+                                                  .block_size_kibibytes = 4});
+  generate(storage_directory / "uncompressed", {});
+
+  auto get_file = [](const std::filesystem::path &directory) {
+    std::vector<std::filesystem::path> files;
+    for (const auto &item : std::filesystem::directory_iterator(directory)) files.push_back(item.path());
+    EXPECT_EQ(files.size(), 1);
+    return files.front();
+  };
+  const auto compressed_file = get_file(storage_directory / "compressed");
+  // A block per transaction would make the compressed file larger than the
+  // uncompressed one.
+  ASSERT_LT(std::filesystem::file_size(compressed_file),
+            std::filesystem::file_size(get_file(storage_directory / "uncompressed")));
+
+  AssertWalInfoEqual(info, storage::durability::ReadWalInfo(compressed_file));
+  AssertWalDataEqual(data, compressed_file);
+
+  storage::durability::RecoveredIndicesAndConstraints indices_constraints;
+  utils::SkipList<storage::Vertex> vertices;
+  utils::SkipList<storage::Edge> edges;
+  storage::NameIdMapper mapper;
+  std::atomic<uint64_t> edge_count{0};
+  const auto recovery_info =
+      storage::durability::LoadWal(compressed_file, &indices_constraints, std::nullopt, &vertices, &edges, &mapper,
+                                   &edge_count, {.properties_on_edges = GetParam()});
+  ASSERT_EQ(recovery_info.next_vertex_id, 1000);
+  ASSERT_EQ(recovery_info.last_commit_timestamp, info.to_timestamp);
+  auto acc = vertices.access();
+  ASSERT_EQ(acc.size(), 1000);
+  const auto label = storage::LabelId::FromUint(mapper.NameToId("label"));
+  const auto property = storage::PropertyId::FromUint(mapper.NameToId("property"));
+  for (const auto &vertex : acc) {
+    ASSERT_EQ(vertex.labels, std::vector{label});
+    ASSERT_EQ(vertex.properties.GetProperty(property),
+              storage::PropertyValue(static_cast<int64_t>(vertex.gid.AsUint())));
+  }
+}
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_P(WalFileTest, CompressedTransactionFlushed) {
+  DeltaGenerator gen(storage_directory, GetParam(), 5,
+                     {.type = storage::Config::Durability::Compression::Type::ZLIB, .block_size_kibibytes = 1024});
+  auto get_file = [this] {
+    auto files = GetFilesList();
+    EXPECT_EQ(files.size(), 1);
+    return files.front();
+  };
+  for (int64_t i = 0; i < 3; ++i) {
+    TRANSACTION(true, {
+      auto vertex = tx.CreateVertex();
+      tx.SetProperty(vertex, "property", storage::PropertyValue(i));
+    });
+    // The WAL file is neither synced nor finalized, the committed deltas must
+    // still be in the file.
+    gen.TryFlushing();
+    const auto file = get_file();
+    AssertWalInfoEqual(gen.GetInfo(), storage::durability::ReadWalInfo(file));
+    AssertWalDataEqual(gen.GetData(), file);
+  }
+}
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_P(WalFileTest, ParallelLoader) {
+  uint64_t middle_timestamp = 0;
+  {
+    DeltaGenerator gen(storage_directory, GetParam(), 5);
+    for (int64_t i = 0; i < 1000; ++i) {
+      TRANSACTION(true, {
+        auto vertex = tx.CreateVertex();
+        tx.AddLabel(vertex, "label");
+        tx.SetProperty(vertex, "property", storage::PropertyValue(i));
+      });
+      if (i == 499) middle_timestamp = gen.GetInfo().to_timestamp;
+    }
+  }
+  const auto wal_files = GetFilesList();
+  ASSERT_EQ(wal_files.size(), 1);
+  const auto info = storage::durability::ReadWalInfo(wal_files.front());
+
+  storage::durability::RecoveredIndicesAndConstraints indices_constraints;
+  utils::SkipList<storage::Vertex> vertices;
+  utils::SkipList<storage::Edge> edges;
+  storage::NameIdMapper mapper;
+  std::atomic<uint64_t> edge_count{0};
+  utils::ThreadPool pool(4);
+  // The same file is loaded twice, the second time it must be skipped because
+  // all of its deltas are already loaded.
+  storage::durability::ParallelWalLoader loader({wal_files.front(), wal_files.front()}, middle_timestamp, 0, &pool,
+                                                4);
+  auto load_next = [&] {
+    return loader.LoadNext(&indices_constraints, &vertices, &edges, &mapper, &edge_count,
+                           {.properties_on_edges = GetParam()});
+  };
+
+  const auto first = load_next();
+  ASSERT_EQ(first.next_vertex_id, 1000);
+  ASSERT_EQ(first.next_timestamp, info.to_timestamp + 1);
+  ASSERT_EQ(first.last_commit_timestamp, info.to_timestamp);
+  const auto label = storage::LabelId::FromUint(mapper.NameToId("label"));
+  const auto property = storage::PropertyId::FromUint(mapper.NameToId("property"));
+  {
+    auto acc = vertices.access();
+    ASSERT_EQ(acc.size(), 500);
+    for (const auto &vertex : acc) {
+      ASSERT_GE(vertex.gid.AsUint(), 500);
+      ASSERT_EQ(vertex.labels, std::vector{label});
+      ASSERT_EQ(vertex.properties.GetProperty(property),
+                storage::PropertyValue(static_cast<int64_t>(vertex.gid.AsUint())));
+    }
+  }
+
+  const auto second = load_next();
+  ASSERT_EQ(second.next_vertex_id, 0);
+  ASSERT_EQ(second.next_timestamp, 0);
+  ASSERT_EQ(second.last_commit_timestamp, info.to_timestamp);
+  ASSERT_EQ(vertices.access().size(), 500);
+}
+
+class WalNameTest : public ::testing::Test {
+ public:
+  void SetUp() override { Clear(); }
+
+  void TearDown() override { Clear(); }
+
+  std::filesystem::path storage_file{std::filesystem::temp_directory_path() / "MG_test_unit_storage_v2_wal_names.bin"};
+
+ private:
+  void Clear() {
+    if (!std::filesystem::exists(storage_file)) return;
+    std::filesystem::remove(storage_file);
+  }
+};
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_F(WalNameTest, RoundTrip) {
+  storage::NameIdMapper mapper;
+  const auto first = mapper.NameToId("first");
+  const auto second = mapper.NameToId("second");
+  // Another writer (eg. a replica continuing the file) assigns the same ID to
+  // a different name.
+  storage::NameIdMapper other_mapper;
+  const auto other = other_mapper.NameToId("other");
+  ASSERT_EQ(first, other);
+  {
+    storage::durability::Encoder encoder;
+    encoder.Initialize(storage_file, storage::durability::kWalMagic, storage::durability::kVersion);
+    storage::durability::WalNameEncoder names(&mapper);
+    for (const auto id : {first, second, first, second}) names.Write(&encoder, id);
+    // A new encoder writes the names again.
+    storage::durability::WalNameEncoder other_names(&other_mapper);
+    for (const auto id : {other, other}) other_names.Write(&encoder, id);
+    encoder.Finalize();
+  }
+  storage::durability::Decoder decoder;
+  ASSERT_EQ(decoder.Initialize(storage_file, storage::durability::kWalMagic), storage::durability::kVersion);
+  storage::durability::WalNameDecoder names;
+  for (const auto *expected : {"first", "second", "first", "second", "other", "other"}) {
+    ASSERT_EQ(names.Read(&decoder), expected);
+  }
+  ASSERT_EQ(decoder.GetPosition(), decoder.GetSize());
+}
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_F(WalNameTest, RepeatedNameIsShort) {
+  storage::NameIdMapper mapper;
+  const auto id = mapper.NameToId("a_rather_long_property_name");
+  uint64_t first_size = 0;
+  uint64_t repeated_size = 0;
+  {
+    storage::durability::Encoder encoder;
+    encoder.Initialize(storage_file, storage::durability::kWalMagic, storage::durability::kVersion);
+    storage::durability::WalNameEncoder names(&mapper);
+    const auto start = encoder.GetPosition();
+    names.Write(&encoder, id);
+    first_size = encoder.GetPosition() - start;
+    names.Write(&encoder, id);
+    repeated_size = encoder.GetPosition() - start - first_size;
+    encoder.Finalize();
+  }
+  ASSERT_LT(repeated_size, first_size);
+  // The marker and a single varint byte.
+  ASSERT_EQ(repeated_size, 2);
+}
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_F(WalNameTest, UnknownId) {
+  {
+    storage::durability::Encoder encoder;
+    encoder.Initialize(storage_file, storage::durability::kWalMagic, storage::durability::kVersion);
+    encoder.WriteVarUint(5U << 1U);
+    encoder.Finalize();
+  }
+  storage::durability::Decoder decoder;
+  ASSERT_TRUE(decoder.Initialize(storage_file, storage::durability::kWalMagic));
+  storage::durability::WalNameDecoder names;
+  ASSERT_THROW(names.Read(&decoder), storage::durability::RecoveryFailure);
+}
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST_F(WalNameTest, LegacyDelta) {
+  const auto legacy_version = storage::durability::kCompactWalVersion - 1;
+  {
+    storage::durability::Encoder encoder;
+    encoder.Initialize(storage_file, storage::durability::kWalMagic, legacy_version);
+    encoder.WriteMarker(storage::durability::Marker::SECTION_DELTA);
+    encoder.WriteUint(42);
+    encoder.WriteMarker(storage::durability::Marker::DELTA_VERTEX_ADD_LABEL);
+    encoder.WriteUint(7);
+    encoder.WriteString("label");
+    encoder.Finalize();
+  }
+  storage::durability::Decoder decoder;
+  const auto version = decoder.Initialize(storage_file, storage::durability::kWalMagic);
+  ASSERT_EQ(version, legacy_version);
+  storage::durability::WalNameDecoder names(*version);
+  ASSERT_EQ(storage::durability::ReadWalDeltaHeader(&decoder, *version), 42);
+  const auto delta = storage::durability::ReadWalDeltaData(&decoder, &names);
+  ASSERT_EQ(delta.type, storage::durability::WalDeltaData::Type::VERTEX_ADD_LABEL);
+  ASSERT_EQ(delta.vertex_add_remove_label.gid, storage::Gid::FromUint(7));
+  ASSERT_EQ(delta.vertex_add_remove_label.label, "label");
+  ASSERT_EQ(decoder.GetPosition(), decoder.GetSize());
+}
@@ -1,5 +1,10 @@
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <fstream>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <map>
 #include <string>
 #include <thread>
@@ -9,6 +14,7 @@
 #include <gtest/gtest.h>
 
 #include "utils/file.hpp"
+#include "utils/io_uring.hpp"
 #include "utils/spin_lock.hpp"
 #include "utils/string.hpp"
 #include "utils/synchronized.hpp"
@@ -65,6 +71,101 @@ void CreateFiles(const fs::path &path) {
   fs::permissions(path / "existing_file_000", fs::perms::none);
 }
 
+std::vector<uint8_t> ReadFileContent(const fs::path &path) {
+  std::ifstream stream(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+}
+
+// Writes, overwrites and syncs data through `handle`, which must use io_uring,
+// and checks the file content after every step that guarantees it.
+void CheckIoUringWrites(utils::OutputFile &handle, const fs::path &path) {
+  std::vector<uint8_t> expected(2 * utils::kFileBufferSize + 1234);
+  for (size_t i = 0; i < expected.size(); ++i) expected[i] = i % 251;
+
+  handle.Write(expected.data(), 1000);
+  handle.TryFlushing();
+  // The buffer is filled and flushed again while the previous write may still
+  // be in flight.
+  handle.Write(expected.data() + 1000, expected.size() - 1000);
+  handle.TryFlushing();
+  // Flushed data never stays in the buffer, even if the previous write was
+  // still in flight.
+  ASSERT_EQ(handle.CurrentBuffer().second, 0);
+  ASSERT_EQ(handle.GetSize(), expected.size());
+  ASSERT_EQ(handle.GetPosition(), expected.size());
+  ASSERT_EQ(ReadFileContent(path), expected);
+
+  const std::vector<uint8_t> patch(100, 255);
+  ASSERT_EQ(handle.SetPosition(utils::OutputFile::Position::SET, 5000), 5000);
+  handle.Write(patch.data(), patch.size());
+  std::copy(patch.begin(), patch.end(), expected.begin() + 5000);
+  ASSERT_EQ(handle.GetPosition(), 5100);
+
+  const std::vector<uint8_t> tail(777, 42);
+  ASSERT_EQ(handle.SetPosition(utils::OutputFile::Position::RELATIVE_TO_END, 0), expected.size());
+  handle.Write(tail.data(), tail.size());
+  expected.insert(expected.end(), tail.begin(), tail.end());
+  ASSERT_EQ(handle.GetSize(), expected.size());
+  handle.Sync();
+  ASSERT_EQ(ReadFileContent(path), expected);
+
+  handle.Write(tail.data(), tail.size());
+  expected.insert(expected.end(), tail.begin(), tail.end());
+  handle.TryFlushing();
+  handle.Close();
+  ASSERT_EQ(ReadFileContent(path), expected);
+}
+
+// Forwards the operations to a real ring, but caps the size of each write.
+// Larger writes complete short and the operation linked to them completes as
+// canceled, the same as when the kernel writes less than requested.
+class ShortWriteIoUring final : public utils::IoUring {
+ public:
+  ShortWriteIoUring(std::unique_ptr<utils::IoUring> ring, size_t max_write_size)
+      : ring_(std::move(ring)), max_write_size_(max_write_size) {}
+
+  void PrepareWriteFixed(int fd, const uint8_t *data, size_t size, uint64_t user_data, bool link) override {
+    if (size > max_write_size_) {
+      size = max_write_size_;
+      cancel_next_ = link;
+      link = false;
+    }
+    ring_->PrepareWriteFixed(fd, data, size, user_data, link);
+  }
+
+  void PrepareFsync(int fd, uint64_t user_data) override {
+    if (cancel_next_) {
+      // The write it was linked to was shortened, so the kernel would cancel
+      // it.
+      canceled_.push_back(user_data);
+      cancel_next_ = false;
+      return;
+    }
+    ring_->PrepareFsync(fd, user_data);
+  }
+
+  void Submit(unsigned wait_count) override {
+    // The canceled operations complete without the kernel.
+    const auto canceled = static_cast<unsigned>(canceled_.size());
+    ring_->Submit(wait_count > canceled ? wait_count - canceled : 0);
+  }
+
+  std::optional<Completion> PopCompletion() override {
+    if (!canceled_.empty()) {
+      Completion completion{canceled_.back(), -ECANCELED};
+      canceled_.pop_back();
+      return completion;
+    }
+    return ring_->PopCompletion();
+  }
+
+ private:
+  std::unique_ptr<utils::IoUring> ring_;
+  size_t max_write_size_;
+  bool cancel_next_{false};
+  std::vector<uint64_t> canceled_;
+};
+
 class UtilsFileTest : public ::testing::Test {
  public:
   void SetUp() override {
@@ -348,3 +449,33 @@ TEST_F(UtilsFileTest, ConcurrentReadingAndWritting) {
                        [](const auto read_count) { return read_count == number_of_writes; });
   }));
 }
+
+TEST_F(UtilsFileTest, OutputFileIoUring) {
+  const auto file_path = storage / "existing_dir_777" / "existing_file_777";
+  utils::OutputFile handle;
+  handle.Open(file_path, utils::OutputFile::Mode::OVERWRITE_EXISTING);
+  if (!handle.UseIoUring()) {
+    handle.Close();
+    GTEST_SKIP() << "io_uring isn't available";
+  }
+  CheckIoUringWrites(handle, file_path);
+}
+
+TEST_F(UtilsFileTest, OutputFileIoUringShortWrites) {
+  const auto file_path = storage / "existing_dir_777" / "existing_file_777";
+  utils::OutputFile handle;
+  handle.Open(file_path, utils::OutputFile::Mode::OVERWRITE_EXISTING);
+  // Every flush is larger than this, so each write completes short and the
+  // `fsync` linked to the last write on `Sync` is canceled.
+  const auto create_ring = [](unsigned entries, uint8_t *buffer,
+                              size_t buffer_size) -> std::unique_ptr<utils::IoUring> {
+    auto ring = utils::IoUring::Create(entries, buffer, buffer_size);
+    if (!ring) return nullptr;
+    return std::make_unique<ShortWriteIoUring>(std::move(ring), 100);
+  };
+  if (!handle.UseIoUring(create_ring)) {
+    handle.Close();
+    GTEST_SKIP() << "io_uring isn't available";
+  }
+  CheckIoUringWrites(handle, file_path);
+}
@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <limits>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -310,6 +313,106 @@ TEST(PoolResource, BlockDeallocation) {
   EXPECT_EQ(test_mem.new_count_, 0U);
 }
 
+TEST(ThreadCachingPoolResource, BlockReuse) {
+  TestMemory test_mem;
+  const size_t max_blocks_per_chunk = 64U;
+  const size_t max_block_size = 64U;
+  utils::ThreadCachingPoolResource mem(max_blocks_per_chunk, max_block_size, &test_mem);
+  auto *ptr = CheckAllocation(&mem, max_block_size);
+  EXPECT_GE(test_mem.new_count_, 1U);
+  test_mem.new_count_ = 0U;
+  mem.Deallocate(ptr, max_block_size);
+  EXPECT_EQ(test_mem.delete_count_, 0U);
+  // The last deallocated block is the first one to be reused.
+  EXPECT_EQ(ptr, mem.Allocate(max_block_size));
+  // Blocks of other sizes are cached separately, so a deallocated block is
+  // reused only for its own size.
+  auto *small_ptr = CheckAllocation(&mem, max_block_size / 2);
+  const auto new_count = test_mem.new_count_;
+  mem.Deallocate(small_ptr, max_block_size / 2);
+  mem.Deallocate(ptr, max_block_size);
+  EXPECT_EQ(ptr, mem.Allocate(max_block_size));
+  EXPECT_NE(small_ptr, CheckAllocation(&mem, max_block_size));
+  EXPECT_EQ(small_ptr, mem.Allocate(max_block_size / 2));
+  // Both magazines were refilled before, so nothing new was allocated.
+  EXPECT_EQ(test_mem.new_count_, new_count);
+}
+
+TEST(ThreadCachingPoolResource, BigBlockAllocations) {
+  TestMemory test_mem;
+  const size_t max_blocks_per_chunk = 64U;
+  const size_t max_block_size = 64U;
+  {
+    utils::ThreadCachingPoolResource mem(max_blocks_per_chunk, max_block_size, &test_mem);
+    CheckAllocation(&mem, max_block_size + 1, 1U);
+    EXPECT_GE(test_mem.new_count_, 1U);
+    auto *ptr = CheckAllocation(&mem, max_block_size * 2, 1U);
+    EXPECT_GE(test_mem.new_count_, 2U);
+    mem.Deallocate(ptr, max_block_size * 2, 1U);
+    EXPECT_GE(test_mem.delete_count_, 1U);
+  }
+  EXPECT_EQ(test_mem.new_count_, test_mem.delete_count_);
+}
+
+// NOLINTNEXTLINE(hicpp-special-member-functions)
+TEST(ThreadCachingPoolResource, BlockSizeIsNotMultipleOfAlignment) {
+  utils::ThreadCachingPoolResource mem(64U, 64U);
+  EXPECT_THROW(mem.Allocate(64U, 24U), std::bad_alloc);
+  EXPECT_THROW(mem.Allocate(63U), std::bad_alloc);
+}
+
+TEST(ThreadCachingPoolResource, MultipleThreads) {
+  TestMemory test_mem;
+  const size_t max_blocks_per_chunk = 64U;
+  const size_t max_block_size = 64U;
+  const size_t num_threads = 4U;
+  const size_t num_blocks = 1000U;
+  {
+    utils::ThreadCachingPoolResource mem(max_blocks_per_chunk, max_block_size, &test_mem);
+    std::vector<std::vector<void *>> allocated(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads.emplace_back([&, i] {
+        for (size_t j = 0; j < num_blocks; ++j) {
+          auto *ptr = mem.Allocate(max_block_size);
+          // Make sure that no other thread writes to the same block.
+          memset(ptr, static_cast<int>(i), max_block_size);
+          allocated[i].push_back(ptr);
+        }
+        for (auto *ptr : allocated[i]) {
+          EXPECT_EQ(*static_cast<unsigned char *>(ptr), i);
+        }
+      });
+    }
+    for (auto &thread : threads) thread.join();
+    std::vector<void *> all_blocks;
+    for (const auto &blocks : allocated) all_blocks.insert(all_blocks.end(), blocks.begin(), blocks.end());
+    std::sort(all_blocks.begin(), all_blocks.end());
+    EXPECT_EQ(std::adjacent_find(all_blocks.begin(), all_blocks.end()), all_blocks.end());
+    // Blocks may be deallocated by a different thread than the one which
+    // allocated them.
+    for (auto *ptr : all_blocks) mem.Deallocate(ptr, max_block_size);
+  }
+  EXPECT_EQ(test_mem.new_count_, test_mem.delete_count_);
+}
+
+TEST(ThreadCachingPoolResource, BlocksOfExitedThreadAreReused) {
+  TestMemory test_mem;
+  const size_t max_blocks_per_chunk = 64U;
+  const size_t max_block_size = 64U;
+  // A multiple of the refill batch, so that the depot can serve all of them.
+  const size_t num_blocks = utils::ThreadCachingPoolResource::kMagazineSize * 2U;
+  utils::ThreadCachingPoolResource mem(max_blocks_per_chunk, max_block_size, &test_mem);
+  std::thread([&] {
+    std::vector<void *> blocks;
+    for (size_t i = 0; i < num_blocks; ++i) blocks.push_back(mem.Allocate(max_block_size));
+    for (auto *ptr : blocks) mem.Deallocate(ptr, max_block_size);
+  }).join();
+  const auto new_count = test_mem.new_count_;
+  for (size_t i = 0; i < num_blocks; ++i) mem.Allocate(max_block_size);
+  EXPECT_EQ(test_mem.new_count_, new_count);
+}
+
 class AllocationTrackingMemory final : public utils::MemoryResource {
  public:
   std::vector<size_t> allocated_sizes_;
@@ -27,3 +27,52 @@ TEST(ThreadPool, Basic) {
     ASSERT_EQ(count.load(), adder_count);
   }
 }
+
+TEST(PriorityThreadPool, Basic) {
+  constexpr size_t adder_count = 100000;
+
+  utils::PriorityThreadPool pool{4, 1, "Test"};
+
+  std::atomic<int> count{0};
+  for (size_t i = 0; i < adder_count; ++i) {
+    pool.AddTask([&] { count.fetch_add(1); },
+                 i % 2 ? utils::PriorityThreadPool::Priority::HIGH : utils::PriorityThreadPool::Priority::LOW);
+  }
+
+  while (pool.UnfinishedTasksNum() != 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  ASSERT_EQ(count.load(), adder_count);
+}
+
+TEST(PriorityThreadPool, ReservedThreads) {
+  utils::PriorityThreadPool pool{2, 1, "Test"};
+
+  // Occupy the only thread that is allowed to run low priority tasks.
+  std::atomic<bool> release{false};
+  std::atomic<int> low_count{0};
+  pool.AddTask(
+      [&] {
+        while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        low_count.fetch_add(1);
+      },
+      utils::PriorityThreadPool::Priority::LOW);
+  pool.AddTask([&] { low_count.fetch_add(1); }, utils::PriorityThreadPool::Priority::LOW);
+
+  // High priority tasks still run on the reserved thread.
+  std::atomic<int> high_count{0};
+  for (size_t i = 0; i < 10; ++i) {
+    pool.AddTask([&] { high_count.fetch_add(1); }, utils::PriorityThreadPool::Priority::HIGH);
+  }
+  while (high_count.load() != 10) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(low_count.load(), 0);
+
+  release.store(true);
+  while (pool.UnfinishedTasksNum() != 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(low_count.load(), 2);
+}